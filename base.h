@@ -1,10 +1,18 @@
 #ifndef HGUI_H
 #define HGUI_H
 
+#ifdef HGUI_HEADLESS
+#include "hgui_headless.h"   // 无界面后端：内存模型实现的Win32子集，用于非Windows平台
+#else
 #include <windows.h>
+#endif
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include "hgui_sched.h"
+#include "hgui_raster.h"
+#include "hgui_layout.h"
+#include "hgui_trace.h"
 
 // 控件类型枚举
 typedef enum {
@@ -16,43 +24,367 @@ typedef enum {
 	HGUI_RADIO,
 	HGUI_CHECKBOX,
 	HGUI_MENUBAR,
-	HGUI_MENUITEM
+	HGUI_MENUITEM,
+	HGUI_CANVAS,
+	HGUI_BOX,
+	HGUI_CONTROL_TYPE_COUNT
 } HGUI_ControlType;
 
+// 控件句柄：低20位为节点槽位（从1开始），高12位为节点代数；0表示无效句柄。
+// 代数用尽的槽位在cleanup之前不再复用，因此删除控件后的旧句柄不会指向新控件
+typedef unsigned int HGUI_Handle;
+#define HGUI_INVALID_HANDLE 0u
+
+// 控件事件
+typedef enum {
+	HGUI_EVENT_CLICK,       // 按钮或菜单项被点击
+	HGUI_EVENT_DBLCLICK,    // 列表框被双击
+	HGUI_EVENT_CHANGE,      // 单选框/复选框状态变化，或输入框内容被用户修改
+	HGUI_EVENT_SELECT,      // 列表框的选择变化
+	HGUI_EVENT_FOCUS,       // 输入框/列表框获得焦点
+	HGUI_EVENT_BLUR,        // 输入框/列表框失去焦点
+	HGUI_EVENT_REMOVE,      // 控件（或其祖先）即将被删除，此时控件仍然完整可用
+	HGUI_EVENT_COUNT
+} HGUI_Event;
+
+// 事件订阅：低20位为订阅表槽位（从1开始），高12位为代数；0表示无效。代数用尽的槽位不再复用
+typedef unsigned int HGUI_Subscription;
+#define HGUI_INVALID_SUBSCRIPTION 0u
+
+// 事件回调：control为触发事件的控件句柄，user_data为订阅时传入的上下文
+typedef void (*HGUI_EventCallback)(HGUI_Handle control, HGUI_Event event, void* user_data);
+
 // 控件结构体前向声明
 typedef struct HGUI_Control HGUI_Control;
+typedef struct HGUI_RadioGroup HGUI_RadioGroup;
+typedef struct HGUI_Font HGUI_Font;
+typedef struct HGUI_Canvas HGUI_Canvas;
+typedef struct HGUI_ListModel HGUI_ListModel;
+
+// 耗时统计
+typedef struct {
+	unsigned long count;            // 次数
+	unsigned long long total_ns;    // 总耗时（纳秒）
+	unsigned long long max_ns;      // 单次最大耗时（纳秒）
+} HGUI_TimingStats;
 
 // 控件结构体定义
 struct HGUI_Control {
-	char* id;                   // 控件ID
-	char* parent_id;            // 父控件ID
+	const char* id;             // 控件ID（驻留字符串，由库统一释放）
+	unsigned int id_hash;       // 控件ID的哈希值（用于索引查找）
+	HGUI_Control* id_shadowed;  // 被本控件遮蔽的较早同名控件（ID重复时索引只保存最新的一个）
+	const char* parent_id;      // 父控件ID（与父控件共享同一份驻留字符串）
+	
+	// 控件树（子控件按创建顺序排列）
+	HGUI_Control* parent;
+	HGUI_Control* first_child;
+	HGUI_Control* last_child;
+	HGUI_Control* next_sibling;
+	HGUI_Control* prev_sibling;
+	
 	HGUI_ControlType type;      // 控件类型
 	HWND hwnd;                  // 窗口句柄
 	HMENU hmenu;                // 菜单句柄
 	UINT_PTR menu_id;           // 菜单项ID
 	bool is_submenu;            // 是否为子菜单
+	BYTE accel_flags;           // 快捷键的修饰标志（FVIRTKEY|FCONTROL等，仅菜单项）
+	WORD accel_key;             // 快捷键的虚拟键码（0表示无）
+	
+	// 单选框分组
+	HGUI_RadioGroup* radio_group;      // 单选框所属的组
+	HGUI_RadioGroup* open_radio_group; // 作为父控件时，新单选框默认加入的组
+	
+	// 虚拟列表框（行数据由回调按需提供，只绘制可见行）
+	bool is_virtual;
+	const char* (*row_callback)(int index, void* ctx);
+	void* row_context;
+	int row_count;
+	
+	// 列表框内容的快照（hgui.setItems据此只应用差异）
+	HGUI_ListModel* list_model;
+	
+	// 批量更新事务中的待处理状态
+	unsigned char pending_visibility; // 0无变化，1待显示，2待隐藏
+	bool redraw_suspended;            // 事务中已暂停重绘
+	
+	// 属性缓存（文本与选中状态的影子副本，读取时不必与原生控件往返）
+	char* text;                 // 当前文本（text_valid为false时需从原生控件同步）
+	size_t text_length;
+	size_t text_capacity;
+	unsigned int text_hash;
+	bool text_valid;            // 输入框内容被用户修改后置为false
+	bool checked;               // 复选框/单选框的选中状态
+	
+	// 字体（均为字体缓存中的引用）
+	HGUI_Font* font;            // 当前应用的字体（NULL表示默认字体）
+	HGUI_Font* base_font;       // 通过setFont设置的基础字体（NULL表示默认字体）
+	
+	// 画布的帧缓冲与脏矩形（仅画布控件）
+	HGUI_Canvas* canvas;
+	
+	// 布局树中的节点（HGUI_LAYOUT_NO_NODE表示不参与布局）
+	HGUI_LayoutId layout;
+	int natural_width;          // 加入布局时的尺寸：叶子的尺寸为AUTO时作为最小值，之后修改样式不受布局结果影响
+	int natural_height;
 	
 	// 回调函数
 	void (*click_callback)(const char* id);
 	void (*dblclick_callback)(const char* id);
 	void (*change_callback)(const char* id);
 	
+	// 事件订阅（订阅表中以下标相连的链表）
+	unsigned int subscribers;       // 链表头（订阅表下标+1，0表示无）
+	unsigned int subscribers_tail;
+	unsigned int event_mask;        // 有订阅者的事件位，分发前快速判断
+	unsigned char dispatch_depth;   // 正在分发的层数，期间退订只做标记
+	bool subscribers_dirty;         // 有已退订、待回收的节点
+	
+#ifdef HGUI_ENABLE_STATS
+	HGUI_TimingStats callback_timing;  // 该控件回调函数的耗时统计
+#endif
+	
 	HGUI_Control* next;         // 链表中的下一个控件
+	HGUI_Control* prev;         // 链表中的上一个控件
+	
+	// 句柄信息
+	unsigned int slot;          // 节点池槽位
+	unsigned int generation;    // 节点代数，节点复用时递增
+	bool alive;                 // 节点是否在用
+	bool removing;              // 所在子树正在删除（期间对它的删除请求被忽略）
 };
 
+// 批量更新统计
+typedef struct {
+	unsigned long transactions;     // 已提交的事务数
+	unsigned long deferred_changes; // 事务中被延迟应用的改动数
+	unsigned long invalidations;    // 实际发出的重绘请求数
+	unsigned long redraws_saved;    // 合并后节省的重绘次数
+} HGUI_UpdateStats;
+
+// 界面描述加载统计（各阶段耗时，单位毫秒）
+typedef struct {
+	double parse_ms;        // 解析/校验
+	double allocate_ms;     // 预分配节点池与索引
+	double create_ms;       // 创建原生控件
+	int node_count;         // 描述中的节点数
+	int created_count;      // 成功创建的控件数
+	char error[128];        // 失败原因
+} HGUI_LoadStats;
+
+// 列表模型一次更新的结果（hgui.setItems）
+typedef struct {
+	int inserted;           // 插入的行数
+	int deleted;            // 删除的行数
+	int hunks;              // 变化的连续段数
+	bool over_budget;       // 变化过多，超出差异预算的部分整体替换
+	double diff_ms;         // 计算差异的耗时（毫秒）
+	double apply_ms;        // 更新列表框的耗时（毫秒）
+} HGUI_ListUpdate;
+
+// 运行统计（在包含 hgui.h 之前定义 HGUI_ENABLE_STATS 启用，未启用时不插桩、快照为空）
+#define HGUI_STATS_BUCKETS 16          // 延迟直方图桶数：第0桶<1微秒，第i桶为[2^(i-1), 2^i)微秒，最后一桶不设上限
+#define HGUI_STATS_MAX_MESSAGES 64     // 单独统计的消息类型数，超出部分计入 other_messages
+#define HGUI_STATS_TOP_CALLBACKS 8     // 快照中保留的最耗时控件回调数
+
+// 单一消息类型的分发统计
+typedef struct {
+	UINT message;
+	HGUI_TimingStats timing;
+	unsigned long histogram[HGUI_STATS_BUCKETS];
+} HGUI_MessageStats;
+
+// 单一控件的回调统计
+typedef struct {
+	char id[32];                    // 控件ID（过长时截断）
+	HGUI_ControlType type;
+	HGUI_TimingStats timing;
+} HGUI_CallbackStats;
+
+// 统计快照
+typedef struct {
+	bool enabled;                   // 编译时是否启用了统计
+	double elapsed_ms;              // 统计开始（或上次重置）以来的时间
+	
+	size_t message_type_count;
+	HGUI_MessageStats messages[HGUI_STATS_MAX_MESSAGES];      // 按总耗时降序
+	HGUI_TimingStats other_messages;                          // 超出类型上限的消息
+	
+	size_t callback_count;
+	HGUI_CallbackStats callbacks[HGUI_STATS_TOP_CALLBACKS];   // 按总耗时降序
+	HGUI_TimingStats callbacks_total;                         // 全部回调（含已删除控件）
+	
+	HGUI_TimingStats drains;        // 跨线程更新队列的应用
+	HGUI_TimingStats lookups;       // 按ID/窗口句柄查找控件
+	HGUI_TimingStats native_calls;  // 发往原生控件的消息
+} HGUI_Stats;
+
+// 单一控件类型的资源占用
+typedef struct {
+	unsigned long controls;     // 在用的控件节点
+	unsigned long hwnds;        // 拥有的窗口
+	unsigned long hmenus;       // 拥有的菜单（菜单栏与子菜单）
+	unsigned long font_refs;    // 持有的字体引用
+	size_t bytes;               // 附属的堆内存（文本缓存、帧缓冲、列表快照）
+} HGUI_MemoryTypeStats;
+
+// hgui.cleanup时的泄漏检查结果（在包含 hgui.h 之前定义 HGUI_CHECK_LEAKS 启用）
+typedef struct {
+	bool checked;                   // 上一次cleanup是否做了检查
+	unsigned long orphaned;         // 不在控件链表中、或父控件已释放的控件节点
+	unsigned long stale_entries;    // 指向已释放控件的索引项
+	unsigned long font_refs;        // 控件全部释放后仍被引用的字体
+	unsigned long controls;         // cleanup后仍未归还的控件节点
+	unsigned long hwnds;            // cleanup后仍未销毁的窗口
+	unsigned long hmenus;           // cleanup后仍未销毁的菜单
+	unsigned long fonts;            // cleanup后仍未删除的字体
+	unsigned long accel_tables;     // cleanup后仍未销毁的快捷键表
+} HGUI_LeakReport;
+
+// 资源与内存账目快照（hgui.memoryStats）。原生对象在创建与销毁处计数，不依赖控件状态推算
+typedef struct {
+	HGUI_MemoryTypeStats types[HGUI_CONTROL_TYPE_COUNT];  // 按控件类型（下标为HGUI_ControlType）
+	HGUI_MemoryTypeStats total;                           // 各类型之和
+	unsigned long fonts;            // 字体缓存中的字体对象
+	unsigned long accel_tables;     // 快捷键表
+	size_t node_bytes;              // 控件节点池（含空闲节点）
+	size_t string_bytes;            // 字符串驻留区中的控件ID（已用字节）
+	size_t table_bytes;             // ID/窗口句柄/菜单ID索引、驻留表与订阅表
+	size_t total_bytes;             // 以上与各控件附属堆内存之和
+	HGUI_LeakReport last_cleanup;   // 上一次cleanup的泄漏检查结果
+} HGUI_MemoryStats;
+
+// 输入回放选项
+typedef struct {
+	bool realtime;      // true按录制时的间隔回放，false不等待、逐条尽快回放
+	void (*on_event)(const HGUI_TraceEvent* event, double latency_ms, void* user_data);  // 每条事件处理完后调用，可为NULL
+	void* user_data;
+} HGUI_ReplayOptions;
+
+// 输入回放报告（延迟为注入一条事件到其同步处理（含回调）完成的时间）
+typedef struct {
+	int events;                                     // 已读取的事件数（提前结束时不含未读取的部分）
+	int replayed;                                   // 已回放的事件数
+	int skipped;                                    // 找不到对应控件而跳过的事件数
+	double elapsed_ms;                              // 回放总耗时
+	HGUI_TimingStats latency;
+	unsigned long histogram[HGUI_STATS_BUCKETS];    // 延迟直方图，分桶同消息统计
+	char error[128];                                // 失败原因
+} HGUI_ReplayReport;
+
 // 创建控件的函数指针结构体
 typedef struct {
-	void (*window)(const char* id, const char* title, int x, int y, int width, int height);
-	void (*label)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height);
-	void (*button)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height);
-	void (*input)(const char* id, const char* parent_id, int x, int y, int width, int height);
-	void (*listbox)(const char* id, const char* parent_id, int x, int y, int width, int height);
-	void (*radio)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height, bool is_group_first);
-	void (*checkbox)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height);
-	void (*menubar)(const char* id, const char* parent_id);
-	void (*addMenuItem)(const char* parent_id, const char* id, const char* text, bool is_submenu);
+	HGUI_Handle (*window)(const char* id, const char* title, int x, int y, int width, int height);
+	HGUI_Handle (*label)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height);
+	HGUI_Handle (*button)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height);
+	HGUI_Handle (*input)(const char* id, const char* parent_id, int x, int y, int width, int height);
+	HGUI_Handle (*listbox)(const char* id, const char* parent_id, int x, int y, int width, int height);
+	HGUI_Handle (*virtualList)(const char* id, const char* parent_id, int x, int y, int width, int height);
+	HGUI_Handle (*radio)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height, bool is_group_first);
+	HGUI_Handle (*checkbox)(const char* id, const char* parent_id, const char* text, int x, int y, int width, int height);
+	HGUI_Handle (*menubar)(const char* id, const char* parent_id);
+	HGUI_Handle (*addMenuItem)(const char* parent_id, const char* id, const char* text, bool is_submenu);
+	HGUI_Handle (*canvas)(const char* id, const char* parent_id, int x, int y, int width, int height);
+	HGUI_Handle (*box)(const char* id, const char* parent_id);
 } HGUI_CreateFunctions;
 
+// 按句柄操作控件的函数指针结构体（跳过字符串查找的快速路径）
+typedef struct {
+	HGUI_Handle (*lookup)(const char* id);
+	bool (*valid)(HGUI_Handle handle);
+	void (*hide)(HGUI_Handle handle);
+	void (*show)(HGUI_Handle handle);
+	void (*setText)(HGUI_Handle handle, const char* text);
+	void (*getText)(HGUI_Handle handle, char* buffer, int buffer_size);
+	int (*getTextLength)(HGUI_Handle handle);
+	const char* (*getTextView)(HGUI_Handle handle);
+	void (*addItem)(HGUI_Handle list, const char* item_text);
+	void (*setCheck)(HGUI_Handle handle, bool checked);
+	bool (*getCheck)(HGUI_Handle handle);
+	HGUI_Subscription (*subscribe)(HGUI_Handle handle, HGUI_Event event, HGUI_EventCallback callback, void* user_data);
+} HGUI_HandleFunctions;
+
+// 跨线程投递更新的函数指针结构体（可在任意线程调用，由UI线程的消息循环统一应用）
+typedef struct {
+	void (*setText)(const char* id, const char* text);
+	void (*addItem)(const char* list_id, const char* item_text);
+	void (*setCheck)(const char* id, bool checked);
+	void (*show)(const char* id);
+	void (*hide)(const char* id);
+	void (*call)(void (*function)(void* user_data), void* user_data);
+} HGUI_PostFunctions;
+
+// 定时与调度的函数指针结构体（仅限UI线程调用，回调在消息循环中运行）
+typedef struct {
+	HGUI_TaskId (*after)(unsigned int delay_ms, void (*callback)(void* user_data), void* user_data);
+	HGUI_TaskId (*every)(unsigned int interval_ms, void (*callback)(void* user_data), void* user_data);
+	HGUI_TaskId (*idle)(void (*callback)(void* user_data), void* user_data);
+	HGUI_TaskId (*frame)(void (*callback)(void* user_data), void* user_data);
+	bool (*cancel)(HGUI_TaskId task);
+	void (*setFrameRate)(unsigned int fps);
+} HGUI_ScheduleFunctions;
+
+// 画布绘制的函数指针结构体（仅限UI线程调用）。颜色为 0xAARRGGBB（可用 HGUI_ARGB/HGUI_RGB 构造），
+// 绘制先写入帧缓冲并记录脏矩形，同一帧内的绘制合并为一次重绘，重绘时只传输脏矩形
+typedef struct {
+	void (*clear)(const char* id, uint32_t color);
+	void (*fillRect)(const char* id, int x, int y, int width, int height, uint32_t color);  // alpha小于255时混合
+	void (*line)(const char* id, int x0, int y0, int x1, int y1, uint32_t color);           // alpha小于255时混合
+	void (*drawImage)(const char* id, int x, int y, const uint32_t* pixels, int width, int height, int stride, bool blend);
+	uint32_t* (*pixels)(const char* id, int* width, int* height, int* stride);  // 直接访问帧缓冲，修改后需调用invalidate
+	void (*invalidate)(const char* id, int x, int y, int width, int height);
+} HGUI_CanvasFunctions;
+
+// 布局的函数指针结构体（仅限UI线程调用）。窗口是布局的根，窗口大小变化时重新布局；
+// 其他控件加入父控件的布局（父控件必须已设置布局），按设置布局的先后顺序排列
+typedef struct {
+	bool (*set)(const char* id, const HGUI_LayoutStyle* style);  // 叶子控件的尺寸为AUTO时以加入布局时的尺寸为最小值
+	void (*clear)(const char* id);                               // 控件及其子控件退出布局
+	void (*apply)(void);                                         // 立即应用待处理的布局（通常在下一帧自动应用）
+} HGUI_LayoutFunctions;
+
+// 菜单描述项（用于hgui.menu.build一次创建整棵菜单树）
+typedef struct {
+	const char* id;
+	const char* text;                  // 空字符串为分隔线
+	int depth;                         // 0为目标菜单的直接子项；紧随其后且深一级的项是它的子菜单项
+	const char* accel;                 // 快捷键，如 "Ctrl+S"、"Ctrl+Shift+F5"，NULL表示无
+	void (*callback)(const char* id);  // 点击回调，NULL表示无
+} HGUI_MenuSpec;
+
+// 菜单的函数指针结构体（仅限UI线程调用）
+typedef struct {
+	// 在菜单栏或子菜单下按顺序创建items描述的菜单树，全部添加后只重绘一次菜单栏；
+	// 返回创建的项数（遇到无效的项时停止）
+	int (*build)(const char* parent_id, const HGUI_MenuSpec* items, int count);
+	// 设置菜单项的快捷键（accel为NULL时取消），快捷键在hgui.run的消息循环中转换为菜单命令
+	bool (*setAccel)(const char* item_id, const char* accel);
+} HGUI_MenuFunctions;
+
+// 输入录制与回放的函数指针结构体（仅限UI线程调用）。录制菜单命令与库处理的控件通知，
+// 程序设置文本引起的通知不会被录制；回放时按ID找到控件，恢复录制时的状态后重新发送通知
+typedef struct {
+	void (*start)(void);                          // 清空并开始录制
+	void (*stop)(void);                           // 停止录制，已录制的轨迹保留到下一次start或cleanup
+	const void* (*data)(size_t* size);            // 已录制的轨迹（尚未录制任何事件时返回NULL）
+	bool (*save)(const char* path);               // 把已录制的轨迹写入文件
+	// 同步回放轨迹，期间照常处理消息、定时任务与帧任务；收到WM_QUIT时停止并重新投递
+	bool (*replay)(const void* data, size_t size, const HGUI_ReplayOptions* options, HGUI_ReplayReport* report);
+	bool (*replayFile)(const char* path, const HGUI_ReplayOptions* options, HGUI_ReplayReport* report);
+} HGUI_TraceFunctions;
+
+// 实例上下文：拥有自己的控件表、菜单ID空间、调度器与消息循环状态。hgui的全部函数作用于调用线程的
+// 当前上下文（未设置时为默认上下文），在不同线程上运行各自的上下文时互不争用。
+// 上下文的界面只能由运行其消息循环的线程操作；工作线程设置当前上下文后用hgui.post投递更新
+typedef struct HGUI_Context HGUI_Context;
+
+// 上下文的函数指针结构体
+typedef struct {
+	HGUI_Context* (*create)(void);                          // 创建新的上下文，在要运行它的线程上设为当前上下文后调用hgui.init
+	void (*destroy)(HGUI_Context* context);                 // 在运行它的线程上调用：尚未cleanup时先cleanup再释放；默认上下文不会被释放
+	HGUI_Context* (*current)(void);                         // 调用线程的当前上下文
+	HGUI_Context* (*makeCurrent)(HGUI_Context* context);    // 设置调用线程的当前上下文（NULL为默认上下文），返回之前的当前上下文
+} HGUI_ContextFunctions;
+
 // HGUI命名空间结构体
 typedef struct {
 	// 核心功能
@@ -60,23 +392,77 @@ typedef struct {
 	int (*run)(void);
 	void (*cleanup)(void);
 	
+	// 批量更新事务
+	void (*beginUpdate)(void);
+	void (*endUpdate)(void);
+	void (*getUpdateStats)(HGUI_UpdateStats* stats);
+	
+	// 界面描述加载
+	bool (*loadUI)(const void* data, size_t size, HGUI_LoadStats* stats);
+	bool (*loadUIFile)(const char* path, HGUI_LoadStats* stats);
+	
+	// 运行统计
+	void (*stats)(HGUI_Stats* out);
+	void (*resetStats)(void);
+	size_t (*formatStats)(char* buffer, size_t size, bool json);
+	void (*dumpStats)(const char* path, unsigned int interval_ms, bool json);
+	void (*memoryStats)(HGUI_MemoryStats* out);
+	
 	// 控件操作
 	void (*remove)(const char* id);
 	void (*hide)(const char* id);
 	void (*show)(const char* id);
 	void (*bind)(const char* id, const char* event, void (*callback)(const char*));
+	HGUI_Subscription (*subscribe)(const char* id, HGUI_Event event, HGUI_EventCallback callback, void* user_data);
+	bool (*unsubscribe)(HGUI_Subscription subscription);
 	void (*setText)(const char* id, const char* text);
 	void (*getText)(const char* id, char* buffer, int buffer_size);
+	int (*getTextLength)(const char* id);
+	const char* (*getTextView)(const char* id);
 	void (*addItem)(const char* list_id, const char* item_text);
 	void (*removeItem)(const char* list_id, int index);
+	void (*addItems)(const char* list_id, const char** items, int count);
+	void (*addItemsBlob)(const char* list_id, const char* blob);
+	void (*removeItems)(const char* list_id, int start, int count);
+	bool (*setItems)(const char* list_id, const char* const* items, int count, HGUI_ListUpdate* update);
+	void (*setRowProvider)(const char* list_id, const char* (*row)(int index, void* ctx), void* ctx);
+	void (*setRowCount)(const char* list_id, int count);
+	void (*invalidateRows)(const char* list_id, int first, int count);
+	bool (*getVisibleRange)(const char* list_id, int* first, int* last);
 	void (*clearList)(const char* list_id);
 	int (*getSelectedIndex)(const char* list_id);
 	void (*getListItem)(const char* list_id, int index, char* buffer, int buffer_size);
 	void (*setCheck)(const char* id, bool checked);
 	bool (*getCheck)(const char* id);
+	const char* (*getSelectedRadio)(const char* radio_id);
+	void (*setFont)(const char* id, const char* face, int size, int weight, bool italic);
 	
 	// 创建控件的子命名空间
 	HGUI_CreateFunctions create;
+	
+	// 按句柄操作的子命名空间
+	HGUI_HandleFunctions handle;
+	
+	// 跨线程投递更新的子命名空间
+	HGUI_PostFunctions post;
+	
+	// 定时与调度的子命名空间
+	HGUI_ScheduleFunctions schedule;
+	
+	// 画布绘制的子命名空间
+	HGUI_CanvasFunctions canvas;
+	
+	// 布局的子命名空间
+	HGUI_LayoutFunctions layout;
+	
+	// 菜单的子命名空间
+	HGUI_MenuFunctions menu;
+	
+	// 输入录制与回放的子命名空间
+	HGUI_TraceFunctions trace;
+	
+	// 实例上下文的子命名空间
+	HGUI_ContextFunctions context;
 } HGUI_Namespace;
 
 // 全局命名空间实例
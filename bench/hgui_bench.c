@@ -0,0 +1,344 @@
+// HGUI 基准测试：在无界面后端上测量常用操作随控件规模增长的耗时。
+// 构建：gcc -std=gnu99 -O2 -DHGUI_HEADLESS -I.. hgui_bench.c -pthread（或 cmake --build build --target bench）
+// 用法：hgui_bench [最大规模]，规模依次为1000、10000、100000，不超过最大规模（默认100000）。
+// 差异基准的行数为规模的10倍（规模为100000时即100万行）。
+// 最大规模不小于50000时先运行一次50000个控件的建立/释放周期（pool_*），报告分配次数与峰值常驻内存。
+// 每项结果输出一行JSON，便于脚本比较：
+//   {"bench":"lookup","n":10000,"ops":10000,"total_ms":0.412,"ns_per_op":41.2}
+// 涉及原生控件的项另有发送给控件的消息数（无界面后端的计数）：
+//   {"bench":"listbox_fill","n":10000,"ops":10000,"total_ms":0.646,"ns_per_op":64.6,"messages":10003}
+#include "hgui.h"
+#include <sys/resource.h>
+#include <time.h>
+
+#define BENCH_ID_LENGTH 16
+#define BENCH_RADIO_GROUP 8     // 每组单选框的数量
+#define BENCH_DIFF_ROWS 10      // 差异基准的行数为规模的倍数
+#define BENCH_DIFF_EDITS 200    // 差异基准中分散的修改数
+#define BENCH_LINEAR_LOOKUPS 1000   // 线性查找对照的查找次数
+#define BENCH_POOL_CONTROLS 50000   // 建立/释放周期的控件数
+
+static char (*bench_ids)[BENCH_ID_LENGTH];
+static int* bench_order;
+static int bench_clicks;
+
+static double bench_now_ms(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1e6;
+}
+
+static void bench_report(const char* name, int n, int ops, double total_ms) {
+	printf("{\"bench\":\"%s\",\"n\":%d,\"ops\":%d,\"total_ms\":%.3f,\"ns_per_op\":%.1f}\n",
+		name, n, ops, total_ms, ops > 0 ? total_ms * 1e6 / ops : 0.0);
+	fflush(stdout);
+}
+
+static void bench_report_messages(const char* name, int n, int ops, double total_ms, unsigned long messages) {
+	printf("{\"bench\":\"%s\",\"n\":%d,\"ops\":%d,\"total_ms\":%.3f,\"ns_per_op\":%.1f,\"messages\":%lu}\n",
+		name, n, ops, total_ms, ops > 0 ? total_ms * 1e6 / ops : 0.0, messages);
+	fflush(stdout);
+}
+
+static unsigned long bench_messages_sent(void) {
+	HGUI_HeadlessStats stats;
+	hgui_headless_stats(&stats);
+	return stats.messages_sent;
+}
+
+// 预先生成ID与随机访问顺序，避免格式化字符串计入测量
+static void bench_prepare(int n) {
+	bench_ids = (char (*)[BENCH_ID_LENGTH])malloc((size_t)n * BENCH_ID_LENGTH);
+	bench_order = (int*)malloc((size_t)n * sizeof(int));
+	unsigned int seed = 12345u;
+	for (int i = 0; i < n; i++) {
+		snprintf(bench_ids[i], BENCH_ID_LENGTH, "c%d", i);
+		bench_order[i] = i;
+	}
+	for (int i = n - 1; i > 0; i--) {
+		seed = seed * 1103515245u + 12345u;
+		int j = (int)((seed >> 8) % (unsigned int)(i + 1));
+		int swap = bench_order[i];
+		bench_order[i] = bench_order[j];
+		bench_order[j] = swap;
+	}
+}
+
+static void bench_release(void) {
+	free(bench_ids);
+	free(bench_order);
+	bench_ids = NULL;
+	bench_order = NULL;
+}
+
+static void bench_begin(void) {
+	hgui.init();
+	hgui.create.window("main", "bench", 0, 0, 800, 600);
+}
+
+static void bench_end(void) {
+	hgui.cleanup();
+	hgui_headless_reset();
+}
+
+static void bench_on_click(const char* id) {
+	(void)id;
+	bench_clicks++;
+}
+
+// 创建n个标签
+static void bench_create(int n) {
+	bench_begin();
+	double start = bench_now_ms();
+	for (int i = 0; i < n; i++) hgui.create.label(bench_ids[i], "main", "x", 0, 0, 10, 10);
+	bench_report("create", n, n, bench_now_ms() - start);
+	bench_end();
+}
+
+// 在n个控件中按随机顺序按ID查找
+static void bench_lookup(int n) {
+	bench_begin();
+	for (int i = 0; i < n; i++) hgui.create.label(bench_ids[i], "main", "x", 0, 0, 10, 10);
+	int found = 0;
+	double start = bench_now_ms();
+	for (int i = 0; i < n; i++) found += find_control(bench_ids[bench_order[i]]) != NULL;
+	bench_report("lookup", n, n, bench_now_ms() - start);
+	if (found != n) fprintf(stderr, "lookup: 只找到 %d/%d 个控件\n", found, n);
+	bench_end();
+}
+
+// 对照：原来的find_control沿控件链表逐个比较ID。每次查找的耗时与n成正比，
+// 因此只测BENCH_LINEAR_LOOKUPS次，按每次的耗时与哈希索引比较
+static void bench_lookup_linear(int n) {
+	bench_begin();
+	for (int i = 0; i < n; i++) hgui.create.label(bench_ids[i], "main", "x", 0, 0, 10, 10);
+	int ops = n < BENCH_LINEAR_LOOKUPS ? n : BENCH_LINEAR_LOOKUPS;
+	int found = 0;
+	double start = bench_now_ms();
+	for (int i = 0; i < ops; i++) {
+		const char* id = bench_ids[bench_order[i]];
+		for (const HGUI_Control* control = hgui_ctx->controls; control; control = control->next) {
+			if (strcmp(control->id, id) == 0) {
+				found++;
+				break;
+			}
+		}
+	}
+	bench_report("lookup_linear", n, ops, bench_now_ms() - start);
+	if (found != ops) fprintf(stderr, "lookup_linear: 只找到 %d/%d 个控件\n", found, ops);
+	bench_end();
+}
+
+static long bench_peak_rss_kb(void) {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+static unsigned long bench_arena_chunks(void) {
+	unsigned long chunks = 0;
+	for (const HGUI_ArenaChunk* chunk = hgui_ctx->arena_chunks; chunk; chunk = chunk->next) chunks++;
+	return chunks;
+}
+
+// n个控件的建立/释放周期：建立、逐个删除（节点回到空闲链表）、再次建立、整体释放。
+// 另输出一行节点池与驻留区的分配次数（逐个分配时每个控件需要一个节点与两份ID字符串，共3次）与峰值常驻内存。
+// 应在其他基准之前运行，峰值常驻内存才反映这个周期
+static void bench_pool_cycle(int n) {
+	long rss_before = bench_peak_rss_kb();
+	bench_begin();
+	double start = bench_now_ms();
+	for (int i = 0; i < n; i++) hgui.create.label(bench_ids[i], "main", "x", 0, 0, 10, 10);
+	bench_report("pool_build", n, n, bench_now_ms() - start);
+	HGUI_MemoryStats built;
+	hgui.memoryStats(&built);
+	size_t slabs = hgui_ctx->slab_count;
+	unsigned long chunks = bench_arena_chunks();
+
+	start = bench_now_ms();
+	for (int i = 0; i < n; i++) hgui.remove(bench_ids[bench_order[i]]);
+	for (int i = 0; i < n; i++) hgui.create.label(bench_ids[i], "main", "x", 0, 0, 10, 10);
+	bench_report("pool_rebuild", n, 2 * n, bench_now_ms() - start);
+	size_t rebuild_slabs = hgui_ctx->slab_count - slabs;
+	unsigned long rebuild_chunks = bench_arena_chunks() - chunks;
+
+	start = bench_now_ms();
+	hgui.cleanup();
+	bench_report("pool_teardown", n, n + 1, bench_now_ms() - start);
+	hgui_headless_reset();
+
+	long rss_after = bench_peak_rss_kb();
+	printf("{\"bench\":\"pool_cycle\",\"n\":%d,\"slabs\":%zu,\"arena_chunks\":%lu,\"allocations\":%lu,"
+		"\"per_control_allocations\":%lu,\"rebuild_allocations\":%lu,\"node_bytes\":%zu,\"string_bytes\":%zu,"
+		"\"peak_rss_kb\":%ld,\"rss_growth_kb\":%ld}\n",
+		n, slabs, chunks, (unsigned long)slabs + chunks, 3ul * (unsigned long)n, (unsigned long)rebuild_slabs + rebuild_chunks,
+		built.node_bytes, built.string_bytes, rss_after, rss_after - rss_before);
+	fflush(stdout);
+}
+
+// n个控件存在时反复删除并重建控件
+static void bench_churn(int n) {
+	bench_begin();
+	for (int i = 0; i < n; i++) hgui.create.label(bench_ids[i], "main", "x", 0, 0, 10, 10);
+	double start = bench_now_ms();
+	for (int i = 0; i < n; i++) {
+		const char* id = bench_ids[bench_order[i]];
+		hgui.remove(id);
+		hgui.create.label(id, "main", "y", 0, 0, 10, 10);
+	}
+	bench_report("churn", n, n, bench_now_ms() - start);
+	bench_end();
+}
+
+// 向n个按钮的父窗口分发点击通知并调用回调
+static void bench_dispatch(int n) {
+	bench_begin();
+	HWND* hwnds = (HWND*)malloc((size_t)n * sizeof(HWND));
+	for (int i = 0; i < n; i++) {
+		hgui.create.button(bench_ids[i], "main", "b", 0, 0, 10, 10);
+		hgui.bind(bench_ids[i], "click", bench_on_click);
+		hwnds[i] = find_control(bench_ids[i])->hwnd;
+	}
+	bench_clicks = 0;
+	double start = bench_now_ms();
+	for (int i = 0; i < n; i++) hgui_headless_click(hwnds[bench_order[i]]);
+	bench_report("dispatch", n, n, bench_now_ms() - start);
+	if (bench_clicks != n) fprintf(stderr, "dispatch: 回调 %d/%d 次\n", bench_clicks, n);
+	free(hwnds);
+	bench_end();
+}
+
+// 逐行调用addItem向列表框添加n行（与批量添加对照）
+static void bench_listbox_fill_each(int n) {
+	bench_begin();
+	hgui.create.listbox("list", "main", 0, 0, 200, 400);
+	unsigned long messages = bench_messages_sent();
+	double start = bench_now_ms();
+	for (int i = 0; i < n; i++) hgui.addItem("list", bench_ids[i]);
+	bench_report_messages("listbox_fill_each", n, n, bench_now_ms() - start, bench_messages_sent() - messages);
+	bench_end();
+}
+
+// 一次向列表框添加n行
+static void bench_listbox_fill(int n) {
+	bench_begin();
+	hgui.create.listbox("list", "main", 0, 0, 200, 400);
+	const char** items = (const char**)malloc((size_t)n * sizeof(const char*));
+	for (int i = 0; i < n; i++) items[i] = bench_ids[i];
+	unsigned long messages = bench_messages_sent();
+	double start = bench_now_ms();
+	hgui.addItems("list", items, n);
+	bench_report_messages("listbox_fill", n, n, bench_now_ms() - start, bench_messages_sent() - messages);
+	free(items);
+	bench_end();
+}
+
+// 辅助函数：生成rows行文本，第edit_stride行起每隔edit_stride行替换一行（edit_stride为0时不修改）
+static char** bench_rows(int rows, int edit_stride) {
+	char** items = (char**)malloc((size_t)rows * sizeof(char*));
+	char* text = (char*)malloc((size_t)rows * BENCH_ID_LENGTH);
+	for (int i = 0; i < rows; i++) {
+		items[i] = text + (size_t)i * BENCH_ID_LENGTH;
+		bool edited = edit_stride > 0 && i % edit_stride == edit_stride / 2;
+		snprintf(items[i], BENCH_ID_LENGTH, edited ? "edit%d" : "row%d", i);
+	}
+	return items;
+}
+
+static void bench_rows_free(char** items) {
+	free(items[0]);
+	free(items);
+}
+
+// 两份n*BENCH_DIFF_ROWS行的快照之间有BENCH_DIFF_EDITS处分散的修改：分别测量计算哈希与计算差异
+static void bench_diff(int n) {
+	int rows = n * BENCH_DIFF_ROWS;
+	char** old_items = bench_rows(rows, 0);
+	char** new_items = bench_rows(rows, rows / BENCH_DIFF_EDITS);
+	uint64_t* old_hashes = (uint64_t*)malloc((size_t)rows * sizeof(uint64_t));
+	uint64_t* new_hashes = (uint64_t*)malloc((size_t)rows * sizeof(uint64_t));
+
+	double start = bench_now_ms();
+	for (int i = 0; i < rows; i++) new_hashes[i] = hgui_diff_hash(new_items[i]);
+	bench_report("diff_hash", rows, rows, bench_now_ms() - start);
+	for (int i = 0; i < rows; i++) old_hashes[i] = hgui_diff_hash(old_items[i]);
+
+	HGUI_Diff diff;
+	memset(&diff, 0, sizeof(diff));
+	HGUI_DiffStrings strings = { (const char* const*)old_items, old_hashes, (const char* const*)new_items, new_hashes };
+	start = bench_now_ms();
+	hgui_diff_strings(&diff, &strings, rows, rows, 0);
+	bench_report("diff", rows, rows, bench_now_ms() - start);
+	if (diff.count != BENCH_DIFF_EDITS || diff.over_budget) fprintf(stderr, "diff: %d段（预期%d段）\n", diff.count, BENCH_DIFF_EDITS);
+
+	hgui_diff_free(&diff);
+	free(old_hashes);
+	free(new_hashes);
+	bench_rows_free(old_items);
+	bench_rows_free(new_items);
+}
+
+// n行的列表框用setItems刷新为有BENCH_DIFF_EDITS处修改的内容（含计算差异与更新列表框）
+static void bench_set_items(int n) {
+	bench_begin();
+	hgui.create.listbox("list", "main", 0, 0, 200, 400);
+	char** old_items = bench_rows(n, 0);
+	char** new_items = bench_rows(n, n / BENCH_DIFF_EDITS);
+	hgui.setItems("list", (const char* const*)old_items, n, NULL);
+	HGUI_ListUpdate update;
+	double start = bench_now_ms();
+	hgui.setItems("list", (const char* const*)new_items, n, &update);
+	bench_report("set_items", n, n, bench_now_ms() - start);
+	if (update.hunks != BENCH_DIFF_EDITS) fprintf(stderr, "set_items: %d段（预期%d段）\n", update.hunks, BENCH_DIFF_EDITS);
+	bench_rows_free(old_items);
+	bench_rows_free(new_items);
+	bench_end();
+}
+
+// n个单选框按每组BENCH_RADIO_GROUP个分组，随机选中n次（同组其他单选框随之取消）
+static void bench_radio_toggle(int n) {
+	bench_begin();
+	for (int i = 0; i < n; i++) hgui.create.radio(bench_ids[i], "main", "r", 0, 0, 10, 10, i % BENCH_RADIO_GROUP == 0);
+	double start = bench_now_ms();
+	for (int i = 0; i < n; i++) hgui.setCheck(bench_ids[bench_order[i]], true);
+	bench_report("radio_toggle", n, n, bench_now_ms() - start);
+	bench_end();
+}
+
+// 释放含n个控件的界面
+static void bench_cleanup(int n) {
+	bench_begin();
+	for (int i = 0; i < n; i++) hgui.create.label(bench_ids[i], "main", "x", 0, 0, 10, 10);
+	double start = bench_now_ms();
+	hgui.cleanup();
+	bench_report("cleanup", n, n + 1, bench_now_ms() - start);
+	hgui_headless_reset();
+}
+
+int main(int argc, char** argv) {
+	int limit = argc > 1 ? atoi(argv[1]) : 100000;
+	static const int sizes[] = { 1000, 10000, 100000 };
+	if (limit >= BENCH_POOL_CONTROLS) {
+		bench_prepare(BENCH_POOL_CONTROLS);
+		bench_pool_cycle(BENCH_POOL_CONTROLS);
+		bench_release();
+	}
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		int n = sizes[s];
+		if (n > limit) break;
+		bench_prepare(n);
+		bench_create(n);
+		bench_lookup(n);
+		bench_lookup_linear(n);
+		bench_churn(n);
+		bench_dispatch(n);
+		bench_listbox_fill_each(n);
+		bench_listbox_fill(n);
+		bench_diff(n);
+		bench_set_items(n);
+		bench_radio_toggle(n);
+		bench_cleanup(n);
+		bench_release();
+	}
+	return 0;
+}
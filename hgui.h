@@ -1,388 +1,3497 @@
 #include "base.h"
+#include "hgui_uidesc.h"
+#include "hgui_diff.h"
+#include <stdarg.h>
+#include <stdio.h>
 
-// 全局变量
-static HINSTANCE hInstance;
-static HGUI_Control* controls = NULL;
-static HWND main_window_hwnd = NULL;
-static UINT_PTR next_menu_id = 1000;  // 菜单ID计数器
+#define HGUI_MENU_ID_BASE 1000
+#define HGUI_VIRTUAL_ROW_HEIGHT 18   // 虚拟列表框的行高（像素）
+#define WM_HGUI_WAKE (WM_APP + 0x4847)             // 唤醒UI线程应用队列的线程消息
+
+// 线程局部存储（每个线程的当前上下文）
+#if defined(__cplusplus)
+#define HGUI_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define HGUI_THREAD_LOCAL __declspec(thread)
+#else
+#define HGUI_THREAD_LOCAL __thread
+#endif
+
+// 上下文状态用到的类型（结构体定义在各自的模块中）
+typedef struct HGUI_Op HGUI_Op;
+typedef struct HGUI_ArenaChunk HGUI_ArenaChunk;
+typedef struct HGUI_SubscriptionNode HGUI_SubscriptionNode;
+typedef struct HGUI_DirtyRegion HGUI_DirtyRegion;
+
+// 资源账目：控件节点与HGUI创建的原生对象在创建/销毁处计数（hgui.memoryStats与cleanup时的泄漏检查）
+typedef struct {
+	unsigned long controls[HGUI_CONTROL_TYPE_COUNT];
+	unsigned long hwnds[HGUI_CONTROL_TYPE_COUNT];
+	unsigned long hmenus[HGUI_CONTROL_TYPE_COUNT];
+	unsigned long fonts;
+	unsigned long accel_tables;
+} HGUI_MemoryLedger;
+
+// 实例上下文：库的全部状态。每个上下文有自己的控件表、菜单ID空间、调度器与消息循环，
+// 只由运行其消息循环的线程访问（跨线程更新队列的入队除外），不同线程上的上下文之间没有共享状态
+struct HGUI_Context {
+	HINSTANCE hInstance;
+	HGUI_Control* controls;
+	HWND main_window_hwnd;
+	UINT_PTR menu_id_count;                 // 已分配的菜单ID数（菜单ID从HGUI_MENU_ID_BASE起连续分配）
+	DWORD ui_thread_id;                     // 运行消息循环的UI线程
+	HGUI_Control* text_update_target;       // 正在由程序设置文本的控件（其EN_CHANGE不触发事件）
+	bool initialized;                       // 已init且尚未cleanup
+	
+	// 跨线程更新队列
+	HGUI_Op* volatile op_queue_head;        // 生产者入栈的栈顶（最新的操作）
+	volatile LONG op_wake_pending;          // 是否已投递唤醒消息
+	HGUI_Op** op_seen;                      // 合并用的哈希表（仅UI线程访问）
+	size_t op_seen_capacity;
+	
+	// 定时器、空闲任务与帧任务的调度器（由消息循环驱动）
+	HGUI_Scheduler scheduler;
+	
+#ifdef HGUI_ENABLE_STATS
+	// 运行统计
+	HGUI_MessageStats stats_messages[HGUI_STATS_MAX_MESSAGES];
+	unsigned char stats_message_slots[HGUI_STATS_MAX_MESSAGES * 2];  // 消息到条目的开放寻址索引（条目下标+1）
+	size_t stats_message_count;
+	HGUI_TimingStats stats_other_messages;
+	HGUI_TimingStats stats_callbacks_total;
+	HGUI_TimingStats stats_drains;
+	HGUI_TimingStats stats_lookups;
+	HGUI_TimingStats stats_native_calls;
+	long long stats_start_ns;
+	long long stats_nested_ns;              // 当前处理的消息中嵌套发送的消息已用的时间
+#endif
+	HGUI_TaskId stats_dump_task;            // 周期性输出的调度任务
+	char* stats_dump_path;                  // 输出文件（NULL时输出到调试器）
+	bool stats_dump_json;
+	
+	// 控件ID哈希索引（开放寻址 + 线性探测，容量始终为2的幂）
+	HGUI_Control** id_index;
+	size_t id_index_capacity;
+	size_t id_index_count;
+	
+	// 资源账目
+	HGUI_MemoryLedger memory_ledger;
+	HGUI_LeakReport leak_report;            // 上一次cleanup的检查结果
+	
+	// 窗口句柄到控件的哈希索引（用于WM_COMMAND分发）
+	HGUI_Control** hwnd_index;
+	size_t hwnd_index_capacity;
+	size_t hwnd_index_count;
+	
+	// 菜单项分发表：以 menu_id - HGUI_MENU_ID_BASE 为下标
+	HGUI_Control** menu_index;
+	size_t menu_index_capacity;
+	
+	// 快捷键表：由菜单项的快捷键生成（命令ID即菜单ID），有改动时在消息循环中重建
+	HACCEL accel_table;
+	bool accel_dirty;
+	
+	// 控件节点池
+	HGUI_Control** slabs;                   // slab数组，每个slab含HGUI_SLAB_SIZE个节点
+	size_t slab_count;
+	size_t slab_capacity;
+	size_t slab_next_free;                  // 最后一个slab中下一个未使用节点的下标
+	HGUI_Control* free_controls;            // 已归还节点的空闲链表（经next串联）
+	unsigned int handle_epoch;              // 新节点的初始代数：大于上一个节点池中出现过的任何代数，使旧句柄在新节点池中失效
+	unsigned int handle_generation_max;     // 本节点池中出现过的最大代数
+	
+	// 字符串驻留区
+	HGUI_ArenaChunk* arena_chunks;
+	const char** intern_slots;              // 驻留表（开放寻址）
+	unsigned int* intern_hashes;            // 与intern_slots对应的哈希值
+	size_t intern_capacity;
+	size_t intern_count;
+	
+	// 字体缓存
+	HGUI_Font* font_cache;
+	
+	// 事件订阅表
+	HGUI_SubscriptionNode* subscription_nodes;
+	unsigned int subscription_count;        // 已使用过的槽位数
+	unsigned int subscription_capacity;
+	unsigned int subscription_free;         // 空闲节点链表（下标+1）
+	
+	// 布局树
+	HGUI_Layout layout_tree;
+	
+	// 输入录制
+	HGUI_TraceWriter trace_writer;
+	bool trace_recording;
+	long long trace_start_ns;
+	
+	// 批量更新事务
+	int update_depth;
+	HGUI_DirtyRegion* dirty_regions;
+	int dirty_region_count;
+	int dirty_region_capacity;
+	HGUI_Control** pending_controls;        // 有待处理状态的控件
+	int pending_count;
+	int pending_capacity;
+	HWND* menu_redraw_windows;              // 菜单栏有改动、提交时重绘一次的窗口
+	int menu_redraw_count;
+	int menu_redraw_capacity;
+	HGUI_UpdateStats update_stats;
+};
+
+// hgui命名空间的默认上下文，以及调用线程的当前上下文（库的全部函数都作用于当前上下文）
+static HGUI_Context default_context;
+static HGUI_THREAD_LOCAL HGUI_Context* hgui_ctx = &default_context;
+
+// 辅助函数：高精度单调时钟（纳秒）
+static long long now_ns(void) {
+	static HGUI_THREAD_LOCAL LARGE_INTEGER frequency;   // 每个线程各自缓存，多个UI线程之间不共享
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (long long)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+}
+
+// 辅助函数：调度器使用的毫秒时钟
+static long long scheduler_clock(void* context) {
+	(void)context;
+	return now_ns() / 1000000;
+}
+
+// 辅助函数：累计一次耗时
+static void stats_timing_add(HGUI_TimingStats* timing, long long ns) {
+	unsigned long long elapsed = ns > 0 ? (unsigned long long)ns : 0;
+	timing->count++;
+	timing->total_ns += elapsed;
+	if (elapsed > timing->max_ns) timing->max_ns = elapsed;
+}
+
+// 辅助函数：延迟直方图的桶（按微秒数的二进制位数分桶）
+static int stats_bucket(long long ns) {
+	unsigned long long us = ns > 0 ? (unsigned long long)ns / 1000 : 0;
+	int bucket = 0;
+	while (us && bucket < HGUI_STATS_BUCKETS - 1) {
+		us >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+// 运行统计：消息分发延迟、控件回调耗时、队列应用/查找/原生调用耗时。
+// 未定义 HGUI_ENABLE_STATS 时插桩宏为空，不产生任何开销。
+#ifdef HGUI_ENABLE_STATS
+#define HGUI_STATS_BEGIN(start) long long start = now_ns()
+#define HGUI_STATS_END(start, timing) stats_timing_add(&(timing), now_ns() - (start))
+#define HGUI_STATS_MESSAGE_ENTER(frame) HGUI_StatsFrame frame; stats_message_enter(&frame)
+#define HGUI_STATS_MESSAGE_LEAVE(message, frame) stats_message_leave((message), &frame)
+
+// 辅助函数：记录一次消息分发
+static void stats_record_message(UINT message, long long ns) {
+	size_t mask = HGUI_STATS_MAX_MESSAGES * 2 - 1;
+	size_t i = ((size_t)message * 2654435761u) & mask;
+	while (hgui_ctx->stats_message_slots[i] && hgui_ctx->stats_messages[hgui_ctx->stats_message_slots[i] - 1].message != message) {
+		i = (i + 1) & mask;
+	}
+	
+	if (!hgui_ctx->stats_message_slots[i]) {
+		if (hgui_ctx->stats_message_count == HGUI_STATS_MAX_MESSAGES) {
+			stats_timing_add(&hgui_ctx->stats_other_messages, ns);
+			return;
+		}
+		hgui_ctx->stats_messages[hgui_ctx->stats_message_count].message = message;
+		hgui_ctx->stats_message_slots[i] = (unsigned char)(++hgui_ctx->stats_message_count);
+	}
+	
+	HGUI_MessageStats* entry = &hgui_ctx->stats_messages[hgui_ctx->stats_message_slots[i] - 1];
+	stats_timing_add(&entry->timing, ns);
+	entry->histogram[stats_bucket(ns)]++;
+}
+
+// 窗口过程中一次消息处理的计时
+typedef struct {
+	long long start;
+	long long outer_nested;     // 外层消息此前累计的嵌套时间
+} HGUI_StatsFrame;
+
+// 辅助函数：进入窗口过程。发送的消息（子控件的WM_COMMAND、WM_SIZE、RedrawWindow引起的WM_PAINT等）
+// 不经过消息循环，因此在窗口过程的入口与出口计时
+static void stats_message_enter(HGUI_StatsFrame* frame) {
+	frame->outer_nested = hgui_ctx->stats_nested_ns;
+	hgui_ctx->stats_nested_ns = 0;
+	frame->start = now_ns();
+}
+
+// 辅助函数：离开窗口过程。只记录本层的时间（扣除处理期间嵌套发送的消息），
+// 嵌套的消息各自单独记录，外层不会重复计入
+static void stats_message_leave(UINT message, const HGUI_StatsFrame* frame) {
+	long long elapsed = now_ns() - frame->start;
+	stats_record_message(message, elapsed - hgui_ctx->stats_nested_ns);
+	hgui_ctx->stats_nested_ns = frame->outer_nested + elapsed;
+}
+
+// 辅助函数：调用控件回调并计时（回调中可能删除控件，因此通过句柄确认控件仍然有效）
+static HGUI_Control* resolve_handle(HGUI_Handle handle);
+static HGUI_Handle make_handle(const HGUI_Control* control);
+
+static void invoke_callback(HGUI_Control* control, void (*callback)(const char* id)) {
+	HGUI_Handle handle = make_handle(control);
+	long long start = now_ns();
+	callback(control->id);
+	long long elapsed = now_ns() - start;
+	
+	stats_timing_add(&hgui_ctx->stats_callbacks_total, elapsed);
+	control = resolve_handle(handle);
+	if (control) {
+		stats_timing_add(&control->callback_timing, elapsed);
+	}
+}
+
+static void invoke_subscriber(HGUI_Control* control, HGUI_Handle handle, HGUI_Event event,
+							  HGUI_EventCallback callback, void* user_data) {
+	long long start = now_ns();
+	callback(handle, event, user_data);
+	long long elapsed = now_ns() - start;
+	
+	stats_timing_add(&hgui_ctx->stats_callbacks_total, elapsed);
+	control = resolve_handle(handle);
+	if (control) {
+		stats_timing_add(&control->callback_timing, elapsed);
+	}
+}
+#else
+#define HGUI_STATS_BEGIN(start) ((void)0)
+#define HGUI_STATS_END(start, timing) ((void)0)
+#define HGUI_STATS_MESSAGE_ENTER(frame) ((void)0)
+#define HGUI_STATS_MESSAGE_LEAVE(message, frame) ((void)0)
+
+static void invoke_callback(HGUI_Control* control, void (*callback)(const char* id)) {
+	callback(control->id);
+}
+
+static void invoke_subscriber(HGUI_Control* control, HGUI_Handle handle, HGUI_Event event,
+							  HGUI_EventCallback callback, void* user_data) {
+	(void)control;
+	callback(handle, event, user_data);
+}
+#endif
+
+// 辅助函数：向原生控件发送消息（启用统计时计入原生调用耗时）
+static LRESULT native_send(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	HGUI_STATS_BEGIN(start);
+	LRESULT result = SendMessage(hwnd, message, wParam, lParam);
+	HGUI_STATS_END(start, hgui_ctx->stats_native_calls);
+	return result;
+}
 
 // 窗口过程声明
 LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+LRESULT CALLBACK CanvasProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+static void control_set_check(HGUI_Control* control, bool checked);
+static bool control_get_check(HGUI_Control* control);
+static void op_queue_drain(void);
+static void op_queue_discard(void);
 
-// 辅助函数：查找控件（公开供演示程序使用）
-HGUI_Control* find_control(const char* id) {
-	HGUI_Control* current = controls;
-	while (current) {
-		if (strcmp(current->id, id) == 0) {
-			return current;
+// 辅助函数：计算控件ID的哈希值（FNV-1a）
+static unsigned int hash_id(const char* id) {
+	unsigned int hash = 2166136261u;
+	while (*id) {
+		hash ^= (unsigned char)*id++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// 辅助函数：将控件放入索引槽位（调用前需保证有空闲槽位）
+static void id_index_place(HGUI_Control* control) {
+	size_t mask = hgui_ctx->id_index_capacity - 1;
+	size_t i = control->id_hash & mask;
+	while (hgui_ctx->id_index[i]) {
+		// ID重复时新控件占据槽位（与原链表查找“后创建者优先”的行为一致），
+		// 旧控件挂在新控件的id_shadowed上，新控件删除后重新可见
+		if (hgui_ctx->id_index[i]->id_hash == control->id_hash && strcmp(hgui_ctx->id_index[i]->id, control->id) == 0) {
+			control->id_shadowed = hgui_ctx->id_index[i];
+			hgui_ctx->id_index[i] = control;
+			return;
 		}
-		current = current->next;
+		i = (i + 1) & mask;
 	}
-	return NULL;
+	hgui_ctx->id_index[i] = control;
+	hgui_ctx->id_index_count++;
 }
 
-// 辅助函数：查找父窗口句柄
-static HWND find_parent_hwnd(const char* parent_id) {
-	if (parent_id == NULL) return NULL;
+// 辅助函数：扩容索引（负载因子保持在3/4以下）
+static bool id_index_reserve(size_t count) {
+	if (hgui_ctx->id_index && count * 4 < hgui_ctx->id_index_capacity * 3) return true;
 	
-	HGUI_Control* parent = find_control(parent_id);
-	if (parent) {
-		return parent->hwnd;
+	size_t capacity = hgui_ctx->id_index_capacity ? hgui_ctx->id_index_capacity : 64;
+	while (count * 4 >= capacity * 3) capacity *= 2;
+	
+	HGUI_Control** old_slots = hgui_ctx->id_index;
+	size_t old_capacity = hgui_ctx->id_index_capacity;
+	HGUI_Control** slots = (HGUI_Control**)calloc(capacity, sizeof(HGUI_Control*));
+	if (!slots) return false;
+	
+	hgui_ctx->id_index = slots;
+	hgui_ctx->id_index_capacity = capacity;
+	hgui_ctx->id_index_count = 0;
+	for (size_t i = 0; i < old_capacity; i++) {
+		if (old_slots[i]) id_index_place(old_slots[i]);
 	}
-	return NULL;
+	free(old_slots);
+	return true;
 }
 
-// 辅助函数：通过菜单ID查找菜单项
-static HGUI_Control* find_menu_item_by_id(UINT_PTR menu_id) {
-	HGUI_Control* current = controls;
-	while (current) {
-		if (current->type == HGUI_MENUITEM && current->menu_id == menu_id) {
-			return current;
+// 辅助函数：把控件加入索引（id_hash 已在分配时计算）
+static void id_index_insert(HGUI_Control* control) {
+	control->id_shadowed = NULL;
+	if (!id_index_reserve(hgui_ctx->id_index_count + 1)) return;
+	id_index_place(control);
+}
+
+// 辅助函数：从索引中移除控件（后移删除，无需墓碑标记）
+static void id_index_erase(HGUI_Control* control) {
+	if (!hgui_ctx->id_index) return;
+	
+	size_t mask = hgui_ctx->id_index_capacity - 1;
+	size_t i = control->id_hash & mask;
+	while (hgui_ctx->id_index[i] && (hgui_ctx->id_index[i]->id_hash != control->id_hash || strcmp(hgui_ctx->id_index[i]->id, control->id) != 0)) {
+		i = (i + 1) & mask;
+	}
+	if (!hgui_ctx->id_index[i]) return;
+	
+	// 被遮蔽的同名控件：从遮蔽链中摘除即可
+	if (hgui_ctx->id_index[i] != control) {
+		HGUI_Control* newer = hgui_ctx->id_index[i];
+		while (newer->id_shadowed && newer->id_shadowed != control) newer = newer->id_shadowed;
+		if (newer->id_shadowed) newer->id_shadowed = control->id_shadowed;
+		control->id_shadowed = NULL;
+		return;
+	}
+	
+	// 仍有较早的同名控件：由它接替槽位
+	if (control->id_shadowed) {
+		hgui_ctx->id_index[i] = control->id_shadowed;
+		control->id_shadowed = NULL;
+		return;
+	}
+	
+	// 将后续探测链上的元素前移，填补空位
+	size_t j = i;
+	while (true) {
+		j = (j + 1) & mask;
+		if (!hgui_ctx->id_index[j]) break;
+		size_t home = hgui_ctx->id_index[j]->id_hash & mask;
+		bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+		if (!stays) {
+			hgui_ctx->id_index[i] = hgui_ctx->id_index[j];
+			i = j;
 		}
-		current = current->next;
 	}
-	return NULL;
+	hgui_ctx->id_index[i] = NULL;
+	hgui_ctx->id_index_count--;
 }
 
-// 辅助函数：取消同组中其他单选框的选中状态
-static void uncheck_radio_group(const char* current_id) {
-	HGUI_Control* current_control = find_control(current_id);
-	if (!current_control || current_control->type != HGUI_RADIO) return;
-	
-	// 遍历所有单选框，取消同组中其他单选框的选中状态
-	HGUI_Control* control = controls;
-	while (control) {
-		if (control->type == HGUI_RADIO && 
-			strcmp(control->parent_id, current_control->parent_id) == 0 &&
-			strcmp(control->id, current_id) != 0) {
-			
-			hgui.setCheck(control->id, false);
+// 辅助函数：释放索引
+static void id_index_clear(void) {
+	free(hgui_ctx->id_index);
+	hgui_ctx->id_index = NULL;
+	hgui_ctx->id_index_capacity = 0;
+	hgui_ctx->id_index_count = 0;
+}
+
+// 辅助函数：判断控件是否独占自己的窗口句柄（菜单栏、菜单项和容器借用父窗口句柄）
+static bool owns_hwnd(const HGUI_Control* control) {
+	return control->hwnd && control->type != HGUI_MENUBAR && control->type != HGUI_MENUITEM && control->type != HGUI_BOX;
+}
+
+// 辅助函数：计算窗口句柄的哈希槽位
+static size_t hash_hwnd(HWND hwnd, size_t mask) {
+	UINT_PTR value = (UINT_PTR)hwnd;
+	value ^= value >> 16;
+	return (size_t)(value * 2654435761u) & mask;
+}
+
+// 辅助函数：将控件放入句柄索引槽位
+static void hwnd_index_place(HGUI_Control* control) {
+	size_t mask = hgui_ctx->hwnd_index_capacity - 1;
+	size_t i = hash_hwnd(control->hwnd, mask);
+	while (hgui_ctx->hwnd_index[i]) {
+		if (hgui_ctx->hwnd_index[i]->hwnd == control->hwnd) {
+			hgui_ctx->hwnd_index[i] = control;
+			return;
 		}
-		control = control->next;
+		i = (i + 1) & mask;
 	}
+	hgui_ctx->hwnd_index[i] = control;
+	hgui_ctx->hwnd_index_count++;
 }
 
-// 注册窗口类
-static void register_window_class(const char* class_name) {
-	WNDCLASSEX wc = {0};
-	wc.cbSize        = sizeof(WNDCLASSEX);
-	wc.style         = CS_VREDRAW | CS_HREDRAW | CS_DBLCLKS;
-	wc.lpfnWndProc   = WndProc;
-	wc.hInstance     = hInstance;
-	wc.hCursor       = LoadCursor(NULL, IDC_ARROW);
-	wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
-	wc.lpszClassName = class_name;
+// 辅助函数：把控件加入句柄索引
+static bool hwnd_index_reserve(size_t count) {
+	if (hgui_ctx->hwnd_index && count * 4 < hgui_ctx->hwnd_index_capacity * 3) return true;
 	
-	RegisterClassEx(&wc);
+	size_t capacity = hgui_ctx->hwnd_index_capacity ? hgui_ctx->hwnd_index_capacity : 64;
+	while (count * 4 >= capacity * 3) capacity *= 2;
+	
+	HGUI_Control** old_slots = hgui_ctx->hwnd_index;
+	size_t old_capacity = hgui_ctx->hwnd_index_capacity;
+	HGUI_Control** slots = (HGUI_Control**)calloc(capacity, sizeof(HGUI_Control*));
+	if (!slots) return false;
+	
+	hgui_ctx->hwnd_index = slots;
+	hgui_ctx->hwnd_index_capacity = capacity;
+	hgui_ctx->hwnd_index_count = 0;
+	for (size_t i = 0; i < old_capacity; i++) {
+		if (old_slots[i]) hwnd_index_place(old_slots[i]);
+	}
+	free(old_slots);
+	return true;
 }
 
-// 窗口过程实现
-LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
-	switch (msg) {
-		case WM_COMMAND: {
-		// 处理菜单项点击 (lParam为0表示菜单命令)
-		if (lParam == 0) {
-			UINT_PTR menu_id = (UINT_PTR)LOWORD(wParam);
-			HGUI_Control* item = find_menu_item_by_id(menu_id);
-			
-			if (item && item->click_callback) {
-				item->click_callback(item->id);
-				return 0;
-			}
+// 辅助函数：把控件加入句柄索引
+static void hwnd_index_insert(HGUI_Control* control) {
+	if (!hwnd_index_reserve(hgui_ctx->hwnd_index_count + 1)) return;
+	hwnd_index_place(control);
+}
+
+// 辅助函数：从句柄索引中移除控件（后移删除）
+static void hwnd_index_erase(HGUI_Control* control) {
+	if (!hgui_ctx->hwnd_index) return;
+	
+	size_t mask = hgui_ctx->hwnd_index_capacity - 1;
+	size_t i = hash_hwnd(control->hwnd, mask);
+	while (hgui_ctx->hwnd_index[i] && hgui_ctx->hwnd_index[i] != control) {
+		i = (i + 1) & mask;
+	}
+	if (!hgui_ctx->hwnd_index[i]) return;
+	
+	size_t j = i;
+	while (true) {
+		j = (j + 1) & mask;
+		if (!hgui_ctx->hwnd_index[j]) break;
+		size_t home = hash_hwnd(hgui_ctx->hwnd_index[j]->hwnd, mask);
+		bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+		if (!stays) {
+			hgui_ctx->hwnd_index[i] = hgui_ctx->hwnd_index[j];
+			i = j;
 		}
-		// 处理控件消息
-		else {
-			HWND child_hwnd = (HWND)lParam;
-			HGUI_Control* control = NULL;
-			
-			// 根据句柄查找控件
-			HGUI_Control* current = controls;
-			while (current) {
-				if (current->hwnd == child_hwnd) {
-					control = current;
-					break;
-				}
-				current = current->next;
-			}
-			
-			if (control) {
-				// 处理按钮点击
-				if (HIWORD(wParam) == BN_CLICKED && control->click_callback) {
-					control->click_callback(control->id);
-				}
-				// 处理列表框双击
-				else if (HIWORD(wParam) == LBN_DBLCLK && control->dblclick_callback) {
-					control->dblclick_callback(control->id);
-				}
-				// 处理单选框/复选框状态变化
-				else if ((control->type == HGUI_RADIO || control->type == HGUI_CHECKBOX) &&
-						 HIWORD(wParam) == BN_CLICKED) {
-					
-					// 对于单选框，先处理组内互斥
-					if (control->type == HGUI_RADIO) {
-						// 确保点击单选框时设置为选中状态
-						hgui.setCheck(control->id, true);
-						uncheck_radio_group(control->id);
-					}
-					// 对于复选框，切换状态
-					else if (control->type == HGUI_CHECKBOX) {
-						bool checked = hgui.getCheck(control->id);
-						hgui.setCheck(control->id, !checked);
-					}
-					
-					// 触发change事件
-					if (control->change_callback) {
-						control->change_callback(control->id);
-					}
-				}
-			}
+	}
+	hgui_ctx->hwnd_index[i] = NULL;
+	hgui_ctx->hwnd_index_count--;
+}
+
+// 辅助函数：通过窗口句柄查找控件
+static HGUI_Control* find_control_by_hwnd(HWND hwnd) {
+	if (!hwnd || !hgui_ctx->hwnd_index) return NULL;
+	
+	HGUI_STATS_BEGIN(start);
+	HGUI_Control* found = NULL;
+	size_t mask = hgui_ctx->hwnd_index_capacity - 1;
+	for (size_t i = hash_hwnd(hwnd, mask); hgui_ctx->hwnd_index[i]; i = (i + 1) & mask) {
+		if (hgui_ctx->hwnd_index[i]->hwnd == hwnd) {
+			found = hgui_ctx->hwnd_index[i];
+			break;
 		}
-		break;
 	}
+	HGUI_STATS_END(start, hgui_ctx->stats_lookups);
+	return found;
+}
+
+// 辅助函数：登记菜单项到分发表（菜单ID连续分配，数组保持稠密）
+static void menu_index_insert(HGUI_Control* item) {
+	if (item->menu_id < HGUI_MENU_ID_BASE) return;
+	
+	size_t slot = (size_t)(item->menu_id - HGUI_MENU_ID_BASE);
+	if (slot >= hgui_ctx->menu_index_capacity) {
+		size_t capacity = hgui_ctx->menu_index_capacity ? hgui_ctx->menu_index_capacity : 32;
+		while (capacity <= slot) capacity *= 2;
 		
-	case WM_DESTROY:
-		PostQuitMessage(0);
-		break;
-		
-	default:
-		return DefWindowProc(hwnd, msg, wParam, lParam);
+		HGUI_Control** slots = (HGUI_Control**)realloc(hgui_ctx->menu_index, capacity * sizeof(HGUI_Control*));
+		if (!slots) return;
+		memset(slots + hgui_ctx->menu_index_capacity, 0, (capacity - hgui_ctx->menu_index_capacity) * sizeof(HGUI_Control*));
+		hgui_ctx->menu_index = slots;
+		hgui_ctx->menu_index_capacity = capacity;
 	}
-	return 0;
+	hgui_ctx->menu_index[slot] = item;
 }
 
-// 核心功能实现
-static void hgui_init(void) {
-	hInstance = GetModuleHandle(NULL);
+// 辅助函数：从分发表移除菜单项
+static void menu_index_erase(HGUI_Control* item) {
+	if (item->menu_id < HGUI_MENU_ID_BASE) return;
+	
+	size_t slot = (size_t)(item->menu_id - HGUI_MENU_ID_BASE);
+	if (slot < hgui_ctx->menu_index_capacity && hgui_ctx->menu_index[slot] == item) {
+		hgui_ctx->menu_index[slot] = NULL;
+	}
+	if (item->accel_key) hgui_ctx->accel_dirty = true;
 }
 
-static int hgui_run(void) {
-	MSG msg;
-	while (GetMessage(&msg, NULL, 0, 0) > 0) {
-		TranslateMessage(&msg);
-		DispatchMessage(&msg);
+// 辅助函数：释放句柄索引、菜单分发表与快捷键表
+static void dispatch_index_clear(void) {
+	free(hgui_ctx->hwnd_index);
+	hgui_ctx->hwnd_index = NULL;
+	hgui_ctx->hwnd_index_capacity = 0;
+	hgui_ctx->hwnd_index_count = 0;
+	
+	free(hgui_ctx->menu_index);
+	hgui_ctx->menu_index = NULL;
+	hgui_ctx->menu_index_capacity = 0;
+	
+	if (hgui_ctx->accel_table) {
+		DestroyAcceleratorTable(hgui_ctx->accel_table);
+		hgui_ctx->memory_ledger.accel_tables--;
 	}
-	return (int)msg.wParam;
+	hgui_ctx->accel_table = NULL;
+	hgui_ctx->accel_dirty = false;
 }
 
-static void hgui_cleanup(void) {
-	// 释放所有控件
-	HGUI_Control* current = controls;
-	while (current) {
-		HGUI_Control* next = current->next;
-		
-		// 销毁窗口句柄
-		if (current->hwnd) {
-			DestroyWindow(current->hwnd);
+// 控件节点池：固定大小的slab整块分配，删除的节点进入空闲链表复用
+#define HGUI_SLAB_SIZE 256
+
+// 句柄编码：槽位占低20位（存储为槽位+1，保证有效句柄非0），代数占高12位
+#define HGUI_HANDLE_SLOT_BITS 20
+#define HGUI_HANDLE_SLOT_MASK ((1u << HGUI_HANDLE_SLOT_BITS) - 1)
+#define HGUI_HANDLE_GENERATION_MASK ((1u << (32 - HGUI_HANDLE_SLOT_BITS)) - 1)
+
+// 字符串驻留区：ID字符串按块追加存放，相同内容只保存一份
+#define HGUI_ARENA_CHUNK_SIZE 65536
+struct HGUI_ArenaChunk {
+	HGUI_ArenaChunk* next;
+	size_t used;
+	size_t capacity;
+};
+
+// 辅助函数：从驻留区分配字节
+static char* arena_alloc(size_t size) {
+	HGUI_ArenaChunk* chunk = hgui_ctx->arena_chunks;
+	if (!chunk || chunk->capacity - chunk->used < size) {
+		size_t capacity = size > HGUI_ARENA_CHUNK_SIZE ? size : HGUI_ARENA_CHUNK_SIZE;
+		chunk = (HGUI_ArenaChunk*)malloc(sizeof(HGUI_ArenaChunk) + capacity);
+		if (!chunk) return NULL;
+		chunk->used = 0;
+		chunk->capacity = capacity;
+		// 超大块挂在当前块之后，避免浪费当前块的剩余空间
+		if (hgui_ctx->arena_chunks && capacity > HGUI_ARENA_CHUNK_SIZE) {
+			chunk->next = hgui_ctx->arena_chunks->next;
+			hgui_ctx->arena_chunks->next = chunk;
+		} else {
+			chunk->next = hgui_ctx->arena_chunks;
+			hgui_ctx->arena_chunks = chunk;
 		}
-		
-		// 销毁菜单句柄
-		if (current->hmenu) {
-			DestroyMenu(current->hmenu);
+	}
+	char* data = (char*)(chunk + 1) + chunk->used;
+	chunk->used += size;
+	return data;
+}
+
+// 辅助函数：扩容驻留表
+static bool intern_reserve(size_t count) {
+	if (hgui_ctx->intern_slots && count * 4 < hgui_ctx->intern_capacity * 3) return true;
+	
+	size_t capacity = hgui_ctx->intern_capacity ? hgui_ctx->intern_capacity : 256;
+	while (count * 4 >= capacity * 3) capacity *= 2;
+	const char** slots = (const char**)calloc(capacity, sizeof(const char*));
+	unsigned int* hashes = (unsigned int*)calloc(capacity, sizeof(unsigned int));
+	if (!slots || !hashes) {
+		free((void*)slots);
+		free(hashes);
+		return false;
+	}
+	
+	size_t mask = capacity - 1;
+	for (size_t i = 0; i < hgui_ctx->intern_capacity; i++) {
+		if (!hgui_ctx->intern_slots[i]) continue;
+		size_t j = hgui_ctx->intern_hashes[i] & mask;
+		while (slots[j]) j = (j + 1) & mask;
+		slots[j] = hgui_ctx->intern_slots[i];
+		hashes[j] = hgui_ctx->intern_hashes[i];
+	}
+	free((void*)hgui_ctx->intern_slots);
+	free(hgui_ctx->intern_hashes);
+	hgui_ctx->intern_slots = slots;
+	hgui_ctx->intern_hashes = hashes;
+	hgui_ctx->intern_capacity = capacity;
+	return true;
+}
+
+// 辅助函数：驻留字符串，返回共享副本并输出其哈希值
+static const char* intern_string(const char* text, unsigned int* out_hash) {
+	unsigned int hash = hash_id(text);
+	if (out_hash) *out_hash = hash;
+	if (!intern_reserve(hgui_ctx->intern_count + 1)) return NULL;
+	
+	size_t mask = hgui_ctx->intern_capacity - 1;
+	size_t i = hash & mask;
+	while (hgui_ctx->intern_slots[i]) {
+		if (hgui_ctx->intern_hashes[i] == hash && strcmp(hgui_ctx->intern_slots[i], text) == 0) {
+			return hgui_ctx->intern_slots[i];
 		}
-		
-		// 释放内存
-		free(current->id);
-		if (current->parent_id) free(current->parent_id);
-		free(current);
-		
-		current = next;
+		i = (i + 1) & mask;
 	}
-	controls = NULL;
-	main_window_hwnd = NULL;
-	next_menu_id = 1000;
+	
+	size_t length = strlen(text) + 1;
+	char* copy = arena_alloc(length);
+	if (!copy) return NULL;
+	memcpy(copy, text, length);
+	
+	hgui_ctx->intern_slots[i] = copy;
+	hgui_ctx->intern_hashes[i] = hash;
+	hgui_ctx->intern_count++;
+	return copy;
 }
 
-// 控件操作实现
-static void hgui_remove(const char* id) {
-	if (!id) return;
-	
-	HGUI_Control* current = controls;
-	HGUI_Control* prev = NULL;
-	
-	// 查找要删除的控件
-	while (current) {
-		if (strcmp(current->id, id) == 0) {
-			// 从链表中移除控件
-			if (prev) {
-				prev->next = current->next;
-			} else {
-				controls = current->next;
-			}
-			
-			// 销毁窗口句柄
-			if (current->hwnd) {
-				DestroyWindow(current->hwnd);
-			}
-			
-			// 销毁菜单句柄
-			if (current->hmenu) {
-				DestroyMenu(current->hmenu);
-			}
-			
-			// 如果删除的是主窗口，更新主窗口句柄
-			if (current->type == HGUI_WINDOW && current->hwnd == main_window_hwnd) {
-				main_window_hwnd = NULL;
-			}
-			
-			// 释放内存
-			free(current->id);
-			if (current->parent_id) free(current->parent_id);
-			free(current);
-			return;
+// 辅助函数：分配一个控件节点（优先复用空闲链表）
+static HGUI_Control* pool_alloc_control(void) {
+	HGUI_Control* control = hgui_ctx->free_controls;
+	if (control) {
+		hgui_ctx->free_controls = control->next;
+		control->alive = true;
+		return control;
+	}
+	
+	if (hgui_ctx->slab_count == 0 || hgui_ctx->slab_next_free == HGUI_SLAB_SIZE) {
+		if (hgui_ctx->slab_count == hgui_ctx->slab_capacity) {
+			size_t capacity = hgui_ctx->slab_capacity ? hgui_ctx->slab_capacity * 2 : 16;
+			HGUI_Control** grown = (HGUI_Control**)realloc(hgui_ctx->slabs, capacity * sizeof(HGUI_Control*));
+			if (!grown) return NULL;
+			hgui_ctx->slabs = grown;
+			hgui_ctx->slab_capacity = capacity;
 		}
-		
-		prev = current;
-		current = current->next;
+		HGUI_Control* slab = (HGUI_Control*)malloc(HGUI_SLAB_SIZE * sizeof(HGUI_Control));
+		if (!slab) return NULL;
+		hgui_ctx->slabs[hgui_ctx->slab_count++] = slab;
+		hgui_ctx->slab_next_free = 0;
+	}
+	control = &hgui_ctx->slabs[hgui_ctx->slab_count - 1][hgui_ctx->slab_next_free];
+	control->slot = (unsigned int)((hgui_ctx->slab_count - 1) * HGUI_SLAB_SIZE + hgui_ctx->slab_next_free);
+	control->generation = hgui_ctx->handle_epoch & HGUI_HANDLE_GENERATION_MASK;
+	control->alive = true;
+	hgui_ctx->slab_next_free++;
+	return control;
+}
+
+// 辅助函数：归还控件节点到空闲链表（代数递增，旧句柄随之失效）
+static void pool_free_control(HGUI_Control* control) {
+	hgui_ctx->memory_ledger.controls[control->type]--;
+	control->alive = false;
+	// 代数用尽的节点退役，直到cleanup都不再复用，否则代数回绕后旧句柄会解析到新控件
+	if (control->generation == HGUI_HANDLE_GENERATION_MASK) return;
+	control->generation++;
+	if (control->generation > hgui_ctx->handle_generation_max) hgui_ctx->handle_generation_max = control->generation;
+	control->next = hgui_ctx->free_controls;
+	hgui_ctx->free_controls = control;
+}
+
+// 辅助函数：整体释放节点池与字符串驻留区
+static void pool_release_all(void) {
+	for (size_t i = 0; i < hgui_ctx->slab_count; i++) {
+		free(hgui_ctx->slabs[i]);
+	}
+	free(hgui_ctx->slabs);
+	hgui_ctx->slabs = NULL;
+	hgui_ctx->slab_count = 0;
+	hgui_ctx->slab_capacity = 0;
+	hgui_ctx->slab_next_free = 0;
+	hgui_ctx->free_controls = NULL;
+	hgui_ctx->handle_epoch = (hgui_ctx->handle_generation_max + 1) & HGUI_HANDLE_GENERATION_MASK;
+	hgui_ctx->handle_generation_max = hgui_ctx->handle_epoch;
+	
+	while (hgui_ctx->arena_chunks) {
+		HGUI_ArenaChunk* next = hgui_ctx->arena_chunks->next;
+		free(hgui_ctx->arena_chunks);
+		hgui_ctx->arena_chunks = next;
+	}
+	free((void*)hgui_ctx->intern_slots);
+	free(hgui_ctx->intern_hashes);
+	hgui_ctx->intern_slots = NULL;
+	hgui_ctx->intern_hashes = NULL;
+	hgui_ctx->intern_capacity = 0;
+	hgui_ctx->intern_count = 0;
+}
+
+// 辅助函数：为即将创建的count个控件预留slab数组容量
+static bool pool_reserve(size_t count) {
+	size_t available = (hgui_ctx->slab_count ? HGUI_SLAB_SIZE - hgui_ctx->slab_next_free : 0);
+	for (HGUI_Control* node = hgui_ctx->free_controls; node && available < count; node = node->next) {
+		available++;
+	}
+	if (available >= count) return true;
+	
+	size_t needed = hgui_ctx->slab_count + (count - available + HGUI_SLAB_SIZE - 1) / HGUI_SLAB_SIZE;
+	if (needed <= hgui_ctx->slab_capacity) return true;
+	
+	HGUI_Control** grown = (HGUI_Control**)realloc(hgui_ctx->slabs, needed * sizeof(HGUI_Control*));
+	if (!grown) return false;
+	hgui_ctx->slabs = grown;
+	hgui_ctx->slab_capacity = needed;
+	return true;
+}
+
+// 辅助函数：为即将创建的count个控件预留节点池、字符串驻留表与各索引
+static bool registry_reserve(size_t count) {
+	return pool_reserve(count) &&
+		   intern_reserve(hgui_ctx->intern_count + count) &&
+		   id_index_reserve(hgui_ctx->id_index_count + count) &&
+		   hwnd_index_reserve(hgui_ctx->hwnd_index_count + count);
+}
+
+// 辅助函数：分配并初始化控件结构体
+static HGUI_Control* alloc_control(const char* id, HGUI_Control* parent, HGUI_ControlType type) {
+	if (!id) return NULL;
+	
+	HGUI_Control* control = pool_alloc_control();
+	if (!control) return NULL;
+	
+	// 清零时保留节点池维护的句柄信息
+	unsigned int slot = control->slot;
+	unsigned int generation = control->generation;
+	memset(control, 0, sizeof(HGUI_Control));
+	control->slot = slot;
+	control->generation = generation;
+	control->alive = true;
+	
+	control->id = intern_string(id, &control->id_hash);
+	control->parent = parent;
+	control->parent_id = parent ? parent->id : NULL;
+	control->type = type;
+	hgui_ctx->memory_ledger.controls[type]++;
+	if (!control->id) {
+		pool_free_control(control);
+		return NULL;
+	}
+	return control;
+}
+
+// 辅助函数：生成控件句柄
+static HGUI_Handle make_handle(const HGUI_Control* control) {
+	if (!control || control->slot + 1 > HGUI_HANDLE_SLOT_MASK) return HGUI_INVALID_HANDLE;
+	return (control->generation << HGUI_HANDLE_SLOT_BITS) | (control->slot + 1);
+}
+
+// 辅助函数：解析控件句柄，句柄过期或越界时返回NULL
+static HGUI_Control* resolve_handle(HGUI_Handle handle) {
+	unsigned int slot = handle & HGUI_HANDLE_SLOT_MASK;
+	if (slot == 0) return NULL;
+	slot--;
+	
+	size_t slab = slot / HGUI_SLAB_SIZE;
+	size_t offset = slot % HGUI_SLAB_SIZE;
+	if (slab >= hgui_ctx->slab_count || (slab == hgui_ctx->slab_count - 1 && offset >= hgui_ctx->slab_next_free)) return NULL;
+	
+	HGUI_Control* control = &hgui_ctx->slabs[slab][offset];
+	if (!control->alive || control->generation != (handle >> HGUI_HANDLE_SLOT_BITS)) return NULL;
+	return control;
+}
+
+// 辅助函数：将新控件登记到链表与各索引
+static void register_control(HGUI_Control* control) {
+	// 追加到父控件的子控件链表尾部
+	HGUI_Control* parent = control->parent;
+	if (parent) {
+		control->prev_sibling = parent->last_child;
+		control->next_sibling = NULL;
+		if (parent->last_child) parent->last_child->next_sibling = control;
+		else parent->first_child = control;
+		parent->last_child = control;
+	}
+	
+	control->prev = NULL;
+	control->next = hgui_ctx->controls;
+	if (hgui_ctx->controls) hgui_ctx->controls->prev = control;
+	hgui_ctx->controls = control;
+	id_index_insert(control);
+	
+	if (owns_hwnd(control)) {
+		hwnd_index_insert(control);
+		hgui_ctx->memory_ledger.hwnds[control->type]++;
+	}
+	if (control->type == HGUI_MENUITEM) {
+		menu_index_insert(control);
+	}
+}
+
+// 辅助函数：从链表与各索引中注销控件
+static void unregister_control(HGUI_Control* control) {
+	if (control->prev) {
+		control->prev->next = control->next;
+	} else {
+		hgui_ctx->controls = control->next;
+	}
+	if (control->next) {
+		control->next->prev = control->prev;
+	}
+	id_index_erase(control);
+	
+	if (owns_hwnd(control)) {
+		hwnd_index_erase(control);
+	}
+	if (control->type == HGUI_MENUITEM) {
+		menu_index_erase(control);
+	}
+}
+
+// 辅助函数：查找控件（公开供演示程序使用）
+HGUI_Control* find_control(const char* id) {
+	if (!id || !hgui_ctx->id_index) return NULL;
+	
+	HGUI_STATS_BEGIN(start);
+	HGUI_Control* found = NULL;
+	unsigned int hash = hash_id(id);
+	size_t mask = hgui_ctx->id_index_capacity - 1;
+	for (size_t i = hash & mask; hgui_ctx->id_index[i]; i = (i + 1) & mask) {
+		HGUI_Control* control = hgui_ctx->id_index[i];
+		if (control->id_hash == hash && strcmp(control->id, id) == 0) {
+			found = control;
+			break;
+		}
+	}
+	HGUI_STATS_END(start, hgui_ctx->stats_lookups);
+	return found;
+}
+
+// 辅助函数：查找可作为父控件的控件（必须拥有或关联窗口句柄）
+static HGUI_Control* find_parent(const char* parent_id) {
+	if (parent_id == NULL) return NULL;
+	
+	HGUI_Control* parent = find_control(parent_id);
+	return parent && parent->hwnd ? parent : NULL;
+}
+
+// 辅助函数：通过菜单ID查找菜单项（直接数组下标）
+static HGUI_Control* find_menu_item_by_id(UINT_PTR menu_id) {
+	if (menu_id < HGUI_MENU_ID_BASE) return NULL;
+	
+	size_t slot = (size_t)(menu_id - HGUI_MENU_ID_BASE);
+	return slot < hgui_ctx->menu_index_capacity ? hgui_ctx->menu_index[slot] : NULL;
+}
+
+// 快捷键的按键名称（字母与数字的虚拟键码即其大写字符，F1~F24单独解析）
+static const struct {
+	const char* name;
+	WORD key;
+} accel_key_names[] = {
+	{ "Enter", VK_RETURN }, { "Tab", VK_TAB }, { "Esc", VK_ESCAPE }, { "Escape", VK_ESCAPE },
+	{ "Space", VK_SPACE }, { "Backspace", VK_BACK }, { "Del", VK_DELETE }, { "Delete", VK_DELETE },
+	{ "Ins", VK_INSERT }, { "Insert", VK_INSERT }, { "Home", VK_HOME }, { "End", VK_END },
+	{ "PgUp", VK_PRIOR }, { "PgDn", VK_NEXT }, { "Left", VK_LEFT }, { "Right", VK_RIGHT },
+	{ "Up", VK_UP }, { "Down", VK_DOWN }
+};
+
+// 辅助函数：不区分大小写地比较长度为length的片段与名称
+static bool accel_name_equals(const char* text, size_t length, const char* name) {
+	for (size_t i = 0; i < length; i++) {
+		char a = text[i];
+		char b = name[i];
+		if (b == '\0') return false;
+		if (a >= 'a' && a <= 'z') a = (char)(a - 'a' + 'A');
+		if (b >= 'a' && b <= 'z') b = (char)(b - 'a' + 'A');
+		if (a != b) return false;
+	}
+	return name[length] == '\0';
+}
+
+// 辅助函数：解析 "Ctrl+Shift+S" 形式的快捷键（修饰键可为Ctrl、Shift、Alt），无法识别时返回false
+static bool accel_parse(const char* text, BYTE* flags, WORD* key) {
+	*flags = FVIRTKEY;
+	*key = 0;
+	for (const char* plus = strchr(text, '+'); plus; plus = strchr(text, '+')) {
+		size_t length = (size_t)(plus - text);
+		if (accel_name_equals(text, length, "Ctrl")) *flags |= FCONTROL;
+		else if (accel_name_equals(text, length, "Shift")) *flags |= FSHIFT;
+		else if (accel_name_equals(text, length, "Alt")) *flags |= FALT;
+		else return false;
+		text = plus + 1;
+	}
+	
+	// 最后一段是按键
+	size_t length = strlen(text);
+	char c = text[0];
+	if (length == 1 && ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) {
+		*key = (WORD)c;
+	} else if (length == 1 && c >= 'a' && c <= 'z') {
+		*key = (WORD)(c - 'a' + 'A');
+	} else if ((c == 'F' || c == 'f') && length >= 2 && length <= 3) {
+		int number = 0;
+		for (size_t i = 1; i < length; i++) {
+			if (text[i] < '0' || text[i] > '9') return false;
+			number = number * 10 + (text[i] - '0');
+		}
+		if (number >= 1 && number <= 24) *key = (WORD)(VK_F1 + number - 1);
+	} else {
+		for (size_t i = 0; i < sizeof(accel_key_names) / sizeof(accel_key_names[0]); i++) {
+			if (accel_name_equals(text, length, accel_key_names[i].name)) {
+				*key = accel_key_names[i].key;
+				break;
+			}
+		}
+	}
+	return *key != 0;
+}
+
+// 辅助函数：设置菜单项的快捷键（accel为NULL时取消），快捷键表在消息循环中重建
+static bool menu_item_set_accel(HGUI_Control* item, const char* accel) {
+	if (item->menu_id < HGUI_MENU_ID_BASE) return false;
+	
+	BYTE flags = 0;
+	WORD key = 0;
+	if (accel && !accel_parse(accel, &flags, &key)) return false;
+	item->accel_flags = flags;
+	item->accel_key = key;
+	hgui_ctx->accel_dirty = true;
+	return true;
+}
+
+// 辅助函数：按菜单项的快捷键重建快捷键表
+static void accel_refresh(void) {
+	hgui_ctx->accel_dirty = false;
+	if (hgui_ctx->accel_table) {
+		DestroyAcceleratorTable(hgui_ctx->accel_table);
+		hgui_ctx->memory_ledger.accel_tables--;
+		hgui_ctx->accel_table = NULL;
+	}
+	
+	int count = 0;
+	for (size_t slot = 0; slot < hgui_ctx->menu_index_capacity; slot++) {
+		if (hgui_ctx->menu_index[slot] && hgui_ctx->menu_index[slot]->accel_key) count++;
+	}
+	if (count == 0) return;
+	
+	ACCEL* entries = (ACCEL*)malloc(count * sizeof(ACCEL));
+	if (!entries) return;
+	int index = 0;
+	for (size_t slot = 0; slot < hgui_ctx->menu_index_capacity; slot++) {
+		HGUI_Control* item = hgui_ctx->menu_index[slot];
+		if (!item || !item->accel_key) continue;
+		entries[index].fVirt = item->accel_flags;
+		entries[index].key = item->accel_key;
+		entries[index].cmd = (WORD)item->menu_id;
+		index++;
+	}
+	hgui_ctx->accel_table = CreateAcceleratorTable(entries, count);
+	if (hgui_ctx->accel_table) hgui_ctx->memory_ledger.accel_tables++;
+	free(entries);
+}
+
+// 单选框组：由 is_group_first 划分，成员按创建顺序连续存放，并缓存当前选中的成员
+struct HGUI_RadioGroup {
+	HGUI_Control** members;
+	int count;
+	int capacity;
+	HGUI_Control* checked;      // 当前选中的成员（无则为NULL）
+	HGUI_Handle owner;          // 组所在的父控件
+};
+
+// 辅助函数：将单选框加入组（组首或父控件尚无开放的组时新建一组）
+static void radio_group_join(HGUI_Control* radio, HGUI_Control* parent, bool is_group_first) {
+	HGUI_RadioGroup* group = parent->open_radio_group;
+	if (is_group_first || !group) {
+		group = (HGUI_RadioGroup*)calloc(1, sizeof(HGUI_RadioGroup));
+		if (!group) return;
+		group->owner = make_handle(parent);
+		parent->open_radio_group = group;
+	}
+	
+	if (group->count == group->capacity) {
+		int capacity = group->capacity ? group->capacity * 2 : 4;
+		HGUI_Control** members = (HGUI_Control**)realloc(group->members, capacity * sizeof(HGUI_Control*));
+		if (!members) return;
+		group->members = members;
+		group->capacity = capacity;
+	}
+	group->members[group->count++] = radio;
+	radio->radio_group = group;
+}
+
+// 辅助函数：将单选框移出所在的组，组为空时释放
+static void radio_group_leave(HGUI_Control* radio) {
+	HGUI_RadioGroup* group = radio->radio_group;
+	if (!group) return;
+	radio->radio_group = NULL;
+	
+	for (int i = 0; i < group->count; i++) {
+		if (group->members[i] == radio) {
+			memmove(&group->members[i], &group->members[i + 1], (group->count - i - 1) * sizeof(HGUI_Control*));
+			group->count--;
+			break;
+		}
+	}
+	if (group->checked == radio) {
+		group->checked = NULL;
+	}
+	
+	if (group->count == 0) {
+		HGUI_Control* owner = resolve_handle(group->owner);
+		if (owner && owner->open_radio_group == group) {
+			owner->open_radio_group = NULL;
+		}
+		free(group->members);
+		free(group);
+	}
+}
+
+// 字体缓存：按LOGFONT特征（字体名、字号、粗细、样式）共享HFONT，控件持有引用
+struct HGUI_Font {
+	HFONT hfont;
+	LOGFONT logfont;
+	unsigned int hash;
+	int refcount;
+	HGUI_Font* next;
+};
+
+// 辅助函数：计算字体特征的哈希值（FNV-1a）
+static unsigned int hash_logfont(const LOGFONT* lf) {
+	unsigned int hash = hash_id(lf->lfFaceName);
+	const LONG fields[] = { lf->lfHeight, lf->lfWeight, lf->lfItalic, lf->lfUnderline, lf->lfStrikeOut, lf->lfCharSet };
+	for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+		hash ^= (unsigned int)fields[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// 辅助函数：比较两个字体特征是否相同
+static bool logfont_equal(const LOGFONT* a, const LOGFONT* b) {
+	return a->lfHeight == b->lfHeight && a->lfWeight == b->lfWeight &&
+		   a->lfItalic == b->lfItalic && a->lfUnderline == b->lfUnderline &&
+		   a->lfStrikeOut == b->lfStrikeOut && a->lfCharSet == b->lfCharSet &&
+		   strcmp(a->lfFaceName, b->lfFaceName) == 0;
+}
+
+// 辅助函数：获取字体引用，缓存中没有时创建
+static HGUI_Font* font_acquire(const LOGFONT* lf) {
+	unsigned int hash = hash_logfont(lf);
+	for (HGUI_Font* font = hgui_ctx->font_cache; font; font = font->next) {
+		if (font->hash == hash && logfont_equal(&font->logfont, lf)) {
+			font->refcount++;
+			return font;
+		}
+	}
+	
+	HFONT hfont = CreateFontIndirect(lf);
+	if (!hfont) return NULL;
+	
+	HGUI_Font* font = (HGUI_Font*)malloc(sizeof(HGUI_Font));
+	if (!font) {
+		DeleteObject(hfont);
+		return NULL;
+	}
+	hgui_ctx->memory_ledger.fonts++;
+	font->hfont = hfont;
+	font->logfont = *lf;
+	font->hash = hash;
+	font->refcount = 1;
+	font->next = hgui_ctx->font_cache;
+	hgui_ctx->font_cache = font;
+	return font;
+}
+
+// 辅助函数：释放字体引用，引用计数归零时删除字体对象
+static void font_release(HGUI_Font* font) {
+	if (!font || --font->refcount > 0) return;
+	
+	HGUI_Font** link = &hgui_ctx->font_cache;
+	while (*link && *link != font) {
+		link = &(*link)->next;
+	}
+	if (*link) *link = font->next;
+	
+	DeleteObject(font->hfont);
+	hgui_ctx->memory_ledger.fonts--;
+	free(font);
+}
+
+// 辅助函数：读取默认GUI字体的特征
+static void default_logfont(LOGFONT* lf) {
+	memset(lf, 0, sizeof(LOGFONT));
+	GetObject(GetStockObject(DEFAULT_GUI_FONT), sizeof(LOGFONT), lf);
+}
+
+// 辅助函数：为控件应用基础字体或其粗体版本
+static void control_apply_font(HGUI_Control* control, bool bold) {
+	HGUI_Font* font = NULL;
+	if (bold) {
+		LOGFONT lf;
+		if (control->base_font) {
+			lf = control->base_font->logfont;
+		} else {
+			default_logfont(&lf);
+		}
+		lf.lfWeight = FW_BOLD;
+		font = font_acquire(&lf);
+	} else if (control->base_font) {
+		font = control->base_font;
+		font->refcount++;
+	}
+	
+	HFONT hfont = font ? font->hfont : (HFONT)GetStockObject(DEFAULT_GUI_FONT);
+	native_send(control->hwnd, WM_SETFONT, (WPARAM)hfont, TRUE);
+	
+	// 新字体生效后再释放旧引用
+	font_release(control->font);
+	control->font = font;
+}
+
+// 辅助函数：释放控件持有的全部字体引用
+static void control_release_fonts(HGUI_Control* control) {
+	font_release(control->font);
+	font_release(control->base_font);
+	control->font = NULL;
+	control->base_font = NULL;
+}
+
+// 辅助函数：清空字体缓存（cleanup时控件已全部释放引用，此处兜底）
+static void font_cache_clear(void) {
+	while (hgui_ctx->font_cache) {
+		HGUI_Font* next = hgui_ctx->font_cache->next;
+		DeleteObject(hgui_ctx->font_cache->hfont);
+		hgui_ctx->memory_ledger.fonts--;
+		free(hgui_ctx->font_cache);
+		hgui_ctx->font_cache = next;
+	}
+}
+
+// 辅助函数：计算文本哈希并返回长度（FNV-1a）
+static unsigned int hash_text(const char* text, size_t* length) {
+	unsigned int hash = 2166136261u;
+	const char* p = text;
+	while (*p) {
+		hash ^= (unsigned char)*p++;
+		hash *= 16777619u;
+	}
+	*length = (size_t)(p - text);
+	return hash;
+}
+
+// 辅助函数：为文本缓存预留空间
+static bool text_reserve(HGUI_Control* control, size_t length) {
+	if (length + 1 <= control->text_capacity) return true;
+	
+	size_t capacity = control->text_capacity ? control->text_capacity : 16;
+	while (capacity < length + 1) capacity *= 2;
+	char* text = (char*)realloc(control->text, capacity);
+	if (!text) return false;
+	control->text = text;
+	control->text_capacity = capacity;
+	return true;
+}
+
+// 辅助函数：更新文本缓存（text可能指向缓存自身的一部分）
+static void text_store(HGUI_Control* control, const char* text, size_t length, unsigned int hash) {
+	if (!text_reserve(control, length)) {
+		control->text_valid = false;
+		return;
+	}
+	memmove(control->text, text, length);
+	control->text[length] = '\0';
+	control->text_length = length;
+	control->text_hash = hash;
+	control->text_valid = true;
+}
+
+// 辅助函数：从原生控件同步文本缓存
+static void text_sync(HGUI_Control* control) {
+	int length = (int)native_send(control->hwnd, WM_GETTEXTLENGTH, 0, 0);
+	if (length < 0 || !text_reserve(control, (size_t)length)) return;
+	
+	length = (int)native_send(control->hwnd, WM_GETTEXT, (WPARAM)(length + 1), (LPARAM)control->text);
+	control->text[length > 0 ? length : 0] = '\0';
+	control->text_hash = hash_text(control->text, &control->text_length);
+	control->text_valid = true;
+}
+
+// 辅助函数：取得缓存的文本（按需同步），失败时返回NULL
+static const char* control_text_view(HGUI_Control* control) {
+	if (!control || !owns_hwnd(control)) return NULL;
+	if (!control->text_valid) text_sync(control);
+	return control->text_valid ? control->text : NULL;
+}
+
+// 辅助函数：释放文本缓存
+static void control_release_text(HGUI_Control* control) {
+	free(control->text);
+	control->text = NULL;
+	control->text_capacity = 0;
+	control->text_valid = false;
+}
+
+// 事件订阅表：节点存放在可增长的数组中并以下标相连，退订的节点进入空闲链表复用，
+// 分发时只遍历控件的订阅链表，不分配内存
+struct HGUI_SubscriptionNode {
+	HGUI_EventCallback callback;    // NULL表示已退订、等待回收
+	void* user_data;
+	HGUI_Control* owner;
+	HGUI_Event event;
+	unsigned int generation;
+	unsigned int prev;              // 链表前后节点（下标+1，0表示无）
+	unsigned int next;
+};
+
+#define HGUI_SUBSCRIPTION_SLOT_BITS 20
+#define HGUI_SUBSCRIPTION_SLOT_MASK ((1u << HGUI_SUBSCRIPTION_SLOT_BITS) - 1)
+#define HGUI_SUBSCRIPTION_GENERATION_MASK (~0u >> HGUI_SUBSCRIPTION_SLOT_BITS)
+
+// 辅助函数：分配订阅节点，失败返回-1
+static int subscription_alloc(void) {
+	if (hgui_ctx->subscription_free) {
+		unsigned int index = hgui_ctx->subscription_free - 1;
+		hgui_ctx->subscription_free = hgui_ctx->subscription_nodes[index].next;
+		return (int)index;
+	}
+	if (hgui_ctx->subscription_count == hgui_ctx->subscription_capacity) {
+		if (hgui_ctx->subscription_capacity >= HGUI_SUBSCRIPTION_SLOT_MASK) return -1;
+		unsigned int capacity = hgui_ctx->subscription_capacity ? hgui_ctx->subscription_capacity * 2 : 64;
+		HGUI_SubscriptionNode* nodes = (HGUI_SubscriptionNode*)realloc(hgui_ctx->subscription_nodes, capacity * sizeof(HGUI_SubscriptionNode));
+		if (!nodes) return -1;
+		hgui_ctx->subscription_nodes = nodes;
+		hgui_ctx->subscription_capacity = capacity;
+	}
+	hgui_ctx->subscription_nodes[hgui_ctx->subscription_count].generation = 0;
+	return (int)hgui_ctx->subscription_count++;
+}
+
+// 辅助函数：使订阅失效（代数递增，旧ID无法再解析）
+static void subscription_retire(unsigned int index) {
+	HGUI_SubscriptionNode* node = &hgui_ctx->subscription_nodes[index];
+	node->callback = NULL;
+	if (node->generation < HGUI_SUBSCRIPTION_GENERATION_MASK) node->generation++;
+}
+
+// 辅助函数：归还节点到空闲链表（代数用尽的节点退役，不再复用，旧ID不会指向新订阅）
+static void subscription_release(unsigned int index) {
+	hgui_ctx->subscription_nodes[index].owner = NULL;
+	if (hgui_ctx->subscription_nodes[index].generation == HGUI_SUBSCRIPTION_GENERATION_MASK) return;
+	hgui_ctx->subscription_nodes[index].next = hgui_ctx->subscription_free;
+	hgui_ctx->subscription_free = index + 1;
+}
+
+static HGUI_Subscription subscription_make_id(unsigned int index) {
+	return (hgui_ctx->subscription_nodes[index].generation << HGUI_SUBSCRIPTION_SLOT_BITS) | (index + 1);
+}
+
+// 辅助函数：解析订阅ID，无效或已退订时返回-1
+static int subscription_resolve(HGUI_Subscription id) {
+	unsigned int slot = id & HGUI_SUBSCRIPTION_SLOT_MASK;
+	if (slot == 0 || slot > hgui_ctx->subscription_count) return -1;
+	HGUI_SubscriptionNode* node = &hgui_ctx->subscription_nodes[slot - 1];
+	if (!node->callback || node->generation != id >> HGUI_SUBSCRIPTION_SLOT_BITS) return -1;
+	return (int)(slot - 1);
+}
+
+// 辅助函数：从控件的订阅链表中摘除节点
+static void subscription_unlink(HGUI_Control* control, unsigned int index) {
+	HGUI_SubscriptionNode* node = &hgui_ctx->subscription_nodes[index];
+	if (node->prev) hgui_ctx->subscription_nodes[node->prev - 1].next = node->next;
+	else control->subscribers = node->next;
+	if (node->next) hgui_ctx->subscription_nodes[node->next - 1].prev = node->prev;
+	else control->subscribers_tail = node->prev;
+}
+
+// 辅助函数：重新计算控件有订阅者的事件位
+static void subscription_update_mask(HGUI_Control* control) {
+	unsigned int mask = 0;
+	for (unsigned int cursor = control->subscribers; cursor; cursor = hgui_ctx->subscription_nodes[cursor - 1].next) {
+		if (hgui_ctx->subscription_nodes[cursor - 1].callback) mask |= 1u << hgui_ctx->subscription_nodes[cursor - 1].event;
+	}
+	control->event_mask = mask;
+}
+
+// 辅助函数：回收分发期间退订的节点
+static void subscription_sweep(HGUI_Control* control) {
+	unsigned int cursor = control->subscribers;
+	while (cursor) {
+		unsigned int next = hgui_ctx->subscription_nodes[cursor - 1].next;
+		if (!hgui_ctx->subscription_nodes[cursor - 1].callback) {
+			subscription_unlink(control, cursor - 1);
+			subscription_release(cursor - 1);
+		}
+		cursor = next;
+	}
+	control->subscribers_dirty = false;
+	subscription_update_mask(control);
+}
+
+// 辅助函数：释放控件的全部订阅（控件删除时调用）
+static void control_release_subscriptions(HGUI_Control* control) {
+	unsigned int cursor = control->subscribers;
+	while (cursor) {
+		unsigned int next = hgui_ctx->subscription_nodes[cursor - 1].next;
+		subscription_retire(cursor - 1);
+		subscription_release(cursor - 1);
+		cursor = next;
+	}
+	control->subscribers = control->subscribers_tail = 0;
+	control->event_mask = 0;
+	control->subscribers_dirty = false;
+}
+
+// 辅助函数：释放整个订阅表（cleanup时调用）
+static void subscription_table_clear(void) {
+	free(hgui_ctx->subscription_nodes);
+	hgui_ctx->subscription_nodes = NULL;
+	hgui_ctx->subscription_count = hgui_ctx->subscription_capacity = hgui_ctx->subscription_free = 0;
+}
+
+// 辅助函数：订阅控件事件（追加到链表尾部，按订阅顺序通知）
+static HGUI_Subscription control_subscribe(HGUI_Control* control, HGUI_Event event, HGUI_EventCallback callback, void* user_data) {
+	if (!control || !callback || (unsigned int)event >= HGUI_EVENT_COUNT) return HGUI_INVALID_SUBSCRIPTION;
+	
+	int index = subscription_alloc();
+	if (index < 0) return HGUI_INVALID_SUBSCRIPTION;
+	
+	HGUI_SubscriptionNode* node = &hgui_ctx->subscription_nodes[index];
+	node->callback = callback;
+	node->user_data = user_data;
+	node->owner = control;
+	node->event = event;
+	node->prev = control->subscribers_tail;
+	node->next = 0;
+	if (node->prev) hgui_ctx->subscription_nodes[node->prev - 1].next = (unsigned int)index + 1;
+	else control->subscribers = (unsigned int)index + 1;
+	control->subscribers_tail = (unsigned int)index + 1;
+	control->event_mask |= 1u << event;
+	return subscription_make_id((unsigned int)index);
+}
+
+// 辅助函数：触发控件事件：先调用bind绑定的回调，再按订阅顺序通知订阅者。
+// 回调中可以订阅、退订或删除控件；本次分发中新增的订阅留到下一次事件
+static void control_dispatch(HGUI_Control* control, HGUI_Event event, void (*callback)(const char* id)) {
+	HGUI_Handle handle = make_handle(control);
+	if (callback) {
+		invoke_callback(control, callback);
+		control = resolve_handle(handle);
+		if (!control) return;
+	}
+	if (!(control->event_mask & (1u << event))) return;
+	
+	control->dispatch_depth++;
+	unsigned int last = control->subscribers_tail;
+	unsigned int cursor = control->subscribers;
+	while (cursor) {
+		HGUI_SubscriptionNode* node = &hgui_ctx->subscription_nodes[cursor - 1];
+		if (node->callback && node->event == event) {
+			invoke_subscriber(control, handle, event, node->callback, node->user_data);
+			
+			// 控件在回调中被删除时，其订阅已全部释放
+			control = resolve_handle(handle);
+			if (!control) return;
+		}
+		// 分发期间退订的节点仍留在链表中，因此可以继续向后遍历
+		if (cursor == last) break;
+		cursor = hgui_ctx->subscription_nodes[cursor - 1].next;
+	}
+	if (--control->dispatch_depth == 0 && control->subscribers_dirty) {
+		subscription_sweep(control);
+	}
+}
+
+// 辅助函数：计算可见行范围 [first, last]，无可见行时返回false（纯算术，不依赖窗口）
+static bool visible_row_range(int top_index, int client_height, int row_height, int row_count,
+							  int* first, int* last) {
+	if (row_count <= 0 || row_height <= 0 || client_height <= 0) return false;
+	if (top_index < 0) top_index = 0;
+	if (top_index >= row_count) return false;
+	
+	// 最后一行可能只露出一部分，同样需要绘制
+	int visible = (client_height + row_height - 1) / row_height;
+	int end = top_index + visible - 1;
+	if (end >= row_count) end = row_count - 1;
+	
+	*first = top_index;
+	*last = end;
+	return true;
+}
+
+// 辅助函数：绘制虚拟列表框的一行
+static void draw_virtual_row(HGUI_Control* control, const DRAWITEMSTRUCT* dis) {
+	bool selected = (dis->itemState & ODS_SELECTED) != 0;
+	RECT rect = dis->rcItem;
+	FillRect(dis->hDC, &rect, GetSysColorBrush(selected ? COLOR_HIGHLIGHT : COLOR_WINDOW));
+	
+	if (dis->itemID != (UINT)-1 && (int)dis->itemID < control->row_count && control->row_callback) {
+		const char* text = control->row_callback((int)dis->itemID, control->row_context);
+		if (text) {
+			SetBkMode(dis->hDC, TRANSPARENT);
+			SetTextColor(dis->hDC, GetSysColor(selected ? COLOR_HIGHLIGHTTEXT : COLOR_WINDOWTEXT));
+			rect.left += 2;
+			DrawText(dis->hDC, text, -1, &rect, DT_SINGLELINE | DT_VCENTER | DT_NOPREFIX | DT_END_ELLIPSIS);
+		}
+	}
+	
+	if (dis->itemState & ODS_FOCUS) {
+		DrawFocusRect(dis->hDC, &dis->rcItem);
+	}
+}
+
+// 列表模型：列表框内容的快照（行文本连续存放并附带哈希）。hgui.setItems把新内容与快照比较，
+// 只插入/删除变化的行；其他列表操作直接修改列表框，同时丢弃快照，下次设置时从列表框重新读取
+typedef struct {
+	char* text;             // 全部行文本，以'\0'分隔
+	const char** rows;      // 各行在text中的起点
+	uint64_t* hashes;
+	int count;
+	size_t bytes;           // 以上三块内存的总字节数
+} HGUI_ListSnapshot;
+
+struct HGUI_ListModel {
+	HGUI_ListSnapshot snapshot;
+	HGUI_Diff diff;         // 复用的差异结果
+};
+
+static void list_snapshot_free(HGUI_ListSnapshot* snapshot) {
+	free(snapshot->text);
+	free((void*)snapshot->rows);
+	free(snapshot->hashes);
+	memset(snapshot, 0, sizeof(HGUI_ListSnapshot));
+}
+
+// 辅助函数：为count行、共bytes字节（含结尾'\0'）的快照分配内存
+static bool list_snapshot_alloc(HGUI_ListSnapshot* snapshot, int count, size_t bytes) {
+	memset(snapshot, 0, sizeof(HGUI_ListSnapshot));
+	snapshot->text = (char*)malloc(bytes > 0 ? bytes : 1);
+	snapshot->rows = (const char**)malloc((count > 0 ? (size_t)count : 1) * sizeof(const char*));
+	snapshot->hashes = (uint64_t*)malloc((count > 0 ? (size_t)count : 1) * sizeof(uint64_t));
+	if (!snapshot->text || !snapshot->rows || !snapshot->hashes) {
+		list_snapshot_free(snapshot);
+		return false;
+	}
+	snapshot->count = count;
+	snapshot->bytes = (bytes > 0 ? bytes : 1) + (count > 0 ? (size_t)count : 1) * (sizeof(const char*) + sizeof(uint64_t));
+	return true;
+}
+
+// 辅助函数：复制一组行文本为快照（NULL按空字符串处理）
+static bool list_snapshot_build(HGUI_ListSnapshot* snapshot, const char* const* items, int count) {
+	size_t bytes = 0;
+	for (int i = 0; i < count; i++) {
+		bytes += (items[i] ? strlen(items[i]) : 0) + 1;
+	}
+	if (!list_snapshot_alloc(snapshot, count, bytes)) return false;
+	
+	char* cursor = snapshot->text;
+	for (int i = 0; i < count; i++) {
+		size_t length = items[i] ? strlen(items[i]) : 0;
+		memcpy(cursor, items[i] ? items[i] : "", length + 1);
+		snapshot->rows[i] = cursor;
+		snapshot->hashes[i] = hgui_diff_hash(cursor);
+		cursor += length + 1;
+	}
+	return true;
+}
+
+// 辅助函数：从列表框读取当前内容为快照
+static bool list_snapshot_capture(HGUI_ListSnapshot* snapshot, HGUI_Control* control) {
+	int count = (int)native_send(control->hwnd, LB_GETCOUNT, 0, 0);
+	if (count < 0) count = 0;
+	size_t bytes = 0;
+	for (int i = 0; i < count; i++) {
+		LRESULT length = native_send(control->hwnd, LB_GETTEXTLEN, (WPARAM)i, 0);
+		bytes += (length > 0 ? (size_t)length : 0) + 1;
+	}
+	if (!list_snapshot_alloc(snapshot, count, bytes)) return false;
+	
+	char* cursor = snapshot->text;
+	for (int i = 0; i < count; i++) {
+		LRESULT length = native_send(control->hwnd, LB_GETTEXTLEN, (WPARAM)i, 0);
+		if (length > 0) native_send(control->hwnd, LB_GETTEXT, (WPARAM)i, (LPARAM)cursor);
+		else length = 0;
+		cursor[length] = '\0';
+		snapshot->rows[i] = cursor;
+		snapshot->hashes[i] = hgui_diff_hash(cursor);
+		cursor += length + 1;
+	}
+	return true;
+}
+
+// 辅助函数：丢弃列表框的快照（列表被其他操作修改或控件删除时调用）
+static void list_model_release(HGUI_Control* control) {
+	if (!control->list_model) return;
+	list_snapshot_free(&control->list_model->snapshot);
+	hgui_diff_free(&control->list_model->diff);
+	free(control->list_model);
+	control->list_model = NULL;
+}
+
+// 画布：离屏32位帧缓冲。绘制只写入帧缓冲并记录脏矩形，每帧由帧任务把脏矩形传输到窗口；
+// WM_PAINT 只传输系统要求重绘的区域（首次显示、被遮挡后露出等），不擦除背景，因此不会闪烁
+struct HGUI_Canvas {
+	HGUI_Surface surface;
+	HGUI_DirtyRects dirty;      // 自上次传输以来修改过的区域
+};
+
+// 辅助函数：按ID查找画布控件
+static HGUI_Control* find_canvas(const char* id) {
+	HGUI_Control* control = find_control(id);
+	return control && control->type == HGUI_CANVAS && control->canvas ? control : NULL;
+}
+
+// 辅助函数：把帧缓冲的一个区域传输到设备上下文。
+// DIB只描述这些行（自顶向下），源起点因此恒为第0行，不必换算自底向上的坐标
+static void canvas_blit(HDC dc, const HGUI_Surface* surface, HGUI_RasterRect rect) {
+	HGUI_RasterRect bounds = { 0, 0, surface->width, surface->height };
+	rect = hgui_rect_intersect(rect, bounds);
+	if (hgui_rect_empty(rect)) return;
+	
+	int width = rect.right - rect.left;
+	int height = rect.bottom - rect.top;
+	BITMAPINFO info;
+	memset(&info, 0, sizeof(info));
+	info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	info.bmiHeader.biWidth = surface->stride;
+	info.bmiHeader.biHeight = -height;
+	info.bmiHeader.biPlanes = 1;
+	info.bmiHeader.biBitCount = 32;
+	info.bmiHeader.biCompression = BI_RGB;
+	SetDIBitsToDevice(dc, rect.left, rect.top, (DWORD)width, (DWORD)height, rect.left, 0, 0, (UINT)height,
+					  hgui_surface_row(surface, rect.top), &info, DIB_RGB_COLORS);
+}
+
+// 辅助函数：帧任务，把画布的脏矩形传输到窗口（同一帧内多次绘制只传输一次）
+static void canvas_present(void* user_data) {
+	HGUI_Control* control = resolve_handle((HGUI_Handle)(uintptr_t)user_data);
+	if (!control || !control->canvas || control->canvas->dirty.count == 0) return;
+	
+	HGUI_Canvas* canvas = control->canvas;
+	HDC dc = GetDC(control->hwnd);
+	if (dc) {
+		for (int i = 0; i < canvas->dirty.count; i++) {
+			canvas_blit(dc, &canvas->surface, canvas->dirty.rects[i]);
+		}
+		ReleaseDC(control->hwnd, dc);
+	}
+	hgui_dirty_clear(&canvas->dirty);
+}
+
+// 辅助函数：记录画布的脏矩形，并请求在下一帧传输
+static void canvas_mark(HGUI_Control* control, HGUI_RasterRect rect) {
+	if (hgui_rect_empty(rect)) return;
+	hgui_dirty_add(&control->canvas->dirty, rect);
+	hgui_sched_frame(&hgui_ctx->scheduler, canvas_present, (void*)(uintptr_t)make_handle(control));
+}
+
+// 辅助函数：释放画布的帧缓冲（控件删除时调用）
+static void canvas_release(HGUI_Control* control) {
+	if (!control->canvas) return;
+	hgui_surface_free(&control->canvas->surface);
+	free(control->canvas);
+	control->canvas = NULL;
+}
+
+// 画布的窗口过程
+static LRESULT canvas_proc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+	switch (msg) {
+		case WM_ERASEBKGND:
+			// 背景由帧缓冲完整覆盖，擦除只会造成闪烁
+			return 1;
+		
+		case WM_PAINT: {
+			PAINTSTRUCT ps;
+			HDC dc = BeginPaint(hwnd, &ps);
+			HGUI_Control* control = find_control_by_hwnd(hwnd);
+			if (control && control->canvas) {
+				HGUI_RasterRect rect = { (int)ps.rcPaint.left, (int)ps.rcPaint.top, (int)ps.rcPaint.right, (int)ps.rcPaint.bottom };
+				canvas_blit(dc, &control->canvas->surface, rect);
+			}
+			EndPaint(hwnd, &ps);
+			return 0;
+		}
+		
+		case WM_SIZE: {
+			// 保留重叠部分的内容，新露出的区域由随后的WM_PAINT传输
+			HGUI_Control* control = find_control_by_hwnd(hwnd);
+			if (control && control->canvas) {
+				hgui_surface_resize(&control->canvas->surface, LOWORD(lParam), HIWORD(lParam));
+				HGUI_RasterRect bounds = { 0, 0, control->canvas->surface.width, control->canvas->surface.height };
+				for (int i = 0; i < control->canvas->dirty.count; i++) {
+					control->canvas->dirty.rects[i] = hgui_rect_intersect(control->canvas->dirty.rects[i], bounds);
+				}
+			}
+			break;
+		}
+	}
+	return DefWindowProc(hwnd, msg, wParam, lParam);
+}
+
+// 画布窗口类注册的窗口过程：统计计时后交给canvas_proc
+LRESULT CALLBACK CanvasProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+	HGUI_STATS_MESSAGE_ENTER(frame);
+	LRESULT result = canvas_proc(hwnd, msg, wParam, lParam);
+	HGUI_STATS_MESSAGE_LEAVE(msg, frame);
+	return result;
+}
+
+// 布局：参与布局的控件的节点组成布局树，每个窗口是一棵树的根。修改样式或增删控件只使
+// 所在路径失效，下一帧（或窗口大小变化时）只重算失效的子树，结果变化的控件在一批DeferWindowPos中移动
+
+// 辅助函数：控件所在的窗口（窗口有布局时才返回）
+static HGUI_Control* layout_root(HGUI_Control* control) {
+	while (control->type != HGUI_WINDOW && control->parent) control = control->parent;
+	return control->type == HGUI_WINDOW && control->layout ? control : NULL;
+}
+
+// 辅助函数：把结果变化的控件加入移动批次（坐标相对于窗口客户区，容器借用窗口句柄因此无需换算）
+static void layout_defer(const HGUI_LayoutNode* node, void* context) {
+	HDWP* batch = (HDWP*)context;
+	HGUI_Control* control = resolve_handle((HGUI_Handle)(uintptr_t)node->user_data);
+	if (!*batch || !control || !owns_hwnd(control) || control->type == HGUI_WINDOW) return;
+	*batch = DeferWindowPos(*batch, control->hwnd, NULL, node->x, node->y, node->width, node->height,
+							SWP_NOZORDER | SWP_NOACTIVATE);
+}
+
+// 辅助函数：按窗口客户区重新布局，只移动结果变化的控件
+static void layout_update(HGUI_Control* window) {
+	if (!window || window->type != HGUI_WINDOW || !window->layout) return;
+	RECT client;
+	if (!GetClientRect(window->hwnd, &client)) return;
+	if (!hgui_layout_compute(&hgui_ctx->layout_tree, window->layout, 0, 0, client.right - client.left, client.bottom - client.top)) return;
+	if (hgui_ctx->layout_tree.changed_count == 0) return;
+	
+	HDWP batch = BeginDeferWindowPos((int)hgui_ctx->layout_tree.changed_count);
+	hgui_layout_take_changed(&hgui_ctx->layout_tree, layout_defer, &batch);
+	if (batch) EndDeferWindowPos(batch);
+}
+
+// 辅助函数：帧任务，重新布局一个窗口（同一帧内的多次修改只布局一次）
+static void layout_flush(void* user_data) {
+	layout_update(resolve_handle((HGUI_Handle)(uintptr_t)user_data));
+}
+
+// 辅助函数：请求在下一帧重新布局控件所在的窗口
+static void layout_schedule(HGUI_Control* control) {
+	HGUI_Control* window = layout_root(control);
+	if (window) hgui_sched_frame(&hgui_ctx->scheduler, layout_flush, (void*)(uintptr_t)make_handle(window));
+}
+
+// 辅助函数：控件退出布局（子控件已先退出，节点此时是叶子）
+static void layout_detach(HGUI_Control* control) {
+	if (!control->layout) return;
+	hgui_layout_remove(&hgui_ctx->layout_tree, control->layout);
+	control->layout = HGUI_LAYOUT_NO_NODE;
+}
+
+// 注册窗口类
+static void register_window_class(const char* class_name, WNDPROC proc, HBRUSH background) {
+	WNDCLASSEX wc;
+	memset(&wc, 0, sizeof(WNDCLASSEX));
+	wc.cbSize        = sizeof(WNDCLASSEX);
+	wc.style         = CS_VREDRAW | CS_HREDRAW | CS_DBLCLKS;
+	wc.lpfnWndProc   = proc;
+	wc.hInstance     = hgui_ctx->hInstance;
+	wc.hCursor       = LoadCursor(NULL, IDC_ARROW);
+	wc.hbrBackground = background;
+	wc.lpszClassName = class_name;
+	
+	RegisterClassEx(&wc);
+}
+
+// 输入录制：WM_COMMAND在分发前写入轨迹（时间为距开始录制的微秒数）
+
+// 辅助函数：判断控件通知是否由库处理（只录制这些通知，程序设置文本引起的EN_CHANGE除外）
+static bool trace_wants(const HGUI_Control* control, WORD code) {
+	switch (control->type) {
+		case HGUI_BUTTON:
+		case HGUI_RADIO:
+		case HGUI_CHECKBOX:
+			return code == BN_CLICKED;
+		case HGUI_LISTBOX:
+			return code == LBN_DBLCLK || code == LBN_SELCHANGE || code == LBN_SETFOCUS || code == LBN_KILLFOCUS;
+		case HGUI_INPUT:
+			return (code == EN_CHANGE && control != hgui_ctx->text_update_target) || code == EN_SETFOCUS || code == EN_KILLFOCUS;
+		default:
+			return code == BN_CLICKED && control->click_callback;
+	}
+}
+
+// 辅助函数：录制一条WM_COMMAND，同时记下回放时需要恢复的控件状态
+static void trace_record_command(WPARAM wParam, LPARAM lParam) {
+	HGUI_TraceEvent event;
+	memset(&event, 0, sizeof(HGUI_TraceEvent));
+	
+	if (lParam == 0) {
+		HGUI_Control* item = find_menu_item_by_id((UINT_PTR)LOWORD(wParam));
+		if (!item) return;
+		event.kind = HGUI_TRACE_MENU;
+		event.id = item->id;
+	} else {
+		HGUI_Control* control = find_control_by_hwnd((HWND)lParam);
+		WORD code = HIWORD(wParam);
+		if (!control || !trace_wants(control, code)) return;
+		event.kind = HGUI_TRACE_CONTROL;
+		event.id = control->id;
+		event.code = code;
+		
+		if (control->type == HGUI_CHECKBOX) {
+			// 点击前的选中状态（点击由库切换）
+			event.has_value = true;
+			event.value = control->checked;
+		} else if (control->type == HGUI_LISTBOX && (code == LBN_SELCHANGE || code == LBN_DBLCLK)) {
+			event.has_value = true;
+			event.value = (int)native_send(control->hwnd, LB_GETCURSEL, 0, 0);
+		} else if (code == EN_CHANGE) {
+			// 原生控件的内容已变化，重新同步缓存后记录
+			control->text_valid = false;
+			event.text = control_text_view(control);
+			if (!event.text) event.text = "";
+		}
+	}
+	
+	event.time_us = (uint64_t)((now_ns() - hgui_ctx->trace_start_ns) / 1000);
+	hgui_trace_write(&hgui_ctx->trace_writer, &event);
+}
+
+// 窗口过程实现
+static LRESULT window_proc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+	switch (msg) {
+		case WM_COMMAND: {
+		if (hgui_ctx->trace_recording) {
+			trace_record_command(wParam, lParam);
+		}
+		
+		// 处理菜单项点击 (lParam为0表示菜单命令)
+		if (lParam == 0) {
+			UINT_PTR menu_id = (UINT_PTR)LOWORD(wParam);
+			HGUI_Control* item = find_menu_item_by_id(menu_id);
+			
+			if (item) {
+				control_dispatch(item, HGUI_EVENT_CLICK, item->click_callback);
+				return 0;
+			}
+		}
+		// 处理控件消息
+		else {
+			// 根据句柄查找控件
+			HGUI_Control* control = find_control_by_hwnd((HWND)lParam);
+			WORD code = HIWORD(wParam);
+			
+			if (control) {
+				// 处理按钮点击
+				if (code == BN_CLICKED && (control->click_callback || control->type == HGUI_BUTTON)) {
+					control_dispatch(control, HGUI_EVENT_CLICK, control->click_callback);
+				}
+				// 处理单选框/复选框状态变化
+				else if ((control->type == HGUI_RADIO || control->type == HGUI_CHECKBOX) &&
+						 code == BN_CLICKED) {
+					
+					// 对于单选框，选中自身并取消组内原选中项
+					if (control->type == HGUI_RADIO) {
+						control_set_check(control, true);
+					}
+					// 对于复选框，切换状态
+					else if (control->type == HGUI_CHECKBOX) {
+						control_set_check(control, !control_get_check(control));
+					}
+					
+					// 触发change事件
+					control_dispatch(control, HGUI_EVENT_CHANGE, control->change_callback);
+				}
+				// 处理列表框通知
+				else if (control->type == HGUI_LISTBOX) {
+					if (code == LBN_DBLCLK) {
+						control_dispatch(control, HGUI_EVENT_DBLCLICK, control->dblclick_callback);
+					} else if (code == LBN_SELCHANGE) {
+						control_dispatch(control, HGUI_EVENT_SELECT, NULL);
+					} else if (code == LBN_SETFOCUS) {
+						control_dispatch(control, HGUI_EVENT_FOCUS, NULL);
+					} else if (code == LBN_KILLFOCUS) {
+						control_dispatch(control, HGUI_EVENT_BLUR, NULL);
+					}
+				}
+				// 处理输入框通知
+				else if (control->type == HGUI_INPUT) {
+					if (code == EN_CHANGE) {
+						// 内容被修改：原生控件为准，下次读取时重新同步缓存；程序设置的文本不触发change事件
+						control->text_valid = false;
+						if (control != hgui_ctx->text_update_target) {
+							control_dispatch(control, HGUI_EVENT_CHANGE, control->change_callback);
+						}
+					} else if (code == EN_SETFOCUS) {
+						control_dispatch(control, HGUI_EVENT_FOCUS, NULL);
+					} else if (code == EN_KILLFOCUS) {
+						control_dispatch(control, HGUI_EVENT_BLUR, NULL);
+					}
+				}
+			}
+		}
+		break;
+	}
+	
+	// 虚拟列表框：固定行高
+	case WM_MEASUREITEM: {
+		MEASUREITEMSTRUCT* mis = (MEASUREITEMSTRUCT*)lParam;
+		if (mis->CtlType == ODT_LISTBOX) {
+			mis->itemHeight = HGUI_VIRTUAL_ROW_HEIGHT;
+			return TRUE;
+		}
+		return DefWindowProc(hwnd, msg, wParam, lParam);
+	}
+	
+	// 虚拟列表框：只有可见行会收到绘制请求，此时才向回调索取行文本
+	case WM_DRAWITEM: {
+		DRAWITEMSTRUCT* dis = (DRAWITEMSTRUCT*)lParam;
+		HGUI_Control* control = find_control_by_hwnd(dis->hwndItem);
+		if (!control || !control->is_virtual) {
+			return DefWindowProc(hwnd, msg, wParam, lParam);
+		}
+		draw_virtual_row(control, dis);
+		return TRUE;
+	}
+	
+	// 窗口大小变化：立即重新布局（只重算失效或可用空间变化的子树）
+	case WM_SIZE:
+		layout_update(find_control_by_hwnd(hwnd));
+		return DefWindowProc(hwnd, msg, wParam, lParam);
+		
+	case WM_DESTROY:
+		PostQuitMessage(0);
+		break;
+		
+	default:
+		return DefWindowProc(hwnd, msg, wParam, lParam);
+	}
+	return 0;
+}
+
+// 窗口类注册的窗口过程：统计计时后交给window_proc
+LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+	HGUI_STATS_MESSAGE_ENTER(frame);
+	LRESULT result = window_proc(hwnd, msg, wParam, lParam);
+	HGUI_STATS_MESSAGE_LEAVE(msg, frame);
+	return result;
+}
+
+// 批量更新事务：事务期间只记录改动与脏区域，提交时统一应用并对每个父窗口只重绘一次
+#define HGUI_PENDING_SHOW 1
+#define HGUI_PENDING_HIDE 2
+
+struct HGUI_DirtyRegion {
+	HWND parent;
+	RECT dirty;      // 脏区域并集（父窗口客户区坐标）
+	int changes;     // 该区域合并的改动数
+};
+
+// 辅助函数：判断控件的改动能否延迟到事务提交时应用
+static bool can_defer(const HGUI_Control* control) {
+	return hgui_ctx->update_depth > 0 && owns_hwnd(control) && control->parent;
+}
+
+// 辅助函数：把控件所占区域并入其父窗口的脏区域。
+// 无法记录脏区域（没有父窗口或内存不足）时返回false，调用方应立即应用改动而不是延迟
+static bool mark_dirty(HGUI_Control* control) {
+	HWND parent = GetParent(control->hwnd);
+	if (!parent) return false;
+	
+	RECT rect;
+	GetWindowRect(control->hwnd, &rect);
+	MapWindowPoints(HWND_DESKTOP, parent, (POINT*)&rect, 2);
+	
+	for (int i = 0; i < hgui_ctx->dirty_region_count; i++) {
+		HGUI_DirtyRegion* region = &hgui_ctx->dirty_regions[i];
+		if (region->parent == parent) {
+			if (rect.left < region->dirty.left) region->dirty.left = rect.left;
+			if (rect.top < region->dirty.top) region->dirty.top = rect.top;
+			if (rect.right > region->dirty.right) region->dirty.right = rect.right;
+			if (rect.bottom > region->dirty.bottom) region->dirty.bottom = rect.bottom;
+			region->changes++;
+			hgui_ctx->update_stats.deferred_changes++;
+			return true;
+		}
+	}
+	
+	if (hgui_ctx->dirty_region_count == hgui_ctx->dirty_region_capacity) {
+		int capacity = hgui_ctx->dirty_region_capacity ? hgui_ctx->dirty_region_capacity * 2 : 4;
+		HGUI_DirtyRegion* regions = (HGUI_DirtyRegion*)realloc(hgui_ctx->dirty_regions, capacity * sizeof(HGUI_DirtyRegion));
+		if (!regions) return false;
+		hgui_ctx->dirty_regions = regions;
+		hgui_ctx->dirty_region_capacity = capacity;
+	}
+	hgui_ctx->dirty_regions[hgui_ctx->dirty_region_count].parent = parent;
+	hgui_ctx->dirty_regions[hgui_ctx->dirty_region_count].dirty = rect;
+	hgui_ctx->dirty_regions[hgui_ctx->dirty_region_count].changes = 1;
+	hgui_ctx->dirty_region_count++;
+	hgui_ctx->update_stats.deferred_changes++;
+	return true;
+}
+
+// 辅助函数：登记有待处理状态的控件，内存不足时返回false
+static bool add_pending(HGUI_Control* control) {
+	if (control->pending_visibility || control->redraw_suspended) return true;
+	
+	if (hgui_ctx->pending_count == hgui_ctx->pending_capacity) {
+		int capacity = hgui_ctx->pending_capacity ? hgui_ctx->pending_capacity * 2 : 16;
+		HGUI_Control** items = (HGUI_Control**)realloc(hgui_ctx->pending_controls, capacity * sizeof(HGUI_Control*));
+		if (!items) return false;
+		hgui_ctx->pending_controls = items;
+		hgui_ctx->pending_capacity = capacity;
+	}
+	hgui_ctx->pending_controls[hgui_ctx->pending_count++] = control;
+	return true;
+}
+
+// 辅助函数：控件删除时丢弃其待处理状态
+static void drop_pending(HGUI_Control* control) {
+	if (!control->pending_visibility && !control->redraw_suspended) return;
+	
+	for (int i = 0; i < hgui_ctx->pending_count; i++) {
+		if (hgui_ctx->pending_controls[i] == control) {
+			hgui_ctx->pending_controls[i] = hgui_ctx->pending_controls[--hgui_ctx->pending_count];
+			break;
+		}
+	}
+	control->pending_visibility = 0;
+	control->redraw_suspended = false;
+}
+
+// 辅助函数：重绘窗口的菜单栏（事务中延迟到提交时，每个窗口只重绘一次）
+static void menu_redraw(HWND hwnd) {
+	if (hgui_ctx->update_depth == 0) {
+		DrawMenuBar(hwnd);
+		return;
+	}
+	
+	for (int i = 0; i < hgui_ctx->menu_redraw_count; i++) {
+		if (hgui_ctx->menu_redraw_windows[i] == hwnd) return;
+	}
+	if (hgui_ctx->menu_redraw_count == hgui_ctx->menu_redraw_capacity) {
+		int capacity = hgui_ctx->menu_redraw_capacity ? hgui_ctx->menu_redraw_capacity * 2 : 4;
+		HWND* windows = (HWND*)realloc(hgui_ctx->menu_redraw_windows, capacity * sizeof(HWND));
+		if (!windows) {
+			DrawMenuBar(hwnd);
+			return;
+		}
+		hgui_ctx->menu_redraw_windows = windows;
+		hgui_ctx->menu_redraw_capacity = capacity;
+	}
+	hgui_ctx->menu_redraw_windows[hgui_ctx->menu_redraw_count++] = hwnd;
+}
+
+// 辅助函数：事务中暂停控件自身的重绘（文本等改动不立即绘制）
+static bool suspend_redraw(HGUI_Control* control) {
+	if (control->redraw_suspended) return true;
+	if (!add_pending(control)) return false;
+	
+	control->redraw_suspended = true;
+	native_send(control->hwnd, WM_SETREDRAW, FALSE, 0);
+	return true;
+}
+
+// 开始批量更新（可嵌套，最外层endUpdate时提交）
+static void hgui_beginUpdate(void) {
+	hgui_ctx->update_depth++;
+}
+
+// 提交批量更新
+static void hgui_endUpdate(void) {
+	if (hgui_ctx->update_depth == 0 || --hgui_ctx->update_depth > 0) return;
+	
+	// 按父窗口分批应用可见性变化（DeferWindowPos要求同一批窗口有相同的父窗口）
+	for (int r = 0; r < hgui_ctx->dirty_region_count; r++) {
+		HGUI_DirtyRegion* region = &hgui_ctx->dirty_regions[r];
+		HDWP batch = BeginDeferWindowPos(region->changes);
+		
+		for (int i = 0; i < hgui_ctx->pending_count && batch; i++) {
+			HGUI_Control* control = hgui_ctx->pending_controls[i];
+			if (!control->pending_visibility || GetParent(control->hwnd) != region->parent) continue;
+			
+			UINT flags = SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOREDRAW;
+			flags |= control->pending_visibility == HGUI_PENDING_SHOW ? SWP_SHOWWINDOW : SWP_HIDEWINDOW;
+			batch = DeferWindowPos(batch, control->hwnd, NULL, 0, 0, 0, 0, flags);
+		}
+		if (batch) EndDeferWindowPos(batch);
+	}
+	
+	// 恢复被暂停的重绘
+	for (int i = 0; i < hgui_ctx->pending_count; i++) {
+		HGUI_Control* control = hgui_ctx->pending_controls[i];
+		if (control->redraw_suspended) {
+			native_send(control->hwnd, WM_SETREDRAW, TRUE, 0);
+		}
+		control->pending_visibility = 0;
+		control->redraw_suspended = false;
+	}
+	hgui_ctx->pending_count = 0;
+	
+	// 每个父窗口只对脏区域并集重绘一次
+	for (int r = 0; r < hgui_ctx->dirty_region_count; r++) {
+		HGUI_DirtyRegion* region = &hgui_ctx->dirty_regions[r];
+		RedrawWindow(region->parent, &region->dirty, NULL, RDW_INVALIDATE | RDW_ERASE | RDW_ALLCHILDREN);
+		hgui_ctx->update_stats.invalidations++;
+		hgui_ctx->update_stats.redraws_saved += (unsigned long)(region->changes - 1);
+	}
+	hgui_ctx->dirty_region_count = 0;
+	
+	// 菜单栏（窗口可能已在事务中删除，此时DrawMenuBar直接失败）
+	for (int i = 0; i < hgui_ctx->menu_redraw_count; i++) {
+		DrawMenuBar(hgui_ctx->menu_redraw_windows[i]);
+	}
+	hgui_ctx->menu_redraw_count = 0;
+	hgui_ctx->update_stats.transactions++;
+}
+
+// 获取批量更新统计
+static void hgui_getUpdateStats(HGUI_UpdateStats* stats) {
+	if (stats) *stats = hgui_ctx->update_stats;
+}
+
+// 辅助函数：释放事务状态
+static void update_state_clear(void) {
+	free(hgui_ctx->dirty_regions);
+	free(hgui_ctx->pending_controls);
+	free(hgui_ctx->menu_redraw_windows);
+	hgui_ctx->dirty_regions = NULL;
+	hgui_ctx->pending_controls = NULL;
+	hgui_ctx->menu_redraw_windows = NULL;
+	hgui_ctx->dirty_region_count = hgui_ctx->dirty_region_capacity = 0;
+	hgui_ctx->pending_count = hgui_ctx->pending_capacity = 0;
+	hgui_ctx->menu_redraw_count = hgui_ctx->menu_redraw_capacity = 0;
+	hgui_ctx->update_depth = 0;
+}
+
+// 辅助函数：显示或隐藏控件（事务中延迟到提交时应用）
+static void control_set_visible(HGUI_Control* control, bool visible) {
+	if (!control || !owns_hwnd(control)) return;
+	
+	// 先记录脏区域再登记改动，任何一步失败都立即应用，避免提交时丢失
+	if (can_defer(control) && mark_dirty(control) && add_pending(control)) {
+		control->pending_visibility = visible ? HGUI_PENDING_SHOW : HGUI_PENDING_HIDE;
+		return;
+	}
+	
+	ShowWindow(control->hwnd, visible ? SW_SHOW : SW_HIDE);
+	// 通知父窗口重绘
+	if (control->parent && control->parent->hwnd) {
+		InvalidateRect(control->parent->hwnd, NULL, TRUE);
+		hgui_ctx->update_stats.invalidations++;
+	}
+}
+
+// 运行统计实现
+
+static void hgui_stats(HGUI_Stats* out) {
+	if (!out) return;
+	memset(out, 0, sizeof(HGUI_Stats));
+#ifdef HGUI_ENABLE_STATS
+	out->enabled = true;
+	out->elapsed_ms = (double)(now_ns() - hgui_ctx->stats_start_ns) / 1e6;
+	
+	// 消息类型按总耗时降序（插入排序，条目数有上限）
+	for (size_t i = 0; i < hgui_ctx->stats_message_count; i++) {
+		size_t j = i;
+		while (j > 0 && out->messages[j - 1].timing.total_ns < hgui_ctx->stats_messages[i].timing.total_ns) {
+			out->messages[j] = out->messages[j - 1];
+			j--;
+		}
+		out->messages[j] = hgui_ctx->stats_messages[i];
+	}
+	out->message_type_count = hgui_ctx->stats_message_count;
+	out->other_messages = hgui_ctx->stats_other_messages;
+	
+	// 保留回调总耗时最多的若干控件
+	for (HGUI_Control* control = hgui_ctx->controls; control; control = control->next) {
+		if (control->callback_timing.count == 0) continue;
+		
+		size_t j = out->callback_count < HGUI_STATS_TOP_CALLBACKS ? out->callback_count++ : HGUI_STATS_TOP_CALLBACKS;
+		while (j > 0 && out->callbacks[j - 1].timing.total_ns < control->callback_timing.total_ns) {
+			if (j < HGUI_STATS_TOP_CALLBACKS) out->callbacks[j] = out->callbacks[j - 1];
+			j--;
+		}
+		if (j < HGUI_STATS_TOP_CALLBACKS) {
+			HGUI_CallbackStats* entry = &out->callbacks[j];
+			snprintf(entry->id, sizeof(entry->id), "%s", control->id);
+			entry->type = control->type;
+			entry->timing = control->callback_timing;
+		}
+	}
+	
+	out->callbacks_total = hgui_ctx->stats_callbacks_total;
+	out->drains = hgui_ctx->stats_drains;
+	out->lookups = hgui_ctx->stats_lookups;
+	out->native_calls = hgui_ctx->stats_native_calls;
+#endif
+}
+
+static void hgui_resetStats(void) {
+#ifdef HGUI_ENABLE_STATS
+	memset(hgui_ctx->stats_messages, 0, sizeof(hgui_ctx->stats_messages));
+	memset(hgui_ctx->stats_message_slots, 0, sizeof(hgui_ctx->stats_message_slots));
+	hgui_ctx->stats_message_count = 0;
+	memset(&hgui_ctx->stats_other_messages, 0, sizeof(HGUI_TimingStats));
+	memset(&hgui_ctx->stats_callbacks_total, 0, sizeof(HGUI_TimingStats));
+	memset(&hgui_ctx->stats_drains, 0, sizeof(HGUI_TimingStats));
+	memset(&hgui_ctx->stats_lookups, 0, sizeof(HGUI_TimingStats));
+	memset(&hgui_ctx->stats_native_calls, 0, sizeof(HGUI_TimingStats));
+	for (HGUI_Control* control = hgui_ctx->controls; control; control = control->next) {
+		memset(&control->callback_timing, 0, sizeof(HGUI_TimingStats));
+	}
+	hgui_ctx->stats_start_ns = now_ns();
+#endif
+}
+
+// 常见消息的名称（仅用于输出）
+static const char* message_name(UINT message) {
+	switch (message) {
+		case WM_PAINT:       return "WM_PAINT";
+		case WM_TIMER:       return "WM_TIMER";
+		case WM_COMMAND:     return "WM_COMMAND";
+		case WM_MOUSEMOVE:   return "WM_MOUSEMOVE";
+		case WM_LBUTTONDOWN: return "WM_LBUTTONDOWN";
+		case WM_LBUTTONUP:   return "WM_LBUTTONUP";
+		case WM_KEYDOWN:     return "WM_KEYDOWN";
+		case WM_KEYUP:       return "WM_KEYUP";
+		case WM_CHAR:        return "WM_CHAR";
+		case WM_NCMOUSEMOVE: return "WM_NCMOUSEMOVE";
+		default:             return NULL;
+	}
+}
+
+// 文本输出缓冲区（与snprintf一致：超出容量时截断，但仍累计所需长度）
+typedef struct {
+	char* buffer;
+	size_t size;
+	size_t length;
+} HGUI_TextBuilder;
+
+static void text_appendf(HGUI_TextBuilder* builder, const char* format, ...) {
+	char* dest = builder->length < builder->size ? builder->buffer + builder->length : NULL;
+	size_t room = builder->length < builder->size ? builder->size - builder->length : 0;
+	
+	va_list args;
+	va_start(args, format);
+	int written = vsnprintf(dest, room, format, args);
+	va_end(args);
+	if (written > 0) builder->length += (size_t)written;
+}
+
+static void text_append_json_string(HGUI_TextBuilder* builder, const char* text) {
+	text_appendf(builder, "\"");
+	for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+		if (*p == '"' || *p == '\\') text_appendf(builder, "\\%c", *p);
+		else if (*p < 0x20) text_appendf(builder, "\\u%04x", *p);
+		else text_appendf(builder, "%c", *p);
+	}
+	text_appendf(builder, "\"");
+}
+
+static void text_append_timing(HGUI_TextBuilder* builder, const char* name, const HGUI_TimingStats* timing, bool json) {
+	if (json) {
+		text_appendf(builder, "\"%s\":{\"count\":%lu,\"total_ns\":%llu,\"max_ns\":%llu}",
+			name, timing->count, timing->total_ns, timing->max_ns);
+	}
+	else {
+		text_appendf(builder, "%-12s %10lu 次  总计 %10.3f ms  最大 %10.1f us\n",
+			name, timing->count, (double)timing->total_ns / 1e6, (double)timing->max_ns / 1e3);
+	}
+}
+
+static size_t hgui_formatStats(char* buffer, size_t size, bool json) {
+	HGUI_Stats* stats = (HGUI_Stats*)malloc(sizeof(HGUI_Stats));
+	if (!stats) return 0;
+	hgui_stats(stats);
+	
+	HGUI_TextBuilder builder = { buffer, buffer ? size : 0, 0 };
+	if (json) {
+		text_appendf(&builder, "{\"enabled\":%s,\"elapsed_ms\":%.3f,\"messages\":[",
+			stats->enabled ? "true" : "false", stats->elapsed_ms);
+		for (size_t i = 0; i < stats->message_type_count; i++) {
+			const HGUI_MessageStats* entry = &stats->messages[i];
+			const char* name = message_name(entry->message);
+			text_appendf(&builder, "%s{\"message\":%u,", i ? "," : "", entry->message);
+			if (name) text_appendf(&builder, "\"name\":\"%s\",", name);
+			text_appendf(&builder, "\"count\":%lu,\"total_ns\":%llu,\"max_ns\":%llu,\"histogram\":[",
+				entry->timing.count, entry->timing.total_ns, entry->timing.max_ns);
+			for (int b = 0; b < HGUI_STATS_BUCKETS; b++) {
+				text_appendf(&builder, "%s%lu", b ? "," : "", entry->histogram[b]);
+			}
+			text_appendf(&builder, "]}");
+		}
+		text_appendf(&builder, "],");
+		text_append_timing(&builder, "other_messages", &stats->other_messages, true);
+		text_appendf(&builder, ",\"callbacks\":[");
+		for (size_t i = 0; i < stats->callback_count; i++) {
+			const HGUI_CallbackStats* entry = &stats->callbacks[i];
+			text_appendf(&builder, "%s{\"id\":", i ? "," : "");
+			text_append_json_string(&builder, entry->id);
+			text_appendf(&builder, ",\"type\":%d,\"count\":%lu,\"total_ns\":%llu,\"max_ns\":%llu}",
+				(int)entry->type, entry->timing.count, entry->timing.total_ns, entry->timing.max_ns);
+		}
+		text_appendf(&builder, "],");
+		text_append_timing(&builder, "callbacks_total", &stats->callbacks_total, true);
+		text_appendf(&builder, ",");
+		text_append_timing(&builder, "drains", &stats->drains, true);
+		text_appendf(&builder, ",");
+		text_append_timing(&builder, "lookups", &stats->lookups, true);
+		text_appendf(&builder, ",");
+		text_append_timing(&builder, "native_calls", &stats->native_calls, true);
+		text_appendf(&builder, "}\n");
+	}
+	else if (!stats->enabled) {
+		text_appendf(&builder, "HGUI 统计未启用（编译时定义 HGUI_ENABLE_STATS）\n");
+	}
+	else {
+		text_appendf(&builder, "HGUI 统计（%.1f ms）\n", stats->elapsed_ms);
+		text_appendf(&builder, "消息分发:\n");
+		for (size_t i = 0; i < stats->message_type_count; i++) {
+			const HGUI_MessageStats* entry = &stats->messages[i];
+			const char* name = message_name(entry->message);
+			char label[32];
+			if (name) snprintf(label, sizeof(label), "%s", name);
+			else snprintf(label, sizeof(label), "0x%04X", entry->message);
+			text_append_timing(&builder, label, &entry->timing, false);
+			
+			// 直方图只列出非空的桶，标注桶的上限
+			text_appendf(&builder, "             ");
+			for (int b = 0; b < HGUI_STATS_BUCKETS; b++) {
+				if (!entry->histogram[b]) continue;
+				if (b == HGUI_STATS_BUCKETS - 1) text_appendf(&builder, " >=%luus:%lu", 1ul << (b - 1), entry->histogram[b]);
+				else text_appendf(&builder, " <%luus:%lu", 1ul << b, entry->histogram[b]);
+			}
+			text_appendf(&builder, "\n");
+		}
+		if (stats->other_messages.count) {
+			text_append_timing(&builder, "其他消息", &stats->other_messages, false);
+		}
+		text_appendf(&builder, "控件回调:\n");
+		for (size_t i = 0; i < stats->callback_count; i++) {
+			text_append_timing(&builder, stats->callbacks[i].id, &stats->callbacks[i].timing, false);
+		}
+		text_append_timing(&builder, "回调合计", &stats->callbacks_total, false);
+		text_append_timing(&builder, "队列应用", &stats->drains, false);
+		text_append_timing(&builder, "控件查找", &stats->lookups, false);
+		text_append_timing(&builder, "原生调用", &stats->native_calls, false);
+	}
+	
+	free(stats);
+	return builder.length;
+}
+
+// 辅助函数：输出一次统计（文件以追加方式写入，JSON每次一行）
+static void stats_dump_write(void) {
+	size_t length = hgui_formatStats(NULL, 0, hgui_ctx->stats_dump_json);
+	char* text = (char*)malloc(length + 1);
+	if (!text) return;
+	hgui_formatStats(text, length + 1, hgui_ctx->stats_dump_json);
+	
+	if (hgui_ctx->stats_dump_path) {
+		FILE* file = fopen(hgui_ctx->stats_dump_path, "a");
+		if (file) {
+			fwrite(text, 1, length, file);
+			fclose(file);
+		}
+	}
+	else {
+		OutputDebugStringA(text);
+	}
+	free(text);
+}
+
+// 辅助函数：停止周期性输出
+static void stats_dump_stop(void) {
+	if (hgui_ctx->stats_dump_task) {
+		hgui_sched_cancel(&hgui_ctx->scheduler, hgui_ctx->stats_dump_task);
+		hgui_ctx->stats_dump_task = HGUI_INVALID_TASK;
+	}
+	free(hgui_ctx->stats_dump_path);
+	hgui_ctx->stats_dump_path = NULL;
+}
+
+// 辅助函数：周期性输出的调度回调
+static void stats_dump_tick(void* user_data) {
+	(void)user_data;
+	stats_dump_write();
+}
+
+// interval_ms为0时立即输出一次；否则由消息循环每隔interval_ms输出一次
+static void hgui_dumpStats(const char* path, unsigned int interval_ms, bool json) {
+	stats_dump_stop();
+	if (path) {
+		size_t length = strlen(path) + 1;
+		hgui_ctx->stats_dump_path = (char*)malloc(length);
+		if (!hgui_ctx->stats_dump_path) return;
+		memcpy(hgui_ctx->stats_dump_path, path, length);
+	}
+	hgui_ctx->stats_dump_json = json;
+	
+	if (interval_ms == 0) {
+		stats_dump_write();
+		stats_dump_stop();
+	}
+	else {
+		hgui_ctx->stats_dump_task = hgui_sched_every(&hgui_ctx->scheduler, interval_ms, stats_dump_tick, NULL);
+	}
+}
+
+// 资源与内存账目实现
+// 辅助函数：控件附属的堆内存（文本缓存、帧缓冲、列表快照与差异缓冲、所在单选框组）
+static size_t control_heap_bytes(const HGUI_Control* control) {
+	size_t bytes = control->text_capacity;
+	if (control->canvas) {
+		const HGUI_Surface* surface = &control->canvas->surface;
+		bytes += sizeof(HGUI_Canvas);
+		if (surface->owns_pixels) bytes += (size_t)surface->stride * (size_t)surface->height * sizeof(uint32_t);
+	}
+	if (control->list_model) {
+		const HGUI_ListModel* model = control->list_model;
+		bytes += sizeof(HGUI_ListModel) + model->snapshot.bytes +
+				 (size_t)model->diff.capacity * sizeof(HGUI_DiffHunk) +
+				 model->diff.trace_capacity * sizeof(int) + model->diff.marks_capacity;
+	}
+	// 单选框组计入组内第一个成员
+	const HGUI_RadioGroup* group = control->radio_group;
+	if (group && group->count > 0 && group->members[0] == control) {
+		bytes += sizeof(HGUI_RadioGroup) + (size_t)group->capacity * sizeof(HGUI_Control*);
+	}
+	return bytes;
+}
+
+static void hgui_memoryStats(HGUI_MemoryStats* out) {
+	if (!out) return;
+	memset(out, 0, sizeof(HGUI_MemoryStats));
+	
+	// 节点、窗口与菜单数来自账目；字体引用与附属内存按控件链表统计
+	for (int type = 0; type < HGUI_CONTROL_TYPE_COUNT; type++) {
+		out->types[type].controls = hgui_ctx->memory_ledger.controls[type];
+		out->types[type].hwnds = hgui_ctx->memory_ledger.hwnds[type];
+		out->types[type].hmenus = hgui_ctx->memory_ledger.hmenus[type];
+	}
+	for (const HGUI_Control* control = hgui_ctx->controls; control; control = control->next) {
+		HGUI_MemoryTypeStats* entry = &out->types[control->type];
+		entry->font_refs += (control->font != NULL) + (control->base_font != NULL);
+		entry->bytes += control_heap_bytes(control);
+	}
+	for (int type = 0; type < HGUI_CONTROL_TYPE_COUNT; type++) {
+		const HGUI_MemoryTypeStats* entry = &out->types[type];
+		out->total.controls += entry->controls;
+		out->total.hwnds += entry->hwnds;
+		out->total.hmenus += entry->hmenus;
+		out->total.font_refs += entry->font_refs;
+		out->total.bytes += entry->bytes;
+	}
+	out->fonts = hgui_ctx->memory_ledger.fonts;
+	out->accel_tables = hgui_ctx->memory_ledger.accel_tables;
+	
+	out->node_bytes = hgui_ctx->slab_count * HGUI_SLAB_SIZE * sizeof(HGUI_Control) + hgui_ctx->slab_capacity * sizeof(HGUI_Control*);
+	for (const HGUI_ArenaChunk* chunk = hgui_ctx->arena_chunks; chunk; chunk = chunk->next) {
+		out->string_bytes += chunk->used;
+	}
+	out->table_bytes = (hgui_ctx->id_index_capacity + hgui_ctx->hwnd_index_capacity + hgui_ctx->menu_index_capacity) * sizeof(HGUI_Control*) +
+					   hgui_ctx->intern_capacity * (sizeof(const char*) + sizeof(unsigned int)) +
+					   (size_t)hgui_ctx->subscription_capacity * sizeof(HGUI_SubscriptionNode);
+	out->total_bytes = out->node_bytes + out->string_bytes + out->table_bytes + out->total.bytes +
+					   out->fonts * sizeof(HGUI_Font);
+	out->last_cleanup = hgui_ctx->leak_report;
+}
+
+#ifdef HGUI_CHECK_LEAKS
+#define HGUI_LEAK_MAX_LISTED 8   // 报告中逐个列出的孤立控件数
+
+// 辅助函数：cleanup释放控件之前检查控件树与索引：
+// 不在控件链表中的在用节点、父控件已释放的节点、指向已释放控件的索引项
+static void leak_check_tree(HGUI_LeakReport* report, HGUI_TextBuilder* text) {
+	unsigned long listed = 0;
+	for (const HGUI_Control* control = hgui_ctx->controls; control; control = control->next) {
+		listed++;
+		if (control->parent && !control->parent->alive) {
+			if (report->orphaned < HGUI_LEAK_MAX_LISTED) text_appendf(text, "  孤立控件 %s（父控件已释放）\n", control->id);
+			report->orphaned++;
+		}
+	}
+	
+	unsigned long alive = 0;
+	for (size_t slab = 0; slab < hgui_ctx->slab_count; slab++) {
+		size_t used = slab == hgui_ctx->slab_count - 1 ? hgui_ctx->slab_next_free : HGUI_SLAB_SIZE;
+		for (size_t i = 0; i < used; i++) {
+			if (hgui_ctx->slabs[slab][i].alive) alive++;
+		}
+	}
+	if (alive > listed) {
+		text_appendf(text, "  %lu 个在用的控件节点不在控件链表中\n", alive - listed);
+		report->orphaned += alive - listed;
+	}
+	
+	for (size_t i = 0; i < hgui_ctx->id_index_capacity; i++) {
+		for (HGUI_Control* entry = hgui_ctx->id_index[i]; entry; entry = entry->id_shadowed) {
+			if (!entry->alive) report->stale_entries++;
+		}
+	}
+	for (size_t i = 0; i < hgui_ctx->hwnd_index_capacity; i++) {
+		if (hgui_ctx->hwnd_index[i] && !hgui_ctx->hwnd_index[i]->alive) report->stale_entries++;
+	}
+	for (size_t i = 0; i < hgui_ctx->menu_index_capacity; i++) {
+		if (hgui_ctx->menu_index[i] && !hgui_ctx->menu_index[i]->alive) report->stale_entries++;
+	}
+}
+
+// 辅助函数：输出泄漏检查报告（没有问题时不输出）
+static void leak_report_write(const HGUI_LeakReport* report, HGUI_TextBuilder* text) {
+	if (report->orphaned || report->stale_entries || report->font_refs || report->controls ||
+		report->hwnds || report->hmenus || report->fonts || report->accel_tables) {
+		text_appendf(text, "  孤立节点 %lu，失效索引项 %lu，未释放的字体引用 %lu\n",
+			report->orphaned, report->stale_entries, report->font_refs);
+		text_appendf(text, "  泄漏：控件节点 %lu，窗口 %lu，菜单 %lu，字体 %lu，快捷键表 %lu\n",
+			report->controls, report->hwnds, report->hmenus, report->fonts, report->accel_tables);
+		OutputDebugStringA("HGUI 泄漏检查：\n");
+		OutputDebugStringA(text->buffer);
+	}
+}
+#endif
+
+// 辅助函数：子树后序遍历的第一个节点（最深的第一个子控件）
+static HGUI_Control* subtree_first(HGUI_Control* root) {
+	while (root->first_child) root = root->first_child;
+	return root;
+}
+
+// 辅助函数：子树后序遍历的下一个节点（子控件先于父控件，根最后），遍历结束返回NULL
+static HGUI_Control* subtree_next(HGUI_Control* node, HGUI_Control* root) {
+	if (node == root) return NULL;
+	if (node->next_sibling) return subtree_first(node->next_sibling);
+	return node->parent;
+}
+
+// 辅助函数：从父控件的子控件链表中摘除
+static void tree_unlink(HGUI_Control* control) {
+	HGUI_Control* parent = control->parent;
+	if (!parent) return;
+	
+	if (control->prev_sibling) control->prev_sibling->next_sibling = control->next_sibling;
+	else parent->first_child = control->next_sibling;
+	if (control->next_sibling) control->next_sibling->prev_sibling = control->prev_sibling;
+	else parent->last_child = control->prev_sibling;
+	control->parent = NULL;
+	control->prev_sibling = control->next_sibling = NULL;
+}
+
+// 辅助函数：通知删除事件的订阅者（root为NULL时通知所有控件）。
+// 回调中控件树可能变化，因此先收集句柄，通知前再确认控件仍然有效
+static void notify_removal(HGUI_Control* root) {
+	unsigned int bit = 1u << HGUI_EVENT_REMOVE;
+	size_t watched = 0;
+	if (root) {
+		for (HGUI_Control* node = subtree_first(root); node; node = subtree_next(node, root)) {
+			if (node->event_mask & bit) watched++;
+		}
+	} else {
+		for (HGUI_Control* node = hgui_ctx->controls; node; node = node->next) {
+			if (node->event_mask & bit) watched++;
+		}
+	}
+	if (watched == 0) return;
+	
+	HGUI_Handle* handles = (HGUI_Handle*)malloc(watched * sizeof(HGUI_Handle));
+	if (!handles) return;
+	size_t count = 0;
+	if (root) {
+		for (HGUI_Control* node = subtree_first(root); node; node = subtree_next(node, root)) {
+			if (node->event_mask & bit) handles[count++] = make_handle(node);
+		}
+	} else {
+		for (HGUI_Control* node = hgui_ctx->controls; node; node = node->next) {
+			if (node->event_mask & bit) handles[count++] = make_handle(node);
+		}
+	}
+	for (size_t i = 0; i < count; i++) {
+		HGUI_Control* control = resolve_handle(handles[i]);
+		if (control) control_dispatch(control, HGUI_EVENT_REMOVE, NULL);
+	}
+	free(handles);
+}
+
+// 辅助函数：从所在菜单中删除菜单项（菜单中的位置即其在父控件子链表中的序号）
+static void menu_item_delete(HGUI_Control* item) {
+	HGUI_Control* parent = item->parent;
+	if (!parent || !parent->hmenu) return;
+	
+	UINT position = 0;
+	for (HGUI_Control* sibling = item->prev_sibling; sibling; sibling = sibling->prev_sibling) {
+		position++;
+	}
+	DeleteMenu(parent->hmenu, position, MF_BYPOSITION);
+	menu_redraw(parent->hwnd);
+	if (item->hmenu) hgui_ctx->memory_ledger.hmenus[HGUI_MENUITEM]--;
+	item->hmenu = NULL;
+}
+
+// 辅助函数：销毁单个控件的原生资源与附属状态（其子控件已先销毁）
+static void control_destroy(HGUI_Control* control) {
+	radio_group_leave(control);
+	drop_pending(control);
+	control_release_subscriptions(control);
+	
+	if (control->type == HGUI_MENUBAR) {
+		// 先从窗口上取下菜单栏再销毁（其中的子菜单随之销毁）
+		SetMenu(control->hwnd, NULL);
+		if (control->hmenu) {
+			DestroyMenu(control->hmenu);
+			hgui_ctx->memory_ledger.hmenus[HGUI_MENUBAR]--;
+		}
+		menu_redraw(control->hwnd);
+	}
+	else if (owns_hwnd(control) && control->hwnd) {
+		DestroyWindow(control->hwnd);
+		hgui_ctx->memory_ledger.hwnds[control->type]--;
+	}
+	// 菜单项不持有需要单独销毁的资源：作为删除的根时已从菜单中删除，否则子菜单随所在菜单一起销毁
+	else if (control->type == HGUI_MENUITEM && control->hmenu) {
+		hgui_ctx->memory_ledger.hmenus[HGUI_MENUITEM]--;
+	}
+	
+	// 窗口销毁后再释放字体引用与帧缓冲
+	control_release_fonts(control);
+	control_release_text(control);
+	canvas_release(control);
+	list_model_release(control);
+	layout_detach(control);
+	
+	// 如果删除的是主窗口，更新主窗口句柄
+	if (control->type == HGUI_WINDOW && control->hwnd == hgui_ctx->main_window_hwnd) {
+		hgui_ctx->main_window_hwnd = NULL;
+	}
+}
+
+// 辅助函数：自底向上删除整棵子树：摘下子树，逐个注销、销毁并归还节点
+static void destroy_subtree(HGUI_Control* root) {
+	tree_unlink(root);
+	HGUI_Control* node = subtree_first(root);
+	while (node) {
+		HGUI_Control* next = subtree_next(node, root);
+		unregister_control(node);
+		control_destroy(node);
+		
+		// 归还节点（ID字符串留在驻留区，由hgui_cleanup统一释放）
+		pool_free_control(node);
+		node = next;
+	}
+}
+
+// 核心功能实现
+static void hgui_init(void) {
+	hgui_ctx->hInstance = GetModuleHandle(NULL);
+	hgui_ctx->ui_thread_id = GetCurrentThreadId();
+	hgui_sched_init(&hgui_ctx->scheduler, scheduler_clock, NULL);
+	hgui_resetStats();
+	hgui_ctx->initialized = true;
+}
+
+// 辅助函数：运行本帧的帧任务，同一帧内的全部界面修改合并为一次事务
+static void run_frame_tasks(void) {
+	if (!hgui_sched_frame_pending(&hgui_ctx->scheduler)) return;
+	hgui_beginUpdate();
+	hgui_sched_run_frame(&hgui_ctx->scheduler);
+	hgui_endUpdate();
+}
+
+// 辅助函数：处理队列中的全部消息，收到WM_QUIT时返回false并给出退出码
+static bool pump_messages(int* exit_code) {
+	MSG msg;
+	while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+		if (msg.message == WM_QUIT) {
+			*exit_code = (int)msg.wParam;
+			return false;
+		}
+		
+		// 跨线程更新的唤醒消息：批量应用队列中的全部更新
+		if (msg.hwnd == NULL && msg.message == WM_HGUI_WAKE) {
+			op_queue_drain();
+			continue;
+		}
+		
+		// 菜单快捷键转换为菜单命令（WM_COMMAND发送到主窗口，按菜单ID分发）
+		if (hgui_ctx->accel_dirty) accel_refresh();
+		if (hgui_ctx->accel_table && hgui_ctx->main_window_hwnd && TranslateAccelerator(hgui_ctx->main_window_hwnd, hgui_ctx->accel_table, &msg)) {
+			continue;
+		}
+		
+		TranslateMessage(&msg);
+		DispatchMessage(&msg);
+		
+		// 模态循环（菜单、拖动窗口）会丢弃线程消息，此处补偿处理积压的更新（与入队一样原子读取队头）
+		if (InterlockedCompareExchangePointer((PVOID volatile*)&hgui_ctx->op_queue_head, NULL, NULL)) {
+			op_queue_drain();
+		}
+		
+		// 持续的输入不应使定时任务饿死
+		hgui_sched_run_due(&hgui_ctx->scheduler);
+	}
+	return true;
+}
+
+static int hgui_run(void) {
+	MSG msg;
+	int exit_code;
+	for (;;) {
+		// 处理队列中的全部消息
+		if (!pump_messages(&exit_code)) {
+			return exit_code;
+		}
+		
+		// 到期的定时任务，然后是帧周期已到的帧任务
+		hgui_sched_run_due(&hgui_ctx->scheduler);
+		run_frame_tasks();
+		
+		// 队列仍为空时运行空闲任务
+		if (!PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE)) {
+			hgui_sched_run_idle(&hgui_ctx->scheduler);
+		}
+		
+		// 等待下一条消息或下一个定时任务/帧
+		long long timeout = hgui_sched_timeout(&hgui_ctx->scheduler);
+		DWORD wait = timeout < 0 ? INFINITE : (DWORD)timeout;
+		if (MsgWaitForMultipleObjectsEx(0, NULL, wait, QS_ALLINPUT, MWMO_INPUTAVAILABLE) == WAIT_FAILED) {
+			return 0;
+		}
+	}
+}
+
+static void hgui_cleanup(void) {
+#ifdef HGUI_CHECK_LEAKS
+	// 释放之前检查控件树与索引
+	char leak_text[1024] = "";
+	HGUI_TextBuilder leak_builder = { leak_text, sizeof(leak_text), 0 };
+	memset(&hgui_ctx->leak_report, 0, sizeof(HGUI_LeakReport));
+	hgui_ctx->leak_report.checked = true;
+	leak_check_tree(&hgui_ctx->leak_report, &leak_builder);
+#endif
+	
+	// 先通知删除事件的订阅者
+	notify_removal(NULL);
+	
+	// 逐棵树自底向上释放所有控件（销毁窗口时的通知回调不能再删除控件）
+	for (HGUI_Control* control = hgui_ctx->controls; control; control = control->next) {
+		control->removing = true;
+	}
+	while (hgui_ctx->controls) {
+		HGUI_Control* root = hgui_ctx->controls;
+		while (root->parent) root = root->parent;
+		destroy_subtree(root);
+	}
+#ifdef HGUI_CHECK_LEAKS
+	// 控件已全部释放，仍在缓存中的字体说明有引用没有归还
+	for (const HGUI_Font* font = hgui_ctx->font_cache; font; font = font->next) {
+		hgui_ctx->leak_report.font_refs++;
+	}
+#endif
+	id_index_clear();
+	dispatch_index_clear();
+	font_cache_clear();
+	hgui_layout_destroy(&hgui_ctx->layout_tree);
+	update_state_clear();
+	op_queue_discard();
+	stats_dump_stop();
+	hgui_ctx->trace_recording = false;
+	hgui_trace_writer_free(&hgui_ctx->trace_writer);
+	hgui_sched_destroy(&hgui_ctx->scheduler);
+	subscription_table_clear();
+	
+	// 整体释放节点与字符串
+	pool_release_all();
+	hgui_ctx->main_window_hwnd = NULL;
+	hgui_ctx->menu_id_count = 0;
+	hgui_ctx->initialized = false;
+	
+#ifdef HGUI_CHECK_LEAKS
+	// 账目中剩下的对象没有经过对应的销毁路径
+	for (int type = 0; type < HGUI_CONTROL_TYPE_COUNT; type++) {
+		hgui_ctx->leak_report.controls += hgui_ctx->memory_ledger.controls[type];
+		hgui_ctx->leak_report.hwnds += hgui_ctx->memory_ledger.hwnds[type];
+		hgui_ctx->leak_report.hmenus += hgui_ctx->memory_ledger.hmenus[type];
+	}
+	hgui_ctx->leak_report.fonts = hgui_ctx->memory_ledger.fonts;
+	hgui_ctx->leak_report.accel_tables = hgui_ctx->memory_ledger.accel_tables;
+	leak_report_write(&hgui_ctx->leak_report, &leak_builder);
+#endif
+	memset(&hgui_ctx->memory_ledger, 0, sizeof(HGUI_MemoryLedger));
+}
+
+// 实例上下文实现
+static HGUI_Context* hgui_context_create(void) {
+	return (HGUI_Context*)calloc(1, sizeof(HGUI_Context));
+}
+
+static HGUI_Context* hgui_context_current(void) {
+	return hgui_ctx;
+}
+
+static HGUI_Context* hgui_context_makeCurrent(HGUI_Context* context) {
+	HGUI_Context* previous = hgui_ctx;
+	hgui_ctx = context ? context : &default_context;
+	return previous;
+}
+
+// 释放上下文（其界面属于调用线程）；释放调用线程的当前上下文后，当前上下文恢复为默认上下文
+static void hgui_context_destroy(HGUI_Context* context) {
+	if (!context || context == &default_context) return;
+	
+	HGUI_Context* previous = hgui_context_makeCurrent(context);
+	if (context->initialized) hgui_cleanup();
+	hgui_context_makeCurrent(previous == context ? NULL : previous);
+	free(context);
+}
+
+// 控件操作实现
+// 删除控件及其全部子控件，耗时与子树大小成正比
+static void hgui_remove(const char* id) {
+	// 通过索引定位要删除的控件
+	HGUI_Control* root = find_control(id);
+	if (!root || root->removing) return;
+	HGUI_Handle handle = make_handle(root);
+	
+	// 标记整棵子树，然后通知删除事件的订阅者（回调中删除这棵子树内的控件会被忽略）
+	for (HGUI_Control* node = subtree_first(root); node; node = subtree_next(node, root)) {
+		node->removing = true;
+	}
+	notify_removal(root);
+	
+	// 回调中可能已删除了它的祖先
+	root = resolve_handle(handle);
+	if (!root) return;
+	
+	// 菜单项先从所在菜单中删除（弹出菜单项的子菜单随之销毁）
+	if (root->type == HGUI_MENUITEM) {
+		menu_item_delete(root);
+	}
+	
+	// 参与布局的控件删除后，其余兄弟控件在下一帧重新布局
+	HGUI_Control* parent = root->layout ? root->parent : NULL;
+	destroy_subtree(root);
+	if (parent) layout_schedule(parent);
+}
+
+// 隐藏控件
+static void control_hide(HGUI_Control* control) {
+	control_set_visible(control, false);
+}
+
+static void hgui_hide(const char* id) {
+	control_hide(find_control(id));
+}
+
+// 显示控件
+static void control_show(HGUI_Control* control) {
+	control_set_visible(control, true);
+}
+
+static void hgui_show(const char* id) {
+	control_show(find_control(id));
+}
+
+static void hgui_bind(const char* id, const char* event, void (*callback)(const char*)) {
+	HGUI_Control* control = find_control(id);
+	if (!control || !event || !callback) return;
+	
+	if (strcmp(event, "click") == 0) {
+		control->click_callback = callback;
+	} else if (strcmp(event, "dblclick") == 0) {
+		control->dblclick_callback = callback;
+	} else if (strcmp(event, "change") == 0) {
+		control->change_callback = callback;
+	}
+}
+
+// 订阅控件事件，返回的订阅ID用于退订；控件不存在时返回HGUI_INVALID_SUBSCRIPTION。
+// 控件删除时其订阅自动失效
+static HGUI_Subscription hgui_subscribe(const char* id, HGUI_Event event, HGUI_EventCallback callback, void* user_data) {
+	return control_subscribe(find_control(id), event, callback, user_data);
+}
+
+// 退订，订阅ID无效或已退订时返回false；可以在事件回调中调用
+static bool hgui_unsubscribe(HGUI_Subscription subscription) {
+	int index = subscription_resolve(subscription);
+	if (index < 0) return false;
+	
+	HGUI_Control* control = hgui_ctx->subscription_nodes[index].owner;
+	subscription_retire((unsigned int)index);
+	if (control->dispatch_depth > 0) {
+		// 分发中：节点留在链表中，分发结束后回收
+		control->subscribers_dirty = true;
+	} else {
+		subscription_unlink(control, (unsigned int)index);
+		subscription_release((unsigned int)index);
+		subscription_update_mask(control);
+	}
+	return true;
+}
+
+static void control_set_text(HGUI_Control* control, const char* text) {
+	if (!control || !owns_hwnd(control) || !text) return;
+	
+	// 与缓存的文本相同时跳过原生调用（先比较长度和哈希，再逐字节确认）
+	size_t length;
+	unsigned int hash = hash_text(text, &length);
+	if (control->text_valid && control->text_length == length && control->text_hash == hash &&
+		memcmp(control->text, text, length) == 0) {
+		return;
+	}
+	
+	// 事务中暂停控件重绘，提交时随父窗口脏区域一起刷新
+	if (can_defer(control) && mark_dirty(control)) {
+		suspend_redraw(control);
+	}
+	hgui_ctx->text_update_target = control;
+	native_send(control->hwnd, WM_SETTEXT, 0, (LPARAM)text);
+	hgui_ctx->text_update_target = NULL;
+	text_store(control, text, length, hash);
+}
+
+static void hgui_setText(const char* id, const char* text) {
+	control_set_text(find_control(id), text);
+}
+
+// 从缓存复制文本，超出缓冲区时截断
+static void control_get_text(HGUI_Control* control, char* buffer, int buffer_size) {
+	if (!buffer || buffer_size <= 0) return;
+	
+	const char* text = control_text_view(control);
+	if (!text) return;
+	
+	size_t length = control->text_length;
+	if (length > (size_t)buffer_size - 1) length = (size_t)buffer_size - 1;
+	memcpy(buffer, text, length);
+	buffer[length] = '\0';
+}
+
+static void hgui_getText(const char* id, char* buffer, int buffer_size) {
+	control_get_text(find_control(id), buffer, buffer_size);
+}
+
+// 文本长度（不含结尾的'\0'），控件不存在时返回0
+static int control_get_text_length(HGUI_Control* control) {
+	return control_text_view(control) ? (int)control->text_length : 0;
+}
+
+static int hgui_getTextLength(const char* id) {
+	return control_get_text_length(find_control(id));
+}
+
+// 零拷贝读取文本：返回的指针在控件文本下次改变或控件删除前有效，控件不存在时返回NULL
+static const char* hgui_getTextView(const char* id) {
+	return control_text_view(find_control(id));
+}
+
+static void control_add_item(HGUI_Control* control, const char* item_text) {
+	if (control && control->type == HGUI_LISTBOX && !control->is_virtual && item_text) {
+		list_model_release(control);
+		native_send(control->hwnd, LB_ADDSTRING, 0, (LPARAM)item_text);
+	}
+}
+
+static void hgui_addItem(const char* list_id, const char* item_text) {
+	control_add_item(find_control(list_id), item_text);
+}
+
+static void hgui_removeItem(const char* list_id, int index) {
+	HGUI_Control* control = find_control(list_id);
+	if (control && control->type == HGUI_LISTBOX && !control->is_virtual && index >= 0) {
+		list_model_release(control);
+		native_send(control->hwnd, LB_DELETESTRING, (WPARAM)index, 0);
+	}
+}
+
+// 辅助函数：开始批量修改列表框（暂停重绘并按预计数量预分配存储）
+static void listbox_begin_bulk(HGUI_Control* control, int count, size_t bytes) {
+	native_send(control->hwnd, WM_SETREDRAW, FALSE, 0);
+	if (count > 0) {
+		native_send(control->hwnd, LB_INITSTORAGE, (WPARAM)count, (LPARAM)bytes);
+	}
+}
+
+// 辅助函数：结束批量修改列表框（恢复重绘并只刷新一次）
+static void listbox_end_bulk(HGUI_Control* control) {
+	native_send(control->hwnd, WM_SETREDRAW, TRUE, 0);
+	InvalidateRect(control->hwnd, NULL, TRUE);
+}
+
+// 批量添加列表项
+static void hgui_addItems(const char* list_id, const char** items, int count) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX || control->is_virtual || !items || count <= 0) return;
+	
+	size_t bytes = 0;
+	for (int i = 0; i < count; i++) {
+		if (items[i]) bytes += strlen(items[i]) + 1;
+	}
+	
+	list_model_release(control);
+	listbox_begin_bulk(control, count, bytes);
+	for (int i = 0; i < count; i++) {
+		if (items[i]) {
+			native_send(control->hwnd, LB_ADDSTRING, 0, (LPARAM)items[i]);
+		}
+	}
+	listbox_end_bulk(control);
+}
+
+// 批量添加列表项：blob中各项以'\0'分隔，整体以两个'\0'结尾
+static void hgui_addItemsBlob(const char* list_id, const char* blob) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX || control->is_virtual || !blob) return;
+	
+	int count = 0;
+	const char* end = blob;
+	while (*end) {
+		end += strlen(end) + 1;
+		count++;
+	}
+	if (count == 0) return;
+	
+	list_model_release(control);
+	listbox_begin_bulk(control, count, (size_t)(end - blob));
+	for (const char* item = blob; *item; item += strlen(item) + 1) {
+		native_send(control->hwnd, LB_ADDSTRING, 0, (LPARAM)item);
+	}
+	listbox_end_bulk(control);
+}
+
+// 批量删除从start开始的count个列表项
+static void hgui_removeItems(const char* list_id, int start, int count) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX || control->is_virtual || start < 0 || count <= 0) return;
+	
+	int total = (int)native_send(control->hwnd, LB_GETCOUNT, 0, 0);
+	if (start >= total) return;
+	if (count > total - start) count = total - start;
+	list_model_release(control);
+	
+	// 整个列表都被删除时直接清空
+	if (start == 0 && count == total) {
+		native_send(control->hwnd, LB_RESETCONTENT, 0, 0);
+		return;
+	}
+	
+	// 从末尾向前删除，减少列表框内部的数据移动
+	listbox_begin_bulk(control, 0, 0);
+	for (int index = start + count - 1; index >= start; index--) {
+		native_send(control->hwnd, LB_DELETESTRING, (WPARAM)index, 0);
+	}
+	listbox_end_bulk(control);
+}
+
+// 清空列表框（虚拟列表框的行数归零，行回调保持不变）
+static void hgui_clearList(const char* list_id) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX) return;
+	
+	if (control->is_virtual) {
+		control->row_count = 0;
+		native_send(control->hwnd, LB_SETCOUNT, 0, 0);
+		return;
+	}
+	list_model_release(control);
+	native_send(control->hwnd, LB_RESETCONTENT, 0, 0);
+}
+
+// 辅助函数：把差异应用到列表框，保持选中行与首个可见行（它们被删除时分别取消选中、停在替换处）
+static void list_apply_diff(HGUI_Control* control, const HGUI_Diff* diff, const HGUI_ListSnapshot* next) {
+	int selected = (int)native_send(control->hwnd, LB_GETCURSEL, 0, 0);
+	int top = (int)native_send(control->hwnd, LB_GETTOPINDEX, 0, 0);
+	if (selected >= 0) selected = hgui_diff_map(diff, selected, false, next->count);
+	if (top >= 0) top = hgui_diff_map(diff, top, true, next->count);
+	
+	size_t bytes = 0;
+	for (int h = 0; h < diff->count; h++) {
+		const HGUI_DiffHunk* hunk = &diff->hunks[h];
+		for (int i = 0; i < hunk->new_count; i++) {
+			bytes += strlen(next->rows[hunk->new_start + i]) + 1;
+		}
+	}
+	
+	// 从后向前应用，前面各段在旧列表中的位置不受影响
+	listbox_begin_bulk(control, diff->inserted, bytes);
+	for (int h = diff->count - 1; h >= 0; h--) {
+		const HGUI_DiffHunk* hunk = &diff->hunks[h];
+		for (int index = hunk->old_start + hunk->old_count - 1; index >= hunk->old_start; index--) {
+			native_send(control->hwnd, LB_DELETESTRING, (WPARAM)index, 0);
+		}
+		for (int i = 0; i < hunk->new_count; i++) {
+			native_send(control->hwnd, LB_INSERTSTRING, (WPARAM)(hunk->old_start + i), (LPARAM)next->rows[hunk->new_start + i]);
+		}
+	}
+	native_send(control->hwnd, LB_SETCURSEL, (WPARAM)selected, 0);
+	if (top >= 0) native_send(control->hwnd, LB_SETTOPINDEX, (WPARAM)top, 0);
+	listbox_end_bulk(control);
+}
+
+// 用一组行设置列表框的全部内容：与上次的内容比较，只插入/删除变化的行，保持选中行与滚动位置。
+// 首次调用（或其他列表操作之后）先从列表框读取当前内容
+static bool hgui_setItems(const char* list_id, const char* const* items, int count, HGUI_ListUpdate* update) {
+	HGUI_ListUpdate local;
+	if (!update) update = &local;
+	memset(update, 0, sizeof(HGUI_ListUpdate));
+	
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX || control->is_virtual || count < 0 || (count > 0 && !items)) return false;
+	
+	HGUI_ListModel* model = control->list_model;
+	if (!model) {
+		model = (HGUI_ListModel*)calloc(1, sizeof(HGUI_ListModel));
+		if (!model) return false;
+		if (!list_snapshot_capture(&model->snapshot, control)) {
+			free(model);
+			return false;
+		}
+		control->list_model = model;
+	}
+	
+	HGUI_ListSnapshot next;
+	if (!list_snapshot_build(&next, items, count)) return false;
+	
+	long long start = now_ns();
+	HGUI_DiffStrings strings = { model->snapshot.rows, model->snapshot.hashes, next.rows, next.hashes };
+	if (!hgui_diff_strings(&model->diff, &strings, model->snapshot.count, next.count, 0)) {
+		list_snapshot_free(&next);
+		return false;
+	}
+	long long diffed = now_ns();
+	update->diff_ms = (double)(diffed - start) / 1e6;
+	update->inserted = model->diff.inserted;
+	update->deleted = model->diff.deleted;
+	update->hunks = model->diff.count;
+	update->over_budget = model->diff.over_budget;
+	
+	if (model->diff.count > 0) {
+		list_apply_diff(control, &model->diff, &next);
+	}
+	update->apply_ms = (double)(now_ns() - diffed) / 1e6;
+	
+	list_snapshot_free(&model->snapshot);
+	model->snapshot = next;
+	return true;
+}
+
+static int hgui_getSelectedIndex(const char* list_id) {
+	HGUI_Control* control = find_control(list_id);
+	if (control && control->type == HGUI_LISTBOX) {
+		return (int)native_send(control->hwnd, LB_GETCURSEL, 0, 0);
+	}
+	return -1;
+}
+
+static void hgui_getListItem(const char* list_id, int index, char* buffer, int buffer_size) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX || index < 0 || !buffer || buffer_size <= 0) return;
+	
+	// 虚拟列表框直接向回调索取行文本
+	if (control->is_virtual) {
+		const char* text = (index < control->row_count && control->row_callback) ?
+			control->row_callback(index, control->row_context) : NULL;
+		strncpy(buffer, text ? text : "", (size_t)buffer_size - 1);
+		buffer[buffer_size - 1] = '\0';
+		return;
+	}
+	
+	// 先获取项目文本长度
+	int length = (int)native_send(control->hwnd, LB_GETTEXTLEN, (WPARAM)index, 0);
+	if (length >= buffer_size - 1) length = buffer_size - 2;
+	
+	// 获取项目文本
+	native_send(control->hwnd, LB_GETTEXT, (WPARAM)index, (LPARAM)buffer);
+	buffer[length + 1] = '\0'; // 确保字符串终止
+}
+
+// 设置虚拟列表框的行数据回调
+static void hgui_setRowProvider(const char* list_id, const char* (*row)(int index, void* ctx), void* ctx) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || !control->is_virtual) return;
+	
+	control->row_callback = row;
+	control->row_context = ctx;
+	InvalidateRect(control->hwnd, NULL, TRUE);
+}
+
+// 设置虚拟列表框的行数（列表框不保存任何行数据）
+static void hgui_setRowCount(const char* list_id, int count) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || !control->is_virtual || count < 0) return;
+	
+	control->row_count = count;
+	native_send(control->hwnd, LB_SETCOUNT, (WPARAM)count, 0);
+}
+
+// 获取虚拟/普通列表框当前可见的行范围
+static bool hgui_getVisibleRange(const char* list_id, int* first, int* last) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX || !first || !last) return false;
+	
+	RECT client;
+	GetClientRect(control->hwnd, &client);
+	int top = (int)native_send(control->hwnd, LB_GETTOPINDEX, 0, 0);
+	int row_height = (int)native_send(control->hwnd, LB_GETITEMHEIGHT, 0, 0);
+	int count = (int)native_send(control->hwnd, LB_GETCOUNT, 0, 0);
+	return visible_row_range(top, client.bottom - client.top, row_height, count, first, last);
+}
+
+// 行数据变化后通知重绘，只有落在可见范围内的行才会被刷新
+static void hgui_invalidateRows(const char* list_id, int first, int count) {
+	HGUI_Control* control = find_control(list_id);
+	if (!control || control->type != HGUI_LISTBOX || count <= 0) return;
+	
+	int visible_first, visible_last;
+	if (!hgui_getVisibleRange(list_id, &visible_first, &visible_last)) return;
+	
+	int last = first + count - 1;
+	if (first < visible_first) first = visible_first;
+	if (last > visible_last) last = visible_last;
+	if (first > last) return;
+	
+	RECT first_rect, last_rect;
+	native_send(control->hwnd, LB_GETITEMRECT, (WPARAM)first, (LPARAM)&first_rect);
+	native_send(control->hwnd, LB_GETITEMRECT, (WPARAM)last, (LPARAM)&last_rect);
+	first_rect.bottom = last_rect.bottom;
+	InvalidateRect(control->hwnd, &first_rect, TRUE);
+}
+
+// 辅助函数：设置原生选中状态与对应字体
+static void apply_check(HGUI_Control* control, bool checked) {
+	// 状态未变化时跳过原生调用
+	if (control->checked == checked) return;
+	control->checked = checked;
+	
+	// 设置复选框/单选框状态
+	native_send(control->hwnd, BM_SETCHECK, checked ? BST_CHECKED : BST_UNCHECKED, 0);
+	
+	// 视觉反馈：选中状态使用粗体（字体来自缓存，不再每次新建）
+	control_apply_font(control, checked);
+}
+
+static void control_set_check(HGUI_Control* control, bool checked) {
+	if (!control || (control->type != HGUI_CHECKBOX && control->type != HGUI_RADIO)) return;
+	
+	HGUI_RadioGroup* group = control->radio_group;
+	if (!group) {
+		apply_check(control, checked);
+		return;
+	}
+	
+	// 单选框：选中状态变化只涉及原选中项与当前项两个控件
+	if (checked) {
+		if (group->checked && group->checked != control) {
+			apply_check(group->checked, false);
+		}
+		group->checked = control;
+	} else if (group->checked == control) {
+		group->checked = NULL;
+	}
+	apply_check(control, checked);
+}
+
+static void hgui_setCheck(const char* id, bool checked) {
+	control_set_check(find_control(id), checked);
+}
+
+static bool control_get_check(HGUI_Control* control) {
+	if (!control || (control->type != HGUI_CHECKBOX && control->type != HGUI_RADIO)) return false;
+	
+	// 选中状态只由库修改（按钮均为非自动样式），直接读取缓存
+	return control->checked;
+}
+
+static bool hgui_getCheck(const char* id) {
+	return control_get_check(find_control(id));
+}
+
+// 设置控件字体（size为字符高度，单位像素；weight为0时使用常规粗细）
+static void hgui_setFont(const char* id, const char* face, int size, int weight, bool italic) {
+	HGUI_Control* control = find_control(id);
+	if (!control || !owns_hwnd(control)) return;
+	
+	LOGFONT lf;
+	default_logfont(&lf);
+	if (face) {
+		strncpy(lf.lfFaceName, face, sizeof(lf.lfFaceName) - 1);
+		lf.lfFaceName[sizeof(lf.lfFaceName) - 1] = '\0';
+	}
+	if (size > 0) {
+		lf.lfHeight = -size;
+		lf.lfWidth = 0;
+	}
+	lf.lfWeight = weight > 0 ? weight : FW_NORMAL;
+	lf.lfItalic = italic ? TRUE : FALSE;
+	
+	HGUI_Font* font = font_acquire(&lf);
+	if (!font) return;
+	font_release(control->base_font);
+	control->base_font = font;
+	
+	// 选中的复选框/单选框保持粗体
+	control_apply_font(control, control_get_check(control));
+}
+
+// 获取单选框所在组当前选中项的ID（无选中项时返回NULL）
+static const char* hgui_getSelectedRadio(const char* radio_id) {
+	HGUI_Control* control = find_control(radio_id);
+	if (!control || !control->radio_group || !control->radio_group->checked) return NULL;
+	
+	return control->radio_group->checked->id;
+}
+
+// 按句柄操作实现
+static HGUI_Handle hgui_handle_lookup(const char* id) {
+	return make_handle(find_control(id));
+}
+
+static bool hgui_handle_valid(HGUI_Handle handle) {
+	return resolve_handle(handle) != NULL;
+}
+
+static void hgui_handle_hide(HGUI_Handle handle) {
+	control_hide(resolve_handle(handle));
+}
+
+static void hgui_handle_show(HGUI_Handle handle) {
+	control_show(resolve_handle(handle));
+}
+
+static void hgui_handle_setText(HGUI_Handle handle, const char* text) {
+	control_set_text(resolve_handle(handle), text);
+}
+
+static void hgui_handle_getText(HGUI_Handle handle, char* buffer, int buffer_size) {
+	control_get_text(resolve_handle(handle), buffer, buffer_size);
+}
+
+static int hgui_handle_getTextLength(HGUI_Handle handle) {
+	return control_get_text_length(resolve_handle(handle));
+}
+
+static const char* hgui_handle_getTextView(HGUI_Handle handle) {
+	return control_text_view(resolve_handle(handle));
+}
+
+static void hgui_handle_addItem(HGUI_Handle list, const char* item_text) {
+	control_add_item(resolve_handle(list), item_text);
+}
+
+static void hgui_handle_setCheck(HGUI_Handle handle, bool checked) {
+	control_set_check(resolve_handle(handle), checked);
+}
+
+static bool hgui_handle_getCheck(HGUI_Handle handle) {
+	return control_get_check(resolve_handle(handle));
+}
+
+static HGUI_Subscription hgui_handle_subscribe(HGUI_Handle handle, HGUI_Event event, HGUI_EventCallback callback, void* user_data) {
+	return control_subscribe(resolve_handle(handle), event, callback, user_data);
+}
+
+// 跨线程更新队列：多生产者无锁入栈，UI线程一次取走整批并按时间顺序应用。
+// 同一控件同一属性（文本、选中状态、可见性）在一批中只应用最后一次写入。
+typedef enum {
+	HGUI_OP_SET_TEXT,
+	HGUI_OP_SET_CHECK,
+	HGUI_OP_SET_VISIBLE,
+	HGUI_OP_ADD_ITEM,       // 追加操作不可合并
+	HGUI_OP_CALL            // 在UI线程调用函数，不可合并
+} HGUI_OpKind;
+
+struct HGUI_Op {
+	HGUI_Op* next;
+	HGUI_OpKind kind;
+	bool flag;              // 选中状态/可见性
+	bool superseded;        // 已被同批次中更晚的写入覆盖
+	unsigned int hash;      // ID与属性的组合哈希
+	unsigned int segment;   // 合并时所在的段（批次按函数调用分段）
+	const char* id;         // 与操作结构体一起分配
+	const char* text;
+	void (*function)(void* user_data);  // HGUI_OP_CALL 调用的函数
+	void* user_data;
+};
+
+// 辅助函数：创建操作（ID和文本与结构体一次分配）
+static HGUI_Op* op_create(HGUI_OpKind kind, const char* id, const char* text, bool flag) {
+	if (!id) return NULL;
+	
+	size_t id_length = strlen(id) + 1;
+	size_t text_length = text ? strlen(text) + 1 : 0;
+	HGUI_Op* op = (HGUI_Op*)malloc(sizeof(HGUI_Op) + id_length + text_length);
+	if (!op) return NULL;
+	
+	char* storage = (char*)(op + 1);
+	memcpy(storage, id, id_length);
+	op->id = storage;
+	op->text = NULL;
+	if (text) {
+		memcpy(storage + id_length, text, text_length);
+		op->text = storage + id_length;
 	}
+	op->kind = kind;
+	op->flag = flag;
+	op->superseded = false;
+	op->hash = (hash_id(id) ^ ((unsigned int)kind * 0x9E3779B9u)) | 1u;
+	op->function = NULL;
+	op->user_data = NULL;
+	return op;
 }
 
-// 隐藏控件
-static void hgui_hide(const char* id) {
-	HGUI_Control* control = find_control(id);
-	if (control && control->hwnd) {
-		ShowWindow(control->hwnd, SW_HIDE);
-		// 通知父窗口重绘
-		if (control->parent_id) {
-			HWND parent_hwnd = find_parent_hwnd(control->parent_id);
-			if (parent_hwnd) {
-				InvalidateRect(parent_hwnd, NULL, TRUE);
-			}
-		}
-	}
+// 辅助函数：创建函数调用操作
+static HGUI_Op* op_create_call(void (*function)(void* user_data), void* user_data) {
+	HGUI_Op* op = (HGUI_Op*)malloc(sizeof(HGUI_Op));
+	if (!op) return NULL;
+	
+	memset(op, 0, sizeof(HGUI_Op));
+	op->kind = HGUI_OP_CALL;
+	op->id = "";
+	op->function = function;
+	op->user_data = user_data;
+	return op;
 }
 
-// 显示控件
-static void hgui_show(const char* id) {
-	HGUI_Control* control = find_control(id);
-	if (control && control->hwnd) {
-		ShowWindow(control->hwnd, SW_SHOW);
-		// 通知父窗口重绘
-		if (control->parent_id) {
-			HWND parent_hwnd = find_parent_hwnd(control->parent_id);
-			if (parent_hwnd) {
-				InvalidateRect(parent_hwnd, NULL, TRUE);
-			}
-		}
+// 辅助函数：无锁入队，队列由空变为非空时唤醒UI线程（每批只投递一条消息）
+static void op_push(HGUI_Op* op) {
+	if (!op) return;
+	
+	// 失败时比较交换返回的就是最新的队头，直接用于下一次尝试（首次用比较交换做原子读取）
+	PVOID volatile* queue = (PVOID volatile*)&hgui_ctx->op_queue_head;
+	HGUI_Op* head = (HGUI_Op*)InterlockedCompareExchangePointer(queue, NULL, NULL);
+	while (true) {
+		op->next = head;
+		HGUI_Op* seen = (HGUI_Op*)InterlockedCompareExchangePointer(queue, op, head);
+		if (seen == head) break;
+		head = seen;
+	}
+	
+	if (InterlockedExchange(&hgui_ctx->op_wake_pending, 1) == 0) {
+		PostThreadMessage(hgui_ctx->ui_thread_id, WM_HGUI_WAKE, 0, 0);
 	}
 }
 
-static void hgui_bind(const char* id, const char* event, void (*callback)(const char*)) {
-	HGUI_Control* control = find_control(id);
-	if (!control || !event || !callback) return;
+// 辅助函数：标记同批次中被覆盖的写入（list为从新到旧的顺序）。
+// 函数调用是屏障：只合并相邻两次调用之间的写入，调用看到的是它之前投递的状态。
+// 每遇到一次调用进入新的段，哈希表中属于之前段的项视为空槽，相当于清空了哈希表
+static void op_mark_superseded(HGUI_Op* list, size_t count) {
+	size_t capacity = hgui_ctx->op_seen_capacity ? hgui_ctx->op_seen_capacity : 64;
+	while (count * 2 >= capacity) capacity *= 2;
+	if (capacity != hgui_ctx->op_seen_capacity) {
+		HGUI_Op** table = (HGUI_Op**)realloc(hgui_ctx->op_seen, capacity * sizeof(HGUI_Op*));
+		if (!table) return;
+		hgui_ctx->op_seen = table;
+		hgui_ctx->op_seen_capacity = capacity;
+	}
+	memset(hgui_ctx->op_seen, 0, hgui_ctx->op_seen_capacity * sizeof(HGUI_Op*));
 	
-	if (strcmp(event, "click") == 0) {
-		control->click_callback = callback;
-	} else if (strcmp(event, "dblclick") == 0) {
-		control->dblclick_callback = callback;
-	} else if (strcmp(event, "change") == 0) {
-		control->change_callback = callback;
+	size_t mask = hgui_ctx->op_seen_capacity - 1;
+	unsigned int segment = 0;
+	for (HGUI_Op* op = list; op; op = op->next) {
+		if (op->kind == HGUI_OP_CALL) {
+			segment++;
+			continue;
+		}
+		if (op->kind == HGUI_OP_ADD_ITEM) continue;
+		
+		op->segment = segment;
+		size_t i = op->hash & mask;
+		while (hgui_ctx->op_seen[i] && hgui_ctx->op_seen[i]->segment == segment) {
+			HGUI_Op* seen = hgui_ctx->op_seen[i];
+			if (seen->hash == op->hash && seen->kind == op->kind && strcmp(seen->id, op->id) == 0) {
+				op->superseded = true;
+				break;
+			}
+			i = (i + 1) & mask;
+		}
+		if (!op->superseded) hgui_ctx->op_seen[i] = op;
 	}
 }
 
-static void hgui_setText(const char* id, const char* text) {
-	HGUI_Control* control = find_control(id);
-	if (control && control->hwnd && text) {
-		SendMessage(control->hwnd, WM_SETTEXT, 0, (LPARAM)text);
+// 辅助函数：应用一个操作
+static void op_apply(const HGUI_Op* op) {
+	HGUI_Control* control = op->kind == HGUI_OP_CALL ? NULL : find_control(op->id);
+	switch (op->kind) {
+		case HGUI_OP_SET_TEXT:
+			control_set_text(control, op->text);
+			break;
+		case HGUI_OP_SET_CHECK:
+			control_set_check(control, op->flag);
+			break;
+		case HGUI_OP_SET_VISIBLE:
+			control_set_visible(control, op->flag);
+			break;
+		case HGUI_OP_ADD_ITEM:
+			control_add_item(control, op->text);
+			break;
+		case HGUI_OP_CALL:
+			op->function(op->user_data);
+			break;
 	}
 }
 
-static void hgui_getText(const char* id, char* buffer, int buffer_size) {
-	HGUI_Control* control = find_control(id);
-	if (control && control->hwnd && buffer && buffer_size > 0) {
-		SendMessage(control->hwnd, WM_GETTEXT, (WPARAM)buffer_size, (LPARAM)buffer);
+// 辅助函数：取走整批操作，合并后按投递顺序应用（UI线程调用）
+static void op_queue_drain(void) {
+	// 先清除唤醒标志，之后入队的操作会重新投递唤醒消息
+	InterlockedExchange(&hgui_ctx->op_wake_pending, 0);
+	HGUI_Op* list = (HGUI_Op*)InterlockedExchangePointer((PVOID volatile*)&hgui_ctx->op_queue_head, NULL);
+	if (!list) return;
+	
+	HGUI_STATS_BEGIN(start);
+	size_t count = 0;
+	for (HGUI_Op* op = list; op; op = op->next) count++;
+	op_mark_superseded(list, count);
+	
+	// 反转为从旧到新的顺序
+	HGUI_Op* ordered = NULL;
+	while (list) {
+		HGUI_Op* next = list->next;
+		list->next = ordered;
+		ordered = list;
+		list = next;
+	}
+	
+	// 整批更新放在一个事务中，只重绘一次
+	hgui_beginUpdate();
+	while (ordered) {
+		HGUI_Op* next = ordered->next;
+		if (!ordered->superseded) op_apply(ordered);
+		free(ordered);
+		ordered = next;
 	}
+	hgui_endUpdate();
+	HGUI_STATS_END(start, hgui_ctx->stats_drains);
 }
 
-static void hgui_addItem(const char* list_id, const char* item_text) {
-	HGUI_Control* control = find_control(list_id);
-	if (control && control->type == HGUI_LISTBOX && item_text) {
-		SendMessage(control->hwnd, LB_ADDSTRING, 0, (LPARAM)item_text);
+// 辅助函数：丢弃队列中尚未应用的操作（cleanup时调用，未执行的函数调用同样被丢弃）
+static void op_queue_discard(void) {
+	HGUI_Op* list = (HGUI_Op*)InterlockedExchangePointer((PVOID volatile*)&hgui_ctx->op_queue_head, NULL);
+	while (list) {
+		HGUI_Op* next = list->next;
+		free(list);
+		list = next;
 	}
+	InterlockedExchange(&hgui_ctx->op_wake_pending, 0);
+	free(hgui_ctx->op_seen);
+	hgui_ctx->op_seen = NULL;
+	hgui_ctx->op_seen_capacity = 0;
 }
 
-static void hgui_removeItem(const char* list_id, int index) {
-	HGUI_Control* control = find_control(list_id);
-	if (control && control->type == HGUI_LISTBOX && index >= 0) {
-		SendMessage(control->hwnd, LB_DELETESTRING, (WPARAM)index, 0);
-	}
+// 跨线程投递实现
+static void hgui_post_setText(const char* id, const char* text) {
+	if (text) op_push(op_create(HGUI_OP_SET_TEXT, id, text, false));
 }
 
-static void hgui_clearList(const char* list_id) {
-	HGUI_Control* control = find_control(list_id);
-	if (control && control->type == HGUI_LISTBOX) {
-		SendMessage(control->hwnd, LB_RESETCONTENT, 0, 0);
-	}
+static void hgui_post_addItem(const char* list_id, const char* item_text) {
+	if (item_text) op_push(op_create(HGUI_OP_ADD_ITEM, list_id, item_text, false));
 }
 
-static int hgui_getSelectedIndex(const char* list_id) {
-	HGUI_Control* control = find_control(list_id);
-	if (control && control->type == HGUI_LISTBOX) {
-		return (int)SendMessage(control->hwnd, LB_GETCURSEL, 0, 0);
-	}
-	return -1;
+static void hgui_post_setCheck(const char* id, bool checked) {
+	op_push(op_create(HGUI_OP_SET_CHECK, id, NULL, checked));
 }
 
-static void hgui_getListItem(const char* list_id, int index, char* buffer, int buffer_size) {
-	HGUI_Control* control = find_control(list_id);
-	if (control && control->type == HGUI_LISTBOX && index >= 0 && buffer && buffer_size > 0) {
-		// 先获取项目文本长度
-		int length = (int)SendMessage(control->hwnd, LB_GETTEXTLEN, (WPARAM)index, 0);
-		if (length >= buffer_size - 1) length = buffer_size - 2;
-		
-		// 获取项目文本
-		SendMessage(control->hwnd, LB_GETTEXT, (WPARAM)index, (LPARAM)buffer);
-		buffer[length + 1] = '\0'; // 确保字符串终止
-	}
+static void hgui_post_show(const char* id) {
+	op_push(op_create(HGUI_OP_SET_VISIBLE, id, NULL, true));
 }
 
-static void hgui_setCheck(const char* id, bool checked) {
-	HGUI_Control* control = find_control(id);
-	if (!control || (control->type != HGUI_CHECKBOX && control->type != HGUI_RADIO)) return;
-	
-	// 设置复选框/单选框状态
-	SendMessage(control->hwnd, BM_SETCHECK, checked ? BST_CHECKED : BST_UNCHECKED, 0);
-	
-	// 视觉反馈：选中状态使用粗体（修复了BOLD_FONT未定义的问题）
-	HFONT font;
-	if (checked) {
-		// 获取默认字体信息
-		LOGFONT lf;
-		GetObject((HFONT)GetStockObject(DEFAULT_GUI_FONT), sizeof(LOGFONT), &lf);
-		// 设置为粗体
-		lf.lfWeight = FW_BOLD;
-		// 创建粗体字体
-		font = CreateFontIndirect(&lf);
-	} else {
-		// 使用默认字体
-		font = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
-	}
-	SendMessage(control->hwnd, WM_SETFONT, (WPARAM)font, TRUE);
+static void hgui_post_hide(const char* id) {
+	op_push(op_create(HGUI_OP_SET_VISIBLE, id, NULL, false));
 }
 
-static bool hgui_getCheck(const char* id) {
-	HGUI_Control* control = find_control(id);
-	if (!control || (control->type != HGUI_CHECKBOX && control->type != HGUI_RADIO)) return false;
-	
-	return SendMessage(control->hwnd, BM_GETCHECK, 0, 0) == BST_CHECKED;
+// 在UI线程的消息循环中调用function(user_data)，与其他投递的更新保持先后顺序
+static void hgui_post_call(void (*function)(void* user_data), void* user_data) {
+	if (function) op_push(op_create_call(function, user_data));
 }
 
 // 创建控件函数实现
-static void hgui_create_window(const char* id, const char* title, int x, int y, int width, int height) {
+static HGUI_Handle hgui_create_window(const char* id, const char* title, int x, int y, int width, int height) {
 	const char* class_name = "HGUI_WindowClass";
-	register_window_class(class_name);
+	register_window_class(class_name, WndProc, (HBRUSH)(COLOR_WINDOW + 1));
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = NULL;
-	control->type = HGUI_WINDOW;
-	control->hwnd = NULL;
-	control->hmenu = NULL;
-	control->menu_id = 0;
-	control->is_submenu = false;
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	HGUI_Control* control = alloc_control(id, NULL, HGUI_WINDOW);
+	if (!control) return HGUI_INVALID_HANDLE;
 	
 	// 创建窗口（添加WS_CLIPCHILDREN确保菜单正确显示）
 	control->hwnd = CreateWindowEx(
@@ -391,161 +3500,153 @@ static void hgui_create_window(const char* id, const char* title, int x, int y,
 								   title,
 								   WS_OVERLAPPEDWINDOW | WS_CLIPCHILDREN,
 								   x, y, width, height,
-								   NULL, NULL, hInstance, NULL
+								   NULL, NULL, hgui_ctx->hInstance, NULL
 								   );
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	// 添加到控件链表与索引
+	register_control(control);
 	
 	// 显示窗口
 	ShowWindow(control->hwnd, SW_SHOW);
 	UpdateWindow(control->hwnd);
 	
-	main_window_hwnd = control->hwnd;
+	hgui_ctx->main_window_hwnd = control->hwnd;
+	
+	return make_handle(control);
 }
 
-static void hgui_create_label(const char* id, const char* parent_id, const char* text, 
+static HGUI_Handle hgui_create_label(const char* id, const char* parent_id, const char* text, 
 							  int x, int y, int width, int height) {
-	HWND parent_hwnd = find_parent_hwnd(parent_id);
-	if (!parent_hwnd) return;
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = _strdup(parent_id);
-	control->type = HGUI_LABEL;
-	control->hwnd = NULL;
-	control->hmenu = NULL;
-	control->menu_id = 0;
-	control->is_submenu = false;
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	HGUI_Control* control = alloc_control(id, parent, HGUI_LABEL);
+	if (!control) return HGUI_INVALID_HANDLE;
 	
 	// 创建标签
 	control->hwnd = CreateWindowEx(
 								   0, "STATIC", text,
 								   WS_CHILD | WS_VISIBLE | SS_LEFT,
 								   x, y, width, height,
-								   parent_hwnd, NULL, hInstance, NULL
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
 								   );
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
 }
 
-static void hgui_create_button(const char* id, const char* parent_id, const char* text,
+static HGUI_Handle hgui_create_button(const char* id, const char* parent_id, const char* text,
 							   int x, int y, int width, int height) {
-	HWND parent_hwnd = find_parent_hwnd(parent_id);
-	if (!parent_hwnd) return;
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = _strdup(parent_id);
-	control->type = HGUI_BUTTON;
-	control->hwnd = NULL;
-	control->hmenu = NULL;
-	control->menu_id = 0;
-	control->is_submenu = false;
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	HGUI_Control* control = alloc_control(id, parent, HGUI_BUTTON);
+	if (!control) return HGUI_INVALID_HANDLE;
 	
 	// 创建按钮
 	control->hwnd = CreateWindowEx(
 								   0, "BUTTON", text,
 								   WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
 								   x, y, width, height,
-								   parent_hwnd, NULL, hInstance, NULL
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
 								   );
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
 }
 
-static void hgui_create_input(const char* id, const char* parent_id,
+static HGUI_Handle hgui_create_input(const char* id, const char* parent_id,
 							  int x, int y, int width, int height) {
-	HWND parent_hwnd = find_parent_hwnd(parent_id);
-	if (!parent_hwnd) return;
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = _strdup(parent_id);
-	control->type = HGUI_INPUT;
-	control->hwnd = NULL;
-	control->hmenu = NULL;
-	control->menu_id = 0;
-	control->is_submenu = false;
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	HGUI_Control* control = alloc_control(id, parent, HGUI_INPUT);
+	if (!control) return HGUI_INVALID_HANDLE;
 	
 	// 创建输入框
 	control->hwnd = CreateWindowEx(
 								   WS_EX_CLIENTEDGE, "EDIT", "",
 								   WS_CHILD | WS_VISIBLE | ES_LEFT | ES_AUTOHSCROLL,
 								   x, y, width, height,
-								   parent_hwnd, NULL, hInstance, NULL
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
 								   );
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
 }
 
-static void hgui_create_listbox(const char* id, const char* parent_id,
+static HGUI_Handle hgui_create_listbox(const char* id, const char* parent_id,
 								int x, int y, int width, int height) {
-	HWND parent_hwnd = find_parent_hwnd(parent_id);
-	if (!parent_hwnd) return;
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = _strdup(parent_id);
-	control->type = HGUI_LISTBOX;
-	control->hwnd = NULL;
-	control->hmenu = NULL;
-	control->menu_id = 0;
-	control->is_submenu = false;
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	HGUI_Control* control = alloc_control(id, parent, HGUI_LISTBOX);
+	if (!control) return HGUI_INVALID_HANDLE;
 	
 	// 创建列表框
 	control->hwnd = CreateWindowEx(
 								   WS_EX_CLIENTEDGE, "LISTBOX", "",
 								   WS_CHILD | WS_VISIBLE | LBS_NOTIFY | WS_VSCROLL,
 								   x, y, width, height,
-								   parent_hwnd, NULL, hInstance, NULL
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
+								   );
+	
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
+}
+
+static HGUI_Handle hgui_create_virtualList(const char* id, const char* parent_id,
+										   int x, int y, int width, int height) {
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
+	
+	// 分配控件结构体
+	HGUI_Control* control = alloc_control(id, parent, HGUI_LISTBOX);
+	if (!control) return HGUI_INVALID_HANDLE;
+	
+	control->is_virtual = true;
+	
+	// 创建无数据的自绘列表框：行文本在绘制时由回调提供
+	control->hwnd = CreateWindowEx(
+								   WS_EX_CLIENTEDGE, "LISTBOX", "",
+								   WS_CHILD | WS_VISIBLE | LBS_NOTIFY | WS_VSCROLL |
+								   LBS_NODATA | LBS_OWNERDRAWFIXED | LBS_NOINTEGRALHEIGHT,
+								   x, y, width, height,
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
 								   );
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
 }
 
-static void hgui_create_radio(const char* id, const char* parent_id, const char* text,
+static HGUI_Handle hgui_create_radio(const char* id, const char* parent_id, const char* text,
 							  int x, int y, int width, int height, bool is_group_first) {
-	HWND parent_hwnd = find_parent_hwnd(parent_id);
-	if (!parent_hwnd) return;
+	HGUI_Control* parent = find_control(parent_id);
+	HWND parent_hwnd = parent ? parent->hwnd : NULL;
+	if (!parent_hwnd) return HGUI_INVALID_HANDLE;
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = _strdup(parent_id);
-	control->type = HGUI_RADIO;
-	control->hwnd = NULL;
-	control->hmenu = NULL;
-	control->menu_id = 0;
-	control->is_submenu = false;
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	HGUI_Control* control = alloc_control(id, parent, HGUI_RADIO);
+	if (!control) return HGUI_INVALID_HANDLE;
 	
 	// 单选框样式：WS_GROUP用于标记一组单选框的第一个
 	DWORD style = WS_CHILD | WS_VISIBLE | BS_RADIOBUTTON;
@@ -557,90 +3658,78 @@ static void hgui_create_radio(const char* id, const char* parent_id, const char*
 								   0, "BUTTON", text,
 								   style,
 								   x, y, width, height,
-								   parent_hwnd, NULL, hInstance, NULL
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
 								   );
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	// 添加到控件链表与索引，并加入单选框组
+	register_control(control);
+	radio_group_join(control, parent, is_group_first);
+	
+	return make_handle(control);
 }
 
-static void hgui_create_checkbox(const char* id, const char* parent_id, const char* text,
+static HGUI_Handle hgui_create_checkbox(const char* id, const char* parent_id, const char* text,
 								 int x, int y, int width, int height) {
-	HWND parent_hwnd = find_parent_hwnd(parent_id);
-	if (!parent_hwnd) return;
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = _strdup(parent_id);
-	control->type = HGUI_CHECKBOX;
-	control->hwnd = NULL;
-	control->hmenu = NULL;
-	control->menu_id = 0;
-	control->is_submenu = false;
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	HGUI_Control* control = alloc_control(id, parent, HGUI_CHECKBOX);
+	if (!control) return HGUI_INVALID_HANDLE;
 	
 	control->hwnd = CreateWindowEx(
 								   0, "BUTTON", text,
 								   WS_CHILD | WS_VISIBLE | BS_CHECKBOX,
 								   x, y, width, height,
-								   parent_hwnd, NULL, hInstance, NULL
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
 								   );
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
 }
 
-static void hgui_create_menubar(const char* id, const char* parent_id) {
-	HWND parent_hwnd = find_parent_hwnd(parent_id);
-	if (!parent_hwnd) return;
+static HGUI_Handle hgui_create_menubar(const char* id, const char* parent_id) {
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
 	
 	// 分配控件结构体
-	HGUI_Control* control = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	control->id = _strdup(id);
-	control->parent_id = _strdup(parent_id);
-	control->type = HGUI_MENUBAR;
+	HGUI_Control* control = alloc_control(id, parent, HGUI_MENUBAR);
+	if (!control) return HGUI_INVALID_HANDLE;
+	
 	control->hwnd = parent_hwnd;  // 菜单栏关联到父窗口
 	control->hmenu = CreateMenu(); // 创建主菜单
-	control->menu_id = 0;
 	control->is_submenu = true;    // 菜单栏是顶级菜单容器
-	control->click_callback = NULL;
-	control->dblclick_callback = NULL;
-	control->change_callback = NULL;
+	if (control->hmenu) hgui_ctx->memory_ledger.hmenus[HGUI_MENUBAR]++;
 	
 	// 设置窗口菜单
 	SetMenu(parent_hwnd, control->hmenu);
-	DrawMenuBar(parent_hwnd);  // 强制重绘菜单
+	menu_redraw(parent_hwnd);  // 强制重绘菜单
+	
+	// 添加到控件链表与索引
+	register_control(control);
 	
-	// 添加到控件链表
-	control->next = controls;
-	controls = control;
+	return make_handle(control);
 }
 
-static void hgui_create_addMenuItem(const char* parent_id, const char* id, const char* text, bool is_submenu) {
-	HGUI_Control* parent = find_control(parent_id);
-	if (!parent || !parent->is_submenu || !parent->hmenu) return;
+// 辅助函数：在菜单栏或子菜单末尾添加菜单项
+static HGUI_Control* menu_item_append(HGUI_Control* parent, const char* id, const char* text, bool is_submenu) {
+	if (!parent || !parent->is_submenu || !parent->hmenu) return NULL;
 	
 	// 分配控件结构体
-	HGUI_Control* item = (HGUI_Control*)malloc(sizeof(HGUI_Control));
-	item->id = _strdup(id);
-	item->parent_id = _strdup(parent_id);
-	item->type = HGUI_MENUITEM;
+	HGUI_Control* item = alloc_control(id, parent, HGUI_MENUITEM);
+	if (!item) return NULL;
+	
 	item->hwnd = parent->hwnd;  // 关联到父窗口
-	item->hmenu = NULL;
-	item->menu_id = 0;
 	item->is_submenu = is_submenu;
-	item->click_callback = NULL;
-	item->dblclick_callback = NULL;
-	item->change_callback = NULL;
 	
 	if (is_submenu) {
 		// 子菜单容器
 		item->hmenu = CreatePopupMenu();
+		if (item->hmenu) hgui_ctx->memory_ledger.hmenus[HGUI_MENUITEM]++;
 		AppendMenu(parent->hmenu, MF_STRING | MF_POPUP, 
 				   (UINT_PTR)item->hmenu, text);
 	} else {
@@ -652,18 +3741,566 @@ static void hgui_create_addMenuItem(const char* parent_id, const char* id, const
 			AppendMenu(parent->hmenu, MF_SEPARATOR, 0, NULL);
 			item->menu_id = 0;
 		} else {
-			item->menu_id = next_menu_id++;  // 分配唯一ID
+			item->menu_id = HGUI_MENU_ID_BASE + hgui_ctx->menu_id_count++;  // 分配唯一ID
 			AppendMenu(parent->hmenu, MF_STRING, 
 					   (UINT_PTR)item->menu_id, text);
 		}
 	}
 	
-	// 添加到控件链表
-	item->next = controls;
-	controls = item;
+	// 添加到控件链表与索引
+	register_control(item);
+	
+	// 强制重绘菜单（事务中合并为一次）
+	menu_redraw(parent->hwnd);
+	
+	return item;
+}
+
+static HGUI_Handle hgui_create_addMenuItem(const char* parent_id, const char* id, const char* text, bool is_submenu) {
+	HGUI_Control* item = menu_item_append(find_control(parent_id), id, text, is_submenu);
+	return item ? make_handle(item) : HGUI_INVALID_HANDLE;
+}
+
+static HGUI_Handle hgui_create_canvas(const char* id, const char* parent_id, int x, int y, int width, int height) {
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
+	
+	const char* class_name = "HGUI_CanvasClass";
+	register_window_class(class_name, CanvasProc, NULL);
+	
+	// 分配控件结构体与帧缓冲（初始为不透明白色）
+	HGUI_Control* control = alloc_control(id, parent, HGUI_CANVAS);
+	if (!control) return HGUI_INVALID_HANDLE;
+	
+	control->canvas = (HGUI_Canvas*)calloc(1, sizeof(HGUI_Canvas));
+	if (!control->canvas || !hgui_surface_init(&control->canvas->surface, width > 0 ? width : 0, height > 0 ? height : 0)) {
+		free(control->canvas);
+		control->canvas = NULL;
+		pool_free_control(control);
+		return HGUI_INVALID_HANDLE;
+	}
+	hgui_raster_fill(&control->canvas->surface, hgui_rect_make(0, 0, width, height), HGUI_RGB(255, 255, 255));
+	
+	// 创建画布窗口
+	control->hwnd = CreateWindowEx(
+								   0, class_name, "",
+								   WS_CHILD | WS_VISIBLE,
+								   x, y, width, height,
+								   parent_hwnd, NULL, hgui_ctx->hInstance, NULL
+								   );
+	
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
+}
+
+static HGUI_Handle hgui_create_box(const char* id, const char* parent_id) {
+	HGUI_Control* parent = find_parent(parent_id);
+	if (!parent) return HGUI_INVALID_HANDLE;
+	HWND parent_hwnd = parent->hwnd;
+	
+	// 分配控件结构体
+	HGUI_Control* control = alloc_control(id, parent, HGUI_BOX);
+	if (!control) return HGUI_INVALID_HANDLE;
+	
+	control->hwnd = parent_hwnd;  // 容器只参与布局，其子控件直接创建在父窗口上
+	
+	// 添加到控件链表与索引
+	register_control(control);
+	
+	return make_handle(control);
+}
+
+// 辅助函数：按节点类型创建控件
+static HGUI_Handle create_from_node(const HGUI_UIDescHeader* header, const HGUI_UIDescNode* node) {
+	const char* id = hgui_uidesc_string(header, node->id);
+	const char* parent = hgui_uidesc_string(header, node->parent);
+	const char* text = hgui_uidesc_string(header, node->text);
+	
+	switch ((HGUI_UIDescType)node->type) {
+		case HGUI_UIDESC_WINDOW:
+			return hgui_create_window(id, text, node->x, node->y, node->width, node->height);
+		case HGUI_UIDESC_LABEL:
+			return hgui_create_label(id, parent, text, node->x, node->y, node->width, node->height);
+		case HGUI_UIDESC_BUTTON:
+			return hgui_create_button(id, parent, text, node->x, node->y, node->width, node->height);
+		case HGUI_UIDESC_INPUT:
+			return hgui_create_input(id, parent, node->x, node->y, node->width, node->height);
+		case HGUI_UIDESC_LISTBOX:
+			return hgui_create_listbox(id, parent, node->x, node->y, node->width, node->height);
+		case HGUI_UIDESC_RADIO:
+			return hgui_create_radio(id, parent, text, node->x, node->y, node->width, node->height,
+									 (node->flags & HGUI_UIDESC_FLAG_GROUP_FIRST) != 0);
+		case HGUI_UIDESC_CHECKBOX:
+			return hgui_create_checkbox(id, parent, text, node->x, node->y, node->width, node->height);
+		case HGUI_UIDESC_MENUBAR:
+			return hgui_create_menubar(id, parent);
+		case HGUI_UIDESC_MENUITEM:
+			return hgui_create_addMenuItem(parent, id, text, (node->flags & HGUI_UIDESC_FLAG_SUBMENU) != 0);
+		case HGUI_UIDESC_CANVAS:
+			return hgui_create_canvas(id, parent, node->x, node->y, node->width, node->height);
+		default:
+			return HGUI_INVALID_HANDLE;
+	}
+}
+
+// 加载界面描述：data可以是编译后的二进制数据，也可以是文本描述（先编译再加载）
+static bool hgui_loadUI(const void* data, size_t size, HGUI_LoadStats* stats) {
+	HGUI_LoadStats local;
+	if (!stats) stats = &local;
+	memset(stats, 0, sizeof(HGUI_LoadStats));
+	if (!data) return false;
+	
+	// 解析阶段：二进制数据只需校验；文本需要编译
+	long long start = now_ns();
+	void* compiled = NULL;
+	const HGUI_UIDescHeader* header = hgui_uidesc_validate(data, size);
+	if (!header) {
+		size_t compiled_size = 0;
+		if (!hgui_uidesc_compile((const char*)data, size, &compiled, &compiled_size,
+								 stats->error, sizeof(stats->error))) {
+			return false;
+		}
+		header = hgui_uidesc_validate(compiled, compiled_size);
+	}
+	long long parsed = now_ns();
+	stats->parse_ms = (double)(parsed - start) / 1e6;
+	if (!header) {
+		free(compiled);
+		snprintf(stats->error, sizeof(stats->error), "无效的界面描述数据");
+		return false;
+	}
+	stats->node_count = (int)header->node_count;
+	
+	// 分配阶段：一次性预留节点池与索引，避免创建过程中反复扩容
+	bool reserved = registry_reserve(header->node_count);
+	long long allocated = now_ns();
+	stats->allocate_ms = (double)(allocated - parsed) / 1e6;
+	if (!reserved) {
+		free(compiled);
+		snprintf(stats->error, sizeof(stats->error), "内存不足");
+		return false;
+	}
+	
+	// 创建阶段：父节点总在子节点之前，单遍顺序创建（菜单栏在结束时只重绘一次）
+	const HGUI_UIDescNode* nodes = hgui_uidesc_nodes(header);
+	hgui_beginUpdate();
+	for (uint32_t i = 0; i < header->node_count; i++) {
+		if (create_from_node(header, &nodes[i]) != HGUI_INVALID_HANDLE) {
+			stats->created_count++;
+		} else if (!stats->error[0]) {
+			// 只记录第一个失败的节点，其余节点仍继续创建
+			snprintf(stats->error, sizeof(stats->error), "无法创建控件 %.64s",
+					 hgui_uidesc_string(header, nodes[i].id));
+		}
+	}
+	hgui_endUpdate();
+	stats->create_ms = (double)(now_ns() - allocated) / 1e6;
+	
+	free(compiled);
+	return stats->created_count == stats->node_count;
+}
+
+// 通过内存映射加载界面描述文件（二进制或文本）
+static bool hgui_loadUIFile(const char* path, HGUI_LoadStats* stats) {
+	HGUI_LoadStats local;
+	if (!stats) stats = &local;
+	memset(stats, 0, sizeof(HGUI_LoadStats));
+	if (!path) return false;
+	
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		snprintf(stats->error, sizeof(stats->error), "无法打开文件");
+		return false;
+	}
+	
+	bool ok = false;
+	DWORD size = GetFileSize(file, NULL);
+	HANDLE mapping = (size > 0 && size != INVALID_FILE_SIZE) ?
+		CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	if (mapping) {
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view) {
+			ok = hgui_loadUI(view, (size_t)size, stats);
+			UnmapViewOfFile(view);
+		}
+		CloseHandle(mapping);
+	}
+	if (!ok && !stats->error[0]) {
+		snprintf(stats->error, sizeof(stats->error), "无法映射文件");
+	}
+	CloseHandle(file);
+	return ok;
+}
+
+// 输入录制与回放实现
+static void hgui_trace_start(void) {
+	hgui_trace_writer_free(&hgui_ctx->trace_writer);
+	hgui_ctx->trace_start_ns = now_ns();
+	hgui_ctx->trace_recording = true;
+}
+
+static void hgui_trace_stop(void) {
+	hgui_ctx->trace_recording = false;
+}
+
+static const void* hgui_trace_data(size_t* size) {
+	if (size) *size = hgui_ctx->trace_writer.size;
+	return hgui_ctx->trace_writer.size ? hgui_ctx->trace_writer.data : NULL;
+}
+
+static bool hgui_trace_save(const char* path) {
+	if (!path || !hgui_ctx->trace_writer.size) return false;
+	
+	FILE* file = fopen(path, "wb");
+	if (!file) return false;
+	bool ok = fwrite(hgui_ctx->trace_writer.data, 1, hgui_ctx->trace_writer.size, file) == hgui_ctx->trace_writer.size;
+	if (fclose(file) != 0) ok = false;
+	return ok;
+}
+
+// 辅助函数：回放一条事件，找不到对应控件时返回false。
+// 先恢复录制时的控件状态（程序设置，不产生事件），再像原生控件一样向父窗口同步发送WM_COMMAND
+static bool replay_event(const HGUI_TraceEvent* event, long long* latency_ns) {
+	HGUI_Control* control = find_control(event->id);
+	if (!control) return false;
+	
+	HWND target;
+	WPARAM wParam;
+	LPARAM lParam;
+	if (event->kind == HGUI_TRACE_MENU) {
+		if (control->type != HGUI_MENUITEM || !control->menu_id) return false;
+		
+		// 菜单命令发送到菜单所在的窗口
+		HGUI_Control* window = control;
+		while (window->parent && window->type != HGUI_WINDOW) window = window->parent;
+		target = window->type == HGUI_WINDOW ? window->hwnd : hgui_ctx->main_window_hwnd;
+		wParam = MAKEWPARAM(control->menu_id, 0);
+		lParam = 0;
+	} else {
+		if (!owns_hwnd(control)) return false;
+		target = GetParent(control->hwnd);
+		
+		if (control->type == HGUI_INPUT && event->code == EN_CHANGE) {
+			control_set_text(control, event->text ? event->text : "");
+		} else if (control->type == HGUI_CHECKBOX && event->has_value) {
+			control_set_check(control, event->value != 0);
+		} else if (control->type == HGUI_LISTBOX && event->has_value) {
+			native_send(control->hwnd, LB_SETCURSEL, (WPARAM)event->value, 0);
+		}
+		wParam = MAKEWPARAM(0, event->code);
+		lParam = (LPARAM)control->hwnd;
+	}
+	if (!target) return false;
+	
+	long long start = now_ns();
+	SendMessage(target, WM_COMMAND, wParam, lParam);
+	*latency_ns = now_ns() - start;
+	return true;
+}
+
+// 同步回放轨迹：事件之间照常处理消息、定时任务与帧任务，按原间隔回放时等待到事件的时刻
+static bool hgui_trace_replay(const void* data, size_t size, const HGUI_ReplayOptions* options, HGUI_ReplayReport* report) {
+	HGUI_ReplayReport local_report;
+	HGUI_ReplayOptions local_options;
+	if (!report) report = &local_report;
+	if (!options) {
+		memset(&local_options, 0, sizeof(HGUI_ReplayOptions));
+		options = &local_options;
+	}
+	memset(report, 0, sizeof(HGUI_ReplayReport));
+	
+	HGUI_TraceReader reader;
+	if (!hgui_trace_reader_init(&reader, data, size)) {
+		snprintf(report->error, sizeof(report->error), "不是有效的输入轨迹");
+		return false;
+	}
+	
+	long long start = now_ns();
+	int exit_code = 0;
+	bool quit = false;
+	HGUI_TraceEvent event;
+	while (!quit && hgui_trace_next(&reader, &event)) {
+		report->events++;
+		
+		// 先处理积压的消息与到期的任务
+		long long due = start + (long long)event.time_us * 1000;
+		for (;;) {
+			if (!pump_messages(&exit_code)) {
+				quit = true;
+				break;
+			}
+			hgui_sched_run_due(&hgui_ctx->scheduler);
+			run_frame_tasks();
+			
+			long long now = now_ns();
+			if (!options->realtime || now >= due) break;
+			
+			// 等待到事件的时刻，期间有消息或任务到期时先处理
+			long long timeout = hgui_sched_timeout(&hgui_ctx->scheduler);
+			long long remaining = (due - now + 999999) / 1000000;
+			if (timeout < 0 || timeout > remaining) timeout = remaining;
+			MsgWaitForMultipleObjectsEx(0, NULL, (DWORD)timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+		}
+		if (quit) break;
+		
+		long long latency;
+		if (!replay_event(&event, &latency)) {
+			report->skipped++;
+			continue;
+		}
+		report->replayed++;
+		stats_timing_add(&report->latency, latency);
+		report->histogram[stats_bucket(latency)]++;
+		if (options->on_event) {
+			options->on_event(&event, (double)latency / 1e6, options->user_data);
+		}
+	}
+	
+	// 处理最后一条事件引起的后续消息
+	if (!quit && !pump_messages(&exit_code)) quit = true;
+	report->elapsed_ms = (double)(now_ns() - start) / 1e6;
+	
+	bool failed = reader.failed;
+	hgui_trace_reader_free(&reader);
+	if (quit) {
+		// 把退出消息留给外层的消息循环
+		PostQuitMessage(exit_code);
+		snprintf(report->error, sizeof(report->error), "收到WM_QUIT，回放提前结束");
+		return false;
+	}
+	if (failed) {
+		snprintf(report->error, sizeof(report->error), "轨迹数据损坏");
+		return false;
+	}
+	return true;
+}
+
+// 通过内存映射回放轨迹文件
+static bool hgui_trace_replayFile(const char* path, const HGUI_ReplayOptions* options, HGUI_ReplayReport* report) {
+	HGUI_ReplayReport local;
+	if (!report) report = &local;
+	memset(report, 0, sizeof(HGUI_ReplayReport));
+	if (!path) return false;
+	
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		snprintf(report->error, sizeof(report->error), "无法打开文件");
+		return false;
+	}
+	
+	bool ok = false;
+	DWORD size = GetFileSize(file, NULL);
+	HANDLE mapping = (size > 0 && size != INVALID_FILE_SIZE) ?
+		CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	if (mapping) {
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view) {
+			ok = hgui_trace_replay(view, (size_t)size, options, report);
+			UnmapViewOfFile(view);
+		}
+		CloseHandle(mapping);
+	}
+	if (!ok && !report->error[0]) {
+		snprintf(report->error, sizeof(report->error), "无法映射文件");
+	}
+	CloseHandle(file);
+	return ok;
+}
+
+// 定时与调度实现（毫秒；回调在UI线程的消息循环中运行）
+static HGUI_TaskId hgui_schedule_after(unsigned int delay_ms, void (*callback)(void* user_data), void* user_data) {
+	return hgui_sched_after(&hgui_ctx->scheduler, delay_ms, callback, user_data);
+}
+
+static HGUI_TaskId hgui_schedule_every(unsigned int interval_ms, void (*callback)(void* user_data), void* user_data) {
+	return hgui_sched_every(&hgui_ctx->scheduler, interval_ms, callback, user_data);
+}
+
+// 空闲任务在每次消息队列处理完、即将等待时运行，直到被取消
+static HGUI_TaskId hgui_schedule_idle(void (*callback)(void* user_data), void* user_data) {
+	return hgui_sched_idle(&hgui_ctx->scheduler, callback, user_data);
+}
+
+// 请求在下一帧运行一次；同一帧内相同的(回调, 参数)只运行一次
+static HGUI_TaskId hgui_schedule_frame(void (*callback)(void* user_data), void* user_data) {
+	return hgui_sched_frame(&hgui_ctx->scheduler, callback, user_data);
+}
+
+static bool hgui_schedule_cancel(HGUI_TaskId task) {
+	return hgui_sched_cancel(&hgui_ctx->scheduler, task);
+}
+
+static void hgui_schedule_setFrameRate(unsigned int fps) {
+	hgui_sched_set_frame_interval(&hgui_ctx->scheduler, fps > 0 ? 1000 / fps : 16);
+}
+
+// 画布绘制实现（坐标超出画布的部分被裁剪）
+static void hgui_canvas_clear(const char* id, uint32_t color) {
+	HGUI_Control* control = find_canvas(id);
+	if (!control) return;
+	HGUI_Surface* surface = &control->canvas->surface;
+	canvas_mark(control, hgui_raster_fill(surface, hgui_rect_make(0, 0, surface->width, surface->height), color));
+}
+
+static void hgui_canvas_fillRect(const char* id, int x, int y, int width, int height, uint32_t color) {
+	HGUI_Control* control = find_canvas(id);
+	if (!control) return;
+	canvas_mark(control, hgui_raster_blend(&control->canvas->surface, hgui_rect_make(x, y, width, height), color));
+}
+
+static void hgui_canvas_line(const char* id, int x0, int y0, int x1, int y1, uint32_t color) {
+	HGUI_Control* control = find_canvas(id);
+	if (!control) return;
+	canvas_mark(control, hgui_raster_line(&control->canvas->surface, x0, y0, x1, y1, color));
+}
+
+// 把调用方的像素（0xAARRGGBB，stride为每行像素数）画到(x, y)；blend为true时按各像素的alpha混合，
+// 否则直接复制
+static void hgui_canvas_drawImage(const char* id, int x, int y, const uint32_t* pixels, int width, int height, int stride, bool blend) {
+	HGUI_Control* control = find_canvas(id);
+	if (!control || !pixels || width <= 0 || height <= 0 || stride < width) return;
+	
+	// 源图像只读，包装为表面不会写入
+	HGUI_Surface image;
+	hgui_surface_wrap(&image, (uint32_t*)pixels, width, height, stride);
+	HGUI_RasterRect source = { 0, 0, width, height };
+	HGUI_Surface* surface = &control->canvas->surface;
+	canvas_mark(control, blend ? hgui_raster_blend_image(surface, x, y, &image, source)
+					  : hgui_raster_copy(surface, x, y, &image, source));
+}
+
+// 直接访问帧缓冲；修改后调用invalidate登记修改过的区域
+static uint32_t* hgui_canvas_pixels(const char* id, int* width, int* height, int* stride) {
+	HGUI_Control* control = find_canvas(id);
+	HGUI_Surface* surface = control ? &control->canvas->surface : NULL;
+	if (width) *width = surface ? surface->width : 0;
+	if (height) *height = surface ? surface->height : 0;
+	if (stride) *stride = surface ? surface->stride : 0;
+	return surface ? surface->pixels : NULL;
+}
+
+static void hgui_canvas_invalidate(const char* id, int x, int y, int width, int height) {
+	HGUI_Control* control = find_canvas(id);
+	if (!control) return;
+	HGUI_Surface* surface = &control->canvas->surface;
+	HGUI_RasterRect bounds = { 0, 0, surface->width, surface->height };
+	canvas_mark(control, hgui_rect_intersect(hgui_rect_make(x, y, width, height), bounds));
+}
+
+// 布局实现
+static bool hgui_layout_set(const char* id, const HGUI_LayoutStyle* style) {
+	HGUI_Control* control = find_control(id);
+	if (!control || !style || control->type == HGUI_MENUBAR || control->type == HGUI_MENUITEM) return false;
+	
+	// 叶子控件没有内容尺寸：未指定的尺寸以加入布局时的尺寸为最小值（仍可拉伸）。
+	// 加入后控件的尺寸是布局的结果，不能再作为最小值，否则修改样式后控件再也无法缩小
+	RECT rect;
+	if (!control->layout && owns_hwnd(control) && GetWindowRect(control->hwnd, &rect)) {
+		control->natural_width = rect.right - rect.left;
+		control->natural_height = rect.bottom - rect.top;
+	}
+	HGUI_LayoutStyle resolved = *style;
+	if (resolved.kind == HGUI_LAYOUT_LEAF && owns_hwnd(control)) {
+		if (resolved.width == HGUI_LAYOUT_AUTO && resolved.min_width == 0) resolved.min_width = control->natural_width;
+		if (resolved.height == HGUI_LAYOUT_AUTO && resolved.min_height == 0) resolved.min_height = control->natural_height;
+	}
+	
+	if (control->layout) {
+		hgui_layout_set_style(&hgui_ctx->layout_tree, control->layout, &resolved);
+	} else {
+		// 窗口是布局的根，其他控件加入父控件的布局
+		HGUI_LayoutId parent = HGUI_LAYOUT_NO_NODE;
+		if (control->type != HGUI_WINDOW) {
+			if (!control->parent || !control->parent->layout) return false;
+			parent = control->parent->layout;
+		}
+		control->layout = hgui_layout_add(&hgui_ctx->layout_tree, parent, &resolved, (void*)(uintptr_t)make_handle(control));
+		if (!control->layout) return false;
+	}
+	layout_schedule(control);
+	return true;
+}
+
+static void hgui_layout_clear(const char* id) {
+	HGUI_Control* root = find_control(id);
+	if (!root || !root->layout) return;
+	HGUI_Control* parent = root->parent;
+	for (HGUI_Control* node = subtree_first(root); node; node = subtree_next(node, root)) {
+		layout_detach(node);
+	}
+	if (parent && root->type != HGUI_WINDOW) layout_schedule(parent);
+}
+
+static void hgui_layout_apply(void) {
+	for (HGUI_Control* control = hgui_ctx->controls; control; control = control->next) {
+		if (control->type == HGUI_WINDOW && control->layout &&
+			!hgui_layout_node(&hgui_ctx->layout_tree, control->layout)->layout_valid) {
+			layout_update(control);
+		}
+	}
+}
+
+// 菜单实现
+#define HGUI_MENU_MAX_DEPTH 16
+
+static int hgui_menu_build(const char* parent_id, const HGUI_MenuSpec* items, int count) {
+	HGUI_Control* root = find_control(parent_id);
+	if (!root || !root->is_submenu || !root->hmenu || !items) return 0;
 	
-	// 强制重绘菜单
-	DrawMenuBar(parent->hwnd);
+	// parents[d]为深度d的项所在的菜单；全部项在一个事务中添加，菜单栏只重绘一次
+	HGUI_Handle parents[HGUI_MENU_MAX_DEPTH];
+	parents[0] = make_handle(root);
+	int open_depth = 0;     // 下一项允许的最大深度
+	int created = 0;
+	hgui_beginUpdate();
+	for (int i = 0; i < count; i++) {
+		const HGUI_MenuSpec* spec = &items[i];
+		if (spec->depth < 0 || spec->depth > open_depth) break;
+		bool is_submenu = i + 1 < count && items[i + 1].depth == spec->depth + 1;
+		if (is_submenu && spec->depth + 1 >= HGUI_MENU_MAX_DEPTH) break;
+		
+		// 快捷键按Windows的惯例用制表符显示在文本右侧
+		BYTE flags = 0;
+		WORD key = 0;
+		const char* text = spec->text ? spec->text : "";
+		char label[256];
+		char* buffer = NULL;
+		if (spec->accel && *text) {
+			if (!accel_parse(spec->accel, &flags, &key)) break;
+			size_t size = strlen(text) + strlen(spec->accel) + 2;
+			buffer = size <= sizeof(label) ? label : (char*)malloc(size);
+			if (!buffer) break;
+			if (snprintf(buffer, size, "%s\t%s", text, spec->accel) < 0) {
+				if (buffer != label) free(buffer);
+				break;
+			}
+		}
+		
+		HGUI_Control* item = menu_item_append(resolve_handle(parents[spec->depth]), spec->id,
+											  buffer ? buffer : text, is_submenu);
+		if (buffer != label) free(buffer);
+		if (!item) break;
+		
+		if (key && item->menu_id >= HGUI_MENU_ID_BASE) {
+			item->accel_flags = flags;
+			item->accel_key = key;
+			hgui_ctx->accel_dirty = true;
+		}
+		if (spec->callback) item->click_callback = spec->callback;
+		if (is_submenu) parents[spec->depth + 1] = make_handle(item);
+		open_depth = is_submenu ? spec->depth + 1 : spec->depth;
+		created++;
+	}
+	hgui_endUpdate();
+	return created;
+}
+
+static bool hgui_menu_setAccel(const char* item_id, const char* accel) {
+	HGUI_Control* item = find_control(item_id);
+	return item && item->type == HGUI_MENUITEM && menu_item_set_accel(item, accel);
 }
 
 // 命名空间实例初始化
@@ -673,20 +4310,50 @@ const HGUI_Namespace hgui = {
 	.run = hgui_run,
 	.cleanup = hgui_cleanup,
 	
+	// 批量更新事务
+	.beginUpdate = hgui_beginUpdate,
+	.endUpdate = hgui_endUpdate,
+	.getUpdateStats = hgui_getUpdateStats,
+	
+	// 界面描述加载
+	.loadUI = hgui_loadUI,
+	.loadUIFile = hgui_loadUIFile,
+	
+	// 运行统计
+	.stats = hgui_stats,
+	.resetStats = hgui_resetStats,
+	.formatStats = hgui_formatStats,
+	.dumpStats = hgui_dumpStats,
+	.memoryStats = hgui_memoryStats,
+	
 	// 控件操作
 	.remove = hgui_remove,
 	.hide = hgui_hide,
 	.show = hgui_show,
 	.bind = hgui_bind,
+	.subscribe = hgui_subscribe,
+	.unsubscribe = hgui_unsubscribe,
 	.setText = hgui_setText,
 	.getText = hgui_getText,
+	.getTextLength = hgui_getTextLength,
+	.getTextView = hgui_getTextView,
 	.addItem = hgui_addItem,
 	.removeItem = hgui_removeItem,
+	.addItems = hgui_addItems,
+	.addItemsBlob = hgui_addItemsBlob,
+	.removeItems = hgui_removeItems,
+	.setItems = hgui_setItems,
+	.setRowProvider = hgui_setRowProvider,
+	.setRowCount = hgui_setRowCount,
+	.invalidateRows = hgui_invalidateRows,
+	.getVisibleRange = hgui_getVisibleRange,
 	.clearList = hgui_clearList,
 	.getSelectedIndex = hgui_getSelectedIndex,
 	.getListItem = hgui_getListItem,
 	.setCheck = hgui_setCheck,
 	.getCheck = hgui_getCheck,
+	.getSelectedRadio = hgui_getSelectedRadio,
+	.setFont = hgui_setFont,
 	
 	// 创建控件的子命名空间
 	.create = {
@@ -695,10 +4362,90 @@ const HGUI_Namespace hgui = {
 		.button = hgui_create_button,
 		.input = hgui_create_input,
 		.listbox = hgui_create_listbox,
+		.virtualList = hgui_create_virtualList,
 		.radio = hgui_create_radio,
 		.checkbox = hgui_create_checkbox,
 		.menubar = hgui_create_menubar,
-		.addMenuItem = hgui_create_addMenuItem
+		.addMenuItem = hgui_create_addMenuItem,
+		.canvas = hgui_create_canvas,
+		.box = hgui_create_box
+	},
+	
+	// 按句柄操作的子命名空间
+	.handle = {
+		.lookup = hgui_handle_lookup,
+		.valid = hgui_handle_valid,
+		.hide = hgui_handle_hide,
+		.show = hgui_handle_show,
+		.setText = hgui_handle_setText,
+		.getText = hgui_handle_getText,
+		.getTextLength = hgui_handle_getTextLength,
+		.getTextView = hgui_handle_getTextView,
+		.addItem = hgui_handle_addItem,
+		.setCheck = hgui_handle_setCheck,
+		.getCheck = hgui_handle_getCheck,
+		.subscribe = hgui_handle_subscribe
+	},
+	
+	// 跨线程投递更新的子命名空间
+	.post = {
+		.setText = hgui_post_setText,
+		.addItem = hgui_post_addItem,
+		.setCheck = hgui_post_setCheck,
+		.show = hgui_post_show,
+		.hide = hgui_post_hide,
+		.call = hgui_post_call
+	},
+	
+	// 定时与调度的子命名空间
+	.schedule = {
+		.after = hgui_schedule_after,
+		.every = hgui_schedule_every,
+		.idle = hgui_schedule_idle,
+		.frame = hgui_schedule_frame,
+		.cancel = hgui_schedule_cancel,
+		.setFrameRate = hgui_schedule_setFrameRate
+	},
+	
+	// 画布绘制的子命名空间
+	.canvas = {
+		.clear = hgui_canvas_clear,
+		.fillRect = hgui_canvas_fillRect,
+		.line = hgui_canvas_line,
+		.drawImage = hgui_canvas_drawImage,
+		.pixels = hgui_canvas_pixels,
+		.invalidate = hgui_canvas_invalidate
+	},
+	
+	// 布局的子命名空间
+	.layout = {
+		.set = hgui_layout_set,
+		.clear = hgui_layout_clear,
+		.apply = hgui_layout_apply
+	},
+	
+	// 菜单的子命名空间
+	.menu = {
+		.build = hgui_menu_build,
+		.setAccel = hgui_menu_setAccel
+	},
+	
+	// 输入录制与回放的子命名空间
+	.trace = {
+		.start = hgui_trace_start,
+		.stop = hgui_trace_stop,
+		.data = hgui_trace_data,
+		.save = hgui_trace_save,
+		.replay = hgui_trace_replay,
+		.replayFile = hgui_trace_replayFile
+	},
+	
+	// 实例上下文的子命名空间
+	.context = {
+		.create = hgui_context_create,
+		.destroy = hgui_context_destroy,
+		.current = hgui_context_current,
+		.makeCurrent = hgui_context_makeCurrent
 	}
 };
 
@@ -0,0 +1,240 @@
+#ifndef HGUI_CORO_HPP
+#define HGUI_CORO_HPP
+
+// HGUI 协程层（C++20）：用 co_await 等待界面事件、把耗时工作移到工作线程。
+// 建立在 hgui 命名空间之上：事件等待使用 hgui.subscribe，回到UI线程使用 hgui.post.call，
+// 计时使用 hgui.schedule。全局对象 hgui 已占用该名字，因此C++接口位于 hgui_co 命名空间。
+//
+//   hgui_co::task login_flow() {
+//       while (co_await hgui_co::clicked("login_btn")) {          // 按钮被删除时返回false，循环结束
+//           std::string user = hgui.getTextView("user_input");
+//           bool ok = co_await hgui_co::background([user] { return check_user(user); });  // 在工作线程中运行
+//           hgui.setText("status_label", ok ? "成功" : "失败");                           // 已回到UI线程
+//       }
+//   }
+//
+// 协程必须在UI线程上启动，所有 co_await 之后都在UI线程的消息循环中恢复。
+
+#include "hgui.h"
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hgui_co {
+
+// 即发即弃的协程：调用时立即开始运行，结束时自行销毁；未捕获的异常会终止程序
+struct task {
+	struct promise_type {
+		task get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+};
+
+// 等待控件事件：事件发生时返回true，控件在此之前被删除（或不存在）时返回false
+class event {
+public:
+	event(const char* id, HGUI_Event type) : id_(id), type_(type) {}
+
+	bool await_ready() const noexcept { return false; }
+
+	bool await_suspend(std::coroutine_handle<> handle) {
+		handle_ = handle;
+		fired_ = hgui.subscribe(id_, type_, &event::notify, this);
+		if (!fired_) return false;
+		removed_ = hgui.subscribe(id_, HGUI_EVENT_REMOVE, &event::notify, this);
+		return true;
+	}
+
+	bool await_resume() const noexcept { return result_; }
+
+private:
+	static void notify(HGUI_Handle control, HGUI_Event type, void* user_data) {
+		(void)control;
+		event* self = static_cast<event*>(user_data);
+		hgui.unsubscribe(self->fired_);
+		hgui.unsubscribe(self->removed_);
+		self->result_ = type != HGUI_EVENT_REMOVE;
+		self->handle_.resume();
+	}
+
+	const char* id_;
+	HGUI_Event type_;
+	std::coroutine_handle<> handle_;
+	HGUI_Subscription fired_ = HGUI_INVALID_SUBSCRIPTION;
+	HGUI_Subscription removed_ = HGUI_INVALID_SUBSCRIPTION;
+	bool result_ = false;
+};
+
+inline event clicked(const char* id) { return event(id, HGUI_EVENT_CLICK); }
+inline event double_clicked(const char* id) { return event(id, HGUI_EVENT_DBLCLICK); }
+inline event changed(const char* id) { return event(id, HGUI_EVENT_CHANGE); }
+inline event selected(const char* id) { return event(id, HGUI_EVENT_SELECT); }
+
+// 等待指定的毫秒数（由调度器计时，不阻塞消息循环）
+class delay {
+public:
+	explicit delay(unsigned int ms) : ms_(ms) {}
+
+	bool await_ready() const noexcept { return false; }
+
+	bool await_suspend(std::coroutine_handle<> handle) {
+		return hgui.schedule.after(ms_, &delay::resume, handle.address()) != HGUI_INVALID_TASK;
+	}
+
+	void await_resume() const noexcept {}
+
+private:
+	static void resume(void* address) {
+		std::coroutine_handle<>::from_address(address).resume();
+	}
+
+	unsigned int ms_;
+};
+
+// 等待到下一帧（同一帧内的界面修改合并为一次重绘）
+class next_frame {
+public:
+	bool await_ready() const noexcept { return false; }
+
+	bool await_suspend(std::coroutine_handle<> handle) {
+		return hgui.schedule.frame(&next_frame::resume, handle.address()) != HGUI_INVALID_TASK;
+	}
+
+	void await_resume() const noexcept {}
+
+private:
+	static void resume(void* address) {
+		std::coroutine_handle<>::from_address(address).resume();
+	}
+};
+
+namespace detail {
+
+// 工作线程池：首次使用时按硬件线程数创建，程序退出时运行完剩余任务后回收
+class worker_pool {
+public:
+	static worker_pool& instance() {
+		static worker_pool pool;
+		return pool;
+	}
+
+	void submit(std::function<void()> job) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			jobs_.push_back(std::move(job));
+		}
+		ready_.notify_one();
+	}
+
+	~worker_pool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		ready_.notify_all();
+		for (std::thread& thread : threads_) thread.join();
+	}
+
+private:
+	worker_pool() {
+		unsigned int count = std::thread::hardware_concurrency();
+		if (count == 0) count = 2;
+		for (unsigned int i = 0; i < count; i++) {
+			threads_.emplace_back([this] { run(); });
+		}
+	}
+
+	void run() {
+		for (;;) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+				if (jobs_.empty()) return;
+				job = std::move(jobs_.front());
+				jobs_.pop_front();
+			}
+			job();
+		}
+	}
+
+	std::mutex mutex_;
+	std::condition_variable ready_;
+	std::deque<std::function<void()>> jobs_;
+	std::vector<std::thread> threads_;
+	bool stopping_ = false;
+};
+
+} // namespace detail
+
+// 在工作线程中运行fn，完成后通过 hgui.post.call 回到UI线程恢复协程；
+// 投递到 co_await 时UI线程的当前上下文，协程在该上下文的消息循环中恢复。
+// co_await 的结果为fn的返回值，fn抛出的异常在UI线程上重新抛出
+template <typename F>
+class background_awaiter {
+public:
+	using result_type = std::decay_t<std::invoke_result_t<F&>>;
+
+	explicit background_awaiter(F fn) : fn_(std::move(fn)) {}
+
+	bool await_ready() const noexcept { return false; }
+
+	void await_suspend(std::coroutine_handle<> handle) {
+		handle_ = handle;
+		HGUI_Context* context = hgui.context.current();
+#ifdef HGUI_HEADLESS
+		hgui_headless_pending(1);
+#endif
+		detail::worker_pool::instance().submit([this, context] {
+			try {
+				if constexpr (std::is_void_v<result_type>) fn_();
+				else result_.emplace(fn_());
+			}
+			catch (...) {
+				error_ = std::current_exception();
+			}
+			// 投递之后协程可能立即在UI线程恢复并销毁本对象，此后不能再访问成员
+			HGUI_Context* previous = hgui.context.makeCurrent(context);
+			hgui.post.call(&background_awaiter::resume, this);
+			hgui.context.makeCurrent(previous);
+#ifdef HGUI_HEADLESS
+			hgui_headless_pending(-1);
+#endif
+		});
+	}
+
+	result_type await_resume() {
+		if (error_) std::rethrow_exception(error_);
+		if constexpr (!std::is_void_v<result_type>) return std::move(*result_);
+	}
+
+private:
+	static void resume(void* user_data) {
+		static_cast<background_awaiter*>(user_data)->handle_.resume();
+	}
+
+	F fn_;
+	std::coroutine_handle<> handle_;
+	std::conditional_t<std::is_void_v<result_type>, bool, std::optional<result_type>> result_{};
+	std::exception_ptr error_;
+};
+
+template <typename F>
+background_awaiter<std::decay_t<F>> background(F&& fn) {
+	return background_awaiter<std::decay_t<F>>(std::forward<F>(fn));
+}
+
+} // namespace hgui_co
+
+#endif // HGUI_CORO_HPP
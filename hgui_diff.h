@@ -0,0 +1,227 @@
+#ifndef HGUI_DIFF_H
+#define HGUI_DIFF_H
+
+// HGUI 序列差异：计算把旧序列变为新序列的最少插入/删除，结果按位置分组为若干段（hunk）。
+// 本文件不依赖Windows API，可以在任意平台上测试与基准测量。
+//
+// 先去掉相同的前缀与后缀（列表刷新时通常只有中间一小段变化），剩余部分用Myers的O(ND)算法求解。
+// 编辑距离超过预算时不再求最优解，把剩余部分整体作为一段替换，耗时与内存因此有上界：
+// 预算为D时比较次数不超过 (n+m)*D，记录路径需要 (D+1)^2 个int。
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HGUI_DIFF_DEFAULT_BUDGET 1024   // 默认的编辑预算（插入与删除的总数）
+
+// 一段差异：旧序列中从old_start起的old_count个元素替换为新序列中从new_start起的new_count个元素
+typedef struct {
+	int old_start;
+	int old_count;
+	int new_start;
+	int new_count;
+} HGUI_DiffHunk;
+
+// 比较回调：旧序列的第old_index个元素与新序列的第new_index个元素是否相同
+typedef bool (*HGUI_DiffEqual)(int old_index, int new_index, void* context);
+
+// 差异结果（全零初始化即可使用，可以反复计算以复用内存）
+typedef struct {
+	HGUI_DiffHunk* hunks;       // 按位置升序，互不相邻
+	int count;
+	int capacity;
+	int deleted;                // 删除的元素总数
+	int inserted;               // 插入的元素总数
+	bool over_budget;           // 超出预算，中间部分整体替换（结果正确但不一定最少）
+
+	int* trace;                 // 每一步各对角线到达的最远位置（第d步占 2d+1 项，从d*d开始）
+	size_t trace_capacity;
+	unsigned char* marks;       // 回溯时标记的删除（前n项）与插入（后m项）
+	size_t marks_capacity;
+} HGUI_Diff;
+
+static inline void hgui_diff_free(HGUI_Diff* diff) {
+	free(diff->hunks);
+	free(diff->trace);
+	free(diff->marks);
+	memset(diff, 0, sizeof(HGUI_Diff));
+}
+
+// 辅助函数：追加一段差异
+static inline bool diff_add_hunk(HGUI_Diff* diff, int old_start, int old_count, int new_start, int new_count) {
+	if (diff->count == diff->capacity) {
+		int capacity = diff->capacity ? diff->capacity * 2 : 16;
+		HGUI_DiffHunk* hunks = (HGUI_DiffHunk*)realloc(diff->hunks, (size_t)capacity * sizeof(HGUI_DiffHunk));
+		if (!hunks) return false;
+		diff->hunks = hunks;
+		diff->capacity = capacity;
+	}
+	HGUI_DiffHunk* hunk = &diff->hunks[diff->count++];
+	hunk->old_start = old_start;
+	hunk->old_count = old_count;
+	hunk->new_start = new_start;
+	hunk->new_count = new_count;
+	diff->deleted += old_count;
+	diff->inserted += new_count;
+	return true;
+}
+
+// 辅助函数：保证路径记录能容纳第d步
+static inline bool diff_reserve_trace(HGUI_Diff* diff, int d) {
+	size_t needed = (size_t)(d + 1) * (size_t)(d + 1);
+	if (needed <= diff->trace_capacity) return true;
+
+	size_t capacity = diff->trace_capacity ? diff->trace_capacity : 64;
+	while (capacity < needed) capacity *= 2;
+	int* trace = (int*)realloc(diff->trace, capacity * sizeof(int));
+	if (!trace) return false;
+	diff->trace = trace;
+	diff->trace_capacity = capacity;
+	return true;
+}
+
+// 辅助函数：从终点沿记录的路径回溯，标记被删除的旧元素与被插入的新元素
+static inline void diff_backtrack(HGUI_Diff* diff, int d, int k, int n) {
+	unsigned char* deleted = diff->marks;
+	unsigned char* inserted = diff->marks + n;
+	for (; d > 0; d--) {
+		const int* previous = diff->trace + (size_t)(d - 1) * (size_t)(d - 1) + (d - 1);
+		bool down = k == -d || (k != d && previous[k - 1] < previous[k + 1]);
+		int previous_k = down ? k + 1 : k - 1;
+		int previous_x = previous[previous_k];
+		int previous_y = previous_x - previous_k;
+		if (down) inserted[previous_y] = 1;
+		else deleted[previous_x] = 1;
+		k = previous_k;
+	}
+}
+
+// 计算差异。max_edits为编辑预算（不大于0时使用默认预算），内存不足时返回false
+static inline bool hgui_diff_compute(HGUI_Diff* diff, int old_count, int new_count, HGUI_DiffEqual equal, void* context, int max_edits) {
+	diff->count = 0;
+	diff->deleted = 0;
+	diff->inserted = 0;
+	diff->over_budget = false;
+
+	// 相同的前缀与后缀
+	int prefix = 0;
+	while (prefix < old_count && prefix < new_count && equal(prefix, prefix, context)) prefix++;
+	int suffix = 0;
+	while (suffix < old_count - prefix && suffix < new_count - prefix &&
+		   equal(old_count - 1 - suffix, new_count - 1 - suffix, context)) {
+		suffix++;
+	}
+	int n = old_count - prefix - suffix;
+	int m = new_count - prefix - suffix;
+	if (n == 0 && m == 0) return true;
+	if (n == 0 || m == 0) return diff_add_hunk(diff, prefix, n, prefix, m);
+
+	int budget = max_edits > 0 ? max_edits : HGUI_DIFF_DEFAULT_BUDGET;
+	if (budget > n + m) budget = n + m;
+
+	// Myers：第d步沿每条对角线k=x-y走到最远处，x、y为去掉前缀后的位置
+	for (int d = 0; d <= budget; d++) {
+		if (!diff_reserve_trace(diff, d)) return false;
+		int* current = diff->trace + (size_t)d * (size_t)d + d;
+		const int* previous = d > 0 ? diff->trace + (size_t)(d - 1) * (size_t)(d - 1) + (d - 1) : NULL;
+
+		for (int k = -d; k <= d; k += 2) {
+			int x;
+			if (d == 0) x = 0;
+			else if (k == -d || (k != d && previous[k - 1] < previous[k + 1])) x = previous[k + 1];     // 插入
+			else x = previous[k - 1] + 1;                                                             // 删除
+			int y = x - k;
+			while (x < n && y < m && equal(prefix + x, prefix + y, context)) {
+				x++;
+				y++;
+			}
+			current[k] = x;
+			if (x < n || y < m) continue;
+
+			// 到达终点：回溯标记，再把连续的删除与插入合并为段
+			size_t marks_needed = (size_t)n + (size_t)m;
+			if (marks_needed > diff->marks_capacity) {
+				unsigned char* marks = (unsigned char*)realloc(diff->marks, marks_needed);
+				if (!marks) return false;
+				diff->marks = marks;
+				diff->marks_capacity = marks_needed;
+			}
+			memset(diff->marks, 0, marks_needed);
+			diff_backtrack(diff, d, k, n);
+
+			const unsigned char* deleted = diff->marks;
+			const unsigned char* inserted = diff->marks + n;
+			int i = 0;
+			int j = 0;
+			while (i < n || j < m) {
+				if (i < n && j < m && !deleted[i] && !inserted[j]) {
+					i++;
+					j++;
+					continue;
+				}
+				int old_start = i;
+				int new_start = j;
+				while ((i < n && deleted[i]) || (j < m && inserted[j])) {
+					while (i < n && deleted[i]) i++;
+					while (j < m && inserted[j]) j++;
+				}
+				if (!diff_add_hunk(diff, prefix + old_start, i - old_start, prefix + new_start, j - new_start)) return false;
+			}
+			return true;
+		}
+	}
+
+	// 超出预算：中间部分整体替换
+	diff->over_budget = true;
+	return diff_add_hunk(diff, prefix, n, prefix, m);
+}
+
+// 把旧序列中的位置换算为新序列中的位置。元素被删除时：nearest为false返回-1，
+// 为true返回替换它的段在新序列中的起点（新序列为空时为-1）
+static inline int hgui_diff_map(const HGUI_Diff* diff, int old_index, bool nearest, int new_count) {
+	int shift = 0;
+	for (int i = 0; i < diff->count; i++) {
+		const HGUI_DiffHunk* hunk = &diff->hunks[i];
+		if (old_index < hunk->old_start) break;
+		if (old_index < hunk->old_start + hunk->old_count) {
+			if (!nearest) return -1;
+			int index = hunk->new_start < new_count ? hunk->new_start : new_count - 1;
+			return index;
+		}
+		shift += hunk->new_count - hunk->old_count;
+	}
+	return old_index + shift;
+}
+
+// 字符串序列：先比较64位哈希，哈希相同再比较内容
+typedef struct {
+	const char* const* old_items;
+	const uint64_t* old_hashes;
+	const char* const* new_items;
+	const uint64_t* new_hashes;
+} HGUI_DiffStrings;
+
+// FNV-1a 64位哈希
+static inline uint64_t hgui_diff_hash(const char* text) {
+	uint64_t hash = 14695981039346656037ull;
+	for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+		hash ^= *p;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static inline bool hgui_diff_strings_equal(int old_index, int new_index, void* context) {
+	const HGUI_DiffStrings* strings = (const HGUI_DiffStrings*)context;
+	return strings->old_hashes[old_index] == strings->new_hashes[new_index] &&
+		   strcmp(strings->old_items[old_index], strings->new_items[new_index]) == 0;
+}
+
+// 计算两个字符串数组的差异（哈希由调用方用hgui_diff_hash预先计算，可在多次计算间复用）
+static inline bool hgui_diff_strings(HGUI_Diff* diff, const HGUI_DiffStrings* strings, int old_count, int new_count, int max_edits) {
+	return hgui_diff_compute(diff, old_count, new_count, hgui_diff_strings_equal, (void*)strings, max_edits);
+}
+
+#endif // HGUI_DIFF_H
@@ -0,0 +1,1826 @@
+#ifndef HGUI_HEADLESS_H
+#define HGUI_HEADLESS_H
+
+// HGUI 无界面后端：用内存模型实现 hgui.h 用到的 Win32 子集，
+// 使整个库可以在非Windows平台上运行、测试和做基准测量。
+// 在包含 hgui.h 之前定义 HGUI_HEADLESS 即可启用（由 base.h 代替 <windows.h> 包含本文件）。
+//
+// 模型范围：
+//   窗口      类名、文本、样式、位置、父子关系、可见性、重绘开关、字体、菜单
+//   移动      SetWindowPos/DeferWindowPos，尺寸变化时同步发送WM_SIZE
+//   控件      STATIC/BUTTON/EDIT/LISTBOX 的文本、选中状态、列表项（含LBS_NODATA计数）、当前选择、顶行
+//   菜单      菜单栏/弹出菜单及其菜单项，销毁时递归销毁子菜单
+//   快捷键    CreateAcceleratorTable/TranslateAccelerator，修饰键状态（每线程）由hgui_headless_key模拟
+//   字体      CreateFontIndirect/GetObject/DeleteObject，库存字体不会被删除
+//   消息      SendMessage直接调用窗口过程；每个线程有自己的消息队列，PostMessage投递到创建窗口的线程，
+//             PostThreadMessage投递到指定线程（线程安全），PeekMessage只取调用线程的消息
+//   定时器    SetTimer/KillTimer属于调用线程，在该线程的消息队列为空时按真实时钟产生WM_TIMER
+//   等待      PeekMessage/MsgWaitForMultipleObjectsEx，有限超时按真实时钟睡眠
+//   文件      CreateFileA/CreateFileMappingA/MapViewOfFile以读入整个文件的方式实现
+//
+// 与真实Win32的差异：不绘制任何内容；消息队列为空且没有到期的定时器时 GetMessage 返回FALSE，
+// 没有任何可等待的消息或定时器时 MsgWaitForMultipleObjectsEx 以无限超时等待会返回WAIT_FAILED，
+// 因此 hgui.run 会在处理完所有积压消息与定时任务后返回0（运行到空闲）。
+// 句柄由对象表分配（槽位+代数），已销毁的句柄不会被误用，对其调用API会返回失败。
+// 对象表与窗口类注册可以在多个线程中并行使用；每个窗口、菜单与字体只应由创建它的线程操作。
+// 计数器按线程记录（hgui_headless_stats取调用线程的计数），线程状态按线程ID取模后共享
+// HGUI_HEADLESS_MAX_THREADS个槽位。
+// 依赖POSIX的clock_gettime与GCC/Clang的原子内建函数。
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// 基本类型
+typedef struct HGUI_HeadlessHwnd* HWND;
+typedef struct HGUI_HeadlessHmenu* HMENU;
+typedef struct HGUI_HeadlessHfont* HFONT;
+typedef struct HGUI_HeadlessHbrush* HBRUSH;
+typedef struct HGUI_HeadlessHaccel* HACCEL;
+typedef void* HGDIOBJ;
+typedef void* HINSTANCE;
+typedef void* HCURSOR;
+typedef void* HDC;
+typedef void* HDWP;
+typedef void* HANDLE;
+typedef void* PVOID;
+typedef unsigned int UINT;
+typedef uintptr_t UINT_PTR;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef intptr_t LRESULT;
+typedef unsigned long DWORD;
+typedef int BOOL;
+typedef long LONG;
+typedef unsigned short WORD;
+typedef unsigned char BYTE;
+typedef const char* LPCSTR;
+typedef DWORD COLORREF;
+
+#define TRUE 1
+#define FALSE 0
+#define CALLBACK
+#define WINAPI
+
+typedef LRESULT (*WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+typedef void (*TIMERPROC)(HWND, UINT, UINT_PTR, DWORD);
+
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { LONG x, y; } POINT;
+typedef struct { HWND hwnd; UINT message; WPARAM wParam; LPARAM lParam; DWORD time; POINT pt; } MSG;
+typedef union { struct { DWORD LowPart; LONG HighPart; } u; long long QuadPart; } LARGE_INTEGER;
+typedef struct { BYTE fVirt; WORD key; WORD cmd; } ACCEL;
+
+typedef struct {
+	UINT cbSize, style;
+	WNDPROC lpfnWndProc;
+	int cbClsExtra, cbWndExtra;
+	HINSTANCE hInstance;
+	void* hIcon;
+	HCURSOR hCursor;
+	HBRUSH hbrBackground;
+	LPCSTR lpszMenuName, lpszClassName;
+	void* hIconSm;
+} WNDCLASSEX;
+
+typedef struct {
+	LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight;
+	BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet, lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily;
+	char lfFaceName[32];
+} LOGFONT;
+
+typedef struct { UINT CtlType, CtlID, itemID, itemWidth, itemHeight; UINT_PTR itemData; } MEASUREITEMSTRUCT;
+typedef struct { HDC hdc; BOOL fErase; RECT rcPaint; BOOL fRestore, fIncUpdate; BYTE rgbReserved[32]; } PAINTSTRUCT;
+typedef struct {
+	DWORD biSize;
+	LONG biWidth, biHeight;
+	WORD biPlanes, biBitCount;
+	DWORD biCompression, biSizeImage;
+	LONG biXPelsPerMeter, biYPelsPerMeter;
+	DWORD biClrUsed, biClrImportant;
+} BITMAPINFOHEADER;
+typedef struct { BYTE rgbBlue, rgbGreen, rgbRed, rgbReserved; } RGBQUAD;
+typedef struct { BITMAPINFOHEADER bmiHeader; RGBQUAD bmiColors[1]; } BITMAPINFO;
+typedef struct { UINT CtlType, CtlID, itemID, itemAction, itemState; HWND hwndItem; HDC hDC; RECT rcItem; UINT_PTR itemData; } DRAWITEMSTRUCT;
+
+#define LOWORD(l) ((WORD)(((UINT_PTR)(l)) & 0xffff))
+#define HIWORD(l) ((WORD)((((UINT_PTR)(l)) >> 16) & 0xffff))
+#define MAKELPARAM(l, h) ((LPARAM)(((UINT_PTR)(WORD)(l)) | (((UINT_PTR)(WORD)(h)) << 16)))
+#define MAKEWPARAM(l, h) ((WPARAM)(((WORD)(l)) | ((DWORD)((WORD)(h))) << 16))
+
+// 消息
+#define WM_DESTROY        0x0002
+#define WM_SIZE           0x0005
+#define WM_SETFOCUS       0x0007
+#define WM_KILLFOCUS      0x0008
+#define WM_SETREDRAW      0x000B
+#define WM_SETTEXT        0x000C
+#define WM_GETTEXT        0x000D
+#define WM_GETTEXTLENGTH  0x000E
+#define WM_PAINT          0x000F
+#define WM_QUIT           0x0012
+#define WM_ERASEBKGND     0x0014
+#define WM_DRAWITEM       0x002B
+#define WM_MEASUREITEM    0x002C
+#define WM_SETFONT        0x0030
+#define WM_GETFONT        0x0031
+#define WM_NCMOUSEMOVE    0x00A0
+#define WM_KEYDOWN        0x0100
+#define WM_KEYUP          0x0101
+#define WM_CHAR           0x0102
+#define WM_SYSKEYDOWN     0x0104
+#define WM_COMMAND        0x0111
+#define WM_TIMER          0x0113
+#define WM_MOUSEMOVE      0x0200
+#define WM_LBUTTONDOWN    0x0201
+#define WM_LBUTTONUP      0x0202
+#define WM_USER           0x0400
+#define WM_APP            0x8000
+
+// 消息等待
+#define PM_NOREMOVE         0x0000
+#define PM_REMOVE           0x0001
+#define QS_ALLINPUT         0x04FF
+#define MWMO_INPUTAVAILABLE 0x0004
+#define INFINITE            0xFFFFFFFFu
+#define WAIT_OBJECT_0       0x00000000u
+#define WAIT_TIMEOUT        0x00000102u
+#define WAIT_FAILED         0xFFFFFFFFu
+
+// 列表框消息与通知
+#define LB_ADDSTRING      0x0180
+#define LB_INSERTSTRING   0x0181
+#define LB_DELETESTRING   0x0182
+#define LB_RESETCONTENT   0x0184
+#define LB_SETCURSEL      0x0186
+#define LB_GETCURSEL      0x0188
+#define LB_GETTEXT        0x0189
+#define LB_GETTEXTLEN     0x018A
+#define LB_GETCOUNT       0x018B
+#define LB_GETTOPINDEX    0x018E
+#define LB_SETTOPINDEX    0x0197
+#define LB_GETITEMRECT    0x0198
+#define LB_SETITEMHEIGHT  0x01A0
+#define LB_GETITEMHEIGHT  0x01A1
+#define LB_SETCOUNT       0x01A7
+#define LB_INITSTORAGE    0x01A8
+#define LB_ERR            (-1)
+#define LBN_SELCHANGE     1
+#define LBN_DBLCLK        2
+#define LBN_SETFOCUS      4
+#define LBN_KILLFOCUS     5
+
+// 按钮与编辑框消息与通知
+#define BM_GETCHECK       0x00F0
+#define BM_SETCHECK       0x00F1
+#define BST_UNCHECKED     0
+#define BST_CHECKED       1
+#define BN_CLICKED        0
+#define EN_SETFOCUS       0x0100
+#define EN_KILLFOCUS      0x0200
+#define EN_CHANGE         0x0300
+
+// 窗口与控件样式
+#define WS_OVERLAPPEDWINDOW   0x00CF0000L
+#define WS_CLIPCHILDREN       0x02000000L
+#define WS_CHILD              0x40000000L
+#define WS_VISIBLE            0x10000000L
+#define WS_VSCROLL            0x00200000L
+#define WS_GROUP              0x00020000L
+#define WS_EX_CLIENTEDGE      0x00000200L
+#define SS_LEFT               0x0000
+#define BS_PUSHBUTTON         0x0000
+#define BS_CHECKBOX           0x0002
+#define BS_RADIOBUTTON        0x0004
+#define ES_LEFT               0x0000
+#define ES_AUTOHSCROLL        0x0080
+#define LBS_NOTIFY            0x0001
+#define LBS_OWNERDRAWFIXED    0x0010
+#define LBS_NOINTEGRALHEIGHT  0x0100
+#define LBS_NODATA            0x2000
+#define CS_VREDRAW            0x0001
+#define CS_HREDRAW            0x0002
+#define CS_DBLCLKS            0x0008
+
+// 显示、重绘与位置
+#define SW_HIDE               0
+#define SW_SHOW               5
+#define SWP_NOSIZE            0x0001
+#define SWP_NOMOVE            0x0002
+#define SWP_NOZORDER          0x0004
+#define SWP_NOREDRAW          0x0008
+#define SWP_NOACTIVATE        0x0010
+#define SWP_SHOWWINDOW        0x0040
+#define SWP_HIDEWINDOW        0x0080
+#define RDW_INVALIDATE        0x0001
+#define RDW_ERASE             0x0004
+#define RDW_ALLCHILDREN       0x0080
+#define HWND_DESKTOP          ((HWND)0)
+
+// 菜单
+#define MF_STRING             0x0000
+#define MF_BYCOMMAND          0x0000
+#define MF_POPUP              0x0010
+#define MF_BYPOSITION         0x0400
+#define MF_SEPARATOR          0x0800
+
+// 快捷键
+#define FVIRTKEY              0x01
+#define FSHIFT                0x04
+#define FCONTROL              0x08
+#define FALT                  0x10
+#define VK_BACK               0x08
+#define VK_TAB                0x09
+#define VK_RETURN             0x0D
+#define VK_ESCAPE             0x1B
+#define VK_SPACE              0x20
+#define VK_PRIOR              0x21
+#define VK_NEXT               0x22
+#define VK_END                0x23
+#define VK_HOME               0x24
+#define VK_LEFT               0x25
+#define VK_UP                 0x26
+#define VK_RIGHT              0x27
+#define VK_DOWN               0x28
+#define VK_INSERT             0x2D
+#define VK_DELETE             0x2E
+#define VK_F1                 0x70
+
+// 绘制
+#define ODT_LISTBOX           2
+#define ODS_SELECTED          0x0001
+#define ODS_FOCUS             0x0010
+#define COLOR_WINDOW          5
+#define COLOR_WINDOWTEXT      8
+#define COLOR_HIGHLIGHT       13
+#define COLOR_HIGHLIGHTTEXT   14
+#define TRANSPARENT           1
+#define DT_VCENTER            0x0004
+#define DT_SINGLELINE         0x0020
+#define DT_NOPREFIX           0x0800
+#define DT_END_ELLIPSIS       0x8000
+#define BI_RGB                0
+#define DIB_RGB_COLORS        0
+#define DEFAULT_GUI_FONT      17
+#define FW_NORMAL             400
+#define FW_BOLD               700
+#define IDC_ARROW             ((LPCSTR)32512)
+
+// 文件
+#define INVALID_HANDLE_VALUE  ((HANDLE)(intptr_t)-1)
+#define INVALID_FILE_SIZE     ((DWORD)0xFFFFFFFF)
+#define GENERIC_READ          0x80000000L
+#define FILE_SHARE_READ       0x00000001
+#define OPEN_EXISTING         3
+#define FILE_ATTRIBUTE_NORMAL 0x00000080
+#define PAGE_READONLY         0x02
+#define FILE_MAP_READ         0x0004
+
+// 无界面后端的计数器
+typedef struct {
+	unsigned long windows_created;
+	unsigned long windows_destroyed;
+	unsigned long windows_alive;
+	unsigned long menus_created;
+	unsigned long menus_alive;
+	unsigned long menu_items;
+	unsigned long fonts_created;
+	unsigned long fonts_alive;
+	unsigned long messages_sent;        // SendMessage 次数
+	unsigned long messages_posted;      // PostMessage/PostThreadMessage 次数
+	unsigned long messages_dispatched;  // DispatchMessage 次数
+	unsigned long invalidations;        // InvalidateRect/RedrawWindow 次数
+	unsigned long paints;               // BeginPaint 次数
+	unsigned long blits;                // SetDIBitsToDevice 次数
+	unsigned long pixels_blitted;       // SetDIBitsToDevice 写入的像素数
+	unsigned long menu_redraws;         // DrawMenuBar 次数
+	unsigned long accel_tables_alive;
+	unsigned long accelerators;         // TranslateAccelerator 转换为命令的按键数
+	unsigned long window_moves;         // 经DeferWindowPos生效的位置/可见性变化
+} HGUI_HeadlessStats;
+
+// 对象表：窗口、菜单、字体与文件句柄统一由槽位+代数编码，已销毁的句柄可被识别
+typedef enum {
+	HGUI_HEADLESS_FREE,
+	HGUI_HEADLESS_WINDOW,
+	HGUI_HEADLESS_MENU,
+	HGUI_HEADLESS_ACCEL,
+	HGUI_HEADLESS_FONT,
+	HGUI_HEADLESS_FILE,
+	HGUI_HEADLESS_MAPPING
+} HGUI_HeadlessKind;
+
+typedef struct {
+	void* object;
+	unsigned int generation;
+	unsigned char kind;
+} HGUI_HeadlessSlot;
+
+#define HGUI_HEADLESS_SLOT_BITS 24
+#define HGUI_HEADLESS_CHUNK_BITS 12      // 对象表分块存放，已分配的槽位不会移动（其他线程可以无锁读取）
+#define HGUI_HEADLESS_CHUNK_SIZE ((size_t)1 << HGUI_HEADLESS_CHUNK_BITS)
+#define HGUI_HEADLESS_MAX_THREADS 1024
+
+typedef struct {
+	char* text;
+	UINT flags;
+	UINT_PTR id;        // 菜单项ID，MF_POPUP时为子菜单句柄
+} HGUI_HeadlessMenuItem;
+
+typedef struct {
+	HGUI_HeadlessMenuItem* items;
+	int item_count;
+	int item_capacity;
+} HGUI_HeadlessMenu;
+
+typedef struct {
+	ACCEL* entries;
+	int count;
+} HGUI_HeadlessAccel;
+
+typedef struct {
+	LOGFONT logfont;
+	bool stock;
+} HGUI_HeadlessFont;
+
+typedef struct {
+	char class_name[32];
+	char* text;
+	DWORD style;
+	DWORD ex_style;
+	RECT rect;                  // 相对父窗口客户区（顶层窗口为屏幕坐标）
+	HWND hwnd;
+	DWORD thread;               // 创建窗口的线程（PostMessage投递到它的消息队列）
+	HWND parent;
+	HWND first_child;
+	HWND next_sibling;
+	HWND prev_sibling;
+	WNDPROC proc;               // 注册窗口类的窗口过程，内置控件类为NULL
+	HMENU menu;
+	HGDIOBJ font;
+	bool visible;
+	bool redraw;
+	int check;
+	char** items;               // 列表项（LBS_NODATA时为NULL，只记录数量）
+	int item_count;
+	int item_capacity;
+	int cursel;
+	int top_index;
+	int item_height;
+	RECT update;                // 无效区域的外接矩形（客户区坐标）
+	bool has_update;
+	uint32_t* screen;           // SetDIBitsToDevice写入的客户区像素（首次写入时按客户区大小分配）
+	int screen_width;
+	int screen_height;
+} HGUI_HeadlessWindow;
+
+typedef struct {
+	char name[64];
+	WNDPROC proc;
+} HGUI_HeadlessClass;
+
+typedef struct {
+	UINT_PTR id;
+	HWND hwnd;
+	long long interval_ns;
+	long long due_ns;
+} HGUI_HeadlessTimer;
+
+// 每个线程的消息队列、定时器、修饰键与计数器（按线程ID索引，首次使用时创建）
+typedef struct {
+	MSG* queue;                     // 环形消息队列，其他线程可以投递（由lock保护）
+	size_t queue_head;
+	size_t queue_count;
+	size_t queue_capacity;
+	volatile int lock;
+	HGUI_HeadlessTimer* timers;     // 以下只由所属线程访问
+	int timer_count;
+	int timer_capacity;
+	UINT_PTR next_timer_id;
+	BYTE modifiers;                 // 当前按下的修饰键（FCONTROL等），由hgui_headless_key设置
+	HGUI_HeadlessStats stats;       // messages_posted由投递方在lock内累加
+} HGUI_HeadlessThread;
+
+typedef struct {
+	HWND hwnd;
+	RECT rect;
+	UINT flags;
+} HGUI_HeadlessMove;
+
+typedef struct {
+	HGUI_HeadlessMove* moves;
+	int count;
+	int capacity;
+} HGUI_HeadlessDefer;
+
+static HGUI_HeadlessSlot* headless_chunks[(size_t)1 << (HGUI_HEADLESS_SLOT_BITS - HGUI_HEADLESS_CHUNK_BITS)];
+static size_t headless_slot_count = 0;          // 已使用过的槽位数（在写入槽位后发布）
+static size_t* headless_free_slots = NULL;
+static size_t headless_free_count = 0;
+static size_t headless_free_capacity = 0;
+static volatile int headless_table_lock = 0;    // 保护对象表的分配与释放，以及窗口类注册
+
+static HGUI_HeadlessClass headless_classes[16];
+static int headless_class_count = 0;
+
+static HGUI_HeadlessThread* headless_threads[HGUI_HEADLESS_MAX_THREADS];
+
+static volatile int headless_pending_work = 0;  // 其他线程中尚未投递回来的工作数
+static HGUI_HeadlessFont headless_stock_font = { { -12, 0, 0, 0, FW_NORMAL, 0, 0, 0, 1, 0, 0, 0, 0, "MS Shell Dlg" }, true };
+static volatile DWORD headless_next_thread_id = 0;
+static __thread DWORD headless_thread_id = 0;
+
+static inline void headless_lock(volatile int* lock) {
+	while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+	}
+}
+
+static inline void headless_unlock(volatile int* lock) {
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+// 辅助函数：取得槽位（槽位必须已分配过）
+static inline HGUI_HeadlessSlot* headless_slot(size_t slot) {
+	return &headless_chunks[slot >> HGUI_HEADLESS_CHUNK_BITS][slot & (HGUI_HEADLESS_CHUNK_SIZE - 1)];
+}
+
+// 辅助函数：分配对象句柄
+static inline void* headless_handle_alloc(HGUI_HeadlessKind kind, void* object) {
+	headless_lock(&headless_table_lock);
+	size_t slot;
+	HGUI_HeadlessSlot* entry;
+	if (headless_free_count > 0) {
+		slot = headless_free_slots[--headless_free_count];
+		entry = headless_slot(slot);
+	}
+	else {
+		slot = headless_slot_count;
+		size_t chunk = slot >> HGUI_HEADLESS_CHUNK_BITS;
+		if (chunk == sizeof(headless_chunks) / sizeof(headless_chunks[0])) {
+			headless_unlock(&headless_table_lock);
+			return NULL;
+		}
+		if (!headless_chunks[chunk]) {
+			headless_chunks[chunk] = (HGUI_HeadlessSlot*)calloc(HGUI_HEADLESS_CHUNK_SIZE, sizeof(HGUI_HeadlessSlot));
+			if (!headless_chunks[chunk]) {
+				headless_unlock(&headless_table_lock);
+				return NULL;
+			}
+		}
+		if (headless_free_capacity < slot + 1) {
+			size_t capacity = headless_free_capacity ? headless_free_capacity * 2 : 256;
+			size_t* free_slots = (size_t*)realloc(headless_free_slots, capacity * sizeof(size_t));
+			if (!free_slots) {
+				headless_unlock(&headless_table_lock);
+				return NULL;
+			}
+			headless_free_slots = free_slots;
+			headless_free_capacity = capacity;
+		}
+		entry = headless_slot(slot);
+		entry->generation = 0;
+	}
+
+	entry->object = object;
+	entry->kind = (unsigned char)kind;
+	entry->generation = (entry->generation + 1) & (unsigned int)(UINTPTR_MAX >> HGUI_HEADLESS_SLOT_BITS);
+	if (entry->generation == 0) entry->generation = 1;
+	void* handle = (void*)(((uintptr_t)entry->generation << HGUI_HEADLESS_SLOT_BITS) | (uintptr_t)(slot + 1));
+	if (slot == headless_slot_count) __atomic_store_n(&headless_slot_count, slot + 1, __ATOMIC_RELEASE);
+	headless_unlock(&headless_table_lock);
+	return handle;
+}
+
+// 辅助函数：解析对象句柄，已释放或类型不符时返回NULL
+static inline void* headless_handle_get(const void* handle, HGUI_HeadlessKind kind) {
+	uintptr_t value = (uintptr_t)handle;
+	size_t slot = (size_t)(value & (((uintptr_t)1 << HGUI_HEADLESS_SLOT_BITS) - 1));
+	if (slot == 0 || slot > __atomic_load_n(&headless_slot_count, __ATOMIC_ACQUIRE)) return NULL;
+
+	HGUI_HeadlessSlot* entry = headless_slot(slot - 1);
+	if (entry->kind != kind || entry->generation != (unsigned int)(value >> HGUI_HEADLESS_SLOT_BITS)) return NULL;
+	return entry->object;
+}
+
+// 辅助函数：释放对象句柄
+static inline void headless_handle_free(const void* handle) {
+	size_t slot = (size_t)((uintptr_t)handle & (((uintptr_t)1 << HGUI_HEADLESS_SLOT_BITS) - 1));
+	headless_lock(&headless_table_lock);
+	HGUI_HeadlessSlot* entry = headless_slot(slot - 1);
+	entry->kind = HGUI_HEADLESS_FREE;
+	entry->object = NULL;
+	headless_free_slots[headless_free_count++] = slot - 1;
+	headless_unlock(&headless_table_lock);
+}
+
+static inline HGUI_HeadlessWindow* headless_window(HWND hwnd) {
+	return (HGUI_HeadlessWindow*)headless_handle_get(hwnd, HGUI_HEADLESS_WINDOW);
+}
+
+static inline char* headless_strdup(const char* text) {
+	if (!text) text = "";
+	size_t length = strlen(text) + 1;
+	char* copy = (char*)malloc(length);
+	if (copy) memcpy(copy, text, length);
+	return copy;
+}
+
+static inline long long headless_now_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// 时钟与线程
+static inline BOOL QueryPerformanceCounter(LARGE_INTEGER* counter) {
+	counter->QuadPart = headless_now_ns();
+	return TRUE;
+}
+
+static inline BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency) {
+	frequency->QuadPart = 1000000000LL;
+	return TRUE;
+}
+
+static inline DWORD GetCurrentThreadId(void) {
+	if (!headless_thread_id) {
+		headless_thread_id = __atomic_add_fetch(&headless_next_thread_id, 1, __ATOMIC_RELAXED);
+	}
+	return headless_thread_id;
+}
+
+// 辅助函数：取得线程的状态，不存在时创建（其他线程可以为尚未取消息的线程创建）
+static inline HGUI_HeadlessThread* headless_thread(DWORD thread_id) {
+	HGUI_HeadlessThread** slot = &headless_threads[thread_id % HGUI_HEADLESS_MAX_THREADS];
+	HGUI_HeadlessThread* state = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+	if (state) return state;
+
+	HGUI_HeadlessThread* created = (HGUI_HeadlessThread*)calloc(1, sizeof(HGUI_HeadlessThread));
+	if (!created) return NULL;
+	created->next_timer_id = 1;
+	if (!__atomic_compare_exchange_n(slot, &state, created, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		free(created);
+		return state;
+	}
+	return created;
+}
+
+// 辅助函数：调用线程的状态
+static inline HGUI_HeadlessThread* headless_self(void) {
+	HGUI_HeadlessThread* state = headless_thread(GetCurrentThreadId());
+	if (!state) abort();
+	return state;
+}
+
+static inline void* InterlockedCompareExchangePointer(PVOID volatile* destination, void* exchange, void* comparand) {
+	return __sync_val_compare_and_swap(destination, comparand, exchange);
+}
+
+static inline void* InterlockedExchangePointer(PVOID volatile* target, void* value) {
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG InterlockedExchange(volatile LONG* target, LONG value) {
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline void OutputDebugStringA(const char* text) {
+	fputs(text, stderr);
+}
+
+// 模块与窗口类
+static inline HINSTANCE GetModuleHandle(LPCSTR name) {
+	(void)name;
+	return (HINSTANCE)headless_classes;
+}
+
+static inline HCURSOR LoadCursor(HINSTANCE instance, LPCSTR name) {
+	(void)instance;
+	return (HCURSOR)name;
+}
+
+static inline WORD RegisterClassEx(const WNDCLASSEX* wc) {
+	headless_lock(&headless_table_lock);
+	for (int i = 0; i < headless_class_count; i++) {
+		if (strcmp(headless_classes[i].name, wc->lpszClassName) == 0) {
+			headless_unlock(&headless_table_lock);
+			return 0;   // 已注册
+		}
+	}
+	if (headless_class_count == (int)(sizeof(headless_classes) / sizeof(headless_classes[0]))) {
+		headless_unlock(&headless_table_lock);
+		return 0;
+	}
+
+	HGUI_HeadlessClass* entry = &headless_classes[headless_class_count];
+	snprintf(entry->name, sizeof(entry->name), "%s", wc->lpszClassName);
+	entry->proc = wc->lpfnWndProc;
+	int count = headless_class_count + 1;
+	__atomic_store_n(&headless_class_count, count, __ATOMIC_RELEASE);   // 写入条目后发布，查找不需要加锁
+	headless_unlock(&headless_table_lock);
+	return (WORD)count;
+}
+
+// 消息队列
+static inline BOOL headless_post(HGUI_HeadlessThread* target, HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	if (!target) return FALSE;
+	headless_lock(&target->lock);
+	if (target->queue_count == target->queue_capacity) {
+		size_t capacity = target->queue_capacity ? target->queue_capacity * 2 : 64;
+		MSG* queue = (MSG*)malloc(capacity * sizeof(MSG));
+		if (!queue) {
+			headless_unlock(&target->lock);
+			return FALSE;
+		}
+		for (size_t i = 0; i < target->queue_count; i++) {
+			queue[i] = target->queue[(target->queue_head + i) % target->queue_capacity];
+		}
+		free(target->queue);
+		target->queue = queue;
+		target->queue_head = 0;
+		target->queue_capacity = capacity;
+	}
+
+	MSG* msg = &target->queue[(target->queue_head + target->queue_count) % target->queue_capacity];
+	memset(msg, 0, sizeof(MSG));
+	msg->hwnd = hwnd;
+	msg->message = message;
+	msg->wParam = wParam;
+	msg->lParam = lParam;
+	target->queue_count++;
+	target->stats.messages_posted++;
+	headless_unlock(&target->lock);
+	return TRUE;
+}
+
+// 投递到创建窗口的线程（hwnd为NULL时投递到调用线程）
+static inline BOOL PostMessage(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	if (!hwnd) return headless_post(headless_self(), NULL, message, wParam, lParam);
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+	return headless_post(headless_thread(window->thread), hwnd, message, wParam, lParam);
+}
+
+static inline BOOL PostThreadMessage(DWORD thread_id, UINT message, WPARAM wParam, LPARAM lParam) {
+	if (thread_id == 0) return FALSE;
+	return headless_post(headless_thread(thread_id), NULL, message, wParam, lParam);
+}
+
+static inline void PostQuitMessage(int exit_code) {
+	headless_post(headless_self(), NULL, WM_QUIT, (WPARAM)exit_code, 0);
+}
+
+// 辅助函数：取出调用线程的下一条消息，队列为空时产生到期的定时器消息；两者都没有时返回FALSE
+static inline BOOL headless_next_message(MSG* msg, bool remove) {
+	HGUI_HeadlessThread* self = headless_self();
+	headless_lock(&self->lock);
+	if (self->queue_count > 0) {
+		*msg = self->queue[self->queue_head];
+		if (remove) {
+			self->queue_head = (self->queue_head + 1) % self->queue_capacity;
+			self->queue_count--;
+		}
+		headless_unlock(&self->lock);
+		return TRUE;
+	}
+	headless_unlock(&self->lock);
+
+	memset(msg, 0, sizeof(MSG));
+	long long now = headless_now_ns();
+	for (int i = 0; i < self->timer_count; i++) {
+		HGUI_HeadlessTimer* timer = &self->timers[i];
+		if (timer->due_ns <= now) {
+			if (remove) timer->due_ns = now + timer->interval_ns;
+			msg->hwnd = timer->hwnd;
+			msg->message = WM_TIMER;
+			msg->wParam = timer->id;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+// 消息队列为空且没有到期的定时器时返回FALSE（运行到空闲）
+static inline BOOL GetMessage(MSG* msg, HWND hwnd, UINT filter_min, UINT filter_max) {
+	(void)hwnd;
+	(void)filter_min;
+	(void)filter_max;
+
+	if (!headless_next_message(msg, true)) {
+		msg->message = WM_QUIT;
+		return FALSE;
+	}
+	return msg->message != WM_QUIT;
+}
+
+static inline BOOL PeekMessage(MSG* msg, HWND hwnd, UINT filter_min, UINT filter_max, UINT remove) {
+	(void)hwnd;
+	(void)filter_min;
+	(void)filter_max;
+	return headless_next_message(msg, (remove & PM_REMOVE) != 0);
+}
+
+// 等待到有消息、定时器到期或超时；没有消息、定时器与其他线程的待投递工作且超时为无限时
+// 返回WAIT_FAILED（运行到空闲）。睡眠按1毫秒分片，以便及时发现其他线程投递的消息。
+static inline DWORD MsgWaitForMultipleObjectsEx(DWORD count, const HANDLE* handles, DWORD timeout_ms, DWORD wake_mask, DWORD flags) {
+	(void)count;
+	(void)handles;
+	(void)wake_mask;
+	(void)flags;
+
+	HGUI_HeadlessThread* self = headless_self();
+	long long deadline = timeout_ms == INFINITE ? -1 : headless_now_ns() + (long long)timeout_ms * 1000000LL;
+	for (int i = 0; i < self->timer_count; i++) {
+		if (deadline < 0 || self->timers[i].due_ns < deadline) deadline = self->timers[i].due_ns;
+	}
+
+	for (;;) {
+		MSG msg;
+		if (headless_next_message(&msg, false)) return WAIT_OBJECT_0;
+		if (deadline < 0 && __atomic_load_n(&headless_pending_work, __ATOMIC_ACQUIRE) == 0) return WAIT_FAILED;
+
+		long long now = headless_now_ns();
+		if (deadline >= 0 && now >= deadline) return WAIT_TIMEOUT;
+		long long slice = deadline >= 0 && deadline - now < 1000000LL ? deadline - now : 1000000LL;
+		struct timespec pause = { 0, (long)slice };
+		nanosleep(&pause, NULL);
+	}
+}
+
+static inline BOOL TranslateMessage(const MSG* msg) {
+	(void)msg;
+	return FALSE;
+}
+
+static inline LRESULT headless_default_proc(HGUI_HeadlessWindow* window, UINT message, WPARAM wParam, LPARAM lParam);
+
+static inline LRESULT SendMessage(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return 0;
+
+	headless_self()->stats.messages_sent++;
+	if (window->proc) return window->proc(hwnd, message, wParam, lParam);
+	return headless_default_proc(window, message, wParam, lParam);
+}
+
+static inline LRESULT DispatchMessage(const MSG* msg) {
+	headless_self()->stats.messages_dispatched++;
+	HGUI_HeadlessWindow* window = headless_window(msg->hwnd);
+	if (!window) return 0;
+	if (window->proc) return window->proc(msg->hwnd, msg->message, msg->wParam, msg->lParam);
+	return headless_default_proc(window, msg->message, msg->wParam, msg->lParam);
+}
+
+static inline LRESULT DefWindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	return window ? headless_default_proc(window, message, wParam, lParam) : 0;
+}
+
+// 定时器（属于调用线程）
+static inline UINT_PTR SetTimer(HWND hwnd, UINT_PTR id, UINT elapse_ms, TIMERPROC proc) {
+	(void)proc;
+	HGUI_HeadlessThread* self = headless_self();
+	if (!hwnd) id = self->next_timer_id++;
+
+	HGUI_HeadlessTimer* timer = NULL;
+	for (int i = 0; i < self->timer_count; i++) {
+		if (self->timers[i].hwnd == hwnd && self->timers[i].id == id) timer = &self->timers[i];
+	}
+	if (!timer) {
+		if (self->timer_count == self->timer_capacity) {
+			int capacity = self->timer_capacity ? self->timer_capacity * 2 : 8;
+			HGUI_HeadlessTimer* timers = (HGUI_HeadlessTimer*)realloc(self->timers, (size_t)capacity * sizeof(HGUI_HeadlessTimer));
+			if (!timers) return 0;
+			self->timers = timers;
+			self->timer_capacity = capacity;
+		}
+		timer = &self->timers[self->timer_count++];
+	}
+	timer->id = id;
+	timer->hwnd = hwnd;
+	timer->interval_ns = (long long)elapse_ms * 1000000LL;
+	timer->due_ns = headless_now_ns() + timer->interval_ns;
+	return id;
+}
+
+static inline BOOL KillTimer(HWND hwnd, UINT_PTR id) {
+	HGUI_HeadlessThread* self = headless_self();
+	for (int i = 0; i < self->timer_count; i++) {
+		if (self->timers[i].hwnd == hwnd && self->timers[i].id == id) {
+			self->timers[i] = self->timers[--self->timer_count];
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+// 窗口
+static inline HGUI_HeadlessClass* headless_find_class(const char* name) {
+	int count = __atomic_load_n(&headless_class_count, __ATOMIC_ACQUIRE);
+	for (int i = 0; i < count; i++) {
+		if (strcmp(headless_classes[i].name, name) == 0) return &headless_classes[i];
+	}
+	return NULL;
+}
+
+static inline bool headless_is_class(const HGUI_HeadlessWindow* window, const char* name) {
+	return strcmp(window->class_name, name) == 0;
+}
+
+static inline HWND CreateWindowEx(DWORD ex_style, LPCSTR class_name, LPCSTR text, DWORD style,
+						   int x, int y, int width, int height,
+						   HWND parent, HMENU menu, HINSTANCE instance, void* param) {
+	(void)instance;
+	(void)param;
+
+	HGUI_HeadlessWindow* parent_window = NULL;
+	if (parent) {
+		parent_window = headless_window(parent);
+		if (!parent_window) return NULL;
+	}
+
+	HGUI_HeadlessClass* registered = headless_find_class(class_name);
+	if (!registered && strcmp(class_name, "STATIC") != 0 && strcmp(class_name, "BUTTON") != 0 &&
+		strcmp(class_name, "EDIT") != 0 && strcmp(class_name, "LISTBOX") != 0) {
+		return NULL;
+	}
+
+	HGUI_HeadlessWindow* window = (HGUI_HeadlessWindow*)calloc(1, sizeof(HGUI_HeadlessWindow));
+	if (!window) return NULL;
+	HWND hwnd = (HWND)headless_handle_alloc(HGUI_HEADLESS_WINDOW, window);
+	if (!hwnd) {
+		free(window);
+		return NULL;
+	}
+
+	snprintf(window->class_name, sizeof(window->class_name), "%s", class_name);
+	window->text = headless_strdup(text);
+	window->style = style;
+	window->ex_style = ex_style;
+	window->rect.left = x;
+	window->rect.top = y;
+	window->rect.right = x + width;
+	window->rect.bottom = y + height;
+	window->hwnd = hwnd;
+	window->thread = GetCurrentThreadId();
+	window->parent = parent;
+	window->proc = registered ? registered->proc : NULL;
+	window->menu = (style & WS_CHILD) ? NULL : menu;
+	window->visible = (style & WS_VISIBLE) != 0;
+	window->redraw = true;
+	window->cursel = -1;
+	window->item_height = 16;
+
+	if (parent_window) {
+		HGUI_HeadlessWindow* first = headless_window(parent_window->first_child);
+		if (first) first->prev_sibling = hwnd;
+		window->next_sibling = parent_window->first_child;
+		parent_window->first_child = hwnd;
+	}
+	headless_self()->stats.windows_created++;
+	headless_self()->stats.windows_alive++;
+
+	// 自绘列表框在创建时向父窗口询问行高
+	if (parent && headless_is_class(window, "LISTBOX") && (style & LBS_OWNERDRAWFIXED)) {
+		MEASUREITEMSTRUCT mis;
+		memset(&mis, 0, sizeof(mis));
+		mis.CtlType = ODT_LISTBOX;
+		mis.itemHeight = (UINT)window->item_height;
+		SendMessage(parent, WM_MEASUREITEM, 0, (LPARAM)&mis);
+		if (headless_window(hwnd) && mis.itemHeight > 0) window->item_height = (int)mis.itemHeight;
+	}
+	return hwnd;
+}
+
+static inline void headless_clear_items(HGUI_HeadlessWindow* window) {
+	if (window->items) {
+		for (int i = 0; i < window->item_count; i++) free(window->items[i]);
+	}
+	window->item_count = 0;
+	window->cursel = -1;
+	window->top_index = 0;
+}
+
+static inline BOOL DestroyMenu(HMENU menu);
+
+static inline BOOL DestroyWindow(HWND hwnd) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+
+	// 与Win32一致：先通知窗口本身，再递归销毁子窗口
+	if (window->proc) window->proc(hwnd, WM_DESTROY, 0, 0);
+	window = headless_window(hwnd);
+	if (!window) return TRUE;
+
+	while (window->first_child) {
+		if (!DestroyWindow(window->first_child)) {
+			window->first_child = NULL;
+		}
+	}
+
+	// 从父窗口的子窗口链表中摘除
+	HGUI_HeadlessWindow* next = headless_window(window->next_sibling);
+	HGUI_HeadlessWindow* prev = headless_window(window->prev_sibling);
+	HGUI_HeadlessWindow* parent_window = headless_window(window->parent);
+	if (next) next->prev_sibling = window->prev_sibling;
+	if (prev) prev->next_sibling = window->next_sibling;
+	else if (parent_window) parent_window->first_child = window->next_sibling;
+
+	if (window->menu) DestroyMenu(window->menu);
+	headless_clear_items(window);
+	free(window->items);
+	free(window->text);
+	free(window->screen);
+	free(window);
+	headless_handle_free(hwnd);
+	HGUI_HeadlessThread* self = headless_self();
+	self->stats.windows_destroyed++;
+	self->stats.windows_alive--;
+
+	// 删除窗口的定时器
+	for (int i = 0; i < self->timer_count; ) {
+		if (self->timers[i].hwnd == hwnd) self->timers[i] = self->timers[--self->timer_count];
+		else i++;
+	}
+	return TRUE;
+}
+
+static inline BOOL ShowWindow(HWND hwnd, int command) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+
+	BOOL was_visible = window->visible;
+	window->visible = command != SW_HIDE;
+	return was_visible;
+}
+
+// 有无效区域时同步发送WM_PAINT
+static inline BOOL UpdateWindow(HWND hwnd) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+	if (window->has_update) SendMessage(hwnd, WM_PAINT, 0, 0);
+	return TRUE;
+}
+
+static inline HWND GetParent(HWND hwnd) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	return window ? window->parent : NULL;
+}
+
+// 辅助函数：窗口客户区原点的屏幕坐标
+static inline POINT headless_screen_origin(HWND hwnd) {
+	POINT origin = { 0, 0 };
+	for (HGUI_HeadlessWindow* window = headless_window(hwnd); window; window = headless_window(window->parent)) {
+		origin.x += window->rect.left;
+		origin.y += window->rect.top;
+	}
+	return origin;
+}
+
+static inline BOOL GetWindowRect(HWND hwnd, RECT* rect) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+
+	POINT origin = headless_screen_origin(window->parent);
+	rect->left = window->rect.left + origin.x;
+	rect->top = window->rect.top + origin.y;
+	rect->right = window->rect.right + origin.x;
+	rect->bottom = window->rect.bottom + origin.y;
+	return TRUE;
+}
+
+static inline BOOL GetClientRect(HWND hwnd, RECT* rect) {
+	memset(rect, 0, sizeof(RECT));
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+
+	rect->right = window->rect.right - window->rect.left;
+	rect->bottom = window->rect.bottom - window->rect.top;
+	return TRUE;
+}
+
+static inline int MapWindowPoints(HWND from, HWND to, POINT* points, UINT count) {
+	POINT source = headless_screen_origin(from);
+	POINT target = headless_screen_origin(to);
+	LONG dx = source.x - target.x;
+	LONG dy = source.y - target.y;
+	for (UINT i = 0; i < count; i++) {
+		points[i].x += dx;
+		points[i].y += dy;
+	}
+	return (int)(((DWORD)(WORD)dy << 16) | (WORD)dx);
+}
+
+// 无效区域只记录外接矩形，由UpdateWindow触发WM_PAINT
+static inline BOOL InvalidateRect(HWND hwnd, const RECT* rect, BOOL erase) {
+	(void)erase;
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+	headless_self()->stats.invalidations++;
+
+	RECT client;
+	GetClientRect(hwnd, &client);
+	RECT area = rect ? *rect : client;
+	if (area.left < client.left) area.left = client.left;
+	if (area.top < client.top) area.top = client.top;
+	if (area.right > client.right) area.right = client.right;
+	if (area.bottom > client.bottom) area.bottom = client.bottom;
+	if (area.left >= area.right || area.top >= area.bottom) return TRUE;
+
+	if (!window->has_update) {
+		window->update = area;
+		window->has_update = true;
+		return TRUE;
+	}
+	if (area.left < window->update.left) window->update.left = area.left;
+	if (area.top < window->update.top) window->update.top = area.top;
+	if (area.right > window->update.right) window->update.right = area.right;
+	if (area.bottom > window->update.bottom) window->update.bottom = area.bottom;
+	return TRUE;
+}
+
+static inline BOOL RedrawWindow(HWND hwnd, const RECT* rect, void* region, UINT flags) {
+	(void)rect;
+	(void)region;
+	(void)flags;
+	if (!headless_window(hwnd)) return FALSE;
+	headless_self()->stats.invalidations++;
+	return TRUE;
+}
+
+// 绘制：设备上下文即窗口句柄
+static inline HDC GetDC(HWND hwnd) {
+	return headless_window(hwnd) ? (HDC)hwnd : NULL;
+}
+
+static inline int ReleaseDC(HWND hwnd, HDC dc) {
+	(void)hwnd;
+	return dc != NULL;
+}
+
+// 取出并清空无效区域
+static inline HDC BeginPaint(HWND hwnd, PAINTSTRUCT* ps) {
+	memset(ps, 0, sizeof(PAINTSTRUCT));
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return NULL;
+
+	headless_self()->stats.paints++;
+	if (window->has_update) ps->rcPaint = window->update;
+	window->has_update = false;
+	ps->hdc = (HDC)hwnd;
+	return ps->hdc;
+}
+
+static inline BOOL EndPaint(HWND hwnd, const PAINTSTRUCT* ps) {
+	(void)ps;
+	return headless_window(hwnd) != NULL;
+}
+
+// 只支持32位BI_RGB的自顶向下DIB；像素写入窗口的客户区像素缓冲（超出客户区的部分被裁剪）
+static inline int SetDIBitsToDevice(HDC dc, int x, int y, DWORD width, DWORD height, int src_x, int src_y,
+							 UINT start_scan, UINT lines, const void* bits, const BITMAPINFO* info, UINT usage) {
+	(void)start_scan;
+	(void)usage;
+	HGUI_HeadlessWindow* window = headless_window((HWND)dc);
+	if (!window || !bits || info->bmiHeader.biBitCount != 32 || info->bmiHeader.biCompression != BI_RGB ||
+		info->bmiHeader.biHeight >= 0) return 0;
+	HGUI_HeadlessStats* stats = &headless_self()->stats;
+	stats->blits++;
+
+	RECT client;
+	GetClientRect((HWND)dc, &client);
+	if (!window->screen || window->screen_width != client.right || window->screen_height != client.bottom) {
+		free(window->screen);
+		window->screen = (uint32_t*)calloc((size_t)client.right * (size_t)client.bottom + 1, sizeof(uint32_t));
+		window->screen_width = window->screen ? client.right : 0;
+		window->screen_height = window->screen ? client.bottom : 0;
+	}
+
+	LONG dib_width = info->bmiHeader.biWidth;
+	LONG dib_height = -info->bmiHeader.biHeight;
+	const uint32_t* pixels = (const uint32_t*)bits;
+	UINT written = 0;
+	for (DWORD row = 0; row < height && row < lines; row++) {
+		int ty = y + (int)row;
+		int sy = src_y + (int)row;
+		if (ty < 0 || ty >= window->screen_height || sy < 0 || sy >= dib_height) continue;
+		const uint32_t* source = pixels + (size_t)sy * (size_t)dib_width;
+		for (DWORD col = 0; col < width; col++) {
+			int tx = x + (int)col;
+			int sx = src_x + (int)col;
+			if (tx < 0 || tx >= window->screen_width || sx < 0 || sx >= dib_width) continue;
+			window->screen[(size_t)ty * (size_t)window->screen_width + (size_t)tx] = source[sx];
+			stats->pixels_blitted++;
+		}
+		written++;
+	}
+	return (int)written;
+}
+
+static inline HDWP BeginDeferWindowPos(int count) {
+	HGUI_HeadlessDefer* defer = (HGUI_HeadlessDefer*)calloc(1, sizeof(HGUI_HeadlessDefer));
+	if (!defer) return NULL;
+
+	if (count > 0) {
+		defer->moves = (HGUI_HeadlessMove*)malloc((size_t)count * sizeof(HGUI_HeadlessMove));
+		if (defer->moves) defer->capacity = count;
+	}
+	return (HDWP)defer;
+}
+
+static inline HDWP DeferWindowPos(HDWP handle, HWND hwnd, HWND insert_after, int x, int y, int width, int height, UINT flags) {
+	(void)insert_after;
+	HGUI_HeadlessDefer* defer = (HGUI_HeadlessDefer*)handle;
+	if (!defer || !headless_window(hwnd)) return handle;
+
+	if (defer->count == defer->capacity) {
+		int capacity = defer->capacity ? defer->capacity * 2 : 8;
+		HGUI_HeadlessMove* moves = (HGUI_HeadlessMove*)realloc(defer->moves, (size_t)capacity * sizeof(HGUI_HeadlessMove));
+		if (!moves) {
+			free(defer->moves);
+			free(defer);
+			return NULL;
+		}
+		defer->moves = moves;
+		defer->capacity = capacity;
+	}
+
+	HGUI_HeadlessMove* move = &defer->moves[defer->count++];
+	move->hwnd = hwnd;
+	move->rect.left = x;
+	move->rect.top = y;
+	move->rect.right = x + width;
+	move->rect.bottom = y + height;
+	move->flags = flags;
+	return handle;
+}
+
+static inline BOOL EndDeferWindowPos(HDWP handle) {
+	HGUI_HeadlessDefer* defer = (HGUI_HeadlessDefer*)handle;
+	if (!defer) return FALSE;
+
+	for (int i = 0; i < defer->count; i++) {
+		HGUI_HeadlessMove* move = &defer->moves[i];
+		HGUI_HeadlessWindow* window = headless_window(move->hwnd);
+		if (!window) continue;
+
+		LONG old_width = window->rect.right - window->rect.left;
+		LONG old_height = window->rect.bottom - window->rect.top;
+		if (!(move->flags & SWP_NOMOVE)) {
+			LONG width = window->rect.right - window->rect.left;
+			LONG height = window->rect.bottom - window->rect.top;
+			window->rect.left = move->rect.left;
+			window->rect.top = move->rect.top;
+			window->rect.right = move->rect.left + width;
+			window->rect.bottom = move->rect.top + height;
+		}
+		if (!(move->flags & SWP_NOSIZE)) {
+			window->rect.right = window->rect.left + (move->rect.right - move->rect.left);
+			window->rect.bottom = window->rect.top + (move->rect.bottom - move->rect.top);
+		}
+		if (move->flags & SWP_SHOWWINDOW) window->visible = true;
+		if (move->flags & SWP_HIDEWINDOW) window->visible = false;
+		headless_self()->stats.window_moves++;
+
+		// 尺寸变化时与系统一样同步发送WM_SIZE
+		LONG width = window->rect.right - window->rect.left;
+		LONG height = window->rect.bottom - window->rect.top;
+		if (width != old_width || height != old_height) {
+			SendMessage(move->hwnd, WM_SIZE, 0, MAKELPARAM(width, height));
+		}
+	}
+	free(defer->moves);
+	free(defer);
+	return TRUE;
+}
+
+static inline BOOL SetWindowPos(HWND hwnd, HWND insert_after, int x, int y, int width, int height, UINT flags) {
+	HDWP defer = BeginDeferWindowPos(1);
+	defer = DeferWindowPos(defer, hwnd, insert_after, x, y, width, height, flags);
+	return defer ? EndDeferWindowPos(defer) : FALSE;
+}
+
+// 辅助函数：在列表项数组的index处插入一项
+static inline bool headless_items_insert(HGUI_HeadlessWindow* window, int index, const char* text) {
+	if (window->item_count == window->item_capacity) {
+		int capacity = window->item_capacity ? window->item_capacity * 2 : 16;
+		char** items = (char**)realloc(window->items, (size_t)capacity * sizeof(char*));
+		if (!items) return false;
+		window->items = items;
+		window->item_capacity = capacity;
+	}
+
+	char* copy = headless_strdup(text);
+	if (!copy) return false;
+	memmove(window->items + index + 1, window->items + index, (size_t)(window->item_count - index) * sizeof(char*));
+	window->items[index] = copy;
+	window->item_count++;
+	if (window->cursel >= index) window->cursel++;
+	return true;
+}
+
+// 内置控件类与注册窗口类共用的默认消息处理
+static inline LRESULT headless_default_proc(HGUI_HeadlessWindow* window, UINT message, WPARAM wParam, LPARAM lParam) {
+	bool nodata = (window->style & LBS_NODATA) != 0;
+
+	switch (message) {
+		case WM_SETTEXT: {
+			char* text = headless_strdup((const char*)lParam);
+			if (!text) return FALSE;
+			free(window->text);
+			window->text = text;
+			return TRUE;
+		}
+		case WM_GETTEXT: {
+			if (wParam == 0) return 0;
+			size_t length = strlen(window->text);
+			if (length > (size_t)wParam - 1) length = (size_t)wParam - 1;
+			memcpy((char*)lParam, window->text, length);
+			((char*)lParam)[length] = '\0';
+			return (LRESULT)length;
+		}
+		case WM_GETTEXTLENGTH:
+			return (LRESULT)strlen(window->text);
+		case WM_SETFONT:
+			window->font = (HGDIOBJ)wParam;
+			return 0;
+		case WM_PAINT: {
+			// 默认处理只使无效区域生效
+			PAINTSTRUCT ps;
+			BeginPaint(window->hwnd, &ps);
+			EndPaint(window->hwnd, &ps);
+			return 0;
+		}
+		case WM_GETFONT:
+			return (LRESULT)window->font;
+		case WM_SETREDRAW:
+			window->redraw = wParam != 0;
+			return 0;
+
+		case BM_SETCHECK:
+			window->check = (int)wParam;
+			return 0;
+		case BM_GETCHECK:
+			return window->check;
+
+		case LB_INITSTORAGE:
+			if (!nodata && (int)wParam > window->item_capacity - window->item_count) {
+				int capacity = window->item_count + (int)wParam;
+				char** items = (char**)realloc(window->items, (size_t)capacity * sizeof(char*));
+				if (!items) return LB_ERR;
+				window->items = items;
+				window->item_capacity = capacity;
+			}
+			return window->item_capacity;
+		case LB_ADDSTRING:
+		case LB_INSERTSTRING: {
+			if (nodata) return LB_ERR;
+			int index = message == LB_ADDSTRING || (int)wParam < 0 ? window->item_count : (int)wParam;
+			if (index > window->item_count) return LB_ERR;
+			return headless_items_insert(window, index, (const char*)lParam) ? index : LB_ERR;
+		}
+		case LB_DELETESTRING: {
+			int index = (int)wParam;
+			if (index < 0 || index >= window->item_count) return LB_ERR;
+			if (!nodata) {
+				free(window->items[index]);
+				memmove(window->items + index, window->items + index + 1, (size_t)(window->item_count - index - 1) * sizeof(char*));
+			}
+			window->item_count--;
+			if (window->cursel == index) window->cursel = -1;
+			else if (window->cursel > index) window->cursel--;
+			if (window->top_index >= window->item_count) window->top_index = window->item_count > 0 ? window->item_count - 1 : 0;
+			return window->item_count;
+		}
+		case LB_RESETCONTENT:
+			if (nodata) {
+				window->item_count = 0;
+				window->cursel = -1;
+				window->top_index = 0;
+			}
+			else {
+				headless_clear_items(window);
+			}
+			return 0;
+		case LB_SETCOUNT:
+			if (!nodata) return LB_ERR;
+			window->item_count = (int)wParam;
+			if (window->cursel >= window->item_count) window->cursel = -1;
+			if (window->top_index >= window->item_count) window->top_index = 0;
+			return 0;
+		case LB_GETCOUNT:
+			return window->item_count;
+		case LB_GETTEXTLEN: {
+			int index = (int)wParam;
+			if (nodata || index < 0 || index >= window->item_count) return LB_ERR;
+			return (LRESULT)strlen(window->items[index]);
+		}
+		case LB_GETTEXT: {
+			int index = (int)wParam;
+			if (nodata || index < 0 || index >= window->item_count) return LB_ERR;
+			size_t length = strlen(window->items[index]);
+			memcpy((char*)lParam, window->items[index], length + 1);
+			return (LRESULT)length;
+		}
+		case LB_SETCURSEL: {
+			int index = (int)wParam;
+			if (index < -1 || index >= window->item_count) {
+				window->cursel = -1;
+				return LB_ERR;
+			}
+			window->cursel = index;
+			return index;
+		}
+		case LB_GETCURSEL:
+			return window->cursel;
+		case LB_SETTOPINDEX: {
+			int index = (int)wParam;
+			if (index < 0 || (index >= window->item_count && index != 0)) return LB_ERR;
+			window->top_index = index;
+			return 0;
+		}
+		case LB_GETTOPINDEX:
+			return window->top_index;
+		case LB_SETITEMHEIGHT:
+			window->item_height = (int)LOWORD(lParam);
+			return 0;
+		case LB_GETITEMHEIGHT:
+			return window->item_height;
+		case LB_GETITEMRECT: {
+			int index = (int)wParam;
+			if (index < 0 || index >= window->item_count) return LB_ERR;
+			RECT* rect = (RECT*)lParam;
+			rect->left = 0;
+			rect->right = window->rect.right - window->rect.left;
+			rect->top = (index - window->top_index) * window->item_height;
+			rect->bottom = rect->top + window->item_height;
+			return 0;
+		}
+
+		default:
+			return 0;
+	}
+}
+
+// 菜单
+static inline HMENU headless_create_menu(void) {
+	HGUI_HeadlessMenu* menu = (HGUI_HeadlessMenu*)calloc(1, sizeof(HGUI_HeadlessMenu));
+	if (!menu) return NULL;
+
+	HMENU handle = (HMENU)headless_handle_alloc(HGUI_HEADLESS_MENU, menu);
+	if (!handle) {
+		free(menu);
+		return NULL;
+	}
+	headless_self()->stats.menus_created++;
+	headless_self()->stats.menus_alive++;
+	return handle;
+}
+
+static inline HMENU CreateMenu(void) {
+	return headless_create_menu();
+}
+
+static inline HMENU CreatePopupMenu(void) {
+	return headless_create_menu();
+}
+
+static inline BOOL AppendMenu(HMENU handle, UINT flags, UINT_PTR id, LPCSTR text) {
+	HGUI_HeadlessMenu* menu = (HGUI_HeadlessMenu*)headless_handle_get(handle, HGUI_HEADLESS_MENU);
+	if (!menu) return FALSE;
+
+	if (menu->item_count == menu->item_capacity) {
+		int capacity = menu->item_capacity ? menu->item_capacity * 2 : 8;
+		HGUI_HeadlessMenuItem* items = (HGUI_HeadlessMenuItem*)realloc(menu->items, (size_t)capacity * sizeof(HGUI_HeadlessMenuItem));
+		if (!items) return FALSE;
+		menu->items = items;
+		menu->item_capacity = capacity;
+	}
+
+	HGUI_HeadlessMenuItem* item = &menu->items[menu->item_count++];
+	item->text = (flags & MF_SEPARATOR) ? NULL : headless_strdup(text);
+	item->flags = flags;
+	item->id = id;
+	headless_self()->stats.menu_items++;
+	return TRUE;
+}
+
+// 与Win32一致：销毁菜单时递归销毁其弹出子菜单
+static inline BOOL DestroyMenu(HMENU handle) {
+	HGUI_HeadlessMenu* menu = (HGUI_HeadlessMenu*)headless_handle_get(handle, HGUI_HEADLESS_MENU);
+	if (!menu) return FALSE;
+
+	headless_handle_free(handle);
+	for (int i = 0; i < menu->item_count; i++) {
+		if (menu->items[i].flags & MF_POPUP) DestroyMenu((HMENU)menu->items[i].id);
+		free(menu->items[i].text);
+	}
+	headless_self()->stats.menu_items -= (unsigned long)menu->item_count;
+	free(menu->items);
+	free(menu);
+	headless_self()->stats.menus_alive--;
+	return TRUE;
+}
+
+// 与Win32一致：删除弹出菜单项时同时销毁其子菜单
+static inline BOOL DeleteMenu(HMENU handle, UINT position, UINT flags) {
+	HGUI_HeadlessMenu* menu = (HGUI_HeadlessMenu*)headless_handle_get(handle, HGUI_HEADLESS_MENU);
+	if (!menu) return FALSE;
+
+	int index = -1;
+	if (flags & MF_BYPOSITION) {
+		if (position < (UINT)menu->item_count) index = (int)position;
+	} else {
+		for (int i = 0; i < menu->item_count && index < 0; i++) {
+			if (!(menu->items[i].flags & (MF_POPUP | MF_SEPARATOR)) && menu->items[i].id == position) index = i;
+		}
+	}
+	if (index < 0) return FALSE;
+
+	HGUI_HeadlessMenuItem item = menu->items[index];
+	memmove(&menu->items[index], &menu->items[index + 1], (size_t)(menu->item_count - index - 1) * sizeof(HGUI_HeadlessMenuItem));
+	menu->item_count--;
+	headless_self()->stats.menu_items--;
+	free(item.text);
+	if (item.flags & MF_POPUP) DestroyMenu((HMENU)item.id);
+	return TRUE;
+}
+
+static inline BOOL SetMenu(HWND hwnd, HMENU menu) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return FALSE;
+	window->menu = menu;
+	return TRUE;
+}
+
+static inline BOOL DrawMenuBar(HWND hwnd) {
+	if (!headless_window(hwnd)) return FALSE;
+	headless_self()->stats.menu_redraws++;
+	return TRUE;
+}
+
+// 快捷键表
+static inline HACCEL CreateAcceleratorTable(ACCEL* entries, int count) {
+	if (!entries || count <= 0) return NULL;
+	HGUI_HeadlessAccel* table = (HGUI_HeadlessAccel*)calloc(1, sizeof(HGUI_HeadlessAccel));
+	if (!table) return NULL;
+	table->entries = (ACCEL*)malloc((size_t)count * sizeof(ACCEL));
+	if (!table->entries) {
+		free(table);
+		return NULL;
+	}
+	memcpy(table->entries, entries, (size_t)count * sizeof(ACCEL));
+	table->count = count;
+
+	HACCEL handle = (HACCEL)headless_handle_alloc(HGUI_HEADLESS_ACCEL, table);
+	if (!handle) {
+		free(table->entries);
+		free(table);
+		return NULL;
+	}
+	headless_self()->stats.accel_tables_alive++;
+	return handle;
+}
+
+static inline BOOL DestroyAcceleratorTable(HACCEL handle) {
+	HGUI_HeadlessAccel* table = (HGUI_HeadlessAccel*)headless_handle_get(handle, HGUI_HEADLESS_ACCEL);
+	if (!table) return FALSE;
+	headless_handle_free(handle);
+	free(table->entries);
+	free(table);
+	headless_self()->stats.accel_tables_alive--;
+	return TRUE;
+}
+
+// 与Win32一致：按键与修饰键都匹配时向hwnd同步发送WM_COMMAND（HIWORD(wParam)为1），返回非0
+static inline int TranslateAccelerator(HWND hwnd, HACCEL handle, MSG* msg) {
+	HGUI_HeadlessAccel* table = (HGUI_HeadlessAccel*)headless_handle_get(handle, HGUI_HEADLESS_ACCEL);
+	if (!table || !headless_window(hwnd) || !msg) return 0;
+	if (msg->message != WM_KEYDOWN && msg->message != WM_SYSKEYDOWN) return 0;
+
+	BYTE modifiers = headless_self()->modifiers & (FSHIFT | FCONTROL | FALT);
+	for (int i = 0; i < table->count; i++) {
+		const ACCEL* entry = &table->entries[i];
+		if (entry->key != (WORD)msg->wParam || (entry->fVirt & (FSHIFT | FCONTROL | FALT)) != modifiers) continue;
+		headless_self()->stats.accelerators++;
+		SendMessage(hwnd, WM_COMMAND, MAKEWPARAM(entry->cmd, 1), 0);
+		return 1;
+	}
+	return 0;
+}
+
+// 字体与绘制
+static inline HGDIOBJ GetStockObject(int object) {
+	static HGDIOBJ stock_font = NULL;
+	if (object != DEFAULT_GUI_FONT) return NULL;
+	HGDIOBJ font = __atomic_load_n(&stock_font, __ATOMIC_ACQUIRE);
+	if (font) return font;
+
+	// 多个线程同时首次取用时只保留一个句柄（库存字体不会被删除）
+	font = headless_handle_alloc(HGUI_HEADLESS_FONT, &headless_stock_font);
+	HGDIOBJ expected = NULL;
+	if (font && !__atomic_compare_exchange_n(&stock_font, &expected, font, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		headless_handle_free(font);
+		font = expected;
+	}
+	return font;
+}
+
+static inline int GetObject(HGDIOBJ object, int size, void* buffer) {
+	HGUI_HeadlessFont* font = (HGUI_HeadlessFont*)headless_handle_get(object, HGUI_HEADLESS_FONT);
+	if (!font || size < (int)sizeof(LOGFONT)) return 0;
+	memcpy(buffer, &font->logfont, sizeof(LOGFONT));
+	return (int)sizeof(LOGFONT);
+}
+
+static inline HFONT CreateFontIndirect(const LOGFONT* logfont) {
+	HGUI_HeadlessFont* font = (HGUI_HeadlessFont*)malloc(sizeof(HGUI_HeadlessFont));
+	if (!font) return NULL;
+	font->logfont = *logfont;
+	font->stock = false;
+
+	HFONT handle = (HFONT)headless_handle_alloc(HGUI_HEADLESS_FONT, font);
+	if (!handle) {
+		free(font);
+		return NULL;
+	}
+	headless_self()->stats.fonts_created++;
+	headless_self()->stats.fonts_alive++;
+	return handle;
+}
+
+static inline BOOL DeleteObject(HGDIOBJ object) {
+	HGUI_HeadlessFont* font = (HGUI_HeadlessFont*)headless_handle_get(object, HGUI_HEADLESS_FONT);
+	if (!font) return FALSE;
+	if (font->stock) return TRUE;
+
+	headless_handle_free(object);
+	free(font);
+	headless_self()->stats.fonts_alive--;
+	return TRUE;
+}
+
+static inline HBRUSH GetSysColorBrush(int index) {
+	return (HBRUSH)(intptr_t)(index + 1);
+}
+
+static inline DWORD GetSysColor(int index) {
+	(void)index;
+	return 0;
+}
+
+static inline int FillRect(HDC dc, const RECT* rect, HBRUSH brush) {
+	(void)dc;
+	(void)rect;
+	(void)brush;
+	return 1;
+}
+
+static inline int SetBkMode(HDC dc, int mode) {
+	(void)dc;
+	(void)mode;
+	return TRANSPARENT;
+}
+
+static inline COLORREF SetTextColor(HDC dc, COLORREF color) {
+	(void)dc;
+	(void)color;
+	return 0;
+}
+
+static inline int DrawText(HDC dc, LPCSTR text, int length, RECT* rect, UINT format) {
+	(void)dc;
+	(void)text;
+	(void)length;
+	(void)format;
+	return rect->bottom - rect->top;
+}
+
+static inline BOOL DrawFocusRect(HDC dc, const RECT* rect) {
+	(void)dc;
+	(void)rect;
+	return TRUE;
+}
+
+// 文件（映射视图为读入内存的整个文件）
+static inline HANDLE CreateFileA(LPCSTR path, DWORD access, DWORD share, void* security, DWORD disposition, DWORD attributes, HANDLE template_file) {
+	(void)access;
+	(void)share;
+	(void)security;
+	(void)disposition;
+	(void)attributes;
+	(void)template_file;
+
+	FILE* file = fopen(path, "rb");
+	if (!file) return INVALID_HANDLE_VALUE;
+	HANDLE handle = headless_handle_alloc(HGUI_HEADLESS_FILE, file);
+	if (!handle) {
+		fclose(file);
+		return INVALID_HANDLE_VALUE;
+	}
+	return handle;
+}
+
+static inline DWORD GetFileSize(HANDLE handle, DWORD* high) {
+	FILE* file = (FILE*)headless_handle_get(handle, HGUI_HEADLESS_FILE);
+	if (high) *high = 0;
+	if (!file || fseek(file, 0, SEEK_END) != 0) return INVALID_FILE_SIZE;
+	long size = ftell(file);
+	return size < 0 ? INVALID_FILE_SIZE : (DWORD)size;
+}
+
+static inline HANDLE CreateFileMappingA(HANDLE handle, void* security, DWORD protect, DWORD size_high, DWORD size_low, LPCSTR name) {
+	(void)security;
+	(void)protect;
+	(void)size_high;
+	(void)size_low;
+	(void)name;
+
+	FILE* file = (FILE*)headless_handle_get(handle, HGUI_HEADLESS_FILE);
+	return file ? headless_handle_alloc(HGUI_HEADLESS_MAPPING, file) : NULL;
+}
+
+static inline void* MapViewOfFile(HANDLE mapping, DWORD access, DWORD offset_high, DWORD offset_low, size_t size) {
+	(void)access;
+	(void)offset_high;
+	(void)offset_low;
+	(void)size;
+
+	FILE* file = (FILE*)headless_handle_get(mapping, HGUI_HEADLESS_MAPPING);
+	if (!file || fseek(file, 0, SEEK_END) != 0) return NULL;
+	long length = ftell(file);
+	if (length <= 0 || fseek(file, 0, SEEK_SET) != 0) return NULL;
+
+	void* view = malloc((size_t)length);
+	if (view && fread(view, 1, (size_t)length, file) != (size_t)length) {
+		free(view);
+		view = NULL;
+	}
+	return view;
+}
+
+static inline BOOL UnmapViewOfFile(const void* view) {
+	free((void*)view);
+	return TRUE;
+}
+
+static inline BOOL CloseHandle(HANDLE handle) {
+	FILE* file = (FILE*)headless_handle_get(handle, HGUI_HEADLESS_FILE);
+	if (file) {
+		fclose(file);
+	}
+	else if (!headless_handle_get(handle, HGUI_HEADLESS_MAPPING)) {
+		return FALSE;
+	}
+	headless_handle_free(handle);
+	return TRUE;
+}
+
+// 模拟输入与状态查询（仅无界面后端提供）
+
+// 取得调用线程的计数器
+static inline void hgui_headless_stats(HGUI_HeadlessStats* stats) {
+	if (!stats) return;
+	HGUI_HeadlessThread* self = headless_self();
+	headless_lock(&self->lock);
+	*stats = self->stats;
+	headless_unlock(&self->lock);
+}
+
+// 清空调用线程的消息队列、定时器与事件计数（存活对象的计数保持不变）
+static inline void hgui_headless_reset(void) {
+	HGUI_HeadlessThread* self = headless_self();
+	headless_lock(&self->lock);
+	self->queue_head = 0;
+	self->queue_count = 0;
+	HGUI_HeadlessStats alive = self->stats;
+	memset(&self->stats, 0, sizeof(HGUI_HeadlessStats));
+	self->stats.windows_alive = alive.windows_alive;
+	self->stats.menus_alive = alive.menus_alive;
+	self->stats.menu_items = alive.menu_items;
+	self->stats.fonts_alive = alive.fonts_alive;
+	self->stats.accel_tables_alive = alive.accel_tables_alive;
+	headless_unlock(&self->lock);
+	self->timer_count = 0;
+}
+
+// 向控件的父窗口发送通知（与真实控件一样同步发送WM_COMMAND）
+static inline void hgui_headless_notify(HWND hwnd, WORD code) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window || !window->parent) return;
+	SendMessage(window->parent, WM_COMMAND, MAKEWPARAM(0, code), (LPARAM)hwnd);
+}
+
+// 声明其他线程中尚未投递回来的工作（开始时delta为1，投递后为-1）。
+// 计数不为0时消息循环会继续等待，而不是在队列为空时结束
+static inline void hgui_headless_pending(int delta) {
+	__atomic_add_fetch(&headless_pending_work, delta, __ATOMIC_ACQ_REL);
+}
+
+// 模拟点击按钮、单选框或复选框
+static inline void hgui_headless_click(HWND hwnd) {
+	hgui_headless_notify(hwnd, BN_CLICKED);
+}
+
+// 模拟在输入框中输入文本
+static inline void hgui_headless_type(HWND hwnd, const char* text) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return;
+	headless_default_proc(window, WM_SETTEXT, 0, (LPARAM)text);
+	hgui_headless_notify(hwnd, EN_CHANGE);
+}
+
+// 模拟在列表框中选择一行（double_click为true时再发送双击通知）
+static inline void hgui_headless_select(HWND hwnd, int index, bool double_click) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return;
+	headless_default_proc(window, LB_SETCURSEL, (WPARAM)index, 0);
+	hgui_headless_notify(hwnd, LBN_SELCHANGE);
+	if (double_click) hgui_headless_notify(hwnd, LBN_DBLCLK);
+}
+
+// 模拟输入框或列表框获得/失去焦点
+static inline void hgui_headless_focus(HWND hwnd, bool focused) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window) return;
+	if (headless_is_class(window, "EDIT")) {
+		hgui_headless_notify(hwnd, focused ? EN_SETFOCUS : EN_KILLFOCUS);
+	} else if (headless_is_class(window, "LISTBOX")) {
+		hgui_headless_notify(hwnd, focused ? LBN_SETFOCUS : LBN_KILLFOCUS);
+	}
+}
+
+// 模拟选择菜单项
+static inline void hgui_headless_menu_command(HWND hwnd, UINT_PTR menu_id) {
+	SendMessage(hwnd, WM_COMMAND, MAKEWPARAM(menu_id, 0), 0);
+}
+
+// 模拟按键：设置修饰键状态（FCONTROL|FSHIFT|FALT）并向hwnd投递按下消息（含Alt时为WM_SYSKEYDOWN）。
+// 修饰键状态保持到下一次调用，由消息循环中的TranslateAccelerator读取
+static inline void hgui_headless_key(HWND hwnd, WORD key, BYTE modifiers) {
+	headless_self()->modifiers = modifiers;
+	PostMessage(hwnd, (modifiers & FALT) ? WM_SYSKEYDOWN : WM_KEYDOWN, (WPARAM)key, 0);
+}
+
+// 读取窗口客户区中经SetDIBitsToDevice写入的像素（未写入过为0）
+static inline uint32_t hgui_headless_pixel(HWND hwnd, int x, int y) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window || !window->screen || x < 0 || y < 0 || x >= window->screen_width || y >= window->screen_height) return 0;
+	return window->screen[(size_t)y * (size_t)window->screen_width + (size_t)x];
+}
+
+// 模拟绘制自绘列表框的可见行（向父窗口发送WM_DRAWITEM），返回绘制的行数
+static inline int hgui_headless_paint(HWND hwnd) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	if (!window || !(window->style & LBS_OWNERDRAWFIXED) || !window->parent || window->item_height <= 0) return 0;
+
+	int height = window->rect.bottom - window->rect.top;
+	int last = window->top_index + (height + window->item_height - 1) / window->item_height;
+	if (last > window->item_count) last = window->item_count;
+
+	int painted = 0;
+	for (int index = window->top_index; index < last; index++) {
+		DRAWITEMSTRUCT dis;
+		memset(&dis, 0, sizeof(dis));
+		dis.CtlType = ODT_LISTBOX;
+		dis.itemID = (UINT)index;
+		dis.itemState = index == window->cursel ? ODS_SELECTED : 0;
+		dis.hwndItem = hwnd;
+		dis.rcItem.right = window->rect.right - window->rect.left;
+		dis.rcItem.top = (index - window->top_index) * window->item_height;
+		dis.rcItem.bottom = dis.rcItem.top + window->item_height;
+		SendMessage(window->parent, WM_DRAWITEM, 0, (LPARAM)&dis);
+		if (!headless_window(hwnd)) break;
+		painted++;
+	}
+	return painted;
+}
+
+// 查询窗口是否可见
+static inline bool hgui_headless_visible(HWND hwnd) {
+	HGUI_HeadlessWindow* window = headless_window(hwnd);
+	return window && window->visible;
+}
+
+// 查询窗口或菜单句柄是否仍然有效
+static inline bool hgui_headless_alive(const void* handle) {
+	return headless_handle_get(handle, HGUI_HEADLESS_WINDOW) || headless_handle_get(handle, HGUI_HEADLESS_MENU);
+}
+
+// 查询菜单项数量
+static inline int hgui_headless_menu_item_count(HMENU handle) {
+	HGUI_HeadlessMenu* menu = (HGUI_HeadlessMenu*)headless_handle_get(handle, HGUI_HEADLESS_MENU);
+	return menu ? menu->item_count : -1;
+}
+
+// 查询菜单项的文本（分隔线为NULL）
+static inline const char* hgui_headless_menu_item_text(HMENU handle, int index) {
+	HGUI_HeadlessMenu* menu = (HGUI_HeadlessMenu*)headless_handle_get(handle, HGUI_HEADLESS_MENU);
+	if (!menu || index < 0 || index >= menu->item_count) return NULL;
+	return menu->items[index].text;
+}
+
+#endif // HGUI_HEADLESS_H
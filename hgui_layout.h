@@ -0,0 +1,565 @@
+#ifndef HGUI_LAYOUT_H
+#define HGUI_LAYOUT_H
+
+// HGUI 布局引擎：弹性（行/列）与网格布局的求解器。
+// 本文件不依赖Windows API，可以在任意平台上测试与基准测量。
+//
+// 节点组成一棵树，每个节点有一份样式。求解分两遍，都只访问需要重算的部分：
+//   测量  自底向上计算首选尺寸并缓存；样式或子节点变化只使该节点及其祖先的缓存失效
+//   排布  自顶向下分配位置与尺寸；分配结果与上次相同且子树内没有变化的节点整棵跳过，
+//         只是位置平移的子树直接偏移坐标
+// 坐标相对于根节点所在的坐标系。结果变化的节点记入变化列表，由调用方统一应用。
+// 两遍都用显式栈遍历，树的深度不受调用栈限制。
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HGUI_LAYOUT_AUTO (-1)      // 尺寸由内容决定（容器为子节点所需的尺寸，叶子为0）
+
+// 排列方式
+typedef enum {
+	HGUI_LAYOUT_LEAF,           // 不排列子节点
+	HGUI_LAYOUT_ROW,            // 子节点从左到右排列
+	HGUI_LAYOUT_COLUMN,         // 子节点从上到下排列
+	HGUI_LAYOUT_GRID            // 等宽列的网格，按顺序逐行填入，行高取该行最高的子节点
+} HGUI_LayoutKind;
+
+// 交叉轴对齐（网格为单元格内两个方向的对齐）
+typedef enum {
+	HGUI_ALIGN_STRETCH,         // 拉伸到可用尺寸（子节点在该方向上的尺寸为AUTO时）
+	HGUI_ALIGN_START,
+	HGUI_ALIGN_CENTER,
+	HGUI_ALIGN_END
+} HGUI_LayoutAlign;
+
+// 主轴分布（没有grow的子节点吸收剩余空间时生效）
+typedef enum {
+	HGUI_JUSTIFY_START,
+	HGUI_JUSTIFY_CENTER,
+	HGUI_JUSTIFY_END,
+	HGUI_JUSTIFY_SPACE_BETWEEN
+} HGUI_LayoutJustify;
+
+// 样式（全零为：尺寸为0、不伸缩的叶子）
+typedef struct {
+	HGUI_LayoutKind kind;
+	int width;                  // 首选尺寸，HGUI_LAYOUT_AUTO表示由内容决定
+	int height;
+	int min_width;
+	int min_height;
+	int max_width;              // 0表示不限
+	int max_height;
+	float grow;                 // 按比例分得主轴上的剩余空间
+	float shrink;               // 主轴空间不足时按 shrink*首选尺寸 的比例收缩
+	int margin;                 // 外边距（四边相同）
+	int padding;                // 内边距（四边相同）
+	int gap;                    // 相邻子节点的间距（网格为行列间距）
+	HGUI_LayoutAlign align;     // 子节点的交叉轴对齐
+	HGUI_LayoutJustify justify; // 子节点的主轴分布
+	int columns;                // 网格列数（0按1处理）
+} HGUI_LayoutStyle;
+
+// 节点ID：节点槽位+1，0表示无
+typedef unsigned int HGUI_LayoutId;
+#define HGUI_LAYOUT_NO_NODE 0u
+
+typedef struct {
+	HGUI_LayoutStyle style;
+	void* user_data;
+
+	// 树（子节点按添加顺序排列）；空闲节点经next_sibling相连
+	HGUI_LayoutId parent;
+	HGUI_LayoutId first_child;
+	HGUI_LayoutId last_child;
+	HGUI_LayoutId next_sibling;
+	HGUI_LayoutId prev_sibling;
+
+	int measured_width;         // 缓存的首选尺寸（含内边距，不含外边距）
+	int measured_height;
+	int x;                      // 排布结果（不含外边距）
+	int y;
+	int width;
+	int height;
+
+	bool alive;
+	bool measure_valid;         // 首选尺寸缓存有效；无效时祖先也都无效
+	bool layout_valid;          // 子节点已按当前结果排布且子树内没有变化；无效时祖先也都无效
+	bool changed;               // 结果变化后尚未被取走
+} HGUI_LayoutNode;
+
+// 计数器（用于观察增量布局的效果）
+typedef struct {
+	unsigned long measured;     // 重新测量的节点数
+	unsigned long laid_out;     // 重新排布子节点的节点数
+	unsigned long skipped;      // 整棵跳过的子树数
+	unsigned long translated;   // 只平移坐标的子树数
+	unsigned long changed;      // 结果发生变化的节点数
+} HGUI_LayoutStats;
+
+// 布局树（全零初始化即可使用）
+typedef struct {
+	HGUI_LayoutNode* nodes;
+	unsigned int count;             // 已使用过的槽位数
+	unsigned int capacity;
+	HGUI_LayoutId free_head;
+
+	unsigned int* stack;            // 遍历用的显式栈
+	unsigned int stack_capacity;
+
+	HGUI_LayoutId* changed;         // 结果变化的节点（可能含已删除或重复的项，取走时过滤）
+	unsigned int changed_count;
+	unsigned int changed_capacity;
+
+	HGUI_LayoutStats stats;
+} HGUI_Layout;
+
+static inline HGUI_LayoutNode* hgui_layout_node(const HGUI_Layout* layout, HGUI_LayoutId id) {
+	return &layout->nodes[id - 1];
+}
+
+static inline void hgui_layout_init(HGUI_Layout* layout) {
+	memset(layout, 0, sizeof(HGUI_Layout));
+}
+
+static inline void hgui_layout_destroy(HGUI_Layout* layout) {
+	free(layout->nodes);
+	free(layout->stack);
+	free(layout->changed);
+	memset(layout, 0, sizeof(HGUI_Layout));
+}
+
+// 辅助函数：压栈（容量不足时扩容）
+static inline bool layout_push(HGUI_Layout* layout, unsigned int* top, unsigned int value) {
+	if (*top == layout->stack_capacity) {
+		unsigned int capacity = layout->stack_capacity ? layout->stack_capacity * 2 : 64;
+		unsigned int* stack = (unsigned int*)realloc(layout->stack, capacity * sizeof(unsigned int));
+		if (!stack) return false;
+		layout->stack = stack;
+		layout->stack_capacity = capacity;
+	}
+	layout->stack[(*top)++] = value;
+	return true;
+}
+
+// 辅助函数：先序遍历中root子树内的下一个节点
+static inline HGUI_LayoutId layout_next_preorder(const HGUI_Layout* layout, HGUI_LayoutId id, HGUI_LayoutId root) {
+	const HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+	if (node->first_child) return node->first_child;
+	while (id != root) {
+		node = hgui_layout_node(layout, id);
+		if (node->next_sibling) return node->next_sibling;
+		id = node->parent;
+	}
+	return HGUI_LAYOUT_NO_NODE;
+}
+
+// 使节点及其祖先的测量与排布缓存失效（遇到已失效的祖先即停止）
+static inline void hgui_layout_invalidate(HGUI_Layout* layout, HGUI_LayoutId id) {
+	while (id) {
+		HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+		if (!node->measure_valid && !node->layout_valid) break;
+		node->measure_valid = false;
+		node->layout_valid = false;
+		id = node->parent;
+	}
+}
+
+// 添加节点到parent的子节点末尾（parent为HGUI_LAYOUT_NO_NODE时为新的根），失败返回HGUI_LAYOUT_NO_NODE
+static inline HGUI_LayoutId hgui_layout_add(HGUI_Layout* layout, HGUI_LayoutId parent, const HGUI_LayoutStyle* style, void* user_data) {
+	HGUI_LayoutId id = layout->free_head;
+	if (id) {
+		layout->free_head = hgui_layout_node(layout, id)->next_sibling;
+	} else {
+		if (layout->count == layout->capacity) {
+			unsigned int capacity = layout->capacity ? layout->capacity * 2 : 64;
+			HGUI_LayoutNode* nodes = (HGUI_LayoutNode*)realloc(layout->nodes, capacity * sizeof(HGUI_LayoutNode));
+			if (!nodes) return HGUI_LAYOUT_NO_NODE;
+			layout->nodes = nodes;
+			layout->capacity = capacity;
+		}
+		id = ++layout->count;
+	}
+
+	HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+	memset(node, 0, sizeof(HGUI_LayoutNode));
+	if (style) node->style = *style;
+	node->user_data = user_data;
+	node->alive = true;
+	// 尚未排布过：保证第一次排布的结果总被视为变化
+	node->width = -1;
+	node->height = -1;
+
+	node->parent = parent;
+	if (parent) {
+		HGUI_LayoutNode* parent_node = hgui_layout_node(layout, parent);
+		node->prev_sibling = parent_node->last_child;
+		if (parent_node->last_child) hgui_layout_node(layout, parent_node->last_child)->next_sibling = id;
+		else parent_node->first_child = id;
+		parent_node->last_child = id;
+		hgui_layout_invalidate(layout, parent);
+	}
+	return id;
+}
+
+// 删除节点及其整棵子树
+static inline void hgui_layout_remove(HGUI_Layout* layout, HGUI_LayoutId id) {
+	HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+	if (node->parent) {
+		HGUI_LayoutNode* parent = hgui_layout_node(layout, node->parent);
+		if (node->prev_sibling) hgui_layout_node(layout, node->prev_sibling)->next_sibling = node->next_sibling;
+		else parent->first_child = node->next_sibling;
+		if (node->next_sibling) hgui_layout_node(layout, node->next_sibling)->prev_sibling = node->prev_sibling;
+		else parent->last_child = node->prev_sibling;
+		hgui_layout_invalidate(layout, node->parent);
+	}
+
+	// 子树已摘下，从最左的叶子开始逐个释放
+	HGUI_LayoutId current = id;
+	while (current) {
+		HGUI_LayoutNode* victim = hgui_layout_node(layout, current);
+		if (victim->first_child) {
+			current = victim->first_child;
+			continue;
+		}
+
+		HGUI_LayoutId next = current == id ? HGUI_LAYOUT_NO_NODE : victim->parent;
+		if (next) {
+			HGUI_LayoutNode* parent = hgui_layout_node(layout, next);
+			parent->first_child = victim->next_sibling;
+			if (victim->next_sibling) next = victim->next_sibling;
+		}
+		victim->alive = false;
+		victim->changed = false;
+		victim->next_sibling = layout->free_head;
+		layout->free_head = current;
+		current = next;
+	}
+}
+
+// 替换节点的样式
+static inline void hgui_layout_set_style(HGUI_Layout* layout, HGUI_LayoutId id, const HGUI_LayoutStyle* style) {
+	hgui_layout_node(layout, id)->style = *style;
+	hgui_layout_invalidate(layout, id);
+}
+
+// 辅助函数：按最小/最大值约束尺寸（二者冲突时最小值优先）
+static inline int layout_clamp(int value, int min, int max) {
+	if (max > 0 && value > max) value = max;
+	if (value < min) value = min;
+	return value < 0 ? 0 : value;
+}
+
+// 辅助函数：根据子节点的缓存计算节点的首选尺寸
+static inline void layout_measure_node(HGUI_Layout* layout, HGUI_LayoutNode* node) {
+	const HGUI_LayoutStyle* style = &node->style;
+	int content_width = 0;
+	int content_height = 0;
+
+	if (style->kind == HGUI_LAYOUT_ROW || style->kind == HGUI_LAYOUT_COLUMN) {
+		bool row = style->kind == HGUI_LAYOUT_ROW;
+		int main = 0;
+		int cross = 0;
+		int count = 0;
+		for (HGUI_LayoutId c = node->first_child; c; c = hgui_layout_node(layout, c)->next_sibling) {
+			const HGUI_LayoutNode* child = hgui_layout_node(layout, c);
+			int outer_width = child->measured_width + 2 * child->style.margin;
+			int outer_height = child->measured_height + 2 * child->style.margin;
+			main += row ? outer_width : outer_height;
+			int child_cross = row ? outer_height : outer_width;
+			if (child_cross > cross) cross = child_cross;
+			count++;
+		}
+		if (count > 1) main += style->gap * (count - 1);
+		content_width = row ? main : cross;
+		content_height = row ? cross : main;
+	}
+	else if (style->kind == HGUI_LAYOUT_GRID) {
+		int columns = style->columns > 0 ? style->columns : 1;
+		int column_width = 0;
+		int row_height = 0;
+		int rows = 0;
+		int index = 0;
+		for (HGUI_LayoutId c = node->first_child; c; c = hgui_layout_node(layout, c)->next_sibling) {
+			const HGUI_LayoutNode* child = hgui_layout_node(layout, c);
+			int outer_width = child->measured_width + 2 * child->style.margin;
+			int outer_height = child->measured_height + 2 * child->style.margin;
+			if (outer_width > column_width) column_width = outer_width;
+			if (outer_height > row_height) row_height = outer_height;
+			if (++index % columns == 0) {
+				content_height += row_height;
+				row_height = 0;
+				rows++;
+			}
+		}
+		if (index % columns != 0) {
+			content_height += row_height;
+			rows++;
+		}
+		int used_columns = index < columns ? index : columns;
+		if (used_columns > 0) content_width = column_width * used_columns + style->gap * (used_columns - 1);
+		if (rows > 1) content_height += style->gap * (rows - 1);
+	}
+
+	bool leaf = style->kind == HGUI_LAYOUT_LEAF;
+	int width = style->width != HGUI_LAYOUT_AUTO ? style->width : leaf ? 0 : content_width + 2 * style->padding;
+	int height = style->height != HGUI_LAYOUT_AUTO ? style->height : leaf ? 0 : content_height + 2 * style->padding;
+	node->measured_width = layout_clamp(width, style->min_width, style->max_width);
+	node->measured_height = layout_clamp(height, style->min_height, style->max_height);
+}
+
+// 辅助函数：测量root子树中缓存失效的节点（后序：子节点先于父节点）。
+// 栈中的值为 节点ID*2+是否已展开
+static inline bool layout_measure(HGUI_Layout* layout, HGUI_LayoutId root) {
+	unsigned int top = 0;
+	if (hgui_layout_node(layout, root)->measure_valid) return true;
+	if (!layout_push(layout, &top, root << 1)) return false;
+
+	while (top > 0) {
+		unsigned int entry = layout->stack[--top];
+		HGUI_LayoutId id = entry >> 1;
+		HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+		if (entry & 1) {
+			layout_measure_node(layout, node);
+			node->measure_valid = true;
+			layout->stats.measured++;
+			continue;
+		}
+
+		if (!layout_push(layout, &top, entry | 1)) return false;
+		for (HGUI_LayoutId c = node->first_child; c; c = hgui_layout_node(layout, c)->next_sibling) {
+			if (!hgui_layout_node(layout, c)->measure_valid && !layout_push(layout, &top, c << 1)) return false;
+		}
+	}
+	return true;
+}
+
+// 辅助函数：记录结果变化的节点
+static inline void layout_mark_changed(HGUI_Layout* layout, HGUI_LayoutId id) {
+	HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+	layout->stats.changed++;
+	if (node->changed) return;
+
+	if (layout->changed_count == layout->changed_capacity) {
+		unsigned int capacity = layout->changed_capacity ? layout->changed_capacity * 2 : 64;
+		HGUI_LayoutId* changed = (HGUI_LayoutId*)realloc(layout->changed, capacity * sizeof(HGUI_LayoutId));
+		if (!changed) return;
+		layout->changed = changed;
+		layout->changed_capacity = capacity;
+	}
+	layout->changed[layout->changed_count++] = id;
+	node->changed = true;
+}
+
+// 辅助函数：给节点分配结果。结果不变且子树有效时整棵跳过，只是平移时偏移整棵子树；
+// 否则记录结果，有子节点的节点压栈等待排布子节点
+static inline bool layout_place(HGUI_Layout* layout, unsigned int* top, HGUI_LayoutId id, int x, int y, int width, int height) {
+	HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+	if (width < 0) width = 0;
+	if (height < 0) height = 0;
+	bool same_size = node->width == width && node->height == height;
+	bool same_position = node->x == x && node->y == y;
+
+	if (node->layout_valid && same_size) {
+		if (same_position) {
+			layout->stats.skipped++;
+			return true;
+		}
+
+		int dx = x - node->x;
+		int dy = y - node->y;
+		for (HGUI_LayoutId d = id; d; d = layout_next_preorder(layout, d, id)) {
+			HGUI_LayoutNode* descendant = hgui_layout_node(layout, d);
+			descendant->x += dx;
+			descendant->y += dy;
+			layout_mark_changed(layout, d);
+		}
+		layout->stats.translated++;
+		return true;
+	}
+
+	node->x = x;
+	node->y = y;
+	node->width = width;
+	node->height = height;
+	if (!same_size || !same_position) layout_mark_changed(layout, id);
+
+	if (!node->first_child) {
+		node->layout_valid = true;
+		return true;
+	}
+	return layout_push(layout, top, id);
+}
+
+// 辅助函数：计算子节点在一个方向上的尺寸与偏移（可用尺寸内按对齐方式放置）
+static inline void layout_align(HGUI_LayoutAlign align, bool fixed, int measured, int available, int min, int max, int* size, int* offset) {
+	if (align == HGUI_ALIGN_STRETCH && !fixed) {
+		*size = layout_clamp(available, min, max);
+	} else {
+		*size = measured;
+	}
+
+	switch (align) {
+		case HGUI_ALIGN_CENTER: *offset = (available - *size) / 2; break;
+		case HGUI_ALIGN_END: *offset = available - *size; break;
+		default: *offset = 0; break;
+	}
+}
+
+// 辅助函数：行/列排布。先按首选尺寸排列，剩余空间按grow比例分配，不足时按shrink*首选尺寸的比例收缩；
+// 分配后受最小/最大值约束的部分不再重新分配
+static inline bool layout_flex(HGUI_Layout* layout, unsigned int* top, const HGUI_LayoutNode* node, bool row) {
+	const HGUI_LayoutStyle* style = &node->style;
+	int inner_x = node->x + style->padding;
+	int inner_y = node->y + style->padding;
+	int main_size = (row ? node->width : node->height) - 2 * style->padding;
+	int cross_size = (row ? node->height : node->width) - 2 * style->padding;
+
+	int count = 0;
+	long long used = 0;
+	double total_grow = 0;
+	double total_shrink = 0;
+	for (HGUI_LayoutId c = node->first_child; c; c = hgui_layout_node(layout, c)->next_sibling) {
+		const HGUI_LayoutNode* child = hgui_layout_node(layout, c);
+		int basis = row ? child->measured_width : child->measured_height;
+		used += basis + 2 * child->style.margin;
+		if (child->style.grow > 0) total_grow += child->style.grow;
+		if (child->style.shrink > 0) total_shrink += child->style.shrink * basis;
+		count++;
+	}
+	used += (long long)style->gap * (count - 1);
+
+	long long free_space = main_size - used;
+	bool growing = free_space > 0 && total_grow > 0;
+	bool shrinking = free_space < 0 && total_shrink > 0;
+
+	// 剩余空间没有被grow吸收时按justify分布
+	int position = 0;
+	int extra_gap = 0;
+	if (free_space > 0 && !growing) {
+		switch (style->justify) {
+			case HGUI_JUSTIFY_CENTER: position = (int)(free_space / 2); break;
+			case HGUI_JUSTIFY_END: position = (int)free_space; break;
+			case HGUI_JUSTIFY_SPACE_BETWEEN: extra_gap = count > 1 ? (int)(free_space / (count - 1)) : 0; break;
+			default: break;
+		}
+	}
+
+	// 按累计比例取整，分配总量精确等于剩余空间
+	double accumulated = 0;
+	long long distributed = 0;
+	for (HGUI_LayoutId c = node->first_child; c; c = hgui_layout_node(layout, c)->next_sibling) {
+		const HGUI_LayoutNode* child = hgui_layout_node(layout, c);
+		const HGUI_LayoutStyle* child_style = &child->style;
+		int basis = row ? child->measured_width : child->measured_height;
+		long long size = basis;
+		if (growing && child_style->grow > 0) {
+			accumulated += child_style->grow;
+			long long target = (long long)(free_space * accumulated / total_grow);
+			size += target - distributed;
+			distributed = target;
+		} else if (shrinking && child_style->shrink > 0) {
+			accumulated += child_style->shrink * basis;
+			long long target = (long long)(-free_space * accumulated / total_shrink);
+			size -= target - distributed;
+			distributed = target;
+		}
+		int main = layout_clamp((int)size, row ? child_style->min_width : child_style->min_height,
+			row ? child_style->max_width : child_style->max_height);
+
+		int cross, offset;
+		bool fixed = (row ? child_style->height : child_style->width) != HGUI_LAYOUT_AUTO;
+		layout_align(style->align, fixed, row ? child->measured_height : child->measured_width, cross_size - 2 * child_style->margin,
+			row ? child_style->min_height : child_style->min_width, row ? child_style->max_height : child_style->max_width,
+			&cross, &offset);
+
+		int main_position = (row ? inner_x : inner_y) + position + child_style->margin;
+		int cross_position = (row ? inner_y : inner_x) + child_style->margin + offset;
+		bool ok = row ? layout_place(layout, top, c, main_position, cross_position, main, cross)
+			: layout_place(layout, top, c, cross_position, main_position, cross, main);
+		if (!ok) return false;
+		position += main + 2 * child_style->margin + style->gap + extra_gap;
+	}
+	return true;
+}
+
+// 辅助函数：网格排布。列宽均分（余数分给前面的列），行高取该行子节点的最大外尺寸
+static inline bool layout_grid(HGUI_Layout* layout, unsigned int* top, const HGUI_LayoutNode* node) {
+	const HGUI_LayoutStyle* style = &node->style;
+	int columns = style->columns > 0 ? style->columns : 1;
+	int inner_width = node->width - 2 * style->padding - style->gap * (columns - 1);
+	if (inner_width < 0) inner_width = 0;
+	int column_width = inner_width / columns;
+	int remainder = inner_width % columns;
+
+	int y = node->y + style->padding;
+	HGUI_LayoutId row_start = node->first_child;
+	while (row_start) {
+		int row_height = 0;
+		HGUI_LayoutId c = row_start;
+		for (int column = 0; column < columns && c; column++, c = hgui_layout_node(layout, c)->next_sibling) {
+			const HGUI_LayoutNode* child = hgui_layout_node(layout, c);
+			int outer_height = child->measured_height + 2 * child->style.margin;
+			if (outer_height > row_height) row_height = outer_height;
+		}
+
+		int x = node->x + style->padding;
+		c = row_start;
+		for (int column = 0; column < columns && c; column++, c = hgui_layout_node(layout, c)->next_sibling) {
+			const HGUI_LayoutNode* child = hgui_layout_node(layout, c);
+			const HGUI_LayoutStyle* child_style = &child->style;
+			int cell_width = column_width + (column < remainder ? 1 : 0);
+
+			int width, height, offset_x, offset_y;
+			layout_align(style->align, child_style->width != HGUI_LAYOUT_AUTO, child->measured_width, cell_width - 2 * child_style->margin,
+				child_style->min_width, child_style->max_width, &width, &offset_x);
+			layout_align(style->align, child_style->height != HGUI_LAYOUT_AUTO, child->measured_height, row_height - 2 * child_style->margin,
+				child_style->min_height, child_style->max_height, &height, &offset_y);
+			if (!layout_place(layout, top, c, x + child_style->margin + offset_x, y + child_style->margin + offset_y, width, height)) return false;
+			x += cell_width + style->gap;
+		}
+		row_start = c;
+		y += row_height + style->gap;
+	}
+	return true;
+}
+
+// 把root排布到给定的矩形中。只重算失效的部分；内存不足时返回false（已完成的部分保持有效）
+static inline bool hgui_layout_compute(HGUI_Layout* layout, HGUI_LayoutId root, int x, int y, int width, int height) {
+	if (!layout_measure(layout, root)) return false;
+
+	unsigned int top = 0;
+	if (!layout_place(layout, &top, root, x, y, width, height)) return false;
+	while (top > 0) {
+		HGUI_LayoutId id = layout->stack[--top];
+		HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+		bool ok = true;
+		switch (node->style.kind) {
+			case HGUI_LAYOUT_ROW: ok = layout_flex(layout, &top, node, true); break;
+			case HGUI_LAYOUT_COLUMN: ok = layout_flex(layout, &top, node, false); break;
+			case HGUI_LAYOUT_GRID: ok = layout_grid(layout, &top, node); break;
+			default: break;     // 叶子的子节点不参与排布
+		}
+		if (!ok) return false;
+		node->layout_valid = true;
+		layout->stats.laid_out++;
+	}
+	return true;
+}
+
+// 取走变化列表：对每个结果变化的存活节点调用一次apply，返回调用次数
+static inline unsigned int hgui_layout_take_changed(HGUI_Layout* layout, void (*apply)(const HGUI_LayoutNode* node, void* context), void* context) {
+	unsigned int applied = 0;
+	for (unsigned int i = 0; i < layout->changed_count; i++) {
+		HGUI_LayoutNode* node = hgui_layout_node(layout, layout->changed[i]);
+		if (!node->alive || !node->changed) continue;
+		node->changed = false;
+		if (apply) apply(node, context);
+		applied++;
+	}
+	layout->changed_count = 0;
+	return applied;
+}
+
+#endif // HGUI_LAYOUT_H
@@ -0,0 +1,466 @@
+#ifndef HGUI_RASTER_H
+#define HGUI_RASTER_H
+
+// HGUI 光栅核心：32位帧缓冲上的填充、直线、alpha混合、图像复制，以及脏矩形跟踪。
+// 本文件不依赖Windows API，可以在任意平台上测试与基准测量。
+//
+// 像素格式为 0xAARRGGBB（内存中依次为B、G、R、A，与32位DIB相同）。帧缓冲视为不透明：
+// 混合写入的像素alpha恒为255。混合公式为 dst = (src*a + dst*(255-a)) / 255（四舍五入），
+// a=255时结果等于src，a=0时结果等于dst。
+//
+// 编译器启用SSE2或AVX2时（__SSE2__/__AVX2__，MSVC的x64或/arch:AVX2）使用对应的向量内核，
+// 否则使用标量内核；定义 HGUI_RASTER_SCALAR 可强制使用标量内核。向量内核与标量内核逐像素结果相同。
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef HGUI_RASTER_SCALAR
+#if defined(__AVX2__)
+#define HGUI_RASTER_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HGUI_RASTER_SSE2 1
+#endif
+#endif
+
+#if defined(HGUI_RASTER_AVX2)
+#include <immintrin.h>
+#elif defined(HGUI_RASTER_SSE2)
+#include <emmintrin.h>
+#endif
+
+#define HGUI_ARGB(a, r, g, b) ((uint32_t)(((uint32_t)(a) << 24) | ((uint32_t)(r) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(b)))
+#define HGUI_RGB(r, g, b) HGUI_ARGB(255, r, g, b)
+
+// 矩形（右、下边界不含）
+typedef struct {
+	int left;
+	int top;
+	int right;
+	int bottom;
+} HGUI_RasterRect;
+
+// 帧缓冲
+typedef struct {
+	uint32_t* pixels;
+	int width;
+	int height;
+	int stride;                 // 每行的像素数
+	bool owns_pixels;           // 像素由本表面分配（hgui_surface_free时释放）
+} HGUI_Surface;
+
+// 脏矩形列表：相交或可无损合并的矩形合并；列表已满时并入使面积增长最少的矩形
+#define HGUI_RASTER_MAX_DIRTY 8
+
+typedef struct {
+	HGUI_RasterRect rects[HGUI_RASTER_MAX_DIRTY];
+	int count;
+} HGUI_DirtyRects;
+
+// 矩形工具
+static inline HGUI_RasterRect hgui_rect_make(int x, int y, int width, int height) {
+	HGUI_RasterRect rect = { x, y, x + width, y + height };
+	return rect;
+}
+
+static inline bool hgui_rect_empty(HGUI_RasterRect rect) {
+	return rect.left >= rect.right || rect.top >= rect.bottom;
+}
+
+static inline HGUI_RasterRect hgui_rect_union(HGUI_RasterRect a, HGUI_RasterRect b) {
+	if (hgui_rect_empty(a)) return b;
+	if (hgui_rect_empty(b)) return a;
+	HGUI_RasterRect rect = {
+		a.left < b.left ? a.left : b.left,
+		a.top < b.top ? a.top : b.top,
+		a.right > b.right ? a.right : b.right,
+		a.bottom > b.bottom ? a.bottom : b.bottom
+	};
+	return rect;
+}
+
+static inline HGUI_RasterRect hgui_rect_intersect(HGUI_RasterRect a, HGUI_RasterRect b) {
+	HGUI_RasterRect rect = {
+		a.left > b.left ? a.left : b.left,
+		a.top > b.top ? a.top : b.top,
+		a.right < b.right ? a.right : b.right,
+		a.bottom < b.bottom ? a.bottom : b.bottom
+	};
+	return rect;
+}
+
+// 辅助函数：矩形面积（空矩形为0）
+static inline long long raster_area(HGUI_RasterRect rect) {
+	if (hgui_rect_empty(rect)) return 0;
+	return (long long)(rect.right - rect.left) * (rect.bottom - rect.top);
+}
+
+// 辅助函数：判断两个矩形应当合并：相交（否则重叠部分会被重复传输），
+// 或者合并后的外接矩形不多覆盖任何像素（例如同高的左右相邻矩形）
+static inline bool raster_should_merge(HGUI_RasterRect a, HGUI_RasterRect b) {
+	if (!hgui_rect_empty(hgui_rect_intersect(a, b))) return true;
+	return raster_area(hgui_rect_union(a, b)) == raster_area(a) + raster_area(b);
+}
+
+// 辅助函数：把矩形裁剪到表面范围内
+static inline HGUI_RasterRect raster_clip(const HGUI_Surface* surface, HGUI_RasterRect rect) {
+	HGUI_RasterRect bounds = { 0, 0, surface->width, surface->height };
+	return hgui_rect_intersect(rect, bounds);
+}
+
+// 脏矩形
+static inline void hgui_dirty_clear(HGUI_DirtyRects* dirty) {
+	dirty->count = 0;
+}
+
+static inline void hgui_dirty_add(HGUI_DirtyRects* dirty, HGUI_RasterRect rect) {
+	if (hgui_rect_empty(rect)) return;
+
+	for (;;) {
+		// 与已有矩形相交或可无损合并时合并；合并结果可能又与其他矩形相交，因此重新扫描
+		int merge = -1;
+		for (int i = 0; i < dirty->count; i++) {
+			if (raster_should_merge(dirty->rects[i], rect)) {
+				merge = i;
+				break;
+			}
+		}
+
+		if (merge < 0 && dirty->count == HGUI_RASTER_MAX_DIRTY) {
+			long long best = -1;
+			for (int i = 0; i < dirty->count; i++) {
+				long long growth = raster_area(hgui_rect_union(dirty->rects[i], rect)) - raster_area(dirty->rects[i]);
+				if (best < 0 || growth < best) {
+					best = growth;
+					merge = i;
+				}
+			}
+		}
+		if (merge < 0) break;
+
+		rect = hgui_rect_union(dirty->rects[merge], rect);
+		dirty->rects[merge] = dirty->rects[--dirty->count];
+	}
+	dirty->rects[dirty->count++] = rect;
+}
+
+static inline HGUI_RasterRect hgui_dirty_bounds(const HGUI_DirtyRects* dirty) {
+	HGUI_RasterRect bounds = { 0, 0, 0, 0 };
+	for (int i = 0; i < dirty->count; i++) {
+		bounds = hgui_rect_union(bounds, dirty->rects[i]);
+	}
+	return bounds;
+}
+
+// 表面
+static inline void hgui_surface_wrap(HGUI_Surface* surface, uint32_t* pixels, int width, int height, int stride) {
+	surface->pixels = pixels;
+	surface->width = width;
+	surface->height = height;
+	surface->stride = stride;
+	surface->owns_pixels = false;
+}
+
+static inline bool hgui_surface_init(HGUI_Surface* surface, int width, int height) {
+	memset(surface, 0, sizeof(HGUI_Surface));
+	if (width < 0 || height < 0) return false;
+	if (width == 0 || height == 0) return true;
+
+	surface->pixels = (uint32_t*)calloc((size_t)width * (size_t)height, sizeof(uint32_t));
+	if (!surface->pixels) return false;
+	surface->width = width;
+	surface->height = height;
+	surface->stride = width;
+	surface->owns_pixels = true;
+	return true;
+}
+
+static inline void hgui_surface_free(HGUI_Surface* surface) {
+	if (surface->owns_pixels) free(surface->pixels);
+	memset(surface, 0, sizeof(HGUI_Surface));
+}
+
+// 改变尺寸，保留与新尺寸重叠部分的内容，新露出的区域为0（透明黑）；失败时表面不变
+static inline bool hgui_surface_resize(HGUI_Surface* surface, int width, int height) {
+	if (width == surface->width && height == surface->height) return true;
+
+	HGUI_Surface resized;
+	if (!hgui_surface_init(&resized, width, height)) return false;
+
+	int copy_width = width < surface->width ? width : surface->width;
+	int copy_height = height < surface->height ? height : surface->height;
+	for (int y = 0; y < copy_height; y++) {
+		memcpy(resized.pixels + (size_t)y * resized.stride, surface->pixels + (size_t)y * surface->stride,
+			(size_t)copy_width * sizeof(uint32_t));
+	}
+
+	hgui_surface_free(surface);
+	*surface = resized;
+	return true;
+}
+
+static inline uint32_t* hgui_surface_row(const HGUI_Surface* surface, int y) {
+	return surface->pixels + (size_t)y * (size_t)surface->stride;
+}
+
+// 标量内核
+static inline uint32_t raster_blend_pixel(uint32_t dst, uint32_t src, uint32_t alpha) {
+	uint32_t inverse = 255 - alpha;
+	uint32_t result = 0xFF000000u;
+	for (int shift = 0; shift < 24; shift += 8) {
+		uint32_t t = ((src >> shift) & 0xFF) * alpha + ((dst >> shift) & 0xFF) * inverse + 128;
+		result |= ((t + (t >> 8)) >> 8) << shift;
+	}
+	return result;
+}
+
+static inline void raster_fill_span_scalar(uint32_t* dst, int count, uint32_t color) {
+	for (int i = 0; i < count; i++) dst[i] = color;
+}
+
+static inline void raster_blend_span_scalar(uint32_t* dst, int count, uint32_t color) {
+	uint32_t alpha = color >> 24;
+	for (int i = 0; i < count; i++) dst[i] = raster_blend_pixel(dst[i], color, alpha);
+}
+
+static inline void raster_blend_image_span_scalar(uint32_t* dst, const uint32_t* src, int count) {
+	for (int i = 0; i < count; i++) dst[i] = raster_blend_pixel(dst[i], src[i], src[i] >> 24);
+}
+
+// 向量内核：每个16位通道计算 t = src*a + dst*(255-a) + 128，结果为 (t + (t>>8)) >> 8，
+// 中间值不超过65407，无符号16位足够；与标量内核结果相同
+#if defined(HGUI_RASTER_SSE2) || defined(HGUI_RASTER_AVX2)
+static inline __m128i raster_blend4(__m128i dst, __m128i src, __m128i alpha_lo, __m128i alpha_hi) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi16(255);
+	const __m128i round = _mm_set1_epi16(128);
+
+	__m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), alpha_lo),
+		_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(full, alpha_lo))), round);
+	__m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), alpha_hi),
+		_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(full, alpha_hi))), round);
+	lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+	hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+	return _mm_or_si128(_mm_packus_epi16(lo, hi), _mm_set1_epi32((int)0xFF000000u));
+}
+
+// 辅助函数：把每个像素的alpha广播到该像素的4个16位通道
+static inline __m128i raster_alpha_lo(__m128i src) {
+	__m128i lo = _mm_unpacklo_epi8(src, _mm_setzero_si128());
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static inline __m128i raster_alpha_hi(__m128i src) {
+	__m128i hi = _mm_unpackhi_epi8(src, _mm_setzero_si128());
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+#endif
+
+#if defined(HGUI_RASTER_AVX2)
+static inline __m256i raster_blend8(__m256i dst, __m256i src, __m256i alpha_lo, __m256i alpha_hi) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i full = _mm256_set1_epi16(255);
+	const __m256i round = _mm256_set1_epi16(128);
+
+	__m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(src, zero), alpha_lo),
+		_mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), _mm256_sub_epi16(full, alpha_lo))), round);
+	__m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(src, zero), alpha_hi),
+		_mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), _mm256_sub_epi16(full, alpha_hi))), round);
+	lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+	hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+	return _mm256_or_si256(_mm256_packus_epi16(lo, hi), _mm256_set1_epi32((int)0xFF000000u));
+}
+
+static inline __m256i raster_alpha8_lo(__m256i src) {
+	__m256i lo = _mm256_unpacklo_epi8(src, _mm256_setzero_si256());
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static inline __m256i raster_alpha8_hi(__m256i src) {
+	__m256i hi = _mm256_unpackhi_epi8(src, _mm256_setzero_si256());
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+#endif
+
+// 按编译目标选择的行内核
+static inline void raster_fill_span(uint32_t* dst, int count, uint32_t color) {
+	int i = 0;
+#if defined(HGUI_RASTER_AVX2)
+	__m256i color8 = _mm256_set1_epi32((int)color);
+	for (; i + 8 <= count; i += 8) _mm256_storeu_si256((__m256i*)(dst + i), color8);
+#endif
+#if defined(HGUI_RASTER_SSE2) || defined(HGUI_RASTER_AVX2)
+	__m128i color4 = _mm_set1_epi32((int)color);
+	for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i*)(dst + i), color4);
+#endif
+	raster_fill_span_scalar(dst + i, count - i, color);
+}
+
+static inline void raster_blend_span(uint32_t* dst, int count, uint32_t color) {
+	int i = 0;
+#if defined(HGUI_RASTER_AVX2)
+	__m256i src8 = _mm256_set1_epi32((int)color);
+	__m256i alpha8 = _mm256_set1_epi16((short)(color >> 24));
+	for (; i + 8 <= count; i += 8) {
+		__m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), raster_blend8(d, src8, alpha8, alpha8));
+	}
+#endif
+#if defined(HGUI_RASTER_SSE2) || defined(HGUI_RASTER_AVX2)
+	__m128i src4 = _mm_set1_epi32((int)color);
+	__m128i alpha4 = _mm_set1_epi16((short)(color >> 24));
+	for (; i + 4 <= count; i += 4) {
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		_mm_storeu_si128((__m128i*)(dst + i), raster_blend4(d, src4, alpha4, alpha4));
+	}
+#endif
+	raster_blend_span_scalar(dst + i, count - i, color);
+}
+
+static inline void raster_blend_image_span(uint32_t* dst, const uint32_t* src, int count) {
+	int i = 0;
+#if defined(HGUI_RASTER_AVX2)
+	for (; i + 8 <= count; i += 8) {
+		__m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), raster_blend8(d, s, raster_alpha8_lo(s), raster_alpha8_hi(s)));
+	}
+#endif
+#if defined(HGUI_RASTER_SSE2) || defined(HGUI_RASTER_AVX2)
+	for (; i + 4 <= count; i += 4) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		_mm_storeu_si128((__m128i*)(dst + i), raster_blend4(d, s, raster_alpha_lo(s), raster_alpha_hi(s)));
+	}
+#endif
+	raster_blend_image_span_scalar(dst + i, src + i, count - i);
+}
+
+// 填充矩形（不透明写入，alpha原样保留），返回实际写入的区域
+static inline HGUI_RasterRect hgui_raster_fill(HGUI_Surface* surface, HGUI_RasterRect rect, uint32_t color) {
+	rect = raster_clip(surface, rect);
+	if (hgui_rect_empty(rect)) return rect;
+
+	int width = rect.right - rect.left;
+	for (int y = rect.top; y < rect.bottom; y++) {
+		raster_fill_span(hgui_surface_row(surface, y) + rect.left, width, color);
+	}
+	return rect;
+}
+
+// 以颜色自身的alpha混合到矩形上（alpha为255时等同于填充，为0时不写入），返回实际写入的区域
+static inline HGUI_RasterRect hgui_raster_blend(HGUI_Surface* surface, HGUI_RasterRect rect, uint32_t color) {
+	uint32_t alpha = color >> 24;
+	if (alpha == 255) return hgui_raster_fill(surface, rect, color);
+
+	rect = raster_clip(surface, rect);
+	if (alpha == 0 || hgui_rect_empty(rect)) {
+		HGUI_RasterRect none = { 0, 0, 0, 0 };
+		return none;
+	}
+
+	int width = rect.right - rect.left;
+	for (int y = rect.top; y < rect.bottom; y++) {
+		raster_blend_span(hgui_surface_row(surface, y) + rect.left, width, color);
+	}
+	return rect;
+}
+
+// 画1像素宽的直线（两端点都包含），颜色alpha小于255时混合；返回实际写入区域的外接矩形
+static inline HGUI_RasterRect hgui_raster_line(HGUI_Surface* surface, int x0, int y0, int x1, int y1, uint32_t color) {
+	// 水平线和竖直线按矩形处理，可以使用行内核
+	if (y0 == y1 || x0 == x1) {
+		HGUI_RasterRect rect = {
+			x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1,
+			(x0 > x1 ? x0 : x1) + 1, (y0 > y1 ? y0 : y1) + 1
+		};
+		return hgui_raster_blend(surface, rect, color);
+	}
+
+	HGUI_RasterRect touched = { 0, 0, 0, 0 };
+	HGUI_RasterRect box = {
+		x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1,
+		(x0 > x1 ? x0 : x1) + 1, (y0 > y1 ? y0 : y1) + 1
+	};
+	if (hgui_rect_empty(raster_clip(surface, box)) || (color >> 24) == 0) return touched;
+
+	// Bresenham：只写入落在表面内的像素
+	bool opaque = (color >> 24) == 255;
+	int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+	int dy = y1 > y0 ? y0 - y1 : y1 - y0;
+	int sx = x0 < x1 ? 1 : -1;
+	int sy = y0 < y1 ? 1 : -1;
+	int error = dx + dy;
+	for (;;) {
+		if (x0 >= 0 && y0 >= 0 && x0 < surface->width && y0 < surface->height) {
+			uint32_t* pixel = hgui_surface_row(surface, y0) + x0;
+			*pixel = opaque ? color : raster_blend_pixel(*pixel, color, color >> 24);
+			touched = hgui_rect_union(touched, hgui_rect_make(x0, y0, 1, 1));
+		}
+		if (x0 == x1 && y0 == y1) break;
+
+		int e2 = 2 * error;
+		if (e2 >= dy) {
+			error += dy;
+			x0 += sx;
+		}
+		if (e2 <= dx) {
+			error += dx;
+			y0 += sy;
+		}
+	}
+	return touched;
+}
+
+// 辅助函数：裁剪图像复制的源区域与目标位置，返回目标区域（源区域左上角同步移动）
+static inline HGUI_RasterRect raster_clip_copy(const HGUI_Surface* dst, int* x, int* y, const HGUI_Surface* src, HGUI_RasterRect* source) {
+	*source = raster_clip(src, *source);
+	HGUI_RasterRect target = hgui_rect_make(*x, *y, source->right - source->left, source->bottom - source->top);
+	HGUI_RasterRect clipped = raster_clip(dst, target);
+	if (hgui_rect_empty(*source) || hgui_rect_empty(clipped)) {
+		HGUI_RasterRect none = { 0, 0, 0, 0 };
+		return none;
+	}
+
+	source->left += clipped.left - target.left;
+	source->top += clipped.top - target.top;
+	*x = clipped.left;
+	*y = clipped.top;
+	return clipped;
+}
+
+// 把源表面的区域复制到目标表面(x, y)处（不混合）；源与目标可以是同一表面且区域重叠。
+// 返回实际写入的区域
+static inline HGUI_RasterRect hgui_raster_copy(HGUI_Surface* dst, int x, int y, const HGUI_Surface* src, HGUI_RasterRect source) {
+	HGUI_RasterRect target = raster_clip_copy(dst, &x, &y, src, &source);
+	if (hgui_rect_empty(target)) return target;
+
+	int width = target.right - target.left;
+	int height = target.bottom - target.top;
+	// 同一表面向下复制时从最后一行开始，避免覆盖尚未复制的源行
+	bool backward = dst->pixels == src->pixels && y > source.top;
+	for (int i = 0; i < height; i++) {
+		int row = backward ? height - 1 - i : i;
+		memmove(hgui_surface_row(dst, y + row) + x, hgui_surface_row(src, source.top + row) + source.left,
+			(size_t)width * sizeof(uint32_t));
+	}
+	return target;
+}
+
+// 按源像素各自的alpha把源表面的区域混合到目标表面(x, y)处；源与目标不能重叠。
+// 返回实际写入的区域
+static inline HGUI_RasterRect hgui_raster_blend_image(HGUI_Surface* dst, int x, int y, const HGUI_Surface* src, HGUI_RasterRect source) {
+	HGUI_RasterRect target = raster_clip_copy(dst, &x, &y, src, &source);
+	if (hgui_rect_empty(target)) return target;
+
+	int width = target.right - target.left;
+	for (int row = 0; row < target.bottom - target.top; row++) {
+		raster_blend_image_span(hgui_surface_row(dst, y + row) + x, hgui_surface_row(src, source.top + row) + source.left, width);
+	}
+	return target;
+}
+
+#endif // HGUI_RASTER_H
@@ -0,0 +1,415 @@
+#ifndef HGUI_SCHED_H
+#define HGUI_SCHED_H
+
+// HGUI 调度器：定时器、空闲任务与按帧合并的任务。
+// 本文件不依赖Windows API，时钟由调用方注入（毫秒），可以用假时钟在任意平台上驱动。
+//
+// 任务种类：
+//   定时任务  一次性（after）或重复（every），存放在哈希时间轮中，插入与取消均为O(1)
+//   空闲任务  每次消息队列处理完、即将进入等待前运行一次，直到被取消
+//   帧任务    请求在下一帧运行一次；同一帧内相同的(回调, 参数)只运行一次，相邻两帧至少间隔一个帧周期
+//
+// 由消息循环按以下顺序驱动：
+//   hgui_sched_run_due    运行到期的定时任务
+//   hgui_sched_run_frame  帧周期已到时运行本帧的帧任务
+//   hgui_sched_run_idle   队列为空时运行空闲任务
+//   hgui_sched_timeout    距离下一个定时任务或帧的等待时间（毫秒，-1表示无限等待）
+//
+// 回调中可以安全地添加或取消任何任务（包括正在运行的任务本身）。
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 任务ID：低20位为节点槽位（从1开始），高12位为节点代数；0表示无效。
+// 代数用尽的节点不再复用，已结束任务的ID不会指向新任务
+typedef unsigned int HGUI_TaskId;
+#define HGUI_INVALID_TASK 0u
+
+typedef void (*HGUI_TaskCallback)(void* user_data);
+typedef long long (*HGUI_SchedClock)(void* context);
+
+#define HGUI_SCHED_WHEEL_SIZE 256          // 时间轮槽数（每槽1毫秒）
+#define HGUI_SCHED_READY HGUI_SCHED_WHEEL_SIZE         // 已到期、等待运行的任务链表
+#define HGUI_SCHED_IDLE (HGUI_SCHED_WHEEL_SIZE + 1)    // 空闲任务链表
+#define HGUI_SCHED_FRAME (HGUI_SCHED_WHEEL_SIZE + 2)   // 帧任务链表
+#define HGUI_SCHED_RUNNING (HGUI_SCHED_WHEEL_SIZE + 3) // 本轮正在运行的空闲任务/帧任务
+#define HGUI_SCHED_LIST_COUNT (HGUI_SCHED_WHEEL_SIZE + 4)
+#define HGUI_SCHED_NO_LIST (-1)
+
+// 任务节点
+typedef struct {
+	HGUI_TaskCallback callback;
+	void* user_data;
+	long long due;              // 定时任务的到期时间（毫秒）
+	long long interval;         // 重复间隔，0表示一次性
+	int list;                   // 所在链表，HGUI_SCHED_NO_LIST表示空闲节点
+	unsigned int generation;
+	unsigned int prev;          // 链表前后节点（槽位+1，0表示无）
+	unsigned int next;
+} HGUI_SchedTask;
+
+// 调度器（全零初始化即可使用，此时时钟恒为0）
+typedef struct {
+	HGUI_SchedClock clock;
+	void* clock_context;
+
+	HGUI_SchedTask* tasks;
+	unsigned int task_count;        // 已使用过的槽位数
+	unsigned int task_capacity;
+	unsigned int free_head;         // 空闲节点链表（槽位+1）
+
+	unsigned int heads[HGUI_SCHED_LIST_COUNT];  // 各链表头（槽位+1）
+	unsigned int tails[HGUI_SCHED_LIST_COUNT];  // 各链表尾（槽位+1）
+	long long current_tick;         // 时间轮已推进到的时刻
+	bool started;
+	int timer_count;                // 时间轮中的定时任务数
+	long long earliest_due;         // 最早到期时间的缓存
+	bool earliest_valid;
+
+	long long frame_interval;       // 帧周期（毫秒）
+	long long last_frame;           // 上一帧运行的时刻
+	bool frame_ran;
+} HGUI_Scheduler;
+
+#define HGUI_SCHED_SLOT_BITS 20
+#define HGUI_SCHED_SLOT_MASK ((1u << HGUI_SCHED_SLOT_BITS) - 1)
+#define HGUI_SCHED_GENERATION_MASK (~0u >> HGUI_SCHED_SLOT_BITS)
+
+// 辅助函数：读取时钟
+static inline long long sched_now(const HGUI_Scheduler* sched) {
+	return sched->clock ? sched->clock(sched->clock_context) : 0;
+}
+
+// 辅助函数：把节点挂到链表尾部（保持到期任务与帧任务的先后顺序）
+static inline void sched_link(HGUI_Scheduler* sched, unsigned int index, int list) {
+	HGUI_SchedTask* task = &sched->tasks[index];
+	task->list = list;
+	task->prev = sched->tails[list];
+	task->next = 0;
+	if (task->prev) sched->tasks[task->prev - 1].next = index + 1;
+	else sched->heads[list] = index + 1;
+	sched->tails[list] = index + 1;
+}
+
+// 辅助函数：从所在链表中摘除节点
+static inline void sched_unlink(HGUI_Scheduler* sched, unsigned int index) {
+	HGUI_SchedTask* task = &sched->tasks[index];
+	if (task->prev) sched->tasks[task->prev - 1].next = task->next;
+	else sched->heads[task->list] = task->next;
+	if (task->next) sched->tasks[task->next - 1].prev = task->prev;
+	else sched->tails[task->list] = task->prev;
+	task->prev = task->next = 0;
+}
+
+// 辅助函数：把整个链表移到另一个（空）链表
+static inline void sched_move_list(HGUI_Scheduler* sched, int from, int to) {
+	for (unsigned int cursor = sched->heads[from]; cursor; cursor = sched->tasks[cursor - 1].next) {
+		sched->tasks[cursor - 1].list = to;
+	}
+	sched->heads[to] = sched->heads[from];
+	sched->tails[to] = sched->tails[from];
+	sched->heads[from] = sched->tails[from] = 0;
+}
+
+// 辅助函数：分配任务节点
+static inline int sched_alloc(HGUI_Scheduler* sched) {
+	if (sched->free_head) {
+		unsigned int index = sched->free_head - 1;
+		sched->free_head = sched->tasks[index].next;
+		return (int)index;
+	}
+
+	if (sched->task_count == sched->task_capacity) {
+		if (sched->task_capacity >= HGUI_SCHED_SLOT_MASK) return -1;
+		unsigned int capacity = sched->task_capacity ? sched->task_capacity * 2 : 32;
+		HGUI_SchedTask* tasks = (HGUI_SchedTask*)realloc(sched->tasks, capacity * sizeof(HGUI_SchedTask));
+		if (!tasks) return -1;
+		sched->tasks = tasks;
+		sched->task_capacity = capacity;
+	}
+	sched->tasks[sched->task_count].generation = 0;
+	return (int)sched->task_count++;
+}
+
+// 辅助函数：释放任务节点（代数递增，旧ID随之失效）。
+// 代数用尽的节点退役、不再进入空闲链表，否则代数回绕后旧ID会解析到新任务
+static inline void sched_release(HGUI_Scheduler* sched, unsigned int index) {
+	HGUI_SchedTask* task = &sched->tasks[index];
+	task->list = HGUI_SCHED_NO_LIST;
+	if (task->generation == HGUI_SCHED_GENERATION_MASK) return;
+	task->generation++;
+	task->next = sched->free_head;
+	sched->free_head = index + 1;
+}
+
+static inline HGUI_TaskId sched_make_id(const HGUI_Scheduler* sched, unsigned int index) {
+	return (sched->tasks[index].generation << HGUI_SCHED_SLOT_BITS) | (index + 1);
+}
+
+// 辅助函数：解析任务ID，失效时返回-1
+static inline int sched_resolve(const HGUI_Scheduler* sched, HGUI_TaskId id) {
+	unsigned int slot = id & HGUI_SCHED_SLOT_MASK;
+	if (slot == 0 || slot > sched->task_count) return -1;
+
+	const HGUI_SchedTask* task = &sched->tasks[slot - 1];
+	if (task->list == HGUI_SCHED_NO_LIST || task->generation != (id >> HGUI_SCHED_SLOT_BITS)) return -1;
+	return (int)(slot - 1);
+}
+
+// 辅助函数：放入时间轮（按到期时刻散列到槽位）
+static inline void sched_wheel_insert(HGUI_Scheduler* sched, unsigned int index) {
+	HGUI_SchedTask* task = &sched->tasks[index];
+	if (task->due <= sched->current_tick) task->due = sched->current_tick + 1;
+	sched_link(sched, index, (int)(task->due & (HGUI_SCHED_WHEEL_SIZE - 1)));
+	sched->timer_count++;
+	if (sched->earliest_valid && (sched->earliest_due < 0 || task->due < sched->earliest_due)) {
+		sched->earliest_due = task->due;
+	}
+}
+
+// 辅助函数：推进时间轮，把到期的定时任务移入待运行链表
+static inline void sched_advance(HGUI_Scheduler* sched, long long now) {
+	if (!sched->started) {
+		sched->current_tick = now;
+		sched->started = true;
+		return;
+	}
+	if (now <= sched->current_tick) return;
+
+	// 间隔超过一圈时每个槽位只需检查一次
+	long long first = sched->current_tick + 1;
+	long long steps = now - sched->current_tick;
+	if (steps > HGUI_SCHED_WHEEL_SIZE) steps = HGUI_SCHED_WHEEL_SIZE;
+
+	for (long long tick = first; tick < first + steps && sched->timer_count > 0; tick++) {
+		int slot = (int)(tick & (HGUI_SCHED_WHEEL_SIZE - 1));
+		unsigned int cursor = sched->heads[slot];
+		while (cursor) {
+			unsigned int index = cursor - 1;
+			cursor = sched->tasks[index].next;
+			if (sched->tasks[index].due <= now) {
+				sched_unlink(sched, index);
+				sched->timer_count--;
+				sched_link(sched, index, HGUI_SCHED_READY);
+				sched->earliest_valid = false;
+			}
+		}
+	}
+	sched->current_tick = now;
+}
+
+// 辅助函数：重新计算最早到期时间
+static inline long long sched_earliest(HGUI_Scheduler* sched) {
+	if (!sched->earliest_valid) {
+		long long earliest = -1;
+		for (int slot = 0; slot < HGUI_SCHED_WHEEL_SIZE && sched->timer_count > 0; slot++) {
+			for (unsigned int cursor = sched->heads[slot]; cursor; cursor = sched->tasks[cursor - 1].next) {
+				long long due = sched->tasks[cursor - 1].due;
+				if (earliest < 0 || due < earliest) earliest = due;
+			}
+		}
+		sched->earliest_due = earliest;
+		sched->earliest_valid = true;
+	}
+	return sched->timer_count > 0 ? sched->earliest_due : -1;
+}
+
+// 初始化调度器，clock为NULL时时钟恒为0
+static inline void hgui_sched_init(HGUI_Scheduler* sched, HGUI_SchedClock clock, void* context) {
+	memset(sched, 0, sizeof(HGUI_Scheduler));
+	sched->clock = clock;
+	sched->clock_context = context;
+	sched->frame_interval = 16;
+}
+
+// 释放调度器的全部任务
+static inline void hgui_sched_destroy(HGUI_Scheduler* sched) {
+	free(sched->tasks);
+	hgui_sched_init(sched, sched->clock, sched->clock_context);
+}
+
+// 设置帧周期（毫秒）
+static inline void hgui_sched_set_frame_interval(HGUI_Scheduler* sched, long long interval_ms) {
+	sched->frame_interval = interval_ms > 0 ? interval_ms : 1;
+}
+
+// 辅助函数：创建定时任务
+static inline HGUI_TaskId sched_add_timer(HGUI_Scheduler* sched, long long delay_ms, long long interval_ms,
+								   HGUI_TaskCallback callback, void* user_data) {
+	if (!callback) return HGUI_INVALID_TASK;
+
+	long long now = sched_now(sched);
+	sched_advance(sched, now);
+	int index = sched_alloc(sched);
+	if (index < 0) return HGUI_INVALID_TASK;
+
+	HGUI_SchedTask* task = &sched->tasks[index];
+	task->callback = callback;
+	task->user_data = user_data;
+	task->interval = interval_ms;
+	task->due = now + (delay_ms > 0 ? delay_ms : 0);
+	sched_wheel_insert(sched, (unsigned int)index);
+	return sched_make_id(sched, (unsigned int)index);
+}
+
+// delay_ms毫秒后运行一次
+static inline HGUI_TaskId hgui_sched_after(HGUI_Scheduler* sched, long long delay_ms, HGUI_TaskCallback callback, void* user_data) {
+	return sched_add_timer(sched, delay_ms, 0, callback, user_data);
+}
+
+// 每隔interval_ms毫秒运行一次（错过的周期不补运行）
+static inline HGUI_TaskId hgui_sched_every(HGUI_Scheduler* sched, long long interval_ms, HGUI_TaskCallback callback, void* user_data) {
+	if (interval_ms <= 0) interval_ms = 1;
+	return sched_add_timer(sched, interval_ms, interval_ms, callback, user_data);
+}
+
+// 添加空闲任务
+static inline HGUI_TaskId hgui_sched_idle(HGUI_Scheduler* sched, HGUI_TaskCallback callback, void* user_data) {
+	if (!callback) return HGUI_INVALID_TASK;
+
+	int index = sched_alloc(sched);
+	if (index < 0) return HGUI_INVALID_TASK;
+
+	HGUI_SchedTask* task = &sched->tasks[index];
+	task->callback = callback;
+	task->user_data = user_data;
+	task->interval = 0;
+	sched_link(sched, (unsigned int)index, HGUI_SCHED_IDLE);
+	return sched_make_id(sched, (unsigned int)index);
+}
+
+// 请求在下一帧运行一次；本帧已有相同的(回调, 参数)时返回已有任务的ID
+static inline HGUI_TaskId hgui_sched_frame(HGUI_Scheduler* sched, HGUI_TaskCallback callback, void* user_data) {
+	if (!callback) return HGUI_INVALID_TASK;
+
+	for (unsigned int cursor = sched->heads[HGUI_SCHED_FRAME]; cursor; cursor = sched->tasks[cursor - 1].next) {
+		HGUI_SchedTask* task = &sched->tasks[cursor - 1];
+		if (task->callback == callback && task->user_data == user_data) {
+			return sched_make_id(sched, cursor - 1);
+		}
+	}
+
+	int index = sched_alloc(sched);
+	if (index < 0) return HGUI_INVALID_TASK;
+
+	HGUI_SchedTask* task = &sched->tasks[index];
+	task->callback = callback;
+	task->user_data = user_data;
+	task->interval = 0;
+	sched_link(sched, (unsigned int)index, HGUI_SCHED_FRAME);
+	return sched_make_id(sched, (unsigned int)index);
+}
+
+// 取消任务，任务已运行完毕或ID无效时返回false
+static inline bool hgui_sched_cancel(HGUI_Scheduler* sched, HGUI_TaskId id) {
+	int index = sched_resolve(sched, id);
+	if (index < 0) return false;
+
+	int list = sched->tasks[index].list;
+	sched_unlink(sched, (unsigned int)index);
+	if (list < HGUI_SCHED_WHEEL_SIZE) {
+		sched->timer_count--;
+		sched->earliest_valid = false;
+	}
+	sched_release(sched, (unsigned int)index);
+	return true;
+}
+
+// 运行到期的定时任务，返回运行的任务数
+static inline int hgui_sched_run_due(HGUI_Scheduler* sched) {
+	long long now = sched_now(sched);
+	sched_advance(sched, now);
+
+	int ran = 0;
+	while (sched->heads[HGUI_SCHED_READY]) {
+		unsigned int index = sched->heads[HGUI_SCHED_READY] - 1;
+		HGUI_SchedTask* task = &sched->tasks[index];
+		HGUI_TaskCallback callback = task->callback;
+		void* user_data = task->user_data;
+
+		// 先重新排期或释放节点，回调中取消自身同样有效
+		sched_unlink(sched, index);
+		if (task->interval > 0) {
+			task->due += task->interval;
+			if (task->due <= now) task->due = now + task->interval;
+			sched_wheel_insert(sched, index);
+		}
+		else {
+			sched_release(sched, index);
+		}
+
+		callback(user_data);
+		ran++;
+	}
+	return ran;
+}
+
+// 帧周期已到且有帧任务时运行本帧的全部帧任务，返回运行的任务数
+static inline int hgui_sched_run_frame(HGUI_Scheduler* sched) {
+	if (!sched->heads[HGUI_SCHED_FRAME]) return 0;
+
+	long long now = sched_now(sched);
+	if (sched->frame_ran && now - sched->last_frame < sched->frame_interval) return 0;
+	sched->last_frame = now;
+	sched->frame_ran = true;
+
+	// 取走本帧的任务；回调中请求的帧任务留到下一帧
+	sched_move_list(sched, HGUI_SCHED_FRAME, HGUI_SCHED_RUNNING);
+
+	int ran = 0;
+	while (sched->heads[HGUI_SCHED_RUNNING]) {
+		unsigned int index = sched->heads[HGUI_SCHED_RUNNING] - 1;
+		HGUI_SchedTask* task = &sched->tasks[index];
+		HGUI_TaskCallback callback = task->callback;
+		void* user_data = task->user_data;
+		sched_unlink(sched, index);
+		sched_release(sched, index);
+		callback(user_data);
+		ran++;
+	}
+	return ran;
+}
+
+// 运行全部空闲任务，返回运行的任务数
+static inline int hgui_sched_run_idle(HGUI_Scheduler* sched) {
+	// 逐个取出本轮的任务并放回空闲链表后再运行，回调中添加的任务留到下一轮
+	sched_move_list(sched, HGUI_SCHED_IDLE, HGUI_SCHED_RUNNING);
+
+	int ran = 0;
+	while (sched->heads[HGUI_SCHED_RUNNING]) {
+		unsigned int index = sched->heads[HGUI_SCHED_RUNNING] - 1;
+		sched_unlink(sched, index);
+		sched_link(sched, index, HGUI_SCHED_IDLE);
+		sched->tasks[index].callback(sched->tasks[index].user_data);
+		ran++;
+	}
+	return ran;
+}
+
+// 是否有等待下一帧运行的帧任务
+static inline bool hgui_sched_frame_pending(const HGUI_Scheduler* sched) {
+	return sched->heads[HGUI_SCHED_FRAME] != 0;
+}
+
+// 距离下一个定时任务或下一帧的等待时间（毫秒），没有待运行的任务时返回-1
+static inline long long hgui_sched_timeout(HGUI_Scheduler* sched) {
+	long long now = sched_now(sched);
+	if (sched->heads[HGUI_SCHED_READY]) return 0;
+
+	long long timeout = -1;
+	long long earliest = sched_earliest(sched);
+	if (earliest >= 0) timeout = earliest > now ? earliest - now : 0;
+
+	if (sched->heads[HGUI_SCHED_FRAME]) {
+		long long frame_wait = 0;
+		if (sched->frame_ran && now - sched->last_frame < sched->frame_interval) {
+			frame_wait = sched->last_frame + sched->frame_interval - now;
+		}
+		if (timeout < 0 || frame_wait < timeout) timeout = frame_wait;
+	}
+	return timeout;
+}
+
+#endif // HGUI_SCHED_H
@@ -0,0 +1,310 @@
+#ifndef HGUI_TRACE_H
+#define HGUI_TRACE_H
+
+// HGUI 输入轨迹：记录用户输入产生的控件通知与菜单命令，用于确定性的回放与性能回归测试。
+// 本文件不依赖Windows API，轨迹的写入与读取可以在任意平台上运行。
+//
+// 二进制格式（整数为小端序）：
+//   文件头 8字节："HGTR"、版本（2字节）、保留（2字节）
+//   事件记录依次存放，每条记录：
+//     标志      1字节：低2位为事件种类，其余位见 HGUI_TRACE_FLAG_*
+//     时间      变长整数，距上一条记录的微秒数
+//     控件ID    首次出现时为以'\0'结尾的字符串（按出现顺序编号），之后为变长整数编号
+//     通知码    变长整数（仅控件通知）
+//     值        zigzag变长整数（列表框的当前选择、复选框点击前的状态）
+//     文本      以'\0'结尾的字符串（输入框修改后的内容）
+// 变长整数每字节存7位，最高位为1表示后面还有字节。一条菜单命令通常只占3~4字节。
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HGUI_TRACE_VERSION 1
+#define HGUI_TRACE_HEADER_SIZE 8
+
+// 事件种类
+typedef enum {
+	HGUI_TRACE_MENU,        // 菜单命令（含快捷键转换的命令）
+	HGUI_TRACE_CONTROL      // 控件通知（WM_COMMAND的通知码）
+} HGUI_TraceKind;
+
+#define HGUI_TRACE_KIND_MASK  0x03
+#define HGUI_TRACE_FLAG_NEW_ID 0x04   // 控件ID首次出现，以字符串存放
+#define HGUI_TRACE_FLAG_VALUE  0x08   // 带值
+#define HGUI_TRACE_FLAG_TEXT   0x10   // 带文本
+
+// 一条事件（字符串指向轨迹数据内部，轨迹数据有效期间有效）
+typedef struct {
+	uint64_t time_us;       // 距录制开始的微秒数
+	HGUI_TraceKind kind;
+	const char* id;         // 控件或菜单项的ID
+	unsigned int code;      // 通知码（菜单命令为0）
+	bool has_value;
+	int value;
+	const char* text;       // 没有文本时为NULL
+} HGUI_TraceEvent;
+
+// 写入器（全零初始化即可使用）
+typedef struct {
+	unsigned char* data;
+	size_t size;
+	size_t capacity;
+	uint64_t time_us;           // 上一条记录的时间
+
+	uint32_t* id_offsets;       // 各ID字符串在data中的偏移（按编号）
+	uint32_t id_count;
+	uint32_t id_capacity;
+	uint32_t* id_slots;         // ID的开放寻址索引（编号+1，0为空）
+	uint32_t slot_capacity;     // 2的幂
+} HGUI_TraceWriter;
+
+static inline void hgui_trace_writer_free(HGUI_TraceWriter* writer) {
+	free(writer->data);
+	free(writer->id_offsets);
+	free(writer->id_slots);
+	memset(writer, 0, sizeof(HGUI_TraceWriter));
+}
+
+// 辅助函数：保证缓冲区还能容纳size字节
+static inline bool trace_reserve(HGUI_TraceWriter* writer, size_t size) {
+	if (writer->size + size <= writer->capacity) return true;
+
+	size_t capacity = writer->capacity ? writer->capacity : 4096;
+	while (capacity < writer->size + size) capacity *= 2;
+	unsigned char* data = (unsigned char*)realloc(writer->data, capacity);
+	if (!data) return false;
+	writer->data = data;
+	writer->capacity = capacity;
+	return true;
+}
+
+// 辅助函数：写入变长整数（调用方已预留10字节）
+static inline void trace_put_varint(HGUI_TraceWriter* writer, uint64_t value) {
+	while (value >= 0x80) {
+		writer->data[writer->size++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	writer->data[writer->size++] = (unsigned char)value;
+}
+
+// 辅助函数：写入以'\0'结尾的字符串
+static inline bool trace_put_string(HGUI_TraceWriter* writer, const char* text) {
+	size_t length = strlen(text) + 1;
+	if (!trace_reserve(writer, length)) return false;
+	memcpy(writer->data + writer->size, text, length);
+	writer->size += length;
+	return true;
+}
+
+// 辅助函数：FNV-1a哈希
+static inline uint32_t trace_hash(const char* text) {
+	uint32_t hash = 2166136261u;
+	for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+		hash ^= *p;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// 辅助函数：查找ID的索引槽位（找到时槽位中为其编号+1，否则为空槽）
+static inline uint32_t trace_id_slot(const HGUI_TraceWriter* writer, const char* id, uint32_t hash) {
+	uint32_t mask = writer->slot_capacity - 1;
+	uint32_t i = hash & mask;
+	while (writer->id_slots[i] &&
+		   strcmp((const char*)writer->data + writer->id_offsets[writer->id_slots[i] - 1], id) != 0) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+// 辅助函数：为新ID预留编号与索引空间（装载因子不超过1/2）
+static inline bool trace_id_reserve(HGUI_TraceWriter* writer) {
+	if (writer->id_count == writer->id_capacity) {
+		uint32_t capacity = writer->id_capacity ? writer->id_capacity * 2 : 64;
+		uint32_t* offsets = (uint32_t*)realloc(writer->id_offsets, capacity * sizeof(uint32_t));
+		if (!offsets) return false;
+		writer->id_offsets = offsets;
+		writer->id_capacity = capacity;
+	}
+	if ((writer->id_count + 1) * 2 <= writer->slot_capacity) return true;
+
+	uint32_t capacity = writer->slot_capacity ? writer->slot_capacity * 2 : 128;
+	uint32_t* slots = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+	if (!slots) return false;
+	free(writer->id_slots);
+	writer->id_slots = slots;
+	writer->slot_capacity = capacity;
+	for (uint32_t i = 0; i < writer->id_count; i++) {
+		const char* id = (const char*)writer->data + writer->id_offsets[i];
+		writer->id_slots[trace_id_slot(writer, id, trace_hash(id))] = i + 1;
+	}
+	return true;
+}
+
+// 追加一条事件（event->time_us不能小于上一条），内存不足时返回false
+static inline bool hgui_trace_write(HGUI_TraceWriter* writer, const HGUI_TraceEvent* event) {
+	if (!event->id) return false;
+	if (writer->size == 0) {
+		static const unsigned char header[HGUI_TRACE_HEADER_SIZE] = { 'H', 'G', 'T', 'R', HGUI_TRACE_VERSION, 0, 0, 0 };
+		if (!trace_reserve(writer, sizeof(header))) return false;
+		memcpy(writer->data, header, sizeof(header));
+		writer->size = sizeof(header);
+	}
+	if (!trace_id_reserve(writer)) return false;
+
+	uint32_t hash = trace_hash(event->id);
+	uint32_t slot = trace_id_slot(writer, event->id, hash);
+	unsigned char flags = (unsigned char)(event->kind & HGUI_TRACE_KIND_MASK);
+	if (!writer->id_slots[slot]) flags |= HGUI_TRACE_FLAG_NEW_ID;
+	if (event->has_value) flags |= HGUI_TRACE_FLAG_VALUE;
+	if (event->text) flags |= HGUI_TRACE_FLAG_TEXT;
+
+	size_t start = writer->size;
+	if (!trace_reserve(writer, 1 + 10 + 10)) return false;
+	writer->data[writer->size++] = flags;
+	uint64_t time_us = event->time_us > writer->time_us ? event->time_us : writer->time_us;
+	trace_put_varint(writer, time_us - writer->time_us);
+
+	size_t id_offset = writer->size;
+	if (flags & HGUI_TRACE_FLAG_NEW_ID) {
+		if (id_offset > UINT32_MAX || !trace_put_string(writer, event->id)) {
+			writer->size = start;
+			return false;
+		}
+	} else {
+		trace_put_varint(writer, writer->id_slots[slot] - 1);
+	}
+
+	if (!trace_reserve(writer, 20)) {
+		writer->size = start;
+		return false;
+	}
+	if (event->kind == HGUI_TRACE_CONTROL) trace_put_varint(writer, event->code);
+	if (event->has_value) {
+		uint64_t value = (uint64_t)(int64_t)event->value << 1;
+		trace_put_varint(writer, event->value < 0 ? ~value : value);
+	}
+	if (event->text && !trace_put_string(writer, event->text)) {
+		writer->size = start;
+		return false;
+	}
+
+	// 整条记录写入成功后才登记新ID
+	if (flags & HGUI_TRACE_FLAG_NEW_ID) {
+		writer->id_offsets[writer->id_count] = (uint32_t)id_offset;
+		writer->id_slots[slot] = ++writer->id_count;
+	}
+	writer->time_us = time_us;
+	return true;
+}
+
+// 读取器：事件中的字符串直接指向轨迹数据（可来自内存映射），不复制
+typedef struct {
+	const unsigned char* data;
+	size_t size;
+	size_t position;
+	uint64_t time_us;
+	const char** ids;           // 按编号的ID
+	uint32_t id_count;
+	uint32_t id_capacity;
+	bool failed;                // 数据损坏或内存不足
+} HGUI_TraceReader;
+
+// 校验文件头并开始读取，数据不是轨迹时返回false
+static inline bool hgui_trace_reader_init(HGUI_TraceReader* reader, const void* data, size_t size) {
+	memset(reader, 0, sizeof(HGUI_TraceReader));
+	const unsigned char* bytes = (const unsigned char*)data;
+	if (!bytes || size < HGUI_TRACE_HEADER_SIZE) return false;
+	if (memcmp(bytes, "HGTR", 4) != 0 || bytes[4] != HGUI_TRACE_VERSION || bytes[5] != 0) return false;
+
+	reader->data = bytes;
+	reader->size = size;
+	reader->position = HGUI_TRACE_HEADER_SIZE;
+	return true;
+}
+
+static inline void hgui_trace_reader_free(HGUI_TraceReader* reader) {
+	free(reader->ids);
+	reader->ids = NULL;
+	reader->id_count = 0;
+	reader->id_capacity = 0;
+}
+
+// 辅助函数：读取变长整数
+static inline bool trace_get_varint(HGUI_TraceReader* reader, uint64_t* value) {
+	uint64_t result = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (reader->position >= reader->size) return false;
+		unsigned char byte = reader->data[reader->position++];
+		result |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+// 辅助函数：读取以'\0'结尾的字符串
+static inline const char* trace_get_string(HGUI_TraceReader* reader) {
+	const unsigned char* start = reader->data + reader->position;
+	const unsigned char* end = (const unsigned char*)memchr(start, '\0', reader->size - reader->position);
+	if (!end) return NULL;
+	reader->position += (size_t)(end - start) + 1;
+	return (const char*)start;
+}
+
+// 读取下一条事件。到达末尾或数据损坏时返回false（损坏时reader->failed为true）
+static inline bool hgui_trace_next(HGUI_TraceReader* reader, HGUI_TraceEvent* event) {
+	if (reader->failed || reader->position >= reader->size) return false;
+	reader->failed = true;
+
+	unsigned char flags = reader->data[reader->position++];
+	uint64_t delta;
+	if ((flags & HGUI_TRACE_KIND_MASK) > HGUI_TRACE_CONTROL || !trace_get_varint(reader, &delta)) return false;
+
+	memset(event, 0, sizeof(HGUI_TraceEvent));
+	event->kind = (HGUI_TraceKind)(flags & HGUI_TRACE_KIND_MASK);
+	reader->time_us += delta;
+	event->time_us = reader->time_us;
+
+	if (flags & HGUI_TRACE_FLAG_NEW_ID) {
+		event->id = trace_get_string(reader);
+		if (!event->id) return false;
+		if (reader->id_count == reader->id_capacity) {
+			uint32_t capacity = reader->id_capacity ? reader->id_capacity * 2 : 64;
+			const char** ids = (const char**)realloc((void*)reader->ids, capacity * sizeof(const char*));
+			if (!ids) return false;
+			reader->ids = ids;
+			reader->id_capacity = capacity;
+		}
+		reader->ids[reader->id_count++] = event->id;
+	} else {
+		uint64_t index;
+		if (!trace_get_varint(reader, &index) || index >= reader->id_count) return false;
+		event->id = reader->ids[index];
+	}
+
+	if (event->kind == HGUI_TRACE_CONTROL) {
+		uint64_t code;
+		if (!trace_get_varint(reader, &code) || code > 0xFFFF) return false;
+		event->code = (unsigned int)code;
+	}
+	if (flags & HGUI_TRACE_FLAG_VALUE) {
+		uint64_t value;
+		if (!trace_get_varint(reader, &value)) return false;
+		event->has_value = true;
+		event->value = (int)(int64_t)((value & 1) ? ~(value >> 1) : (value >> 1));
+	}
+	if (flags & HGUI_TRACE_FLAG_TEXT) {
+		event->text = trace_get_string(reader);
+		if (!event->text) return false;
+	}
+
+	reader->failed = false;
+	return true;
+}
+
+#endif // HGUI_TRACE_H
@@ -0,0 +1,440 @@
+#ifndef HGUI_UIDESC_H
+#define HGUI_UIDESC_H
+
+// HGUI 界面描述格式：文本格式用于编写，编译后的二进制格式可直接内存映射后加载。
+// 本文件不依赖Windows API，解析与编译可在任意平台上运行。
+//
+// 文本格式（每行一个节点，#开头为注释，父节点必须先于子节点声明）：
+//   window   <id> "<标题>" x y w h
+//   label    <id> <父id> "<文本>" x y w h
+//   button   <id> <父id> "<文本>" x y w h
+//   input    <id> <父id> x y w h
+//   listbox  <id> <父id> x y w h
+//   radio    <id> <父id> "<文本>" x y w h [group]
+//   checkbox <id> <父id> "<文本>" x y w h
+//   menubar  <id> <父id>
+//   menu     <id> <父id> "<文本>" [submenu]      （文本为空字符串时为分隔线）
+//   canvas   <id> <父id> x y w h
+//
+// 菜单栏的父节点必须是window，菜单项的父节点必须是menubar或带submenu的菜单项，
+// 其他控件的父节点不能是菜单栏或菜单项。
+//
+// 二进制格式（小端序）：
+//   文件头 HGUI_UIDescHeader（16字节）
+//   节点表 HGUI_UIDescNode[node_count]（每项32字节）
+//   字符串表 string_bytes 字节（以'\0'结尾的字符串依次存放）
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HGUI_UIDESC_MAGIC 0x49554748u   // "HGUI"
+#define HGUI_UIDESC_VERSION 1
+#define HGUI_UIDESC_NO_STRING 0xFFFFFFFFu
+
+// 节点类型
+typedef enum {
+	HGUI_UIDESC_WINDOW,
+	HGUI_UIDESC_LABEL,
+	HGUI_UIDESC_BUTTON,
+	HGUI_UIDESC_INPUT,
+	HGUI_UIDESC_LISTBOX,
+	HGUI_UIDESC_RADIO,
+	HGUI_UIDESC_CHECKBOX,
+	HGUI_UIDESC_MENUBAR,
+	HGUI_UIDESC_MENUITEM,
+	HGUI_UIDESC_CANVAS,
+	HGUI_UIDESC_TYPE_COUNT
+} HGUI_UIDescType;
+
+// 节点标志
+#define HGUI_UIDESC_FLAG_GROUP_FIRST 0x01   // 单选框组首
+#define HGUI_UIDESC_FLAG_SUBMENU     0x02   // 子菜单容器
+
+// 文件头
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t reserved;
+	uint32_t node_count;
+	uint32_t string_bytes;
+} HGUI_UIDescHeader;
+
+// 节点记录（字符串字段为字符串表内的偏移）
+typedef struct {
+	uint8_t type;
+	uint8_t flags;
+	uint16_t reserved;
+	int32_t x, y, width, height;
+	uint32_t id;
+	uint32_t parent;
+	uint32_t text;
+} HGUI_UIDescNode;
+
+// 辅助函数：编译期间使用的可增长缓冲区
+typedef struct {
+	char* data;
+	size_t size;
+	size_t capacity;
+} HGUI_UIDescBuffer;
+
+static inline bool uidesc_buffer_append(HGUI_UIDescBuffer* buffer, const void* data, size_t size) {
+	if (buffer->size + size > buffer->capacity) {
+		size_t capacity = buffer->capacity ? buffer->capacity : 1024;
+		while (capacity < buffer->size + size) capacity *= 2;
+		char* grown = (char*)realloc(buffer->data, capacity);
+		if (!grown) return false;
+		buffer->data = grown;
+		buffer->capacity = capacity;
+	}
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+	return true;
+}
+
+// 解析器状态
+typedef struct {
+	const char* cursor;
+	const char* end;
+	int line;
+	char* error;
+	size_t error_size;
+	char token[1024];
+} HGUI_UIDescParser;
+
+// 辅助函数：记录解析错误
+static inline bool uidesc_fail(HGUI_UIDescParser* parser, const char* message) {
+	if (parser->error && parser->error_size > 0) {
+		snprintf(parser->error, parser->error_size, "第%d行: %s", parser->line, message);
+	}
+	return false;
+}
+
+// 辅助函数：跳过行内空白
+static inline void uidesc_skip_blank(HGUI_UIDescParser* parser) {
+	while (parser->cursor < parser->end && (*parser->cursor == ' ' || *parser->cursor == '\t' || *parser->cursor == '\r')) {
+		parser->cursor++;
+	}
+}
+
+// 辅助函数：当前行是否已结束（遇到换行、注释或文本末尾）
+static inline bool uidesc_at_line_end(HGUI_UIDescParser* parser) {
+	uidesc_skip_blank(parser);
+	return parser->cursor >= parser->end || *parser->cursor == '\n' || *parser->cursor == '#';
+}
+
+// 辅助函数：读取一个词或带引号的字符串到 parser->token
+static inline bool uidesc_read_token(HGUI_UIDescParser* parser, bool* quoted) {
+	if (uidesc_at_line_end(parser)) return uidesc_fail(parser, "参数不足");
+
+	size_t length = 0;
+	*quoted = *parser->cursor == '"';
+	if (*quoted) {
+		parser->cursor++;
+		while (true) {
+			if (parser->cursor >= parser->end || *parser->cursor == '\n') {
+				return uidesc_fail(parser, "字符串缺少结束引号");
+			}
+			char c = *parser->cursor++;
+			if (c == '"') break;
+			if (c == '\\' && parser->cursor < parser->end) {
+				c = *parser->cursor++;
+				if (c == 'n') c = '\n';
+				else if (c == 't') c = '\t';
+			}
+			if (length + 1 >= sizeof(parser->token)) return uidesc_fail(parser, "字符串过长");
+			parser->token[length++] = c;
+		}
+	} else {
+		while (parser->cursor < parser->end && *parser->cursor != ' ' && *parser->cursor != '\t' &&
+			   *parser->cursor != '\r' && *parser->cursor != '\n' && *parser->cursor != '#') {
+			if (length + 1 >= sizeof(parser->token)) return uidesc_fail(parser, "标识符过长");
+			parser->token[length++] = *parser->cursor++;
+		}
+	}
+	parser->token[length] = '\0';
+	return true;
+}
+
+// 辅助函数：读取一个整数参数
+static inline bool uidesc_read_int(HGUI_UIDescParser* parser, int32_t* value) {
+	bool quoted;
+	if (!uidesc_read_token(parser, &quoted)) return false;
+
+	char* end = NULL;
+	long number = strtol(parser->token, &end, 10);
+	if (quoted || end == parser->token || *end != '\0') return uidesc_fail(parser, "需要整数参数");
+	*value = (int32_t)number;
+	return true;
+}
+
+// 已声明ID的集合（开放寻址），用于检查父节点先于子节点声明
+typedef struct {
+	uint32_t* offsets;      // 字符串表偏移，HGUI_UIDESC_NO_STRING 表示空槽
+	uint8_t* types;         // 节点类型，用于检查父节点类型
+	uint8_t* flags;         // 节点标志（子菜单容器才能包含菜单项）
+	size_t capacity;
+	size_t count;
+} HGUI_UIDescIdSet;
+
+static inline uint32_t uidesc_hash(const char* text) {
+	uint32_t hash = 2166136261u;
+	while (*text) {
+		hash ^= (unsigned char)*text++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// 辅助函数：在已声明ID集合中查找，返回槽位
+static inline size_t uidesc_id_slot(const HGUI_UIDescIdSet* set, const HGUI_UIDescBuffer* strings, const char* id) {
+	size_t mask = set->capacity - 1;
+	size_t i = uidesc_hash(id) & mask;
+	while (set->offsets[i] != HGUI_UIDESC_NO_STRING && strcmp(strings->data + set->offsets[i], id) != 0) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+static inline bool uidesc_id_reserve(HGUI_UIDescIdSet* set, const HGUI_UIDescBuffer* strings) {
+	if (set->capacity && (set->count + 1) * 2 < set->capacity) return true;
+
+	HGUI_UIDescIdSet grown;
+	grown.capacity = set->capacity ? set->capacity * 2 : 256;
+	grown.count = set->count;
+	grown.offsets = (uint32_t*)malloc(grown.capacity * sizeof(uint32_t));
+	grown.types = (uint8_t*)malloc(grown.capacity);
+	grown.flags = (uint8_t*)malloc(grown.capacity);
+	if (!grown.offsets || !grown.types || !grown.flags) {
+		free(grown.offsets);
+		free(grown.types);
+		free(grown.flags);
+		return false;
+	}
+	memset(grown.offsets, 0xFF, grown.capacity * sizeof(uint32_t));
+
+	for (size_t i = 0; i < set->capacity; i++) {
+		if (set->offsets[i] == HGUI_UIDESC_NO_STRING) continue;
+		size_t slot = uidesc_id_slot(&grown, strings, strings->data + set->offsets[i]);
+		grown.offsets[slot] = set->offsets[i];
+		grown.types[slot] = set->types[i];
+		grown.flags[slot] = set->flags[i];
+	}
+	free(set->offsets);
+	free(set->types);
+	free(set->flags);
+	*set = grown;
+	return true;
+}
+
+// 辅助函数：把字符串写入字符串表，返回偏移
+static inline uint32_t uidesc_add_string(HGUI_UIDescBuffer* strings, const char* text) {
+	uint32_t offset = (uint32_t)strings->size;
+	if (!uidesc_buffer_append(strings, text, strlen(text) + 1)) return HGUI_UIDESC_NO_STRING;
+	return offset;
+}
+
+// 关键字表
+static const struct {
+	const char* keyword;
+	HGUI_UIDescType type;
+	bool has_parent;
+	bool has_text;
+	bool has_rect;
+} uidesc_keywords[] = {
+	{ "window",   HGUI_UIDESC_WINDOW,   false, true,  true  },
+	{ "label",    HGUI_UIDESC_LABEL,    true,  true,  true  },
+	{ "button",   HGUI_UIDESC_BUTTON,   true,  true,  true  },
+	{ "input",    HGUI_UIDESC_INPUT,    true,  false, true  },
+	{ "listbox",  HGUI_UIDESC_LISTBOX,  true,  false, true  },
+	{ "radio",    HGUI_UIDESC_RADIO,    true,  true,  true  },
+	{ "checkbox", HGUI_UIDESC_CHECKBOX, true,  true,  true  },
+	{ "menubar",  HGUI_UIDESC_MENUBAR,  true,  false, false },
+	{ "menu",     HGUI_UIDESC_MENUITEM, true,  true,  false },
+	{ "canvas",   HGUI_UIDESC_CANVAS,   true,  false, true  },
+};
+
+// 辅助函数：检查父节点类型能否容纳子节点（与加载时各创建函数的要求一致）
+static inline bool uidesc_parent_allowed(HGUI_UIDescType type, HGUI_UIDescType parent_type, uint8_t parent_flags) {
+	switch (type) {
+		case HGUI_UIDESC_MENUBAR:
+			return parent_type == HGUI_UIDESC_WINDOW;
+		case HGUI_UIDESC_MENUITEM:
+			return parent_type == HGUI_UIDESC_MENUBAR ||
+				   (parent_type == HGUI_UIDESC_MENUITEM && (parent_flags & HGUI_UIDESC_FLAG_SUBMENU));
+		default:
+			return parent_type != HGUI_UIDESC_MENUBAR && parent_type != HGUI_UIDESC_MENUITEM;
+	}
+}
+
+// 辅助函数：解析一行节点声明
+static inline bool uidesc_parse_node(HGUI_UIDescParser* parser, HGUI_UIDescNode* node,
+							  HGUI_UIDescBuffer* strings, HGUI_UIDescIdSet* ids) {
+	bool quoted;
+	if (!uidesc_read_token(parser, &quoted)) return false;
+
+	size_t k = 0;
+	size_t keyword_count = sizeof(uidesc_keywords) / sizeof(uidesc_keywords[0]);
+	while (k < keyword_count && strcmp(uidesc_keywords[k].keyword, parser->token) != 0) k++;
+	if (quoted || k == keyword_count) return uidesc_fail(parser, "未知的节点类型");
+
+	memset(node, 0, sizeof(HGUI_UIDescNode));
+	node->type = (uint8_t)uidesc_keywords[k].type;
+	node->parent = HGUI_UIDESC_NO_STRING;
+	node->text = HGUI_UIDESC_NO_STRING;
+
+	// ID必须唯一
+	if (!uidesc_read_token(parser, &quoted)) return false;
+	if (!uidesc_id_reserve(ids, strings)) return uidesc_fail(parser, "内存不足");
+	size_t id_slot = uidesc_id_slot(ids, strings, parser->token);
+	if (ids->offsets[id_slot] != HGUI_UIDESC_NO_STRING) return uidesc_fail(parser, "ID重复");
+	node->id = uidesc_add_string(strings, parser->token);
+	if (node->id == HGUI_UIDESC_NO_STRING) return uidesc_fail(parser, "内存不足");
+
+	// 父节点必须已声明，保证加载时单遍即可创建
+	if (uidesc_keywords[k].has_parent) {
+		if (!uidesc_read_token(parser, &quoted)) return false;
+		size_t parent_slot = uidesc_id_slot(ids, strings, parser->token);
+		if (ids->offsets[parent_slot] == HGUI_UIDESC_NO_STRING) return uidesc_fail(parser, "父节点未声明");
+		if (!uidesc_parent_allowed((HGUI_UIDescType)node->type, (HGUI_UIDescType)ids->types[parent_slot], ids->flags[parent_slot])) {
+			return uidesc_fail(parser, "父节点类型不能包含该节点");
+		}
+		node->parent = ids->offsets[parent_slot];
+	}
+
+	if (uidesc_keywords[k].has_text) {
+		if (!uidesc_read_token(parser, &quoted)) return false;
+		node->text = uidesc_add_string(strings, parser->token);
+		if (node->text == HGUI_UIDESC_NO_STRING) return uidesc_fail(parser, "内存不足");
+	}
+
+	if (uidesc_keywords[k].has_rect) {
+		if (!uidesc_read_int(parser, &node->x) || !uidesc_read_int(parser, &node->y) ||
+			!uidesc_read_int(parser, &node->width) || !uidesc_read_int(parser, &node->height)) {
+			return false;
+		}
+	}
+
+	// 可选标志
+	while (!uidesc_at_line_end(parser)) {
+		if (!uidesc_read_token(parser, &quoted)) return false;
+		if (node->type == HGUI_UIDESC_RADIO && strcmp(parser->token, "group") == 0) {
+			node->flags |= HGUI_UIDESC_FLAG_GROUP_FIRST;
+		} else if (node->type == HGUI_UIDESC_MENUITEM && strcmp(parser->token, "submenu") == 0) {
+			node->flags |= HGUI_UIDESC_FLAG_SUBMENU;
+		} else {
+			return uidesc_fail(parser, "未知的标志");
+		}
+	}
+
+	// 登记ID（字符串表可能已扩容，重新定位槽位）
+	id_slot = uidesc_id_slot(ids, strings, strings->data + node->id);
+	ids->offsets[id_slot] = node->id;
+	ids->types[id_slot] = node->type;
+	ids->flags[id_slot] = node->flags;
+	ids->count++;
+	return true;
+}
+
+// 将文本描述编译为二进制格式。成功时 *out 指向 malloc 分配的数据，由调用者 free
+static inline bool hgui_uidesc_compile(const char* text, size_t length, void** out, size_t* out_size,
+								char* error, size_t error_size) {
+	if (!text || !out || !out_size) return false;
+	*out = NULL;
+	*out_size = 0;
+
+	HGUI_UIDescParser parser;
+	parser.cursor = text;
+	parser.end = text + length;
+	parser.line = 1;
+	parser.error = error;
+	parser.error_size = error_size;
+
+	HGUI_UIDescBuffer nodes = { NULL, 0, 0 };
+	HGUI_UIDescBuffer strings = { NULL, 0, 0 };
+	HGUI_UIDescIdSet ids = { NULL, NULL, NULL, 0, 0 };
+	bool ok = true;
+
+	while (ok && parser.cursor < parser.end) {
+		if (!uidesc_at_line_end(&parser)) {
+			HGUI_UIDescNode node;
+			ok = uidesc_parse_node(&parser, &node, &strings, &ids) &&
+				 (uidesc_at_line_end(&parser) || uidesc_fail(&parser, "多余的参数")) &&
+				 (uidesc_buffer_append(&nodes, &node, sizeof(node)) || uidesc_fail(&parser, "内存不足"));
+		}
+		// 跳到下一行（包括注释部分）
+		while (ok && parser.cursor < parser.end && *parser.cursor != '\n') parser.cursor++;
+		if (parser.cursor < parser.end) parser.cursor++;
+		parser.line++;
+	}
+
+	if (ok) {
+		HGUI_UIDescHeader header;
+		header.magic = HGUI_UIDESC_MAGIC;
+		header.version = HGUI_UIDESC_VERSION;
+		header.reserved = 0;
+		header.node_count = (uint32_t)(nodes.size / sizeof(HGUI_UIDescNode));
+		header.string_bytes = (uint32_t)strings.size;
+
+		HGUI_UIDescBuffer blob = { NULL, 0, 0 };
+		ok = uidesc_buffer_append(&blob, &header, sizeof(header)) &&
+			 (nodes.size == 0 || uidesc_buffer_append(&blob, nodes.data, nodes.size)) &&
+			 (strings.size == 0 || uidesc_buffer_append(&blob, strings.data, strings.size));
+		if (ok) {
+			*out = blob.data;
+			*out_size = blob.size;
+		} else {
+			free(blob.data);
+			uidesc_fail(&parser, "内存不足");
+		}
+	}
+
+	free(nodes.data);
+	free(strings.data);
+	free(ids.offsets);
+	free(ids.types);
+	free(ids.flags);
+	return ok;
+}
+
+// 校验二进制描述，成功时返回文件头（数据可直接来自内存映射）
+static inline const HGUI_UIDescHeader* hgui_uidesc_validate(const void* data, size_t size) {
+	if (!data || size < sizeof(HGUI_UIDescHeader)) return NULL;
+
+	const HGUI_UIDescHeader* header = (const HGUI_UIDescHeader*)data;
+	if (header->magic != HGUI_UIDESC_MAGIC || header->version != HGUI_UIDESC_VERSION) return NULL;
+
+	uint64_t expected = sizeof(HGUI_UIDescHeader) +
+						(uint64_t)header->node_count * sizeof(HGUI_UIDescNode) + header->string_bytes;
+	if (expected != size) return NULL;
+
+	// 字符串表必须以'\0'结尾，所有偏移都必须落在表内
+	const char* strings = (const char*)data + size - header->string_bytes;
+	if (header->string_bytes > 0 && strings[header->string_bytes - 1] != '\0') return NULL;
+
+	const HGUI_UIDescNode* nodes = (const HGUI_UIDescNode*)(header + 1);
+	for (uint32_t i = 0; i < header->node_count; i++) {
+		const HGUI_UIDescNode* node = &nodes[i];
+		if (node->type >= HGUI_UIDESC_TYPE_COUNT || node->id >= header->string_bytes) return NULL;
+		if (node->parent != HGUI_UIDESC_NO_STRING && node->parent >= header->string_bytes) return NULL;
+		if (node->text != HGUI_UIDESC_NO_STRING && node->text >= header->string_bytes) return NULL;
+	}
+	return header;
+}
+
+// 获取节点表
+static inline const HGUI_UIDescNode* hgui_uidesc_nodes(const HGUI_UIDescHeader* header) {
+	return (const HGUI_UIDescNode*)(header + 1);
+}
+
+// 获取节点的字符串字段（偏移为 HGUI_UIDESC_NO_STRING 时返回NULL）
+static inline const char* hgui_uidesc_string(const HGUI_UIDescHeader* header, uint32_t offset) {
+	if (offset == HGUI_UIDESC_NO_STRING) return NULL;
+	const char* strings = (const char*)(hgui_uidesc_nodes(header) + header->node_count);
+	return strings + offset;
+}
+
+#endif // HGUI_UIDESC_H
@@ -0,0 +1,21 @@
+// HGUI 无界面测试的公共辅助：CHECK 在 NDEBUG 下同样生效，失败时打印位置并以非零状态退出
+#ifndef HGUI_TEST_H
+#define HGUI_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(expr) do { \
+	if (!(expr)) { \
+		fprintf(stderr, "%s:%d: CHECK(%s) 失败\n", __FILE__, __LINE__, #expr); \
+		exit(1); \
+	} \
+} while (0)
+
+// 每个测试结束后调用：释放控件并清空当前线程的无界面状态
+#define TEST_TEARDOWN() do { \
+	hgui.cleanup(); \
+	hgui_headless_reset(); \
+} while (0)
+
+#endif // HGUI_TEST_H
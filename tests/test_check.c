@@ -0,0 +1,57 @@
+// 单选框与复选框测试：点击切换、分组互斥，以及按控件本身（而不是ID）更新状态
+#include "hgui.h"
+#include "hgui_test.h"
+
+static int changes;
+
+static void on_change(const char* id) {
+	(void)id;
+	changes++;
+}
+
+static void click(const char* id) {
+	hgui_headless_click(find_control(id)->hwnd);
+}
+
+int main(void) {
+	hgui.init();
+	hgui.create.window("main", "选中", 0, 0, 320, 240);
+
+	// 复选框：每次点击切换一次并触发change
+	hgui.create.checkbox("agree", "main", "同意", 0, 0, 100, 20);
+	hgui.bind("agree", "change", on_change);
+	click("agree");
+	CHECK(hgui.getCheck("agree"));
+	click("agree");
+	CHECK(!hgui.getCheck("agree"));
+	CHECK(changes == 2);
+
+	// 单选框：同组只有一个选中项，新组从is_group_first开始
+	hgui.create.radio("a1", "main", "A1", 0, 0, 10, 10, true);
+	hgui.create.radio("a2", "main", "A2", 0, 0, 10, 10, false);
+	hgui.create.radio("a3", "main", "A3", 0, 0, 10, 10, false);
+	hgui.create.radio("b1", "main", "B1", 0, 0, 10, 10, true);
+	hgui.create.radio("b2", "main", "B2", 0, 0, 10, 10, false);
+	click("a2");
+	click("b1");
+	CHECK(hgui.getCheck("a2") && hgui.getCheck("b1"));
+	click("a3");
+	CHECK(!hgui.getCheck("a2") && hgui.getCheck("a3") && hgui.getCheck("b1"));
+	hgui.setCheck("a1", true);
+	CHECK(hgui.getCheck("a1") && !hgui.getCheck("a3"));
+	hgui.remove("a1");
+	click("a2");
+	CHECK(hgui.getCheck("a2") && !hgui.getCheck("a3"));
+
+	// 被同名控件遮蔽的复选框被点击时切换的是它自己
+	HGUI_Handle older = hgui.create.checkbox("dup", "main", "旧", 0, 0, 10, 10);
+	HWND older_hwnd = find_control("dup")->hwnd;
+	HGUI_Handle newer = hgui.create.checkbox("dup", "main", "新", 0, 0, 10, 10);
+	hgui_headless_click(older_hwnd);
+	CHECK(hgui.handle.getCheck(older));
+	CHECK(!hgui.handle.getCheck(newer));
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
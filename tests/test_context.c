@@ -0,0 +1,145 @@
+// 上下文隔离测试：每个UI线程各自的上下文拥有独立的控件表、菜单ID空间与跨线程队列，
+// 多个线程同时创建控件互不干扰；同一线程切换上下文时看到的是各自的控件
+#include "hgui.h"
+#include "hgui_test.h"
+#include <pthread.h>
+
+#define THREADS 4
+#define LABELS 5000
+#define POSTS 50
+
+typedef struct {
+	HGUI_Context* context;
+	int index;
+	int clicks;
+	bool ok;
+} Job;
+
+static __thread Job* current_job;
+
+static void on_click(const char* id) {
+	(void)id;
+	current_job->clicks++;
+}
+
+static void on_menu(const char* id) {
+	(void)id;
+	current_job->clicks += 100;
+}
+
+// 工作线程：选择目标上下文后投递
+static void* worker(void* arg) {
+	Job* job = (Job*)arg;
+	char text[32];
+	hgui.context.makeCurrent(job->context);
+	for (int i = 0; i < POSTS; i++) {
+		snprintf(text, sizeof(text), "w%d-%d", job->index, i);
+		hgui.post.setText("name", text);
+	}
+	hgui_headless_pending(-1);
+	return NULL;
+}
+
+static void* ui_thread(void* arg) {
+	Job* job = (Job*)arg;
+	current_job = job;
+	job->context = hgui.context.create();
+	hgui.context.makeCurrent(job->context);
+	CHECK(hgui.context.current() == job->context);
+
+	// 各线程使用相同的ID
+	hgui.init();
+	hgui.create.window("main", "线程", 0, 0, 400, 300);
+	hgui.create.menubar("bar", "main");
+	HGUI_MenuSpec menu[] = {
+		{ "file", "文件", 0, NULL, NULL },
+		{ "open", "打开", 1, "Ctrl+O", on_menu }
+	};
+	CHECK(hgui.menu.build("bar", menu, 2) == 2);
+	hgui.create.button("ok", "main", "确定", 0, 0, 80, 24);
+	hgui.bind("ok", "click", on_click);
+	hgui.create.input("name", "main", 0, 30, 120, 24);
+	// 菜单ID在每个上下文中从同一个起始值分配
+	CHECK(find_control("open")->menu_id == HGUI_MENU_ID_BASE);
+
+	char id[32];
+	for (int i = 0; i < LABELS; i++) {
+		snprintf(id, sizeof(id), "label%d", i);
+		CHECK(hgui.create.label(id, "main", "x", 0, 0, 10, 10));
+	}
+
+	// 投递只进入本上下文的队列，点击与快捷键只触发本上下文的回调
+	pthread_t thread;
+	hgui_headless_pending(1);
+	CHECK(pthread_create(&thread, NULL, worker, job) == 0);
+	hgui_headless_click(find_control("ok")->hwnd);
+	hgui_headless_key(find_control("main")->hwnd, 'O', FCONTROL);
+	hgui.run();
+	pthread_join(thread, NULL);
+	hgui.run();
+
+	char expected[32];
+	snprintf(expected, sizeof(expected), "w%d-%d", job->index, POSTS - 1);
+	CHECK(strcmp(hgui.getTextView("name"), expected) == 0);
+	CHECK(job->clicks == 101);
+
+	HGUI_MemoryStats memory;
+	HGUI_HeadlessStats headless;
+	hgui.memoryStats(&memory);
+	hgui_headless_stats(&headless);
+	CHECK(memory.total.controls == LABELS + 6);
+	CHECK(memory.total.hwnds == headless.windows_alive);
+	CHECK(memory.total.hmenus == headless.menus_alive);
+
+	// 释放后当前上下文恢复为默认上下文，本线程的窗口与菜单全部销毁
+	hgui.context.destroy(job->context);
+	CHECK(hgui.context.current() == &default_context);
+	hgui_headless_stats(&headless);
+	CHECK(headless.windows_alive == 0 && headless.menus_alive == 0);
+	hgui_headless_reset();
+	job->ok = true;
+	return NULL;
+}
+
+static void run_threads(int count) {
+	pthread_t threads[THREADS];
+	Job jobs[THREADS];
+	memset(jobs, 0, sizeof(jobs));
+	for (int i = 0; i < count; i++) {
+		jobs[i].index = i;
+		CHECK(pthread_create(&threads[i], NULL, ui_thread, &jobs[i]) == 0);
+	}
+	for (int i = 0; i < count; i++) {
+		pthread_join(threads[i], NULL);
+		CHECK(jobs[i].ok);
+	}
+}
+
+int main(void) {
+	// 默认上下文与其他线程的上下文同时存在
+	hgui.init();
+	hgui.create.window("main", "默认", 0, 0, 100, 100);
+	CHECK(hgui.context.makeCurrent(NULL) == hgui.context.current());
+	run_threads(1);
+	run_threads(THREADS);
+	CHECK(find_control("main") && !find_control("ok") && !find_control("label0"));
+
+	// 同一线程切换上下文
+	HGUI_Context* other = hgui.context.create();
+	HGUI_Context* previous = hgui.context.makeCurrent(other);
+	hgui.init();
+	hgui.create.window("other", "其他", 0, 0, 10, 10);
+	CHECK(!find_control("main") && find_control("other"));
+	hgui.context.makeCurrent(previous);
+	CHECK(find_control("main") && !find_control("other"));
+	hgui.context.destroy(other);
+
+	// 默认上下文不会被释放
+	hgui.context.destroy(NULL);
+	hgui.context.destroy(hgui.context.current());
+	CHECK(find_control("main"));
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
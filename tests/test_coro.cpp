@@ -0,0 +1,176 @@
+// 协程测试：等待按钮点击、控件删除时等待结果为false、background在工作线程执行后回到UI线程恢复，
+// 后台任务的异常在协程中重新抛出，delay与next_frame在消息循环中恢复；
+// 非默认上下文中的协程回到该上下文中恢复，两个UI线程各自的上下文中同时运行的协程互不干扰
+#include "hgui_coro.hpp"
+#include "hgui_test.h"
+#include <stdexcept>
+
+#define ROUNDS 20
+
+static std::thread::id ui_thread_id;
+static int loops, resumed, rethrown, delayed, ended, missing;
+
+static hgui_co::task click_flow(void) {
+	while (co_await hgui_co::clicked("go")) {
+		loops++;
+		CHECK(std::this_thread::get_id() == ui_thread_id);
+		std::thread::id worker;
+		int value = co_await hgui_co::background([&worker] {
+			worker = std::this_thread::get_id();
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			return 41 + loops;
+		});
+		// 计算在工作线程进行，恢复回到UI线程
+		CHECK(worker != ui_thread_id);
+		CHECK(std::this_thread::get_id() == ui_thread_id);
+		CHECK(value == 41 + loops);
+		resumed++;
+		try {
+			co_await hgui_co::background([]() -> int { throw std::runtime_error("后台失败"); });
+		} catch (const std::runtime_error&) {
+			rethrown++;
+		}
+		co_await hgui_co::delay(3);
+		delayed++;
+		co_await hgui_co::next_frame();
+		hgui.setText("status", "完成");
+	}
+	// 按钮被删除：等待返回false，循环结束
+	ended++;
+}
+
+// 等待不存在的控件立即得到false
+static hgui_co::task missing_flow(void) {
+	CHECK(!co_await hgui_co::clicked("nothing"));
+	missing++;
+}
+
+static void click_later(void* arg) {
+	(void)arg;
+	hgui_headless_click(find_control("go")->hwnd);
+}
+
+static void remove_later(void* arg) {
+	(void)arg;
+	hgui.remove("go");
+}
+
+// 同一个按钮上的点击循环：每轮等待后台任务、异常、延时与下一帧，删除按钮后结束
+static void test_click_loop(void) {
+	ui_thread_id = std::this_thread::get_id();
+	hgui.init();
+	hgui.create.window("main", "协程", 0, 0, 200, 100);
+	hgui.create.button("go", "main", "开始", 0, 0, 80, 24);
+	hgui.create.label("status", "main", "", 0, 30, 80, 24);
+	click_flow();
+	missing_flow();
+	CHECK(missing == 1);
+
+	hgui_headless_click(find_control("go")->hwnd);
+	hgui.run();
+	CHECK(loops == 1 && resumed == 1 && rethrown == 1 && delayed == 1);
+	CHECK(strcmp(hgui.getTextView("status"), "完成") == 0);
+	CHECK(ended == 0);
+
+	// 第二次点击后删除按钮
+	hgui.schedule.after(1, click_later, NULL);
+	hgui.schedule.after(100, remove_later, NULL);
+	hgui.run();
+	CHECK(loops == 2 && resumed == 2 && rethrown == 2 && delayed == 2);
+	CHECK(ended == 1);
+	TEST_TEARDOWN();
+}
+
+static int context_resumed;
+
+static hgui_co::task single_flow(HGUI_Context* context) {
+	CHECK(co_await hgui_co::clicked("go"));
+	int value = co_await hgui_co::background([] { return 42; });
+	CHECK(hgui.context.current() == context);
+	CHECK(value == 42);
+	hgui.setText("status", "完成");
+	context_resumed++;
+}
+
+// 同一线程：默认上下文之外的上下文中等待后台任务
+static void test_same_thread(void) {
+	hgui.init();
+	hgui.create.window("main", "默认", 0, 0, 200, 100);
+
+	HGUI_Context* context = hgui.context.create();
+	HGUI_Context* previous = hgui.context.makeCurrent(context);
+	hgui.init();
+	hgui.create.window("main", "协程", 0, 0, 200, 100);
+	hgui.create.button("go", "main", "开始", 0, 0, 80, 24);
+	hgui.create.label("status", "main", "", 0, 30, 80, 24);
+	single_flow(context);
+	hgui_headless_click(find_control("go")->hwnd);
+	hgui.run();
+	CHECK(context_resumed == 1);
+	CHECK(strcmp(hgui.getTextView("status"), "完成") == 0);
+
+	// 恢复操作没有落到默认上下文的队列中
+	hgui.context.makeCurrent(previous);
+	CHECK(hgui.context.current() == &default_context);
+	CHECK(default_context.op_queue_head == NULL);
+	CHECK(!find_control("status"));
+	hgui.context.destroy(context);
+	TEST_TEARDOWN();
+}
+
+struct ui_thread_state {
+	HGUI_Context* context = nullptr;
+	std::thread::id thread;
+	int rounds = 0;
+	int expected_sum = 0;
+	int sum = 0;
+};
+
+static hgui_co::task thread_flow(ui_thread_state* state, int base) {
+	for (int i = 0; i < ROUNDS; i++) {
+		int value = co_await hgui_co::background([base, i] { return base + i; });
+		// 每次都在本线程、本上下文中恢复
+		CHECK(std::this_thread::get_id() == state->thread);
+		CHECK(hgui.context.current() == state->context);
+		state->sum += value;
+		state->rounds++;
+		co_await hgui_co::next_frame();
+	}
+	hgui.setText("status", "完成");
+}
+
+static void ui_thread(ui_thread_state* state, int base) {
+	state->thread = std::this_thread::get_id();
+	state->context = hgui.context.create();
+	hgui.context.makeCurrent(state->context);
+	hgui.init();
+	hgui.create.window("main", "线程", 0, 0, 200, 100);
+	hgui.create.label("status", "main", "", 0, 0, 80, 24);
+	for (int i = 0; i < ROUNDS; i++) state->expected_sum += base + i;
+	thread_flow(state, base);
+	hgui.run();
+	CHECK(state->rounds == ROUNDS);
+	CHECK(strcmp(hgui.getTextView("status"), "完成") == 0);
+	hgui.context.destroy(state->context);
+	hgui_headless_reset();
+}
+
+// 两个UI线程：协程各自在自己的上下文中恢复
+static void test_two_threads(void) {
+	ui_thread_state first, second;
+	std::thread a(ui_thread, &first, 1000);
+	std::thread b(ui_thread, &second, 2000);
+	a.join();
+	b.join();
+	CHECK(first.sum == first.expected_sum);
+	CHECK(second.sum == second.expected_sum);
+	CHECK(default_context.op_queue_head == NULL);
+}
+
+int main(void) {
+	test_click_loop();
+	test_same_thread();
+	test_two_threads();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,238 @@
+// 差异测试：差异段能把旧序列还原为新序列且编辑数最少、超出预算时整体替换，100万行中分散的修改
+// 只产生对应的段；以及setItems只插入/删除变化的行并保持选中行与滚动位置
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define SMALL_ROUNDS 2000
+#define LARGE_ROWS 1000000
+#define LARGE_EDITS 200
+#define LIST_ROWS 20000
+
+static uint32_t seed = 1234567u;
+
+static uint32_t next_random(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+typedef struct {
+	const int* old_items;
+	const int* new_items;
+	int comparisons;
+} IntPair;
+
+static bool int_equal(int old_index, int new_index, void* context) {
+	IntPair* pair = (IntPair*)context;
+	pair->comparisons++;
+	return pair->old_items[old_index] == pair->new_items[new_index];
+}
+
+// 按差异段把旧序列改写为新序列并与新序列比较；段按位置升序且互不相邻
+static bool diff_reproduces(const HGUI_Diff* diff, const int* old_items, int old_count, const int* new_items, int new_count) {
+	int old_index = 0, new_index = 0;
+	for (int h = 0; h < diff->count; h++) {
+		const HGUI_DiffHunk* hunk = &diff->hunks[h];
+		if (hunk->old_start < old_index || (h > 0 && hunk->old_start == old_index)) return false;
+		if (hunk->old_count == 0 && hunk->new_count == 0) return false;
+		// 两段之间的部分保持不变
+		if (hunk->old_start - old_index != hunk->new_start - new_index) return false;
+		while (old_index < hunk->old_start) {
+			if (old_items[old_index++] != new_items[new_index++]) return false;
+		}
+		old_index += hunk->old_count;
+		new_index += hunk->new_count;
+	}
+	if (old_count - old_index != new_count - new_index) return false;
+	while (old_index < old_count) {
+		if (old_items[old_index++] != new_items[new_index++]) return false;
+	}
+	return true;
+}
+
+// 最长公共子序列的长度（动态规划），最少编辑数为 n+m-2*LCS
+static int lcs_length(const int* a, int n, const int* b, int m) {
+	static int table[41][41];
+	for (int i = 0; i <= n; i++) {
+		for (int j = 0; j <= m; j++) {
+			if (i == 0 || j == 0) table[i][j] = 0;
+			else if (a[i - 1] == b[j - 1]) table[i][j] = table[i - 1][j - 1] + 1;
+			else table[i][j] = table[i - 1][j] > table[i][j - 1] ? table[i - 1][j] : table[i][j - 1];
+		}
+	}
+	return table[n][m];
+}
+
+static void test_small(void) {
+	HGUI_Diff diff;
+	memset(&diff, 0, sizeof(diff));
+	int a[40], b[40];
+	for (int round = 0; round < SMALL_ROUNDS; round++) {
+		int n = (int)(next_random() % 41);
+		int m = (int)(next_random() % 41);
+		int alphabet = 1 + (int)(next_random() % 6);
+		for (int i = 0; i < n; i++) a[i] = (int)(next_random() % (uint32_t)alphabet);
+		for (int j = 0; j < m; j++) b[j] = (int)(next_random() % (uint32_t)alphabet);
+		IntPair pair = { a, b, 0 };
+		CHECK(hgui_diff_compute(&diff, n, m, int_equal, &pair, 0));
+		CHECK(!diff.over_budget);
+		CHECK(diff_reproduces(&diff, a, n, b, m));
+		CHECK(diff.deleted + diff.inserted == n + m - 2 * lcs_length(a, n, b, m));
+	}
+
+	// 超出预算：结果仍然正确，中间部分整体替换为一段
+	for (int i = 0; i < 40; i++) {
+		a[i] = i;
+		b[i] = i % 2 == 0 ? i : 100 + i;
+	}
+	IntPair pair = { a, b, 0 };
+	CHECK(hgui_diff_compute(&diff, 40, 40, int_equal, &pair, 4));
+	CHECK(diff.over_budget && diff.count == 1);
+	CHECK(diff.hunks[0].old_start == 1 && diff.hunks[0].old_count == 39 && diff.hunks[0].new_count == 39);
+	CHECK(diff_reproduces(&diff, a, 40, b, 40));
+	CHECK(hgui_diff_compute(&diff, 40, 40, int_equal, &pair, 0));
+	CHECK(!diff.over_budget && diff.count == 20 && diff.deleted == 20 && diff.inserted == 20);
+
+	// 位置换算：第2项被删除，第5项之前插入两项
+	int old_items[] = { 0, 1, 2, 3, 4, 5, 6 };
+	int new_items[] = { 0, 1, 3, 4, 7, 8, 5, 6 };
+	IntPair map_pair = { old_items, new_items, 0 };
+	CHECK(hgui_diff_compute(&diff, 7, 8, int_equal, &map_pair, 0));
+	CHECK(diff.count == 2);
+	CHECK(hgui_diff_map(&diff, 1, false, 8) == 1);
+	CHECK(hgui_diff_map(&diff, 2, false, 8) == -1);
+	CHECK(hgui_diff_map(&diff, 2, true, 8) == 2);
+	CHECK(hgui_diff_map(&diff, 3, false, 8) == 2);
+	CHECK(hgui_diff_map(&diff, 5, false, 8) == 6);
+	CHECK(hgui_diff_map(&diff, 6, false, 8) == 7);
+	hgui_diff_free(&diff);
+}
+
+// 100万行中分散的修改：每处修改成为一段，比较次数不随行数与修改数的乘积增长
+static void test_large(void) {
+	int* old_items = (int*)malloc(LARGE_ROWS * sizeof(int));
+	int* new_items = (int*)malloc((LARGE_ROWS + LARGE_EDITS) * sizeof(int));
+	CHECK(old_items && new_items);
+	for (int i = 0; i < LARGE_ROWS; i++) old_items[i] = i;
+
+	// 每隔5000行依次替换一行、删除一行或插入一行
+	int new_count = 0, replaced = 0, removed = 0, added = 0;
+	for (int i = 0; i < LARGE_ROWS; i++) {
+		int edit = i % (LARGE_ROWS / LARGE_EDITS) == 2500 ? (i / (LARGE_ROWS / LARGE_EDITS)) % 3 : -1;
+		if (edit == 0) {
+			new_items[new_count++] = -1 - i;
+			replaced++;
+		} else if (edit == 1) {
+			removed++;
+		} else {
+			if (edit == 2) {
+				new_items[new_count++] = -1 - i;
+				added++;
+			}
+			new_items[new_count++] = old_items[i];
+		}
+	}
+	CHECK(replaced + removed + added == LARGE_EDITS);
+
+	HGUI_Diff diff;
+	memset(&diff, 0, sizeof(diff));
+	IntPair pair = { old_items, new_items, 0 };
+	CHECK(hgui_diff_compute(&diff, LARGE_ROWS, new_count, int_equal, &pair, 0));
+	CHECK(!diff.over_budget);
+	CHECK(diff.count == LARGE_EDITS);
+	CHECK(diff.deleted == replaced + removed && diff.inserted == replaced + added);
+	CHECK(diff_reproduces(&diff, old_items, LARGE_ROWS, new_items, new_count));
+	// 行各不相同时只有正确的对角线能延伸，比较次数接近行数加编辑数的平方
+	CHECK(pair.comparisons < 2 * LARGE_ROWS);
+
+	// 没有变化时只比较一遍前缀
+	pair.new_items = old_items;
+	pair.comparisons = 0;
+	CHECK(hgui_diff_compute(&diff, LARGE_ROWS, LARGE_ROWS, int_equal, &pair, 0));
+	CHECK(diff.count == 0 && pair.comparisons == LARGE_ROWS);
+	hgui_diff_free(&diff);
+	free(old_items);
+	free(new_items);
+}
+
+static int list_count(HWND hwnd) {
+	return (int)SendMessage(hwnd, LB_GETCOUNT, 0, 0);
+}
+
+// setItems：只应用差异，选中行与顶行随内容移动；选中行被删除时取消选中
+static void test_set_items(void) {
+	static char texts[LIST_ROWS + 10][16];
+	static const char* rows[LIST_ROWS + 10];
+	for (int i = 0; i < LIST_ROWS + 10; i++) {
+		snprintf(texts[i], sizeof(texts[i]), "row%d", i);
+		rows[i] = texts[i];
+	}
+
+	hgui.init();
+	hgui.create.window("main", "列表", 0, 0, 320, 240);
+	hgui.create.listbox("items", "main", 0, 0, 200, 200);
+	HWND hwnd = find_control("items")->hwnd;
+
+	HGUI_ListUpdate update;
+	CHECK(hgui.setItems("items", rows, LIST_ROWS, &update));
+	CHECK(update.inserted == LIST_ROWS && update.deleted == 0 && update.hunks == 1);
+	CHECK(list_count(hwnd) == LIST_ROWS);
+
+	hgui_headless_select(hwnd, 10000, false);
+	SendMessage(hwnd, LB_SETTOPINDEX, 9990, 0);
+
+	// 开头插入3行、第5000行之后删除2行：选中行与顶行下移1行
+	static const char* next[LIST_ROWS + 10];
+	int count = 0;
+	next[count++] = "new-a";
+	next[count++] = "new-b";
+	next[count++] = "new-c";
+	for (int i = 0; i < LIST_ROWS; i++) {
+		if (i == 5000 || i == 5001) continue;
+		next[count++] = rows[i];
+	}
+	HGUI_HeadlessStats before, after;
+	hgui_headless_stats(&before);
+	CHECK(hgui.setItems("items", next, count, &update));
+	hgui_headless_stats(&after);
+	CHECK(update.inserted == 3 && update.deleted == 2 && update.hunks == 2 && !update.over_budget);
+	CHECK(list_count(hwnd) == count);
+	CHECK(hgui.getSelectedIndex("items") == 10001);
+	CHECK(SendMessage(hwnd, LB_GETTOPINDEX, 0, 0) == 9991);
+	char text[32];
+	hgui.getListItem("items", 10001, text, sizeof(text));
+	CHECK(strcmp(text, "row10000") == 0);
+	hgui.getListItem("items", 1, text, sizeof(text));
+	CHECK(strcmp(text, "new-b") == 0);
+	// 发送的消息数与修改的行数相当，而不是逐行重建
+	CHECK(after.messages_sent - before.messages_sent < 50);
+
+	// 内容不变时不修改列表框
+	CHECK(hgui.setItems("items", next, count, &update));
+	CHECK(update.inserted == 0 && update.deleted == 0 && update.hunks == 0);
+
+	// 选中行被删除时取消选中
+	for (int i = 10001; i < count; i++) next[i] = next[i + 1];
+	count--;
+	CHECK(hgui.setItems("items", next, count, &update));
+	CHECK(update.deleted == 1 && hgui.getSelectedIndex("items") == -1);
+
+	// 其他列表操作之后重新读取列表框的内容作为快照
+	hgui.addItem("items", "tail");
+	next[count++] = "tail";
+	next[count++] = "after-tail";
+	CHECK(hgui.setItems("items", next, count, &update));
+	CHECK(update.inserted == 1 && update.deleted == 0);
+	CHECK(list_count(hwnd) == count);
+
+	TEST_TEARDOWN();
+}
+
+int main(void) {
+	test_small();
+	test_large();
+	test_set_items();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,77 @@
+// WM_COMMAND分发测试：按窗口句柄与菜单ID查表，删除后的控件不再收到事件
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define COUNT 3000
+
+static char last_id[32];
+static int calls;
+
+static void on_click(const char* id) {
+	snprintf(last_id, sizeof(last_id), "%s", id);
+	calls++;
+}
+
+int main(void) {
+	char id[32];
+	hgui.init();
+	hgui.create.window("main", "分发", 0, 0, 320, 240);
+	HWND main_hwnd = find_control("main")->hwnd;
+
+	// 句柄索引经多次扩容后每个按钮都分发到自己的回调
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "btn%d", i);
+		hgui.create.button(id, "main", "b", 0, 0, 10, 10);
+		hgui.bind(id, "click", on_click);
+	}
+	for (int i = COUNT - 1; i >= 0; i--) {
+		snprintf(id, sizeof(id), "btn%d", i);
+		hgui_headless_click(find_control(id)->hwnd);
+		CHECK(strcmp(last_id, id) == 0);
+	}
+	CHECK(calls == COUNT);
+
+	// 删除一半后其余按钮仍能分发，新建的按钮加入索引
+	for (int i = 0; i < COUNT; i += 2) {
+		snprintf(id, sizeof(id), "btn%d", i);
+		hgui.remove(id);
+	}
+	calls = 0;
+	for (int i = 1; i < COUNT; i += 2) {
+		snprintf(id, sizeof(id), "btn%d", i);
+		hgui_headless_click(find_control(id)->hwnd);
+		CHECK(strcmp(last_id, id) == 0);
+	}
+	CHECK(calls == COUNT / 2);
+	hgui.create.button("late", "main", "b", 0, 0, 10, 10);
+	hgui.bind("late", "click", on_click);
+	hgui_headless_click(find_control("late")->hwnd);
+	CHECK(strcmp(last_id, "late") == 0);
+
+	// 菜单命令按菜单ID查表
+	hgui.create.menubar("bar", "main");
+	hgui.create.addMenuItem("bar", "file", "文件", true);
+	hgui.create.addMenuItem("file", "open", "打开", false);
+	hgui.create.addMenuItem("file", "save", "保存", false);
+	hgui.bind("open", "click", on_click);
+	hgui.bind("save", "click", on_click);
+	UINT_PTR open_id = find_control("open")->menu_id;
+	UINT_PTR save_id = find_control("save")->menu_id;
+	CHECK(open_id != save_id);
+	hgui_headless_menu_command(main_hwnd, save_id);
+	CHECK(strcmp(last_id, "save") == 0);
+	hgui_headless_menu_command(main_hwnd, open_id);
+	CHECK(strcmp(last_id, "open") == 0);
+
+	// 已删除的菜单项不再分发
+	calls = 0;
+	hgui.remove("open");
+	hgui_headless_menu_command(main_hwnd, open_id);
+	CHECK(calls == 0);
+	hgui_headless_menu_command(main_hwnd, save_id);
+	CHECK(calls == 1);
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,63 @@
+// 事件订阅测试：多个订阅者按订阅顺序收到事件、分发中退订，以及订阅ID反复复用后不会指向新订阅
+#include "hgui.h"
+#include "hgui_test.h"
+
+static char order[16];
+static int order_length;
+static HGUI_Subscription second;
+
+static void record(HGUI_Handle control, HGUI_Event event, void* user_data) {
+	(void)control;
+	(void)event;
+	order[order_length++] = *(const char*)user_data;
+}
+
+static void record_and_unsubscribe(HGUI_Handle control, HGUI_Event event, void* user_data) {
+	record(control, event, user_data);
+	hgui.unsubscribe(second);
+}
+
+int main(void) {
+	hgui.init();
+	hgui.create.window("main", "事件", 0, 0, 320, 240);
+	HGUI_Handle button = hgui.create.button("ok", "main", "确定", 0, 0, 80, 24);
+	HWND hwnd = find_control("ok")->hwnd;
+
+	// 多个订阅者按订阅顺序收到事件，并带回各自的user_data
+	static const char a = 'a', b = 'b', c = 'c';
+	HGUI_Subscription first = hgui.subscribe("ok", HGUI_EVENT_CLICK, record_and_unsubscribe, (void*)&a);
+	second = hgui.handle.subscribe(button, HGUI_EVENT_CLICK, record, (void*)&b);
+	HGUI_Subscription third = hgui.subscribe("ok", HGUI_EVENT_CLICK, record, (void*)&c);
+	CHECK(first && second && third);
+
+	// 分发中退订后面的订阅者：本次分发不再调用它
+	hgui_headless_click(hwnd);
+	CHECK(order_length == 2 && memcmp(order, "ac", 2) == 0);
+	CHECK(!hgui.unsubscribe(second));
+	order_length = 0;
+	hgui_headless_click(hwnd);
+	CHECK(order_length == 2 && memcmp(order, "ac", 2) == 0);
+	CHECK(hgui.unsubscribe(first) && hgui.unsubscribe(third));
+	order_length = 0;
+	hgui_headless_click(hwnd);
+	CHECK(order_length == 0);
+
+	// 订阅节点反复复用：代数用尽后节点退役，旧ID始终无效
+	HGUI_Subscription stale = hgui.subscribe("ok", HGUI_EVENT_CLICK, record, (void*)&a);
+	CHECK(hgui.unsubscribe(stale));
+	for (int i = 0; i < 10000; i++) {
+		HGUI_Subscription subscription = hgui.subscribe("ok", HGUI_EVENT_CLICK, record, (void*)&b);
+		CHECK(subscription && subscription != stale);
+		CHECK(!hgui.unsubscribe(stale));
+		CHECK(hgui.unsubscribe(subscription));
+	}
+
+	// 控件删除时订阅随之失效
+	HGUI_Subscription last = hgui.subscribe("ok", HGUI_EVENT_CLICK, record, (void*)&a);
+	hgui.remove("ok");
+	CHECK(!hgui.unsubscribe(last));
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,71 @@
+// 字体缓存测试：相同特征的字体共享一个对象，引用归零时删除
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define COUNT 200
+
+static unsigned long fonts_alive(void) {
+	HGUI_HeadlessStats stats;
+	hgui_headless_stats(&stats);
+	return stats.fonts_alive;
+}
+
+int main(void) {
+	char id[32];
+	HGUI_MemoryStats memory;
+	hgui.init();
+	hgui.create.window("main", "字体", 0, 0, 320, 240);
+
+	// 大量控件使用相同字体只创建一个字体对象
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "label%d", i);
+		hgui.create.label(id, "main", "x", 0, 0, 10, 10);
+		hgui.setFont(id, "宋体", 14, 400, false);
+	}
+	CHECK(fonts_alive() == 1);
+	CHECK(find_control("label0")->base_font == find_control("label1")->base_font);
+	hgui.memoryStats(&memory);
+	CHECK(memory.fonts == 1);
+	CHECK(memory.total.font_refs == 2 * COUNT);   // 每个控件持有基础字体与当前字体各一个引用
+
+	// 不同特征各自一个对象；重复设置相同字体不增加对象
+	hgui.setFont("label0", "宋体", 20, 700, false);
+	hgui.setFont("label1", "宋体", 14, 400, true);
+	hgui.setFont("label2", "宋体", 14, 400, false);
+	CHECK(fonts_alive() == 3);
+
+	// 选中状态的粗体版本同样共享：所有复选框选中时只多出一个粗体对象
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "check%d", i);
+		hgui.create.checkbox(id, "main", "x", 0, 0, 10, 10);
+		hgui.setCheck(id, true);
+	}
+	CHECK(fonts_alive() == 4);
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "check%d", i);
+		hgui.setCheck(id, false);
+	}
+	CHECK(fonts_alive() == 3);
+
+	// 删除最后一个使用者后字体被删除
+	hgui.remove("label0");
+	CHECK(fonts_alive() == 2);
+	hgui.remove("label1");
+	CHECK(fonts_alive() == 1);
+	for (int i = 2; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "label%d", i);
+		hgui.remove(id);
+	}
+	CHECK(fonts_alive() == 0);
+	hgui.memoryStats(&memory);
+	CHECK(memory.fonts == 0 && memory.total.font_refs == 0);
+
+	// cleanup释放仍被引用的字体
+	hgui.create.label("last", "main", "x", 0, 0, 10, 10);
+	hgui.setFont("last", "黑体", 16, 400, false);
+	CHECK(fonts_alive() == 1);
+	TEST_TEARDOWN();
+	CHECK(fonts_alive() == 0);
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,54 @@
+// 控件句柄测试：按句柄操作、删除后失效、节点反复复用后旧句柄仍不会指向新控件
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define CYCLES 10000
+
+int main(void) {
+	hgui.init();
+	HGUI_Handle window = hgui.create.window("main", "句柄", 0, 0, 320, 240);
+	HGUI_Handle label = hgui.create.label("status", "main", "", 0, 0, 100, 20);
+	CHECK(window != HGUI_INVALID_HANDLE && label != HGUI_INVALID_HANDLE);
+	CHECK(hgui.handle.lookup("status") == label);
+	CHECK(hgui.handle.lookup("missing") == HGUI_INVALID_HANDLE);
+	CHECK(!hgui.handle.valid(HGUI_INVALID_HANDLE));
+	CHECK(!hgui.handle.valid(0xFFFFFFFFu));
+
+	hgui.handle.setText(label, "就绪");
+	CHECK(strcmp(hgui.handle.getTextView(label), "就绪") == 0);
+
+	// 删除后旧句柄失效，对它的操作被忽略
+	hgui.remove("status");
+	CHECK(!hgui.handle.valid(label));
+	hgui.handle.setText(label, "忽略");
+	CHECK(hgui.handle.getTextView(label) == NULL);
+
+	// cleanup后旧句柄在新的节点池中同样无效
+	hgui.cleanup();
+	hgui.init();
+	HGUI_Handle fresh = hgui.create.window("main", "句柄", 0, 0, 320, 240);
+	CHECK(fresh != window && hgui.handle.valid(fresh));
+	CHECK(!hgui.handle.valid(window));
+
+	// 空闲链表后进先出，同一节点被反复复用：代数用尽后节点退役，旧句柄始终无效
+	HGUI_Handle stale = hgui.create.label("status", "main", "", 0, 0, 100, 20);
+	hgui.remove("status");
+	HGUI_Handle previous = HGUI_INVALID_HANDLE;
+	for (int i = 0; i < CYCLES; i++) {
+		HGUI_Handle current = hgui.create.label("churn", "main", "x", 0, 0, 10, 10);
+		CHECK(current != HGUI_INVALID_HANDLE && current != stale && current != previous);
+		CHECK(!hgui.handle.valid(stale));
+		CHECK(previous == HGUI_INVALID_HANDLE || !hgui.handle.valid(previous));
+		hgui.remove("churn");
+		previous = current;
+	}
+
+	// 退役的节点只占用少量新槽位
+	HGUI_MemoryStats stats;
+	hgui.memoryStats(&stats);
+	CHECK(stats.node_bytes <= 2 * 256 * sizeof(HGUI_Control));
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,41 @@
+// 无界面后端冒烟测试：创建、查询、事件、投递与清理的基本流程
+#include "hgui.h"
+#include "hgui_test.h"
+
+static int clicks;
+
+static void on_click(const char* id) {
+	(void)id;
+	clicks++;
+}
+
+int main(void) {
+	hgui.init();
+	HGUI_Handle window = hgui.create.window("main", "冒烟测试", 0, 0, 320, 240);
+	HGUI_Handle button = hgui.create.button("ok", "main", "确定", 10, 10, 80, 24);
+	hgui.create.input("name", "main", 10, 40, 120, 24);
+	CHECK(window && button && window != button);
+	CHECK(hgui.handle.lookup("ok") == button);
+	CHECK(hgui.handle.valid(button));
+
+	// 事件经父窗口的WM_COMMAND分发到回调
+	hgui.bind("ok", "click", on_click);
+	hgui_headless_click(find_control("ok")->hwnd);
+	CHECK(clicks == 1);
+
+	// 投递的更新在消息循环中生效
+	hgui.post.setText("name", "张三");
+	hgui.run();
+	CHECK(strcmp(hgui.getTextView("name"), "张三") == 0);
+
+	hgui.remove("ok");
+	CHECK(!find_control("ok"));
+	CHECK(!hgui.handle.valid(button));
+
+	HGUI_HeadlessStats stats;
+	TEST_TEARDOWN();
+	hgui_headless_stats(&stats);
+	CHECK(stats.windows_alive == 0);
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,62 @@
+// ID索引测试：查找、扩容、删除后移与重复ID的遮蔽
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define COUNT 5000
+
+int main(void) {
+	char id[32];
+	hgui.init();
+	hgui.create.window("main", "索引", 0, 0, 320, 240);
+
+	// 多次扩容后全部可查，删除一半后其余仍可查（后移删除不能断开探测链）
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "item%d", i);
+		CHECK(hgui.create.label(id, "main", "x", 0, 0, 10, 10));
+	}
+	for (int i = 0; i < COUNT; i += 2) {
+		snprintf(id, sizeof(id), "item%d", i);
+		hgui.remove(id);
+	}
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "item%d", i);
+		HGUI_Control* control = find_control(id);
+		CHECK(i % 2 ? control && strcmp(control->id, id) == 0 : control == NULL);
+	}
+	CHECK(!find_control("missing"));
+	CHECK(!find_control(NULL));
+
+	// 重复ID：最新的控件优先，删除后较早的同名控件重新可见
+	HGUI_Handle first = hgui.create.label("dup", "main", "1", 0, 0, 10, 10);
+	HGUI_Handle second = hgui.create.label("dup", "main", "2", 0, 0, 10, 10);
+	HGUI_Handle third = hgui.create.label("dup", "main", "3", 0, 0, 10, 10);
+	CHECK(hgui.handle.lookup("dup") == third);
+	hgui.remove("dup");
+	CHECK(hgui.handle.lookup("dup") == second);
+	CHECK(strcmp(hgui.getTextView("dup"), "2") == 0);
+	hgui.remove("dup");
+	CHECK(hgui.handle.lookup("dup") == first);
+	hgui.remove("dup");
+	CHECK(!find_control("dup"));
+
+	// 删除父控件时一并删除被遮蔽的同名子控件，遮蔽链保持完整
+	first = hgui.create.label("dup", "main", "1", 0, 0, 10, 10);
+	hgui.create.box("group", "main");
+	second = hgui.create.label("dup", "group", "2", 0, 0, 10, 10);
+	third = hgui.create.label("dup", "main", "3", 0, 0, 10, 10);
+	hgui.remove("group");
+	CHECK(!hgui.handle.valid(second));
+	CHECK(hgui.handle.lookup("dup") == third);
+	hgui.remove("dup");
+	CHECK(hgui.handle.lookup("dup") == first);
+
+	// 删除后再创建同名控件不会复活旧句柄
+	hgui.remove("dup");
+	HGUI_Handle again = hgui.create.label("dup", "main", "4", 0, 0, 10, 10);
+	CHECK(again != first && !hgui.handle.valid(first));
+	CHECK(hgui.handle.lookup("dup") == again);
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,389 @@
+// 布局测试：弹性与网格排布的结果、增量布局只重算受影响的部分且与从头布局的结果相同，
+// 以及窗口大小变化时控件在一批DeferWindowPos中移动
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define RANDOM_NODES 400
+#define RANDOM_STEPS 300
+#define DEEP 100000
+
+static uint32_t seed = 88172645u;
+
+static uint32_t next_random(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+static HGUI_LayoutStyle leaf(int width, int height) {
+	HGUI_LayoutStyle style;
+	memset(&style, 0, sizeof(style));
+	style.width = width;
+	style.height = height;
+	return style;
+}
+
+static HGUI_LayoutStyle container(HGUI_LayoutKind kind) {
+	HGUI_LayoutStyle style = leaf(HGUI_LAYOUT_AUTO, HGUI_LAYOUT_AUTO);
+	style.kind = kind;
+	return style;
+}
+
+static bool node_is(const HGUI_Layout* layout, HGUI_LayoutId id, int x, int y, int width, int height) {
+	const HGUI_LayoutNode* node = hgui_layout_node(layout, id);
+	return node->x == x && node->y == y && node->width == width && node->height == height;
+}
+
+static void test_flex(void) {
+	HGUI_Layout layout;
+	hgui_layout_init(&layout);
+
+	// 行：固定尺寸的子节点按首选尺寸排列，剩余空间按grow比例分配，交叉轴默认拉伸
+	HGUI_LayoutStyle style = container(HGUI_LAYOUT_ROW);
+	style.padding = 10;
+	style.gap = 5;
+	HGUI_LayoutId row = hgui_layout_add(&layout, HGUI_LAYOUT_NO_NODE, &style, NULL);
+	HGUI_LayoutStyle a = leaf(50, HGUI_LAYOUT_AUTO);
+	HGUI_LayoutStyle b = leaf(0, HGUI_LAYOUT_AUTO);
+	b.grow = 1;
+	HGUI_LayoutStyle c = leaf(30, 20);
+	c.grow = 2;
+	HGUI_LayoutId ia = hgui_layout_add(&layout, row, &a, NULL);
+	HGUI_LayoutId ib = hgui_layout_add(&layout, row, &b, NULL);
+	HGUI_LayoutId ic = hgui_layout_add(&layout, row, &c, NULL);
+	CHECK(hgui_layout_compute(&layout, row, 0, 0, 300, 100));
+	CHECK(node_is(&layout, row, 0, 0, 300, 100));
+	CHECK(node_is(&layout, ia, 10, 10, 50, 80));
+	CHECK(node_is(&layout, ib, 65, 10, 63, 80));
+	CHECK(node_is(&layout, ic, 133, 10, 157, 20));
+	// 首选尺寸：内容加内边距
+	CHECK(hgui_layout_node(&layout, row)->measured_width == 50 + 0 + 30 + 2 * 5 + 2 * 10);
+	CHECK(hgui_layout_node(&layout, row)->measured_height == 20 + 2 * 10);
+
+	// 空间不足时按 shrink*首选尺寸 收缩，最小值约束优先
+	style = container(HGUI_LAYOUT_ROW);
+	hgui_layout_set_style(&layout, row, &style);
+	a = leaf(100, 10);
+	a.shrink = 1;
+	b = leaf(300, 10);
+	b.shrink = 1;
+	c = leaf(100, 10);
+	c.shrink = 1;
+	c.min_width = 90;
+	hgui_layout_set_style(&layout, ia, &a);
+	hgui_layout_set_style(&layout, ib, &b);
+	hgui_layout_set_style(&layout, ic, &c);
+	CHECK(hgui_layout_compute(&layout, row, 0, 0, 400, 10));
+	CHECK(node_is(&layout, ia, 0, 0, 80, 10));
+	CHECK(node_is(&layout, ib, 80, 0, 240, 10));
+	CHECK(node_is(&layout, ic, 320, 0, 90, 10));
+
+	// 列：没有grow时按justify分布，交叉轴按align对齐
+	style = container(HGUI_LAYOUT_COLUMN);
+	style.justify = HGUI_JUSTIFY_SPACE_BETWEEN;
+	style.align = HGUI_ALIGN_CENTER;
+	hgui_layout_set_style(&layout, row, &style);
+	a = leaf(20, 10);
+	b = leaf(40, 10);
+	b.margin = 2;
+	c = leaf(HGUI_LAYOUT_AUTO, 10);
+	c.max_width = 30;
+	hgui_layout_set_style(&layout, ia, &a);
+	hgui_layout_set_style(&layout, ib, &b);
+	hgui_layout_set_style(&layout, ic, &c);
+	CHECK(hgui_layout_compute(&layout, row, 0, 0, 100, 100));
+	CHECK(node_is(&layout, ia, 40, 0, 20, 10));
+	CHECK(node_is(&layout, ib, 30, 45, 40, 10));
+	CHECK(node_is(&layout, ic, 50, 90, 0, 10));
+
+	style.justify = HGUI_JUSTIFY_END;
+	style.align = HGUI_ALIGN_STRETCH;
+	hgui_layout_set_style(&layout, row, &style);
+	CHECK(hgui_layout_compute(&layout, row, 0, 0, 100, 100));
+	CHECK(node_is(&layout, ia, 0, 66, 20, 10));
+	CHECK(node_is(&layout, ib, 2, 78, 40, 10));
+	CHECK(node_is(&layout, ic, 0, 90, 30, 10));
+	hgui_layout_destroy(&layout);
+}
+
+static void test_grid(void) {
+	HGUI_Layout layout;
+	hgui_layout_init(&layout);
+
+	// 3列网格：列宽均分，余数分给前面的列；行高取该行最高的子节点
+	HGUI_LayoutStyle style = container(HGUI_LAYOUT_GRID);
+	style.columns = 3;
+	style.gap = 2;
+	style.padding = 1;
+	HGUI_LayoutId grid = hgui_layout_add(&layout, HGUI_LAYOUT_NO_NODE, &style, NULL);
+	HGUI_LayoutId cells[5];
+	for (int i = 0; i < 5; i++) {
+		HGUI_LayoutStyle cell = leaf(HGUI_LAYOUT_AUTO, 10 + i * 5);
+		cells[i] = hgui_layout_add(&layout, grid, &cell, NULL);
+	}
+	CHECK(hgui_layout_compute(&layout, grid, 0, 0, 104, 200));
+	CHECK(node_is(&layout, cells[0], 1, 1, 33, 10));
+	CHECK(node_is(&layout, cells[1], 36, 1, 33, 15));
+	CHECK(node_is(&layout, cells[2], 71, 1, 32, 20));
+	CHECK(node_is(&layout, cells[3], 1, 23, 33, 25));
+	CHECK(node_is(&layout, cells[4], 36, 23, 33, 30));
+	CHECK(hgui_layout_node(&layout, grid)->measured_height == 20 + 30 + 2 + 2 * 1);
+	hgui_layout_destroy(&layout);
+}
+
+// 增量布局：不变时整棵跳过，修改一个叶子只重新测量它的祖先，平移的子树直接偏移
+static void test_incremental(void) {
+	HGUI_Layout layout;
+	hgui_layout_init(&layout);
+	HGUI_LayoutStyle column = container(HGUI_LAYOUT_COLUMN);
+	HGUI_LayoutStyle row = container(HGUI_LAYOUT_ROW);
+	HGUI_LayoutId root = hgui_layout_add(&layout, HGUI_LAYOUT_NO_NODE, &column, NULL);
+	HGUI_LayoutId rows[100], first_leaf = HGUI_LAYOUT_NO_NODE, last_leaf = HGUI_LAYOUT_NO_NODE;
+	for (int r = 0; r < 100; r++) {
+		rows[r] = hgui_layout_add(&layout, root, &row, NULL);
+		for (int i = 0; i < 100; i++) {
+			HGUI_LayoutStyle cell = leaf(8, 8);
+			last_leaf = hgui_layout_add(&layout, rows[r], &cell, NULL);
+			if (!first_leaf) first_leaf = last_leaf;
+		}
+	}
+	const unsigned int nodes = 1 + 100 + 100 * 100;
+	CHECK(hgui_layout_compute(&layout, root, 0, 0, 1000, 1000));
+	CHECK(layout.stats.measured == nodes);
+	CHECK(hgui_layout_take_changed(&layout, NULL, NULL) == nodes);
+
+	// 没有变化时只访问根
+	memset(&layout.stats, 0, sizeof(layout.stats));
+	CHECK(hgui_layout_compute(&layout, root, 0, 0, 1000, 1000));
+	CHECK(layout.stats.measured == 0 && layout.stats.laid_out == 0 && layout.stats.skipped == 1);
+	CHECK(hgui_layout_take_changed(&layout, NULL, NULL) == 0);
+
+	// 第一行的第一个叶子变高：重新测量它、所在行与根；后面各行只是下移
+	HGUI_LayoutStyle taller = leaf(8, 20);
+	hgui_layout_set_style(&layout, first_leaf, &taller);
+	memset(&layout.stats, 0, sizeof(layout.stats));
+	CHECK(hgui_layout_compute(&layout, root, 0, 0, 1000, 1000));
+	CHECK(layout.stats.measured == 3);
+	CHECK(layout.stats.translated == 99);
+	CHECK(node_is(&layout, first_leaf, 0, 0, 8, 20));
+	CHECK(node_is(&layout, last_leaf, 99 * 8, 20 + 98 * 8, 8, 8));
+	// 第一行中只有变高的叶子与该行本身变化（其余叶子高度固定），后面99行各101个节点平移
+	CHECK(hgui_layout_take_changed(&layout, NULL, NULL) == 2 + 99 * 101);
+
+	// 根整体平移时整棵树偏移坐标，不重新排布
+	memset(&layout.stats, 0, sizeof(layout.stats));
+	CHECK(hgui_layout_compute(&layout, root, 5, 7, 1000, 1000));
+	CHECK(layout.stats.translated == 1 && layout.stats.laid_out == 0 && layout.stats.measured == 0);
+	CHECK(node_is(&layout, last_leaf, 5 + 99 * 8, 7 + 20 + 98 * 8, 8, 8));
+
+	// 删除子树后槽位被复用，变化列表中已删除的节点被过滤
+	hgui_layout_remove(&layout, rows[0]);
+	CHECK(!hgui_layout_node(&layout, first_leaf)->alive);
+	CHECK(hgui_layout_compute(&layout, root, 0, 0, 1000, 1000));
+	CHECK(node_is(&layout, last_leaf, 99 * 8, 98 * 8, 8, 8));
+	unsigned int count = layout.count;
+	for (int i = 0; i < 101; i++) hgui_layout_add(&layout, root, &row, NULL);
+	CHECK(layout.count == count);
+	hgui_layout_destroy(&layout);
+}
+
+// 极深的树：测量与排布都不使用递归
+static void test_deep(void) {
+	HGUI_Layout layout;
+	hgui_layout_init(&layout);
+	HGUI_LayoutStyle style = container(HGUI_LAYOUT_COLUMN);
+	style.padding = 0;
+	HGUI_LayoutId root = hgui_layout_add(&layout, HGUI_LAYOUT_NO_NODE, &style, NULL);
+	HGUI_LayoutId id = root;
+	for (int i = 0; i < DEEP; i++) id = hgui_layout_add(&layout, id, &style, NULL);
+	HGUI_LayoutStyle tip = leaf(3, 4);
+	HGUI_LayoutId bottom = hgui_layout_add(&layout, id, &tip, NULL);
+	CHECK(hgui_layout_compute(&layout, root, 1, 2, 50, 60));
+	CHECK(hgui_layout_node(&layout, root)->measured_width == 3 && hgui_layout_node(&layout, root)->measured_height == 4);
+	CHECK(node_is(&layout, bottom, 1, 2, 3, 4));
+	hgui_layout_remove(&layout, root);
+	CHECK(!hgui_layout_node(&layout, bottom)->alive);
+	hgui_layout_destroy(&layout);
+}
+
+// 随机的树与修改：每次增量布局的结果都与按同样样式从头布局的结果相同
+static HGUI_LayoutStyle random_style(bool container_allowed) {
+	static const HGUI_LayoutKind kinds[] = { HGUI_LAYOUT_LEAF, HGUI_LAYOUT_ROW, HGUI_LAYOUT_COLUMN, HGUI_LAYOUT_GRID };
+	HGUI_LayoutStyle style;
+	memset(&style, 0, sizeof(style));
+	style.kind = container_allowed ? kinds[next_random() % 4] : HGUI_LAYOUT_LEAF;
+	style.width = next_random() % 3 == 0 ? (int)(next_random() % 60) : HGUI_LAYOUT_AUTO;
+	style.height = next_random() % 3 == 0 ? (int)(next_random() % 60) : HGUI_LAYOUT_AUTO;
+	if (next_random() % 4 == 0) style.min_width = (int)(next_random() % 30);
+	if (next_random() % 4 == 0) style.max_height = 1 + (int)(next_random() % 80);
+	style.grow = (float)(next_random() % 3);
+	style.shrink = (float)(next_random() % 2);
+	style.margin = (int)(next_random() % 4);
+	style.padding = (int)(next_random() % 4);
+	style.gap = (int)(next_random() % 5);
+	style.align = (HGUI_LayoutAlign)(next_random() % 4);
+	style.justify = (HGUI_LayoutJustify)(next_random() % 4);
+	style.columns = 1 + (int)(next_random() % 4);
+	return style;
+}
+
+static HGUI_LayoutId copy_tree(const HGUI_Layout* from, HGUI_LayoutId id, HGUI_Layout* to, HGUI_LayoutId parent, HGUI_LayoutId* mapping) {
+	const HGUI_LayoutNode* node = hgui_layout_node(from, id);
+	mapping[id] = hgui_layout_add(to, parent, &node->style, NULL);
+	for (HGUI_LayoutId c = node->first_child; c; c = hgui_layout_node(from, c)->next_sibling) {
+		copy_tree(from, c, to, mapping[id], mapping);
+	}
+	return mapping[id];
+}
+
+static void test_random(void) {
+	HGUI_Layout layout;
+	hgui_layout_init(&layout);
+	HGUI_LayoutStyle root_style = container(HGUI_LAYOUT_COLUMN);
+	HGUI_LayoutId root = hgui_layout_add(&layout, HGUI_LAYOUT_NO_NODE, &root_style, NULL);
+	for (int i = 0; i < RANDOM_NODES; i++) {
+		HGUI_LayoutId parent = 1 + next_random() % layout.count;
+		if (hgui_layout_node(&layout, parent)->style.kind == HGUI_LAYOUT_LEAF) parent = root;
+		HGUI_LayoutStyle style = random_style(true);
+		hgui_layout_add(&layout, parent, &style, NULL);
+	}
+
+	static HGUI_LayoutId mapping[RANDOM_NODES * 4];
+	for (int step = 0; step < RANDOM_STEPS; step++) {
+		int width = 200 + (int)(next_random() % 400);
+		int height = 200 + (int)(next_random() % 400);
+		CHECK(hgui_layout_compute(&layout, root, (int)(next_random() % 3), 0, width, height));
+		hgui_layout_take_changed(&layout, NULL, NULL);
+
+		HGUI_Layout fresh;
+		hgui_layout_init(&fresh);
+		HGUI_LayoutId fresh_root = copy_tree(&layout, root, &fresh, HGUI_LAYOUT_NO_NODE, mapping);
+		CHECK(hgui_layout_compute(&fresh, fresh_root, hgui_layout_node(&layout, root)->x, 0, width, height));
+		for (HGUI_LayoutId id = root; id; id = layout_next_preorder(&layout, id, root)) {
+			const HGUI_LayoutNode* node = hgui_layout_node(&layout, id);
+			CHECK(node_is(&fresh, mapping[id], node->x, node->y, node->width, node->height));
+		}
+		hgui_layout_destroy(&fresh);
+
+		// 随机修改：改样式、加节点或删除子树
+		HGUI_LayoutId target = 1 + next_random() % layout.count;
+		if (!hgui_layout_node(&layout, target)->alive) continue;
+		switch (next_random() % 3) {
+			case 0: {
+				HGUI_LayoutStyle style = random_style(hgui_layout_node(&layout, target)->first_child == HGUI_LAYOUT_NO_NODE);
+				if (hgui_layout_node(&layout, target)->first_child) style.kind = hgui_layout_node(&layout, target)->style.kind;
+				if (target == root) style.kind = HGUI_LAYOUT_COLUMN;
+				hgui_layout_set_style(&layout, target, &style);
+				break;
+			}
+			case 1:
+				if (hgui_layout_node(&layout, target)->style.kind != HGUI_LAYOUT_LEAF && layout.count < RANDOM_NODES * 4 - 1) {
+					HGUI_LayoutStyle style = random_style(true);
+					hgui_layout_add(&layout, target, &style, NULL);
+				}
+				break;
+			default:
+				if (target != root) hgui_layout_remove(&layout, target);
+				break;
+		}
+	}
+	hgui_layout_destroy(&layout);
+}
+
+static RECT client_rect(const char* id) {
+	RECT window, rect;
+	GetWindowRect(find_control("main")->hwnd, &window);
+	GetWindowRect(find_control(id)->hwnd, &rect);
+	rect.left -= window.left;
+	rect.right -= window.left;
+	rect.top -= window.top;
+	rect.bottom -= window.top;
+	return rect;
+}
+
+static bool rect_is(RECT rect, int x, int y, int width, int height) {
+	return rect.left == x && rect.top == y && rect.right - rect.left == width && rect.bottom - rect.top == height;
+}
+
+// 窗口布局：列表占满剩余宽度、按钮列在右侧；窗口大小变化时立即重新布局，只移动结果变化的控件
+static void test_window(void) {
+	hgui.init();
+	hgui.create.window("main", "布局", 0, 0, 600, 400);
+	hgui.create.listbox("items", "main", 0, 0, 200, 100);
+	hgui.create.box("side", "main");
+	hgui.create.button("ok", "side", "确定", 0, 0, 100, 30);
+	hgui.create.button("cancel", "side", "取消", 0, 0, 100, 30);
+	hgui.create.label("loose", "main", "", 0, 0, 10, 10);
+
+	HGUI_LayoutStyle row = container(HGUI_LAYOUT_ROW);
+	row.padding = 10;
+	row.gap = 10;
+	HGUI_LayoutStyle list = leaf(HGUI_LAYOUT_AUTO, HGUI_LAYOUT_AUTO);
+	list.grow = 1;
+	HGUI_LayoutStyle side = container(HGUI_LAYOUT_COLUMN);
+	side.gap = 5;
+	side.align = HGUI_ALIGN_START;
+	HGUI_LayoutStyle fixed = leaf(HGUI_LAYOUT_AUTO, HGUI_LAYOUT_AUTO);
+
+	// 父控件没有布局时不能加入
+	CHECK(!hgui.layout.set("ok", &fixed));
+	CHECK(hgui.layout.set("main", &row));
+	CHECK(hgui.layout.set("items", &list));
+	CHECK(hgui.layout.set("side", &side));
+	CHECK(hgui.layout.set("ok", &fixed));
+	CHECK(hgui.layout.set("cancel", &fixed));
+
+	// 在下一帧应用
+	CHECK(rect_is(client_rect("ok"), 0, 0, 100, 30));
+	hgui.run();
+	CHECK(rect_is(client_rect("items"), 10, 10, 470, 380));
+	CHECK(rect_is(client_rect("ok"), 490, 10, 100, 30));
+	CHECK(rect_is(client_rect("cancel"), 490, 45, 100, 30));
+	CHECK(rect_is(client_rect("loose"), 0, 0, 10, 10));
+
+	// 窗口变宽：列表变宽、按钮右移，三个控件在一批中移动
+	HGUI_HeadlessStats before, after;
+	hgui_headless_stats(&before);
+	SetWindowPos(find_control("main")->hwnd, NULL, 0, 0, 800, 400, SWP_NOMOVE | SWP_NOZORDER);
+	hgui_headless_stats(&after);
+	CHECK(after.window_moves == before.window_moves + 1 + 3);
+	CHECK(rect_is(client_rect("items"), 10, 10, 670, 380));
+	CHECK(rect_is(client_rect("ok"), 690, 10, 100, 30));
+	CHECK(rect_is(client_rect("cancel"), 690, 45, 100, 30));
+
+	// 只改变高度时按钮不动，只有列表移动
+	hgui_headless_stats(&before);
+	SetWindowPos(find_control("main")->hwnd, NULL, 0, 0, 800, 300, SWP_NOMOVE | SWP_NOZORDER);
+	hgui_headless_stats(&after);
+	CHECK(after.window_moves == before.window_moves + 1 + 1);
+	CHECK(rect_is(client_rect("items"), 10, 10, 670, 280));
+
+	// 删除控件后兄弟控件在下一帧重新排列；退出布局的控件保持当前位置
+	hgui.remove("ok");
+	hgui.run();
+	CHECK(rect_is(client_rect("cancel"), 690, 10, 100, 30));
+	hgui.layout.clear("side");
+	SetWindowPos(find_control("main")->hwnd, NULL, 0, 0, 600, 300, SWP_NOMOVE | SWP_NOZORDER);
+	CHECK(rect_is(client_rect("items"), 10, 10, 580, 280));
+	CHECK(rect_is(client_rect("cancel"), 690, 10, 100, 30));
+
+	// apply立即应用待处理的布局
+	list.margin = 5;
+	CHECK(hgui.layout.set("items", &list));
+	hgui.layout.apply();
+	CHECK(rect_is(client_rect("items"), 15, 15, 570, 270));
+
+	TEST_TEARDOWN();
+}
+
+int main(void) {
+	test_flex();
+	test_grid();
+	test_incremental();
+	test_deep();
+	test_random();
+	test_window();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,149 @@
+// 列表框测试：批量添加/删除（区间截断、整表删除、以'\0'分隔的文本块），
+// 以及虚拟列表框的行数只由setRowCount与clearList改变
+#include "hgui.h"
+#include "hgui_test.h"
+
+static int row_calls;
+
+static const char* row_text(int index, void* ctx) {
+	static char buffer[32];
+	(void)ctx;
+	row_calls++;
+	snprintf(buffer, sizeof(buffer), "row %d", index);
+	return buffer;
+}
+
+static int item_count(const char* id) {
+	return (int)SendMessage(find_control(id)->hwnd, LB_GETCOUNT, 0, 0);
+}
+
+static unsigned long messages_sent(void) {
+	HGUI_HeadlessStats stats;
+	hgui_headless_stats(&stats);
+	return stats.messages_sent;
+}
+
+static void check_items(const char* id, const char* const* expected, int count) {
+	char buffer[64];
+	CHECK(item_count(id) == count);
+	for (int i = 0; i < count; i++) {
+		hgui.getListItem(id, i, buffer, sizeof(buffer));
+		CHECK(strcmp(buffer, expected[i]) == 0);
+	}
+}
+
+// 批量接口的边界：文本块的解析、删除区间的截断与整表删除
+static void test_bulk(void) {
+	hgui.create.listbox("bulk", "main", 0, 0, 200, 200);
+
+	// 文本块：按'\0'分隔，遇到空项（连续两个'\0'）结束；空文本块不添加
+	hgui.addItemsBlob("bulk", "");
+	CHECK(item_count("bulk") == 0);
+	hgui.addItemsBlob("bulk", "甲\0乙乙\0\0丙\0");
+	const char* blob_items[] = { "甲", "乙乙" };
+	check_items("bulk", blob_items, 2);
+	hgui.addItemsBlob("bulk", "x\0");
+	const char* appended[] = { "甲", "乙乙", "x" };
+	check_items("bulk", appended, 3);
+
+	// 数组中的NULL项跳过，数量不大于0时不修改
+	const char* with_null[] = { "a", NULL, "b" };
+	hgui.addItems("bulk", with_null, 3);
+	hgui.addItems("bulk", with_null, 0);
+	hgui.addItems("bulk", NULL, 3);
+	const char* after_null[] = { "甲", "乙乙", "x", "a", "b" };
+	check_items("bulk", after_null, 5);
+
+	// 无效区间不修改；超出末尾的部分截断
+	hgui.removeItems("bulk", -1, 2);
+	hgui.removeItems("bulk", 0, 0);
+	hgui.removeItems("bulk", 0, -3);
+	hgui.removeItems("bulk", 5, 1);
+	hgui.removeItems("bulk", 100, 1);
+	check_items("bulk", after_null, 5);
+	hgui.removeItems("bulk", 1, 2);
+	const char* middle_removed[] = { "甲", "a", "b" };
+	check_items("bulk", middle_removed, 3);
+	hgui.removeItems("bulk", 2, 1000);
+	const char* tail_removed[] = { "甲", "a" };
+	check_items("bulk", tail_removed, 2);
+
+	// 删除整个列表（包括截断后覆盖整个列表）时直接清空，消息数与行数无关
+	static char texts[1000][8];
+	static const char* rows[1000];
+	for (int i = 0; i < 1000; i++) {
+		snprintf(texts[i], sizeof(texts[i]), "%d", i);
+		rows[i] = texts[i];
+	}
+	hgui.addItems("bulk", rows, 1000);
+	CHECK(item_count("bulk") == 1002);
+	unsigned long before = messages_sent();
+	hgui.removeItems("bulk", 0, 5000);
+	CHECK(messages_sent() - before < 5);
+	CHECK(item_count("bulk") == 0);
+	hgui.addItems("bulk", rows, 1000);
+	before = messages_sent();
+	hgui.removeItems("bulk", 0, 1000);
+	CHECK(messages_sent() - before < 5);
+	CHECK(item_count("bulk") == 0);
+
+	// 部分删除逐行发送删除消息
+	hgui.addItems("bulk", rows, 1000);
+	before = messages_sent();
+	hgui.removeItems("bulk", 1, 999);
+	CHECK(messages_sent() - before >= 999);
+	check_items("bulk", rows, 1);
+	hgui.remove("bulk");
+}
+
+int main(void) {
+	char buffer[64];
+	hgui.init();
+	hgui.create.window("main", "列表", 0, 0, 320, 240);
+	test_bulk();
+
+	// 普通列表框：批量添加、单项与区间删除、清空
+	hgui.create.listbox("list", "main", 0, 0, 200, 200);
+	const char* items[] = { "a", "b", "c", "d", "e", "f" };
+	hgui.addItems("list", items, 6);
+	hgui.addItemsBlob("list", "g\0h\0");
+	CHECK(item_count("list") == 8);
+	hgui.removeItem("list", 0);
+	hgui.removeItems("list", 1, 3);     // 删除 c d e
+	CHECK(item_count("list") == 4);
+	hgui.getListItem("list", 1, buffer, sizeof(buffer));
+	CHECK(strcmp(buffer, "f") == 0);
+	hgui.removeItems("list", 2, 100);   // 超出部分截断
+	CHECK(item_count("list") == 2);
+	hgui.clearList("list");
+	CHECK(item_count("list") == 0);
+
+	// 虚拟列表框：增删单项无效，行数与原生控件保持一致
+	hgui.create.virtualList("virtual", "main", 0, 0, 200, 200);
+	hgui.setRowProvider("virtual", row_text, NULL);
+	hgui.setRowCount("virtual", 1000000);
+	hgui.addItem("virtual", "x");
+	hgui.addItems("virtual", items, 6);
+	hgui.removeItem("virtual", 0);
+	hgui.removeItems("virtual", 0, 10);
+	CHECK(find_control("virtual")->row_count == 1000000);
+	CHECK(item_count("virtual") == 1000000);
+	hgui.getListItem("virtual", 999999, buffer, sizeof(buffer));
+	CHECK(strcmp(buffer, "row 999999") == 0);
+
+	// 清空虚拟列表框等同于把行数设为0，之后仍可重新设置行数
+	hgui.clearList("virtual");
+	CHECK(find_control("virtual")->row_count == 0);
+	CHECK(item_count("virtual") == 0);
+	int first, last;
+	CHECK(!hgui.getVisibleRange("virtual", &first, &last));
+	hgui.setRowCount("virtual", 10);
+	CHECK(item_count("virtual") == 10);
+	row_calls = 0;
+	CHECK(hgui_headless_paint(find_control("virtual")->hwnd) > 0);
+	CHECK(row_calls > 0);
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
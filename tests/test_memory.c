@@ -0,0 +1,180 @@
+// 资源账目与泄漏检查测试：按类型统计的节点、窗口、菜单与字体引用，反复操作后账目不增长，
+// 正常cleanup的检查结果为零，人为制造的孤立控件与未归还的字体引用会被报告
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define BUTTONS 50
+#define CHECKS 20
+#define TOGGLES 1000
+
+static void build_ui(void) {
+	char id[32];
+	hgui.init();
+	hgui.create.window("main", "账目", 0, 0, 400, 300);
+	hgui.create.menubar("bar", "main");
+	HGUI_MenuSpec menu[] = {
+		{ "file", "文件", 0, NULL, NULL },
+		{ "open", "打开", 1, "Ctrl+O", NULL },
+		{ "recent", "最近", 1, NULL, NULL },
+		{ "recent1", "一", 2, NULL, NULL },
+		{ "edit", "编辑", 0, NULL, NULL },
+		{ "copy", "复制", 1, "Ctrl+C", NULL }
+	};
+	CHECK(hgui.menu.build("bar", menu, 6) == 6);
+	hgui.create.box("panel", "main");
+	for (int i = 0; i < BUTTONS; i++) {
+		snprintf(id, sizeof(id), "button%d", i);
+		hgui.create.button(id, "panel", "按钮", 0, 0, 80, 24);
+	}
+	for (int i = 0; i < CHECKS; i++) {
+		snprintf(id, sizeof(id), "check%d", i);
+		hgui.create.checkbox(id, "panel", "选项", 0, 0, 80, 24);
+	}
+	hgui.create.input("name", "main", 0, 0, 120, 24);
+	hgui.setText("name", "一段需要缓存的文本");
+	hgui.create.listbox("items", "main", 0, 0, 120, 100);
+	static const char* rows[] = { "甲", "乙", "丙" };
+	hgui.setItems("items", rows, 3, NULL);
+	hgui.create.canvas("paint", "main", 0, 0, 64, 32);
+}
+
+// 按类型的账目与原生对象数一致
+static void test_breakdown(void) {
+	build_ui();
+	HGUI_MemoryStats memory;
+	HGUI_HeadlessStats headless;
+	hgui.memoryStats(&memory);
+	hgui_headless_stats(&headless);
+	CHECK(!memory.last_cleanup.checked);   // 还没有cleanup过
+
+	CHECK(memory.types[HGUI_BUTTON].controls == BUTTONS && memory.types[HGUI_BUTTON].hwnds == BUTTONS);
+	CHECK(memory.types[HGUI_CHECKBOX].controls == CHECKS && memory.types[HGUI_CHECKBOX].hwnds == CHECKS);
+	CHECK(memory.types[HGUI_BOX].controls == 1 && memory.types[HGUI_BOX].hwnds == 0);
+	CHECK(memory.types[HGUI_MENUBAR].controls == 1 && memory.types[HGUI_MENUBAR].hmenus == 1);
+	// 有子项的菜单项各拥有一个弹出菜单
+	CHECK(memory.types[HGUI_MENUITEM].controls == 6 && memory.types[HGUI_MENUITEM].hmenus == 3);
+	CHECK(memory.types[HGUI_MENUITEM].hwnds == 0);
+	CHECK(memory.total.controls == 1 + 1 + 6 + 1 + BUTTONS + CHECKS + 3);
+	CHECK(memory.total.hwnds == headless.windows_alive);
+	CHECK(memory.total.hmenus == headless.menus_alive);
+	CHECK(memory.accel_tables == headless.accel_tables_alive);
+	CHECK(memory.fonts == headless.fonts_alive);
+
+	// 附属内存：文本缓存、帧缓冲与列表快照计入各自的类型
+	CHECK(memory.types[HGUI_INPUT].bytes >= strlen("一段需要缓存的文本") + 1);
+	CHECK(memory.types[HGUI_CANVAS].bytes >= 64 * 32 * sizeof(uint32_t));
+	CHECK(memory.types[HGUI_LISTBOX].bytes > 0);
+	CHECK(memory.types[HGUI_BUTTON].bytes == 0);
+	size_t bytes = 0;
+	for (int type = 0; type < HGUI_CONTROL_TYPE_COUNT; type++) bytes += memory.types[type].bytes;
+	CHECK(memory.total.bytes == bytes);
+	CHECK(memory.string_bytes > 0 && memory.node_bytes > 0 && memory.table_bytes > 0);
+	CHECK(memory.total_bytes >= memory.node_bytes + memory.string_bytes + memory.table_bytes + memory.total.bytes);
+
+	TEST_TEARDOWN();
+}
+
+// 反复切换复选框、删除并重建子树后账目回到原值
+static void test_churn(void) {
+	char id[32];
+	build_ui();
+	HGUI_MemoryStats before, after;
+	HGUI_HeadlessStats headless_before, headless_after;
+	hgui.memoryStats(&before);
+	hgui_headless_stats(&headless_before);
+
+	for (int i = 0; i < TOGGLES; i++) {
+		snprintf(id, sizeof(id), "check%d", i % CHECKS);
+		hgui.setCheck(id, !hgui.getCheck(id));
+	}
+	for (int i = 0; i < CHECKS; i++) {
+		snprintf(id, sizeof(id), "check%d", i);
+		hgui.setCheck(id, false);
+	}
+	hgui.remove("panel");
+	hgui.memoryStats(&after);
+	CHECK(after.types[HGUI_BUTTON].controls == 0 && after.types[HGUI_CHECKBOX].hwnds == 0);
+	CHECK(after.types[HGUI_BOX].controls == 0);
+
+	hgui.create.box("panel", "main");
+	for (int i = 0; i < BUTTONS; i++) {
+		snprintf(id, sizeof(id), "button%d", i);
+		hgui.create.button(id, "panel", "按钮", 0, 0, 80, 24);
+	}
+	for (int i = 0; i < CHECKS; i++) {
+		snprintf(id, sizeof(id), "check%d", i);
+		hgui.create.checkbox(id, "panel", "选项", 0, 0, 80, 24);
+	}
+	hgui.memoryStats(&after);
+	hgui_headless_stats(&headless_after);
+	CHECK(after.total.controls == before.total.controls);
+	CHECK(after.total.hwnds == before.total.hwnds);
+	CHECK(after.total.hmenus == before.total.hmenus);
+	CHECK(after.total.font_refs == before.total.font_refs);
+	CHECK(after.total.bytes == before.total.bytes);
+	CHECK(after.fonts == before.fonts);
+	CHECK(headless_after.windows_alive == headless_before.windows_alive);
+	CHECK(headless_after.fonts_alive == headless_before.fonts_alive);
+
+	TEST_TEARDOWN();
+}
+
+// 正常退出：检查结果为零，原生对象全部销毁
+static void test_clean_exit(void) {
+	build_ui();
+	hgui.cleanup();
+	HGUI_MemoryStats memory;
+	hgui.memoryStats(&memory);
+	const HGUI_LeakReport* report = &memory.last_cleanup;
+	CHECK(report->checked);
+	CHECK(report->orphaned == 0 && report->stale_entries == 0 && report->font_refs == 0);
+	CHECK(report->controls == 0 && report->hwnds == 0 && report->hmenus == 0);
+	CHECK(report->fonts == 0 && report->accel_tables == 0);
+	CHECK(memory.total.controls == 0 && memory.total.hwnds == 0 && memory.fonts == 0);
+
+	HGUI_HeadlessStats headless;
+	hgui_headless_stats(&headless);
+	CHECK(headless.windows_alive == 0 && headless.menus_alive == 0);
+	CHECK(headless.fonts_alive == 0 && headless.accel_tables_alive == 0);
+	hgui_headless_reset();
+}
+
+// 人为制造的泄漏：从控件链表中摘除的顶层窗口与未归还的字体引用
+static void test_detect_leaks(void) {
+	build_ui();
+	hgui.create.window("stray", "孤立", 0, 0, 100, 100);
+	unregister_control(find_control("stray"));
+	LOGFONT lf;
+	default_logfont(&lf);
+	lf.lfWeight = FW_BOLD;
+	CHECK(font_acquire(&lf));
+
+	fprintf(stderr, "以下为预期的泄漏报告：\n");
+	hgui.cleanup();
+	HGUI_MemoryStats memory;
+	hgui.memoryStats(&memory);
+	const HGUI_LeakReport* report = &memory.last_cleanup;
+	CHECK(report->checked);
+	CHECK(report->orphaned == 1);
+	CHECK(report->stale_entries == 0);
+	CHECK(report->font_refs == 1);
+	// 摘除的窗口没有经过销毁路径；字体由cleanup清空缓存时删除
+	CHECK(report->controls == 1 && report->hwnds == 1);
+	CHECK(report->hmenus == 0 && report->fonts == 0);
+
+	// 下一次正常cleanup重新检查，上一次的结果被覆盖
+	build_ui();
+	hgui.cleanup();
+	hgui.memoryStats(&memory);
+	CHECK(memory.last_cleanup.checked && memory.last_cleanup.orphaned == 0 && memory.last_cleanup.controls == 0);
+	hgui_headless_reset();
+}
+
+int main(void) {
+	test_breakdown();
+	test_churn();
+	test_clean_exit();
+	test_detect_leaks();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,57 @@
+// 控件节点池与ID驻留测试：删除的节点被复用，同名ID只保存一份
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define COUNT 1000
+#define ROUNDS 20
+
+int main(void) {
+	char id[32];
+	HGUI_MemoryStats before, after;
+	hgui.init();
+	hgui.create.window("main", "节点池", 0, 0, 320, 240);
+
+	// 子控件的parent_id与父控件的id共享同一份驻留字符串
+	hgui.create.box("group", "main");
+	hgui.create.label("child", "group", "x", 0, 0, 10, 10);
+	CHECK(find_control("child")->parent_id == find_control("group")->id);
+	hgui.remove("group");
+
+	// 反复删除并重建同一批控件：节点从空闲链表复用，驻留区不增长
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "node%d", i);
+		hgui.create.label(id, "main", "x", 0, 0, 10, 10);
+	}
+	hgui.memoryStats(&before);
+	for (int round = 0; round < ROUNDS; round++) {
+		for (int i = 0; i < COUNT; i++) {
+			snprintf(id, sizeof(id), "node%d", i);
+			hgui.remove(id);
+		}
+		for (int i = 0; i < COUNT; i++) {
+			snprintf(id, sizeof(id), "node%d", i);
+			CHECK(hgui.create.label(id, "main", "y", 0, 0, 10, 10));
+		}
+	}
+	hgui.memoryStats(&after);
+	CHECK(after.total.controls == before.total.controls);
+	CHECK(after.node_bytes == before.node_bytes);
+	CHECK(after.string_bytes == before.string_bytes);
+	CHECK(after.table_bytes == before.table_bytes);
+
+	// 复用的节点是干净的：没有残留的回调、文本与子控件
+	HGUI_Control* control = find_control("node0");
+	CHECK(control && !control->click_callback && !control->first_child);
+	CHECK(strcmp(hgui.getTextView("node0"), "y") == 0);
+
+	// cleanup后重新初始化，节点池从空开始
+	TEST_TEARDOWN();
+	hgui.init();
+	hgui.memoryStats(&after);
+	CHECK(after.total.controls == 0);
+	CHECK(after.node_bytes == 0);
+	CHECK(after.string_bytes == 0);
+	hgui.cleanup();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,108 @@
+// 跨线程投递测试：函数调用是合并的屏障，调用看到它之前投递的文本；
+// 16个生产者线程同时投递，每个操作恰好应用一次，且同一生产者的操作保持顺序
+#include "hgui.h"
+#include "hgui_test.h"
+#include <pthread.h>
+
+#define PRODUCERS 16
+#define OPS 2000
+
+typedef struct {
+	int producer;
+	int sequence;
+} Op;
+
+static Op ops[PRODUCERS][OPS];
+static int next_sequence[PRODUCERS];
+static int out_of_order;
+
+// 在UI线程中运行：检查顺序
+static void apply_op(void* user_data) {
+	Op* op = (Op*)user_data;
+	if (op->sequence != next_sequence[op->producer]) out_of_order++;
+	next_sequence[op->producer] = op->sequence + 1;
+}
+
+static char observed[4][32];
+static int observed_count;
+
+// 在UI线程中运行：记录此时的文本
+static void observe_status(void* user_data) {
+	(void)user_data;
+	snprintf(observed[observed_count++], sizeof(observed[0]), "%s", hgui.getTextView("status"));
+}
+
+// 同一批次中 setText / call / setText：调用之前的写入不会被之后的写入合并掉
+static void test_call_barrier(void) {
+	hgui.post.setText("status", "a");
+	hgui.post.call(observe_status, NULL);
+	hgui.post.setText("status", "b");
+	hgui.post.setText("status", "c");
+	hgui.post.call(observe_status, NULL);
+	hgui.post.setText("status", "d");
+	hgui.run();
+	CHECK(observed_count == 2);
+	CHECK(strcmp(observed[0], "a") == 0);
+	CHECK(strcmp(observed[1], "c") == 0);
+	CHECK(strcmp(hgui.getTextView("status"), "d") == 0);
+}
+
+static void* producer(void* arg) {
+	int index = (int)(intptr_t)arg;
+	char text[32];
+	for (int i = 0; i < OPS; i++) {
+		ops[index][i].producer = index;
+		ops[index][i].sequence = i;
+		snprintf(text, sizeof(text), "%d %d", index, i);
+		hgui.post.addItem("log", text);
+		hgui.post.call(apply_op, &ops[index][i]);
+		if (i % 64 == 0) hgui.post.setText("status", text);
+	}
+	hgui_headless_pending(-1);
+	return NULL;
+}
+
+int main(void) {
+	hgui.init();
+	hgui.create.window("main", "投递", 0, 0, 320, 240);
+	hgui.create.listbox("log", "main", 0, 0, 200, 200);
+	hgui.create.label("status", "main", "", 0, 0, 100, 20);
+	test_call_barrier();
+
+	pthread_t threads[PRODUCERS];
+	for (int i = 0; i < PRODUCERS; i++) {
+		hgui_headless_pending(1);
+		CHECK(pthread_create(&threads[i], NULL, producer, (void*)(intptr_t)i) == 0);
+	}
+	hgui.run();
+	for (int i = 0; i < PRODUCERS; i++) pthread_join(threads[i], NULL);
+	hgui.run();
+
+	// 每个回调恰好运行一次且按顺序
+	CHECK(out_of_order == 0);
+	for (int i = 0; i < PRODUCERS; i++) CHECK(next_sequence[i] == OPS);
+
+	// 列表项总数正确，每个生产者的项按投递顺序出现
+	HWND list = find_control("log")->hwnd;
+	CHECK((int)SendMessage(list, LB_GETCOUNT, 0, 0) == PRODUCERS * OPS);
+	int seen[PRODUCERS] = { 0 };
+	char buffer[32];
+	for (int row = 0; row < PRODUCERS * OPS; row++) {
+		int index, sequence;
+		hgui.getListItem("log", row, buffer, sizeof(buffer));
+		CHECK(sscanf(buffer, "%d %d", &index, &sequence) == 2);
+		CHECK(index >= 0 && index < PRODUCERS);
+		CHECK(sequence == seen[index]);
+		seen[index]++;
+	}
+	for (int i = 0; i < PRODUCERS; i++) CHECK(seen[i] == OPS);
+
+	// 文本是某个生产者最后一次投递的值
+	int index, sequence;
+	CHECK(sscanf(hgui.getTextView("status"), "%d %d", &index, &sequence) == 2);
+	CHECK(sequence == (OPS - 1) / 64 * 64);
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
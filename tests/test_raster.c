@@ -0,0 +1,299 @@
+// 光栅测试：各内核与逐像素参考实现一致（含任意对齐与长度）、裁剪、直线、重叠复制与脏矩形合并，
+// 以及画布控件只把脏矩形传输到窗口
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define W 97
+#define H 61
+
+static uint32_t seed = 2463534242u;
+
+static uint32_t next_random(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+// 参考实现：逐通道 round((src*a + dst*(255-a)) / 255)，结果alpha为255
+static uint32_t reference_blend(uint32_t dst, uint32_t src, uint32_t alpha) {
+	uint32_t result = 0xFF000000u;
+	for (int shift = 0; shift < 24; shift += 8) {
+		uint32_t value = ((src >> shift) & 0xFF) * alpha + ((dst >> shift) & 0xFF) * (255 - alpha);
+		result |= ((value + 127) / 255) << shift;
+	}
+	return result;
+}
+
+static void fill_random(uint32_t* pixels, size_t count) {
+	for (size_t i = 0; i < count; i++) pixels[i] = next_random();
+}
+
+static bool rect_equal(HGUI_RasterRect a, int left, int top, int right, int bottom) {
+	return a.left == left && a.top == top && a.right == right && a.bottom == bottom;
+}
+
+// 各长度与起始对齐下，内核结果与参考实现一致，且不写出范围
+static void test_spans(void) {
+	uint32_t buffer[96], src[96], expect[96];
+	for (int offset = 0; offset < 8; offset++) {
+		for (int count = 0; count <= 80; count++) {
+			uint32_t color = next_random();
+			// 每种长度都覆盖alpha为0和255的特殊情况
+			if (count % 7 == 0) color &= 0x00FFFFFFu;
+			if (count % 7 == 1) color |= 0xFF000000u;
+
+			fill_random(buffer, 96);
+			memcpy(expect, buffer, sizeof(buffer));
+			for (int i = 0; i < count; i++) expect[offset + i] = color;
+			raster_fill_span(buffer + offset, count, color);
+			CHECK(memcmp(buffer, expect, sizeof(buffer)) == 0);
+
+			fill_random(buffer, 96);
+			memcpy(expect, buffer, sizeof(buffer));
+			for (int i = 0; i < count; i++) expect[offset + i] = reference_blend(expect[offset + i], color, color >> 24);
+			raster_blend_span(buffer + offset, count, color);
+			CHECK(memcmp(buffer, expect, sizeof(buffer)) == 0);
+
+			fill_random(buffer, 96);
+			fill_random(src, 96);
+			for (int i = 0; i < 96; i += 5) src[i] &= 0x00FFFFFFu;
+			for (int i = 1; i < 96; i += 5) src[i] |= 0xFF000000u;
+			memcpy(expect, buffer, sizeof(buffer));
+			for (int i = 0; i < count; i++) expect[offset + i] = reference_blend(expect[offset + i], src[i], src[i] >> 24);
+			raster_blend_image_span(buffer + offset, src, count);
+			CHECK(memcmp(buffer, expect, sizeof(buffer)) == 0);
+		}
+	}
+
+	// 端点：alpha为255时等于源颜色，为0时保留目标颜色（结果alpha恒为255）
+	CHECK(raster_blend_pixel(0x00123456u, 0xFFABCDEFu, 255) == 0xFFABCDEFu);
+	CHECK(raster_blend_pixel(0x00123456u, 0x00ABCDEFu, 0) == 0xFF123456u);
+	CHECK(raster_blend_pixel(HGUI_RGB(255, 255, 255), HGUI_ARGB(128, 0, 0, 0), 128) == HGUI_RGB(127, 127, 127));
+}
+
+static void test_fill_and_blend(void) {
+	HGUI_Surface surface;
+	CHECK(hgui_surface_init(&surface, W, H));
+	hgui_raster_fill(&surface, hgui_rect_make(0, 0, W, H), HGUI_RGB(1, 2, 3));
+
+	// 部分超出表面的矩形被裁剪，返回实际写入的区域
+	HGUI_RasterRect written = hgui_raster_fill(&surface, hgui_rect_make(-5, 50, 20, 30), HGUI_RGB(9, 9, 9));
+	CHECK(rect_equal(written, 0, 50, 15, H));
+	for (int y = 0; y < H; y++) {
+		for (int x = 0; x < W; x++) {
+			bool inside = x < 15 && y >= 50;
+			CHECK(hgui_surface_row(&surface, y)[x] == (inside ? HGUI_RGB(9, 9, 9) : HGUI_RGB(1, 2, 3)));
+		}
+	}
+	CHECK(hgui_rect_empty(hgui_raster_fill(&surface, hgui_rect_make(W, 0, 10, 10), 0)));
+
+	// 半透明混合；alpha为0时不写入也不返回区域
+	uint32_t color = HGUI_ARGB(77, 200, 100, 50);
+	written = hgui_raster_blend(&surface, hgui_rect_make(3, 4, 33, 5), color);
+	CHECK(rect_equal(written, 3, 4, 36, 9));
+	CHECK(hgui_surface_row(&surface, 4)[3] == reference_blend(HGUI_RGB(1, 2, 3), color, 77));
+	CHECK(hgui_surface_row(&surface, 8)[35] == reference_blend(HGUI_RGB(1, 2, 3), color, 77));
+	CHECK(hgui_surface_row(&surface, 9)[35] == HGUI_RGB(1, 2, 3));
+	CHECK(hgui_rect_empty(hgui_raster_blend(&surface, hgui_rect_make(0, 0, W, H), HGUI_ARGB(0, 255, 255, 255))));
+	CHECK(hgui_surface_row(&surface, 0)[0] == HGUI_RGB(1, 2, 3));
+	hgui_surface_free(&surface);
+}
+
+static int count_color(const HGUI_Surface* surface, uint32_t color) {
+	int count = 0;
+	for (int y = 0; y < surface->height; y++) {
+		for (int x = 0; x < surface->width; x++) {
+			if (hgui_surface_row(surface, y)[x] == color) count++;
+		}
+	}
+	return count;
+}
+
+static void test_lines(void) {
+	HGUI_Surface surface;
+	CHECK(hgui_surface_init(&surface, W, H));
+	uint32_t ink = HGUI_RGB(0, 0, 0);
+
+	// 对角线两端都包含
+	hgui_raster_fill(&surface, hgui_rect_make(0, 0, W, H), HGUI_RGB(255, 255, 255));
+	HGUI_RasterRect written = hgui_raster_line(&surface, 0, 0, 9, 9, ink);
+	CHECK(rect_equal(written, 0, 0, 10, 10));
+	for (int i = 0; i < 10; i++) CHECK(hgui_surface_row(&surface, i)[i] == ink);
+	CHECK(count_color(&surface, ink) == 10);
+
+	// 陡峭的线每行恰好一个像素，方向不影响结果
+	hgui_raster_fill(&surface, hgui_rect_make(0, 0, W, H), HGUI_RGB(255, 255, 255));
+	hgui_raster_line(&surface, 20, 40, 10, 0, ink);
+	CHECK(count_color(&surface, ink) == 41);
+	CHECK(hgui_surface_row(&surface, 0)[10] == ink && hgui_surface_row(&surface, 40)[20] == ink);
+	for (int y = 0; y <= 40; y++) {
+		int hits = 0;
+		for (int x = 0; x < W; x++) hits += hgui_surface_row(&surface, y)[x] == ink;
+		CHECK(hits == 1);
+	}
+
+	// 水平线与竖直线
+	hgui_raster_fill(&surface, hgui_rect_make(0, 0, W, H), HGUI_RGB(255, 255, 255));
+	CHECK(rect_equal(hgui_raster_line(&surface, 30, 5, 2, 5, ink), 2, 5, 31, 6));
+	CHECK(rect_equal(hgui_raster_line(&surface, 50, 59, 50, 1, ink), 50, 1, 51, 60));
+	CHECK(count_color(&surface, ink) == 29 + 59);
+
+	// 穿出表面的线只写入表面内的像素，完全在外的线不写入
+	hgui_raster_fill(&surface, hgui_rect_make(0, 0, W, H), HGUI_RGB(255, 255, 255));
+	written = hgui_raster_line(&surface, -10, -10, 10, 10, ink);
+	CHECK(rect_equal(written, 0, 0, 11, 11));
+	CHECK(count_color(&surface, ink) == 11);
+	CHECK(hgui_rect_empty(hgui_raster_line(&surface, -10, -1, -1, -10, ink)));
+	hgui_surface_free(&surface);
+}
+
+static void test_copy(void) {
+	HGUI_Surface surface, reference;
+	CHECK(hgui_surface_init(&surface, W, H));
+	CHECK(hgui_surface_init(&reference, W, H));
+
+	// 同一表面内区域重叠的复制（向下、向右与向上、向左）与经过临时缓冲的复制结果相同
+	static const int moves[][2] = { { 3, 7 }, { -4, -2 }, { 0, 1 }, { 5, 0 } };
+	for (size_t m = 0; m < sizeof(moves) / sizeof(moves[0]); m++) {
+		fill_random(surface.pixels, (size_t)W * H);
+		memcpy(reference.pixels, surface.pixels, (size_t)W * H * sizeof(uint32_t));
+		HGUI_RasterRect source = hgui_rect_make(10, 10, 40, 30);
+		int x = 10 + moves[m][0], y = 10 + moves[m][1];
+
+		uint32_t saved[40 * 30];
+		for (int row = 0; row < 30; row++) memcpy(saved + row * 40, hgui_surface_row(&reference, 10 + row) + 10, 40 * sizeof(uint32_t));
+		for (int row = 0; row < 30; row++) memcpy(hgui_surface_row(&reference, y + row) + x, saved + row * 40, 40 * sizeof(uint32_t));
+
+		CHECK(rect_equal(hgui_raster_copy(&surface, x, y, &surface, source), x, y, x + 40, y + 30));
+		CHECK(memcmp(surface.pixels, reference.pixels, (size_t)W * H * sizeof(uint32_t)) == 0);
+	}
+
+	// 目标位置超出表面时源区域同步裁剪
+	uint32_t image[4 * 4];
+	for (int i = 0; i < 16; i++) image[i] = HGUI_ARGB(255, i, 0, 0);
+	HGUI_Surface source;
+	hgui_surface_wrap(&source, image, 4, 4, 4);
+	hgui_raster_fill(&surface, hgui_rect_make(0, 0, W, H), 0);
+	HGUI_RasterRect written = hgui_raster_copy(&surface, -1, H - 2, &source, hgui_rect_make(0, 0, 4, 4));
+	CHECK(rect_equal(written, 0, H - 2, 3, H));
+	CHECK(hgui_surface_row(&surface, H - 2)[0] == image[1]);
+	CHECK(hgui_surface_row(&surface, H - 1)[2] == image[7]);
+
+	// 按像素alpha混合图像：alpha为0的像素保留目标，为255的像素覆盖目标
+	for (int i = 0; i < 16; i++) image[i] = HGUI_ARGB(i * 17, 255, 0, 0);
+	hgui_raster_fill(&surface, hgui_rect_make(0, 0, W, H), HGUI_RGB(0, 0, 255));
+	hgui_raster_blend_image(&surface, 2, 2, &source, hgui_rect_make(0, 0, 4, 4));
+	for (int i = 0; i < 16; i++) {
+		CHECK(hgui_surface_row(&surface, 2 + i / 4)[2 + i % 4] == reference_blend(HGUI_RGB(0, 0, 255), image[i], image[i] >> 24));
+	}
+	CHECK(hgui_surface_row(&surface, 2)[2] == HGUI_RGB(0, 0, 255));
+	CHECK(hgui_surface_row(&surface, 5)[5] == HGUI_RGB(255, 0, 0));
+	hgui_surface_free(&surface);
+	hgui_surface_free(&reference);
+}
+
+static void test_dirty(void) {
+	HGUI_DirtyRects dirty;
+	hgui_dirty_clear(&dirty);
+
+	// 相交的矩形合并，同高的左右相邻矩形无损合并，不相邻的矩形分开记录
+	hgui_dirty_add(&dirty, hgui_rect_make(0, 0, 10, 10));
+	hgui_dirty_add(&dirty, hgui_rect_make(5, 5, 10, 10));
+	CHECK(dirty.count == 1 && rect_equal(dirty.rects[0], 0, 0, 15, 15));
+	hgui_dirty_add(&dirty, hgui_rect_make(15, 0, 5, 15));
+	CHECK(dirty.count == 1 && rect_equal(dirty.rects[0], 0, 0, 20, 15));
+	hgui_dirty_add(&dirty, hgui_rect_make(40, 40, 2, 2));
+	hgui_dirty_add(&dirty, hgui_rect_make(0, 0, 0, 5));
+	CHECK(dirty.count == 2);
+
+	// 合并结果又与其他矩形相交时继续合并
+	hgui_dirty_add(&dirty, hgui_rect_make(18, 14, 23, 27));
+	CHECK(dirty.count == 1 && rect_equal(dirty.rects[0], 0, 0, 42, 42));
+
+	// 列表已满时仍不超过上限，且覆盖所有登记过的区域
+	hgui_dirty_clear(&dirty);
+	for (int i = 0; i < 40; i++) hgui_dirty_add(&dirty, hgui_rect_make(i * 10, (i % 3) * 20, 2, 2));
+	CHECK(dirty.count <= HGUI_RASTER_MAX_DIRTY);
+	CHECK(rect_equal(hgui_dirty_bounds(&dirty), 0, 0, 392, 42));
+	for (int i = 0; i < 40; i++) {
+		HGUI_RasterRect rect = hgui_rect_make(i * 10, (i % 3) * 20, 2, 2);
+		bool covered = false;
+		for (int r = 0; r < dirty.count; r++) {
+			HGUI_RasterRect part = hgui_rect_intersect(dirty.rects[r], rect);
+			covered = covered || rect_equal(part, rect.left, rect.top, rect.right, rect.bottom);
+		}
+		CHECK(covered);
+	}
+}
+
+// 画布控件：同一帧内的绘制合并为一次传输，只传输脏矩形，窗口上的像素与帧缓冲一致
+static void test_canvas(void) {
+	hgui.init();
+	hgui.create.window("main", "画布", 0, 0, 320, 240);
+	hgui.create.canvas("chart", "main", 10, 10, 64, 32);
+	HWND hwnd = find_control("chart")->hwnd;
+	hgui.run();
+
+	HGUI_HeadlessStats before, after;
+	hgui_headless_stats(&before);
+	hgui.canvas.clear("chart", HGUI_RGB(255, 255, 255));
+	hgui.canvas.fillRect("chart", 4, 4, 8, 8, HGUI_RGB(70, 130, 180));
+	hgui.run();
+	hgui_headless_stats(&after);
+	CHECK(after.blits == before.blits + 1);
+	CHECK(after.pixels_blitted == before.pixels_blitted + 64 * 32);
+	CHECK(hgui_headless_pixel(hwnd, 4, 4) == HGUI_RGB(70, 130, 180));
+	CHECK(hgui_headless_pixel(hwnd, 11, 11) == HGUI_RGB(70, 130, 180));
+	CHECK(hgui_headless_pixel(hwnd, 12, 12) == HGUI_RGB(255, 255, 255));
+
+	// 只传输修改过的区域；超出画布的部分被裁剪
+	before = after;
+	hgui.canvas.fillRect("chart", 60, 30, 10, 10, HGUI_ARGB(128, 0, 0, 0));
+	hgui.canvas.line("chart", 0, 20, 9, 20, HGUI_RGB(255, 0, 0));
+	hgui.run();
+	hgui_headless_stats(&after);
+	CHECK(after.blits == before.blits + 2);
+	CHECK(after.pixels_blitted == before.pixels_blitted + 4 * 2 + 10);
+	CHECK(hgui_headless_pixel(hwnd, 63, 31) == HGUI_RGB(127, 127, 127));
+	CHECK(hgui_headless_pixel(hwnd, 59, 31) == HGUI_RGB(255, 255, 255));
+	CHECK(hgui_headless_pixel(hwnd, 9, 20) == HGUI_RGB(255, 0, 0));
+
+	// 图像按alpha混合或直接复制
+	uint32_t image[2 * 2] = { HGUI_ARGB(0, 0, 255, 0), HGUI_ARGB(255, 0, 255, 0), HGUI_ARGB(255, 0, 0, 255), 0 };
+	hgui.canvas.drawImage("chart", 30, 0, image, 2, 2, 2, true);
+	hgui.canvas.drawImage("chart", 40, 0, image, 2, 2, 2, false);
+	hgui.run();
+	CHECK(hgui_headless_pixel(hwnd, 30, 0) == HGUI_RGB(255, 255, 255));
+	CHECK(hgui_headless_pixel(hwnd, 31, 0) == HGUI_RGB(0, 255, 0));
+	CHECK(hgui_headless_pixel(hwnd, 41, 1) == 0);
+
+	// 直接修改帧缓冲后登记区域
+	int width, height, stride;
+	uint32_t* pixels = hgui.canvas.pixels("chart", &width, &height, &stride);
+	CHECK(pixels && width == 64 && height == 32 && stride >= width);
+	pixels[5 * stride + 50] = HGUI_RGB(1, 2, 3);
+	CHECK(hgui_headless_pixel(hwnd, 50, 5) == HGUI_RGB(255, 255, 255));
+	hgui.canvas.invalidate("chart", 50, 5, 1, 1);
+	hgui.run();
+	CHECK(hgui_headless_pixel(hwnd, 50, 5) == HGUI_RGB(1, 2, 3));
+
+	TEST_TEARDOWN();
+}
+
+int main(void) {
+#if defined(HGUI_RASTER_AVX2) && defined(__GNUC__)
+	if (!__builtin_cpu_supports("avx2")) {
+		puts("SKIP: CPU不支持AVX2");
+		return 77;
+	}
+#endif
+	test_spans();
+	test_fill_and_blend();
+	test_lines();
+	test_copy();
+	test_dirty();
+	test_canvas();
+	puts("OK");
+	return 0;
+}
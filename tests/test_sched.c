@@ -0,0 +1,115 @@
+// 调度器测试：用假时钟驱动时间轮、空闲任务与帧任务
+#include <stdint.h>
+#include "hgui_sched.h"
+#include "hgui_test.h"
+
+static long long fake_now;
+static int counts[8];
+static HGUI_Scheduler sched;
+static HGUI_TaskId self_id;
+
+static long long fake_clock(void* context) {
+	(void)context;
+	return fake_now;
+}
+
+static void count(void* user_data) {
+	counts[(int)(intptr_t)user_data]++;
+}
+
+static void cancel_self(void* user_data) {
+	count(user_data);
+	hgui_sched_cancel(&sched, self_id);
+}
+
+static void add_idle(void* user_data) {
+	count(user_data);
+	hgui_sched_idle(&sched, count, (void*)(intptr_t)5);
+}
+
+// 把时钟推进到t并运行到期的定时任务
+static int advance_to(long long t) {
+	fake_now = t;
+	return hgui_sched_run_due(&sched);
+}
+
+int main(void) {
+	hgui_sched_init(&sched, fake_clock, NULL);
+
+	// 一次性任务在到期时刻运行，不提前；超过时间轮一圈的延迟同样准确
+	hgui_sched_after(&sched, 10, count, (void*)(intptr_t)0);
+	hgui_sched_after(&sched, 1000, count, (void*)(intptr_t)1);
+	hgui_sched_after(&sched, 100000, count, (void*)(intptr_t)2);
+	CHECK(hgui_sched_timeout(&sched) == 10);
+	CHECK(advance_to(9) == 0);
+	CHECK(advance_to(10) == 1 && counts[0] == 1);
+	CHECK(hgui_sched_timeout(&sched) == 990);
+	CHECK(advance_to(999) == 0);
+	CHECK(advance_to(5000) == 1 && counts[1] == 1);
+	CHECK(advance_to(99999) == 0 && counts[2] == 0);
+	CHECK(advance_to(100000) == 1 && counts[2] == 1);
+	CHECK(hgui_sched_timeout(&sched) == -1);
+
+	// 重复任务：错过的周期不补运行
+	memset(counts, 0, sizeof(counts));
+	HGUI_TaskId every = hgui_sched_every(&sched, 100, count, (void*)(intptr_t)0);
+	CHECK(advance_to(100100) == 1);
+	CHECK(advance_to(100200) == 1);
+	CHECK(advance_to(101000) == 1);
+	CHECK(hgui_sched_timeout(&sched) == 100);
+	CHECK(counts[0] == 3);
+	CHECK(hgui_sched_cancel(&sched, every));
+	CHECK(!hgui_sched_cancel(&sched, every));
+	CHECK(advance_to(102000) == 0);
+
+	// 回调中取消自身
+	self_id = hgui_sched_every(&sched, 5, cancel_self, (void*)(intptr_t)1);
+	CHECK(advance_to(102005) == 1);
+	CHECK(advance_to(102100) == 0 && counts[1] == 1);
+
+	// 同一时刻到期的任务按添加顺序运行；已结束的一次性任务不能再取消
+	HGUI_TaskId once = hgui_sched_after(&sched, 0, count, (void*)(intptr_t)2);
+	CHECK(advance_to(102101) == 1);
+	CHECK(!hgui_sched_cancel(&sched, once));
+
+	// 空闲任务每轮运行一次直到取消，回调中添加的空闲任务留到下一轮
+	memset(counts, 0, sizeof(counts));
+	HGUI_TaskId idle = hgui_sched_idle(&sched, add_idle, (void*)(intptr_t)4);
+	CHECK(hgui_sched_run_idle(&sched) == 1);
+	CHECK(hgui_sched_run_idle(&sched) == 2);
+	CHECK(counts[4] == 2 && counts[5] == 1);
+	CHECK(hgui_sched_cancel(&sched, idle));
+	CHECK(hgui_sched_run_idle(&sched) == 2);   // 之前添加的两个count任务
+
+	// 帧任务：同一帧内相同的(回调, 参数)只运行一次，两帧之间至少间隔一个帧周期
+	hgui_sched_init(&sched, fake_clock, NULL);
+	hgui_sched_set_frame_interval(&sched, 16);
+	memset(counts, 0, sizeof(counts));
+	HGUI_TaskId frame = hgui_sched_frame(&sched, count, (void*)(intptr_t)0);
+	CHECK(hgui_sched_frame(&sched, count, (void*)(intptr_t)0) == frame);
+	hgui_sched_frame(&sched, count, (void*)(intptr_t)1);
+	CHECK(hgui_sched_timeout(&sched) == 0);
+	CHECK(hgui_sched_run_frame(&sched) == 2);
+	hgui_sched_frame(&sched, count, (void*)(intptr_t)0);
+	fake_now += 10;
+	CHECK(hgui_sched_timeout(&sched) == 6);
+	CHECK(hgui_sched_run_frame(&sched) == 0);
+	fake_now += 6;
+	CHECK(hgui_sched_run_frame(&sched) == 1);
+	CHECK(counts[0] == 2 && counts[1] == 1);
+
+	// 节点反复复用：代数用尽后节点退役，旧ID始终无法取消新任务
+	HGUI_TaskId stale = hgui_sched_after(&sched, 1, count, (void*)(intptr_t)0);
+	CHECK(hgui_sched_cancel(&sched, stale));
+	for (int i = 0; i < 10000; i++) {
+		HGUI_TaskId task = hgui_sched_after(&sched, 1, count, (void*)(intptr_t)0);
+		CHECK(task != HGUI_INVALID_TASK && task != stale);
+		CHECK(!hgui_sched_cancel(&sched, stale));
+		CHECK(hgui_sched_cancel(&sched, task));
+	}
+	CHECK(sched.task_count <= 4);
+
+	hgui_sched_destroy(&sched);
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,95 @@
+// 运行统计测试：启用时记录回调、队列应用与查找耗时，发送的消息同样计入消息统计且嵌套时不重复计时；
+// 未启用时快照为空
+#include "hgui.h"
+#include "hgui_test.h"
+
+static void on_click(const char* id) {
+	(void)id;
+}
+
+#ifdef HGUI_ENABLE_STATS
+#define INNER_NS 3000000ll
+
+// 外层按钮的回调中同步点击内层按钮，内层回调忙等INNER_NS
+static void on_outer(const char* id) {
+	(void)id;
+	hgui_headless_click(find_control("inner")->hwnd);
+}
+
+static void on_inner(const char* id) {
+	(void)id;
+	long long start = now_ns();
+	while (now_ns() - start < INNER_NS) {}
+}
+
+static const HGUI_MessageStats* find_message(const HGUI_Stats* stats, UINT message) {
+	for (size_t i = 0; i < stats->message_type_count; i++) {
+		if (stats->messages[i].message == message) return &stats->messages[i];
+	}
+	return NULL;
+}
+#endif
+
+int main(void) {
+	HGUI_Stats stats;
+	char report[8192];
+	hgui.init();
+	hgui.create.window("main", "统计", 0, 0, 320, 240);
+	hgui.create.button("ok", "main", "确定", 0, 0, 80, 24);
+	hgui.bind("ok", "click", on_click);
+	hgui.resetStats();
+
+	for (int i = 0; i < 10; i++) hgui_headless_click(find_control("ok")->hwnd);
+	hgui.post.setText("ok", "完成");
+	hgui.run();
+	hgui.stats(&stats);
+
+#ifdef HGUI_ENABLE_STATS
+	CHECK(stats.enabled);
+	CHECK(stats.callback_count >= 1);
+	CHECK(strcmp(stats.callbacks[0].id, "ok") == 0);
+	CHECK(stats.callbacks[0].timing.count == 10);
+	CHECK(stats.callbacks_total.count == 10);
+	CHECK(stats.drains.count == 1);
+	CHECK(stats.lookups.count > 0);
+	CHECK(stats.native_calls.count > 0);
+
+	// 文本与JSON格式；缓冲区不足时返回所需长度
+	size_t length = hgui.formatStats(report, sizeof(report), true);
+	CHECK(length > 0 && length < sizeof(report));
+	CHECK(report[0] == '{' && strstr(report, "\"ok\"") != NULL);
+	char small[8];
+	CHECK(hgui.formatStats(small, sizeof(small), true) == length);
+	CHECK(hgui.formatStats(report, sizeof(report), false) > 0);
+
+	// 经SendMessage发送、不经过消息循环的WM_COMMAND同样计入
+	const HGUI_MessageStats* command = find_message(&stats, WM_COMMAND);
+	CHECK(command && command->timing.count == 10);
+
+	// 嵌套发送：两次WM_COMMAND各自记录，外层扣除内层的时间，总耗时不重复计入
+	hgui.create.button("outer", "main", "外", 0, 30, 80, 24);
+	hgui.create.button("inner", "main", "内", 0, 60, 80, 24);
+	hgui.bind("outer", "click", on_outer);
+	hgui.bind("inner", "click", on_inner);
+	hgui.resetStats();
+	hgui_headless_click(find_control("outer")->hwnd);
+	hgui.stats(&stats);
+	command = find_message(&stats, WM_COMMAND);
+	CHECK(command && command->timing.count == 2);
+	CHECK(command->timing.max_ns >= (unsigned long long)INNER_NS);
+	CHECK(command->timing.total_ns < command->timing.max_ns * 3 / 2);
+
+	hgui.resetStats();
+	hgui.stats(&stats);
+	CHECK(stats.callback_count == 0 && stats.drains.count == 0);
+#else
+	CHECK(!stats.enabled);
+	CHECK(stats.callback_count == 0 && stats.message_type_count == 0);
+	CHECK(stats.drains.count == 0);
+	(void)report;
+#endif
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,258 @@
+// 输入轨迹测试：编码与解码往返一致、截断与损坏的数据被识别；录制一段操作后保存为文件，
+// 在重建的界面上回放得到相同的回调序列与控件状态，按原间隔回放时保持事件间隔
+#include "hgui.h"
+#include "hgui_test.h"
+#include <limits.h>
+
+#define CODEC_EVENTS 5000
+#define TRACE_PATH "test_trace.hgtr"
+
+static uint32_t seed = 362436069u;
+
+static uint32_t next_random(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+static bool same_string(const char* a, const char* b) {
+	return (!a && !b) || (a && b && strcmp(a, b) == 0);
+}
+
+static bool same_event(const HGUI_TraceEvent* a, const HGUI_TraceEvent* b) {
+	return a->time_us == b->time_us && a->kind == b->kind && same_string(a->id, b->id) && a->code == b->code &&
+		   a->has_value == b->has_value && (!a->has_value || a->value == b->value) && same_string(a->text, b->text);
+}
+
+// 编码与解码：随机事件往返一致；截断在任意位置都只读出完整的前缀；文件头错误时拒绝
+static void test_codec(void) {
+	static const char* ids[] = { "ok", "cancel", "name_input", "items", "menu_open", "很长的控件ID_0123456789" };
+	static const char* texts[] = { "", "abc", "中文输入", "line1\nline2" };
+	static const int values[] = { 0, 1, -1, 127, 128, -129, INT_MAX, INT_MIN };
+	static HGUI_TraceEvent events[CODEC_EVENTS];
+
+	HGUI_TraceWriter writer;
+	memset(&writer, 0, sizeof(writer));
+	uint64_t time_us = 0;
+	for (int i = 0; i < CODEC_EVENTS; i++) {
+		HGUI_TraceEvent* event = &events[i];
+		memset(event, 0, sizeof(HGUI_TraceEvent));
+		// 间隔从0到数小时不等
+		time_us += next_random() % 8 == 0 ? (uint64_t)next_random() * 1000 : next_random() % 200;
+		event->time_us = time_us;
+		event->kind = next_random() % 3 == 0 ? HGUI_TRACE_MENU : HGUI_TRACE_CONTROL;
+		event->id = ids[next_random() % (sizeof(ids) / sizeof(ids[0]))];
+		if (event->kind == HGUI_TRACE_CONTROL) {
+			event->code = next_random() % 2 ? next_random() % 0x10000 : 0;
+			event->has_value = next_random() % 2;
+			event->value = event->has_value ? values[next_random() % (sizeof(values) / sizeof(values[0]))] : 0;
+			event->text = next_random() % 3 == 0 ? texts[next_random() % (sizeof(texts) / sizeof(texts[0]))] : NULL;
+		}
+		CHECK(hgui_trace_write(&writer, event));
+	}
+	CHECK(memcmp(writer.data, "HGTR", 4) == 0);
+
+	HGUI_TraceReader reader;
+	HGUI_TraceEvent event;
+	CHECK(hgui_trace_reader_init(&reader, writer.data, writer.size));
+	int count = 0;
+	while (hgui_trace_next(&reader, &event)) {
+		CHECK(count < CODEC_EVENTS && same_event(&event, &events[count]));
+		count++;
+	}
+	CHECK(count == CODEC_EVENTS && !reader.failed);
+	hgui_trace_reader_free(&reader);
+
+	// 截断：读出的事件都是原来的前缀，不完整的记录报告为损坏
+	for (size_t size = HGUI_TRACE_HEADER_SIZE; size < 2000; size++) {
+		CHECK(hgui_trace_reader_init(&reader, writer.data, size));
+		count = 0;
+		while (hgui_trace_next(&reader, &event)) {
+			CHECK(same_event(&event, &events[count]));
+			count++;
+		}
+		CHECK(reader.position <= size);
+		CHECK(count < CODEC_EVENTS);
+		hgui_trace_reader_free(&reader);
+	}
+
+	// 文件头错误或过短时拒绝；引用不存在的ID编号时报告损坏
+	CHECK(!hgui_trace_reader_init(&reader, writer.data, HGUI_TRACE_HEADER_SIZE - 1));
+	unsigned char bad[] = { 'H', 'G', 'T', 'R', HGUI_TRACE_VERSION + 1, 0, 0, 0 };
+	CHECK(!hgui_trace_reader_init(&reader, bad, sizeof(bad)));
+	unsigned char dangling[] = { 'H', 'G', 'T', 'R', HGUI_TRACE_VERSION, 0, 0, 0, HGUI_TRACE_MENU, 0, 5 };
+	CHECK(hgui_trace_reader_init(&reader, dangling, sizeof(dangling)));
+	CHECK(!hgui_trace_next(&reader, &event) && reader.failed);
+	hgui_trace_reader_free(&reader);
+
+	// 时间倒退的事件按上一条的时间记录
+	HGUI_TraceWriter backwards;
+	memset(&backwards, 0, sizeof(backwards));
+	HGUI_TraceEvent late = { 500, HGUI_TRACE_MENU, "a", 0, false, 0, NULL };
+	HGUI_TraceEvent early = { 100, HGUI_TRACE_MENU, "a", 0, false, 0, NULL };
+	CHECK(hgui_trace_write(&backwards, &late) && hgui_trace_write(&backwards, &early));
+	CHECK(hgui_trace_reader_init(&reader, backwards.data, backwards.size));
+	CHECK(hgui_trace_next(&reader, &event) && event.time_us == 500);
+	CHECK(hgui_trace_next(&reader, &event) && event.time_us == 500);
+	// 重复的菜单命令只占3字节：标志、时间与ID编号
+	CHECK(backwards.size == HGUI_TRACE_HEADER_SIZE + 5 + 3);
+	hgui_trace_reader_free(&reader);
+	hgui_trace_writer_free(&backwards);
+	hgui_trace_writer_free(&writer);
+}
+
+// 录制与回放的界面：回调按顺序记入日志
+static char callback_log[1024];
+
+static void log_callback(const char* kind, const char* id) {
+	size_t length = strlen(callback_log);
+	snprintf(callback_log + length, sizeof(callback_log) - length, "%s:%s;", kind, id);
+}
+
+static void on_click(const char* id) { log_callback("click", id); }
+static void on_change(const char* id) { log_callback("change", id); }
+static void on_dblclick(const char* id) { log_callback("dblclick", id); }
+static void on_menu(const char* id) { log_callback("menu", id); }
+
+static void on_select(HGUI_Handle control, HGUI_Event event, void* user_data) {
+	(void)control;
+	(void)event;
+	log_callback("select", (const char*)user_data);
+}
+
+static void build_ui(void) {
+	hgui.init();
+	hgui.create.window("main", "轨迹", 0, 0, 400, 300);
+	hgui.create.menubar("bar", "main");
+	HGUI_MenuSpec menu[] = {
+		{ "file", "文件", 0, NULL, NULL },
+		{ "open", "打开", 1, "Ctrl+O", on_menu },
+		{ "save", "保存", 1, NULL, on_menu }
+	};
+	CHECK(hgui.menu.build("bar", menu, 3) == 3);
+	hgui.create.button("ok", "main", "确定", 0, 0, 80, 24);
+	hgui.create.checkbox("agree", "main", "同意", 0, 30, 80, 24);
+	hgui.create.input("name", "main", 0, 60, 120, 24);
+	hgui.create.listbox("items", "main", 0, 90, 120, 100);
+	static const char* rows[] = { "甲", "乙", "丙" };
+	hgui.addItems("items", rows, 3);
+	hgui.bind("ok", "click", on_click);
+	hgui.bind("agree", "click", on_click);
+	hgui.bind("name", "change", on_change);
+	hgui.subscribe("items", HGUI_EVENT_SELECT, on_select, (void*)"items");
+	hgui.bind("items", "dblclick", on_dblclick);
+	callback_log[0] = '\0';
+}
+
+static HWND hwnd_of(const char* id) {
+	return find_control(id)->hwnd;
+}
+
+static void count_replayed(const HGUI_TraceEvent* event, double latency_ms, void* user_data) {
+	(void)event;
+	CHECK(latency_ms >= 0);
+	(*(int*)user_data)++;
+}
+
+static void test_record_replay(void) {
+	build_ui();
+
+	// 程序设置的文本与录制开始前的操作不录制
+	hgui_headless_click(hwnd_of("ok"));
+	hgui.trace.start();
+	hgui.setText("name", "程序设置");
+	size_t size;
+	CHECK(hgui.trace.data(&size) == NULL);
+
+	hgui_headless_click(hwnd_of("ok"));
+	hgui_headless_click(hwnd_of("agree"));
+	hgui_headless_type(hwnd_of("name"), "张三");
+	hgui_headless_select(hwnd_of("items"), 2, true);
+	hgui_headless_menu_command(hwnd_of("main"), find_control("save")->menu_id);
+	hgui_headless_key(hwnd_of("main"), 'O', FCONTROL);
+	hgui.run();
+	hgui_headless_click(hwnd_of("agree"));
+	hgui_headless_type(hwnd_of("name"), "李四");
+	hgui.trace.stop();
+	hgui_headless_click(hwnd_of("ok"));
+
+	const char* expected = "click:ok;click:ok;click:agree;change:name;select:items;dblclick:items;menu:save;menu:open;"
+						   "click:agree;change:name;click:ok;";
+	CHECK(strcmp(callback_log, expected) == 0);
+	const void* data = hgui.trace.data(&size);
+	CHECK(data && size > HGUI_TRACE_HEADER_SIZE);
+	CHECK(hgui.trace.save(TRACE_PATH));
+
+	// 轨迹中依次是录制期间的9条事件
+	HGUI_TraceReader reader;
+	HGUI_TraceEvent event;
+	CHECK(hgui_trace_reader_init(&reader, data, size));
+	int events = 0;
+	while (hgui_trace_next(&reader, &event)) events++;
+	CHECK(events == 9 && !reader.failed);
+	hgui_trace_reader_free(&reader);
+
+	char name[32];
+	hgui.getText("name", name, sizeof(name));
+	CHECK(strcmp(name, "李四") == 0);
+	bool agree = hgui.getCheck("agree");
+	int selected = hgui.getSelectedIndex("items");
+	CHECK(selected == 2);
+	TEST_TEARDOWN();
+
+	// 在重建的界面上回放文件：回调序列（去掉录制之外的两次点击）与最终状态相同
+	build_ui();
+	int replayed = 0;
+	HGUI_ReplayOptions options = { false, count_replayed, &replayed };
+	HGUI_ReplayReport report;
+	CHECK(hgui.trace.replayFile(TRACE_PATH, &options, &report));
+	CHECK(report.events == 9 && report.replayed == 9 && report.skipped == 0 && replayed == 9);
+	CHECK(report.latency.count == 9);
+	CHECK(strcmp(callback_log, "click:ok;click:agree;change:name;select:items;dblclick:items;menu:save;menu:open;"
+							   "click:agree;change:name;") == 0);
+	hgui.getText("name", name, sizeof(name));
+	CHECK(strcmp(name, "李四") == 0);
+	CHECK(hgui.getCheck("agree") == agree);
+	CHECK(hgui.getSelectedIndex("items") == selected);
+
+	// 找不到的控件计入skipped
+	hgui.remove("agree");
+	CHECK(hgui.trace.replayFile(TRACE_PATH, NULL, &report));
+	CHECK(report.replayed == 7 && report.skipped == 2);
+
+	// 文件不存在或不是轨迹时返回false并给出原因
+	CHECK(!hgui.trace.replayFile("missing.hgtr", NULL, &report) && report.error[0]);
+	CHECK(!hgui.trace.replay("HGTX", 4, NULL, &report) && report.error[0]);
+	TEST_TEARDOWN();
+	remove(TRACE_PATH);
+}
+
+// 按原间隔回放：两条间隔30毫秒的事件，总耗时不少于间隔；尽快回放时不等待
+static void test_realtime(void) {
+	HGUI_TraceWriter writer;
+	memset(&writer, 0, sizeof(writer));
+	HGUI_TraceEvent first = { 0, HGUI_TRACE_CONTROL, "ok", BN_CLICKED, false, 0, NULL };
+	HGUI_TraceEvent second = { 30000, HGUI_TRACE_CONTROL, "ok", BN_CLICKED, false, 0, NULL };
+	CHECK(hgui_trace_write(&writer, &first) && hgui_trace_write(&writer, &second));
+
+	build_ui();
+	HGUI_ReplayOptions options = { true, NULL, NULL };
+	HGUI_ReplayReport report;
+	CHECK(hgui.trace.replay(writer.data, writer.size, &options, &report));
+	CHECK(report.replayed == 2 && report.elapsed_ms >= 30.0);
+	options.realtime = false;
+	CHECK(hgui.trace.replay(writer.data, writer.size, &options, &report));
+	CHECK(report.replayed == 2 && report.elapsed_ms < 30.0);
+	CHECK(strcmp(callback_log, "click:ok;click:ok;click:ok;click:ok;") == 0);
+	TEST_TEARDOWN();
+	hgui_trace_writer_free(&writer);
+}
+
+int main(void) {
+	test_codec();
+	test_record_replay();
+	test_realtime();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,97 @@
+// 子树删除测试：删除深树与宽树的根后，账目回到创建前的基线、旧句柄全部失效，子孙控件都收到删除事件
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define DEPTH 2000
+#define WIDTH 10000
+#define ROUNDS 5
+
+static HGUI_Handle handles[DEPTH * 2 + WIDTH + 2];
+static int handle_count;
+static int removed;
+
+static void count_removal(HGUI_Handle control, HGUI_Event event, void* user_data) {
+	(void)event;
+	(void)user_data;
+	// 删除事件在销毁前分发，此时句柄仍然有效
+	CHECK(hgui.handle.valid(control));
+	removed++;
+}
+
+// 深树：盒子逐层嵌套，每层再挂一个持有窗口的标签
+static void build_deep(void) {
+	char id[32], parent[32] = "root";
+	handles[handle_count++] = hgui.create.box("root", "main");
+	for (int i = 0; i < DEPTH; i++) {
+		snprintf(id, sizeof(id), "deep%d", i);
+		handles[handle_count++] = hgui.create.box(id, parent);
+		memcpy(parent, id, sizeof(id));
+		snprintf(id, sizeof(id), "leaf%d", i);
+		handles[handle_count++] = hgui.create.label(id, parent, "x", 0, 0, 10, 10);
+	}
+}
+
+// 宽树：同一个盒子下挂大量兄弟标签
+static void build_wide(void) {
+	char id[32];
+	handles[handle_count++] = hgui.create.box("root", "main");
+	for (int i = 0; i < WIDTH; i++) {
+		snprintf(id, sizeof(id), "wide%d", i);
+		handles[handle_count++] = hgui.create.label(id, "root", "x", 0, 0, 10, 10);
+	}
+}
+
+static void check_removal(void (*build)(void)) {
+	HGUI_MemoryStats before, after;
+	HGUI_HeadlessStats headless_before, headless_after;
+	hgui.memoryStats(&before);
+	hgui_headless_stats(&headless_before);
+
+	handle_count = 0;
+	removed = 0;
+	build();
+	for (int i = 0; i < handle_count; i++) {
+		CHECK(hgui.handle.valid(handles[i]));
+		hgui.handle.subscribe(handles[i], HGUI_EVENT_REMOVE, count_removal, NULL);
+	}
+
+	hgui.remove("root");
+	CHECK(removed == handle_count);
+	for (int i = 0; i < handle_count; i++) {
+		CHECK(!hgui.handle.valid(handles[i]));
+	}
+	CHECK(hgui.handle.lookup("root") == HGUI_INVALID_HANDLE);
+	CHECK(hgui.handle.lookup("leaf0") == HGUI_INVALID_HANDLE);
+	CHECK(hgui.handle.lookup("wide0") == HGUI_INVALID_HANDLE);
+	CHECK(hgui.handle.valid(hgui.handle.lookup("main")));
+
+	hgui.memoryStats(&after);
+	hgui_headless_stats(&headless_after);
+	CHECK(after.total.controls == before.total.controls);
+	CHECK(after.total.hwnds == before.total.hwnds);
+	CHECK(after.total.font_refs == before.total.font_refs);
+	CHECK(after.total.bytes == before.total.bytes);
+	CHECK(headless_after.windows_alive == headless_before.windows_alive);
+}
+
+int main(void) {
+	hgui.init();
+	hgui.create.window("main", "子树", 0, 0, 320, 240);
+
+	// 第一轮之后节点池与索引已扩容到位，反复建树删树不再增长
+	check_removal(build_deep);
+	check_removal(build_wide);
+	HGUI_MemoryStats settled, churned;
+	hgui.memoryStats(&settled);
+	for (int round = 0; round < ROUNDS; round++) {
+		check_removal(build_deep);
+		check_removal(build_wide);
+	}
+	hgui.memoryStats(&churned);
+	CHECK(churned.node_bytes == settled.node_bytes);
+	CHECK(churned.table_bytes == settled.table_bytes);
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}
@@ -0,0 +1,77 @@
+// 界面描述测试：编译、父节点类型检查、二进制加载与创建失败时的错误信息
+#include "hgui.h"
+#include "hgui_test.h"
+
+static const char* layout =
+	"# 示例界面\n"
+	"window   main  \"主窗口\" 0 0 400 300\n"
+	"label    title main \"标题\" 10 10 100 20\n"
+	"button   ok    main \"确定\" 10 40 80 24\n"
+	"input    name  main 10 70 120 24\n"
+	"listbox  items main 10 100 120 80\n"
+	"radio    r1    main \"A\" 150 10 60 20 group\n"
+	"radio    r2    main \"B\" 150 40 60 20\n"
+	"checkbox agree main \"同意\" 150 70 80 20\n"
+	"canvas   chart main 220 10 100 100\n"
+	"menubar  bar   main\n"
+	"menu     file  bar \"文件\" submenu\n"
+	"menu     open  file \"打开\"\n"
+	"menu     sep   file \"\"\n";
+
+// 编译应失败，且错误信息包含指定片段
+static void expect_compile_error(const char* text, const char* message) {
+	void* blob = NULL;
+	size_t size = 0;
+	char error[128] = "";
+	CHECK(!hgui_uidesc_compile(text, strlen(text), &blob, &size, error, sizeof(error)));
+	CHECK(blob == NULL);
+	CHECK(strstr(error, message) != NULL);
+}
+
+int main(void) {
+	HGUI_LoadStats stats;
+
+	// 文本格式直接加载
+	hgui.init();
+	CHECK(hgui.loadUI(layout, strlen(layout), &stats));
+	CHECK(stats.node_count == 13 && stats.created_count == 13);
+	CHECK(stats.error[0] == 0);
+	CHECK(find_control("chart") && find_control("chart")->type == HGUI_CANVAS);
+	CHECK(find_control("open")->parent == find_control("file"));
+	CHECK(strcmp(hgui.getTextView("ok"), "确定") == 0);
+	TEST_TEARDOWN();
+
+	// 父节点类型检查
+	expect_compile_error("window w \"t\" 0 0 1 1\nmenu m w \"M\"\n", "第2行");
+	expect_compile_error("window w \"t\" 0 0 1 1\nmenubar b w\nlabel l b \"x\" 0 0 1 1\n", "父节点类型");
+	expect_compile_error("window w \"t\" 0 0 1 1\nmenubar b w\nmenu m b \"M\"\nmenu n m \"N\"\n", "父节点类型");
+	expect_compile_error("window w \"t\" 0 0 1 1\nlabel l w \"x\" 0 0 1 1\nmenubar b l\n", "父节点类型");
+	expect_compile_error("window w \"t\" 0 0 1 1\nlabel l x \"x\" 0 0 1 1\n", "父节点未声明");
+	expect_compile_error("window w \"t\" 0 0 1 1\nwindow w \"t\" 0 0 1 1\n", "ID重复");
+	expect_compile_error("window w \"t\" 0 0 1 1\ncanvas c w 0 0 1\n", "第2行");
+
+	// 编译后的二进制格式加载结果相同
+	void* blob = NULL;
+	size_t size = 0;
+	char error[128];
+	CHECK(hgui_uidesc_compile(layout, strlen(layout), &blob, &size, error, sizeof(error)));
+	hgui.init();
+	CHECK(hgui.loadUI(blob, size, &stats));
+	CHECK(stats.created_count == 13);
+	TEST_TEARDOWN();
+
+	// 绕过编译器构造的数据（菜单项挂在普通菜单项下）在加载时失败，并报告第一个失败的控件
+	const HGUI_UIDescHeader* header = hgui_uidesc_validate(blob, size);
+	CHECK(header);
+	HGUI_UIDescNode* nodes = (HGUI_UIDescNode*)hgui_uidesc_nodes(header);
+	nodes[12].parent = nodes[11].id;    // sep 的父节点改为 open
+	hgui.init();
+	CHECK(!hgui.loadUI(blob, size, &stats));
+	CHECK(stats.created_count == 12);
+	CHECK(strstr(stats.error, "sep") != NULL);
+	TEST_TEARDOWN();
+	free(blob);
+
+	puts("OK");
+	return 0;
+}
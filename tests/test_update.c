@@ -0,0 +1,63 @@
+// 批量更新测试：事务中的改动在提交时应用并按父窗口合并重绘；无法延迟的改动立即生效
+#include "hgui.h"
+#include "hgui_test.h"
+
+#define COUNT 50
+
+int main(void) {
+	char id[32];
+	HGUI_UpdateStats stats;
+	hgui.init();
+	hgui.create.window("main", "批量更新", 0, 0, 320, 240);
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "label%d", i);
+		hgui.create.label(id, "main", "x", i, 0, 10, 10);
+	}
+
+	// 事务中隐藏与改文本，提交前不可见性不变，提交后全部生效且只重绘一次
+	hgui.beginUpdate();
+	hgui.beginUpdate();     // 可嵌套
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "label%d", i);
+		hgui.hide(id);
+		hgui.setText(id, "y");
+	}
+	hgui.endUpdate();
+	CHECK(hgui_headless_visible(find_control("label0")->hwnd));
+	hgui.endUpdate();
+	for (int i = 0; i < COUNT; i++) {
+		snprintf(id, sizeof(id), "label%d", i);
+		CHECK(!hgui_headless_visible(find_control(id)->hwnd));
+		CHECK(strcmp(hgui.getTextView(id), "y") == 0);
+	}
+	hgui.getUpdateStats(&stats);
+	CHECK(stats.transactions == 1);
+	CHECK(stats.invalidations == 1);
+	CHECK(stats.deferred_changes == 2 * COUNT);
+
+	// 事务中删除的控件不会在提交时被访问
+	hgui.beginUpdate();
+	hgui.show("label1");
+	hgui.remove("label1");
+	hgui.endUpdate();
+	CHECK(!find_control("label1"));
+
+	// 原生窗口没有父窗口时无法记录脏区域：改动立即应用，不进入事务
+	HGUI_Control* detached = find_control("label2");
+	headless_window(detached->hwnd)->parent = NULL;
+	hgui.getUpdateStats(&stats);
+	unsigned long deferred = stats.deferred_changes;
+	hgui.beginUpdate();
+	hgui.show("label2");
+	CHECK(hgui_headless_visible(detached->hwnd));
+	hgui.setText("label2", "z");
+	hgui.endUpdate();
+	CHECK(hgui_headless_visible(detached->hwnd));
+	CHECK(strcmp(hgui.getTextView("label2"), "z") == 0);
+	hgui.getUpdateStats(&stats);
+	CHECK(stats.deferred_changes == deferred);
+
+	TEST_TEARDOWN();
+	puts("OK");
+	return 0;
+}